@@ -0,0 +1,103 @@
+# Synchronizes copies of a document between several mediators through a local
+# relay while they take turns editing it, checks that they converge and
+# reports the traffic that it took, e.g.
+#
+#     godot --headless --path Test -s relay_benchmark.gd -- 8
+#
+# or synchronizes the same documents over two shared connections instead so
+# that each one carries half of the peers' channels, e.g.
+#
+#     godot --headless --path Test -s relay_benchmark.gd -- 8 multiplex
+extends SceneTree
+
+const DOCUMENT_ID := "relay-benchmark"
+const DOCUMENT_PATH := "res://a-cube.automerge"
+const EDIT_INTERVAL_MSECS := 250
+const EDIT_MSECS := 8000
+const PORT := 8765
+const SETTLE_MSECS := 4000
+# Multiplexed connections are shared per URL so each site uses another name
+# for the relay's host.
+const SITE_HOSTS := ["127.0.0.1", "localhost"]
+
+var edit_count := 0
+var peers: Array[Node3D] = []
+var relay := UsdjRelay.new()
+var started_msecs := 0
+
+
+func _initialize():
+	var args := OS.get_cmdline_user_args()
+	var peer_count := int(args[0]) if args.size() > 0 else 2
+	var multiplex := args.size() > 1 and args[1] == "multiplex"
+	if relay.listen(PORT) != OK:
+		quit(1)
+		return
+	var source := ResourceLoader.load(DOCUMENT_PATH, "", ResourceLoader.CACHE_MODE_IGNORE)
+	for i in peer_count:
+		# Each mediator needs its own copy of the document, which mustn't be
+		# the project's own.
+		var path := "user://relay_benchmark_%d.automerge" % i
+		if ResourceSaver.save(source, path) != OK:
+			quit(1)
+			return
+		var peer := Node3D.new()
+		peer.name = "Peer%d" % i
+		root.add_child(peer)
+		peers.append(peer)
+		var mediator := UsdjMediator.new()
+		mediator.document_resource = ResourceLoader.load(path, "", ResourceLoader.CACHE_MODE_IGNORE)
+		mediator.document_path = "/data/scene"
+		# A shared connection can only carry one channel per document so the
+		# peers are split between two of them.
+		var site := i % SITE_HOSTS.size() if multiplex else 0
+		mediator.server_domain_name = "%s:%d" % [SITE_HOSTS[site], PORT]
+		mediator.server_path = DOCUMENT_ID + ("-%d" % (i / SITE_HOSTS.size()) if multiplex else "")
+		mediator.server_tls = false
+		mediator.server_multiplex = multiplex
+		peer.add_child(mediator)
+		mediator.document_scan = true
+		mediator.server_sync = true
+	started_msecs = Time.get_ticks_msec()
+
+
+func _process(_delta):
+	relay.poll()
+	var elapsed_msecs := Time.get_ticks_msec() - started_msecs
+	if elapsed_msecs < EDIT_MSECS:
+		# The peers take turns recoloring their copies of every body.
+		if elapsed_msecs >= (edit_count + 1) * EDIT_INTERVAL_MSECS:
+			var peer := peers[edit_count % peers.size()]
+			for body in peer.find_children("*", "UsdjStaticBody3D", true, false):
+				body.display_color = Color.from_hsv(float(edit_count % 16) / 16.0, 1.0, 1.0)
+			edit_count += 1
+		return false
+	if elapsed_msecs < EDIT_MSECS + SETTLE_MSECS:
+		return false
+	print("peers: %d" % relay.get_peer_count())
+	print("edits: %d" % edit_count)
+	print("statistics: %s" % relay.get_statistics())
+	for document_id in relay.get_document_ids():
+		print("%s: %d bytes" % [document_id, relay.save_document(document_id).size()])
+	var converged := check_convergence()
+	print("converged: %s" % converged)
+	relay.stop()
+	quit(0 if converged else 1)
+	return true
+
+
+# Compares the colors of the bodies of the peers that share each document.
+func check_convergence() -> bool:
+	var expected := {}
+	for peer in peers:
+		var mediator := peer.get_child(0) as UsdjMediator
+		var colors := {}
+		for body in peer.find_children("*", "UsdjStaticBody3D", true, false):
+			colors[body.name] = body.display_color
+		if colors.is_empty():
+			return false
+		if not expected.has(mediator.server_path):
+			expected[mediator.server_path] = colors
+		elif expected[mediator.server_path] != colors:
+			return false
+	return true
@@ -27,11 +27,21 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
+#include <algorithm>
 #include <filesystem>
 #include <stdexcept>
+#include <system_error>
+#include <utility>
+
+// third-party
+extern "C" {
+
+#include <automerge-c/automerge.h>
+}
 
 // regional
 #include <core/config/project_settings.h>
+#include <core/error/error_macros.h>
 #include <core/io/file_access.h>
 
 // local
@@ -41,11 +51,48 @@ namespace {
 
 char const* CLASS_NAME = "AutomergeResource";
 char const* FILE_EXT = "automerge";
+
+/// \brief The size that the changes appended to a file can reach before it's
+///        compacted regardless of the size of its compacted part.
+std::size_t const MIN_COMPACTION_THRESHOLD = 1 << 20;
+
+/// \brief Checks whether an Automerge document contains every change in a
+///        sequence of heads.
+///
+/// \param[in] p_document A pointer to an `AMdoc` struct.
+/// \param[in] p_heads A pointer to an `AMresult` struct containing a sequence
+///                    of change hashes.
+/// \returns `true` if \p p_document contains all of \p p_heads.
+bool contains_heads(AMdoc* const p_document, AMresult* const p_heads) {
+    auto heads = AMresultItems(p_heads);
+    while (AMitem* const head = AMitemsNext(&heads, 1)) {
+        AMbyteSpan hash = {0};
+        if (!AMitemToChangeHash(head, &hash))
+            return false;
+        cavi::usdj_am::utils::Document::ResultPtr const change_result{
+            AMgetChangeByHash(p_document, hash.src, hash.count), AMresultFree};
+        if (AMitemValType(AMresultItem(change_result.get())) != AM_VAL_TYPE_CHANGE)
+            return false;
+    }
+    return true;
+}
+
+std::filesystem::path to_filesystem_path(String const& p_path) {
+    // Convert the project-relative path into an absolute one.
+    auto const global_path = ProjectSettings::get_singleton()->globalize_path(p_path);
+    auto const buffer = global_path.to_utf8_buffer();
+    return std::filesystem::path{std::string{reinterpret_cast<std::string::const_pointer>(buffer.ptr()),
+                                             static_cast<std::string::size_type>(buffer.size())}};
+}
+
 }  // namespace
 
 // AutomergeResource
 void AutomergeResource::_bind_methods() {}
 
+AutomergeResource::AutomergeResource()
+    : m_appended_size{0}, m_compacted_size{0}, m_saved_heads{nullptr, AMresultFree} {}
+
 AutomergeResource::~AutomergeResource() {}
 
 std::optional<std::reference_wrapper<cavi::usdj_am::utils::Document const>> AutomergeResource::get_document() const {
@@ -54,13 +101,42 @@ std::optional<std::reference_wrapper<cavi::usdj_am::utils::Document const>> Auto
     return std::nullopt;
 }
 
-Error AutomergeResource::load(Vector<std::uint8_t> const& p_data, String& p_err_msg) {
+std::optional<cavi::usdj_am::utils::Document> AutomergeResource::exchange_document(
+    cavi::usdj_am::utils::Document&& p_document) {
+    // Only a revision that descends from the saved one can be appended to
+    // its file.
+    if (m_saved_heads && !contains_heads(p_document, m_saved_heads.get()))
+        m_saved_heads.reset();
+    auto replaced = std::exchange(m_document, std::make_optional(std::move(p_document)));
+    emit_changed();
+    return replaced;
+}
+
+Error AutomergeResource::load(Vector<std::uint8_t> const& p_data, String const& p_path, String& p_err_msg) {
     using cavi::usdj_am::utils::Document;
 
     auto outcome = Error::OK;
     p_err_msg.clear();
+    m_saved_heads.reset();
+    m_saved_path.clear();
     try {
-        m_document.emplace(Document::load(p_data.ptr(), p_data.size()));
+        std::size_t loaded_size = 0;
+        m_document.emplace(Document::load(p_data.ptr(), p_data.size(), loaded_size));
+        // The file may already have changes appended to it.
+        m_saved_heads = m_document->get_heads();
+        m_saved_path = p_path;
+        m_compacted_size = loaded_size;
+        m_appended_size = 0;
+        if (loaded_size < static_cast<std::size_t>(p_data.size())) {
+            WARN_PRINT(vformat("Discarded an incomplete change at the end of \"%s\".", p_path));
+            // Changes mustn't be appended after the incomplete one so the file
+            // must be rewritten when it can't be truncated, e.g. when it's
+            // read-only.
+            std::error_code error_code;
+            std::filesystem::resize_file(to_filesystem_path(p_path), loaded_size, error_code);
+            if (error_code)
+                m_saved_heads.reset();
+        }
     } catch (std::invalid_argument const& thrown) {
         outcome = Error::ERR_INVALID_PARAMETER;
         p_err_msg = thrown.what();
@@ -72,6 +148,31 @@ Error AutomergeResource::load(Vector<std::uint8_t> const& p_data, String& p_err_
     return outcome;
 }
 
+Error AutomergeResource::save(String const& p_path) {
+    ERR_FAIL_COND_V(!m_document, Error::ERR_INVALID_PARAMETER);
+    auto const filename = to_filesystem_path(p_path);
+    // Compact the file once the appended changes outgrow its compacted part
+    // so that the cost of compacting it is amortized over the appends.
+    auto const threshold = std::max(MIN_COMPACTION_THRESHOLD, m_compacted_size);
+    auto const append =
+        m_saved_heads && p_path == m_saved_path && m_appended_size < threshold && FileAccess::exists(p_path);
+    try {
+        if (append) {
+            m_appended_size += m_document->save_incremental(filename, m_saved_heads);
+        } else {
+            m_compacted_size = m_document->save(filename);
+            m_appended_size = 0;
+            m_saved_path = p_path;
+        }
+        m_saved_heads = m_document->get_heads();
+    } catch (std::exception const& thrown) {
+        // The file's contents are unknown now.
+        m_saved_heads.reset();
+        ERR_FAIL_V_MSG(Error::ERR_FILE_CANT_WRITE, "Cannot save file \"" + p_path + "\": " + thrown.what());
+    }
+    return Error::OK;
+}
+
 // ResourceFormatLoaderAutomerge
 void ResourceFormatLoaderAutomerge::get_recognized_extensions(List<String>* p_extensions) const {
     p_extensions->push_back(FILE_EXT);
@@ -113,7 +214,7 @@ Ref<Resource> ResourceFormatLoaderAutomerge::load(String const& p_path,
         return Ref<Resource>();
     }
     String load_error_msg;
-    auto load_error = automerge_resource->load(bytes, load_error_msg);
+    auto load_error = automerge_resource->load(bytes, p_path, load_error_msg);
     if (load_error != Error::OK) {
         String error_msg = "Error loading file at \"" + p_path + "\": " + load_error_msg;
         if (r_error) {
@@ -143,21 +244,8 @@ bool ResourceFormatSaverAutomerge::recognize(Ref<Resource> const& p_resource) co
 }
 
 Error ResourceFormatSaverAutomerge::save(Ref<Resource> const& p_resource, String const& p_path, uint32_t p_flags) {
-    using std::filesystem::path;
-
     Ref<AutomergeResource> automerge_resource = p_resource;
     ERR_FAIL_COND_V(!(automerge_resource.is_valid() && automerge_resource->get_document()),
                     Error::ERR_INVALID_PARAMETER);
-    // Convert the project-relative path into an absolute one.
-    auto const global_path = ProjectSettings::get_singleton()->globalize_path(p_path);
-    auto const buffer = global_path.to_utf8_buffer();
-    path const filename{std::string{reinterpret_cast<std::string::const_pointer>(buffer.ptr()),
-                                    static_cast<std::string::size_type>(buffer.size())}};
-    try {
-        automerge_resource->get_document()->get().save(filename);
-    } catch (std::invalid_argument const&) {
-        auto const err = Error::ERR_INVALID_PARAMETER;
-        ERR_FAIL_COND_V_MSG(err, err, "Cannot save file \"" + p_path + "\".");
-    }
-    return Error::OK;
+    return automerge_resource->save(p_path);
 }
@@ -30,6 +30,7 @@
 #ifndef REALITY_MERGE_AUTOMERGE_RESOURCE_H
 #define REALITY_MERGE_AUTOMERGE_RESOURCE_H
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <optional>
@@ -50,19 +51,45 @@ class AutomergeResource : public Resource {
     GDCLASS(AutomergeResource, Resource);
 
 public:
-    AutomergeResource() = default;
+    AutomergeResource();
 
     ~AutomergeResource();
 
     std::optional<std::reference_wrapper<cavi::usdj_am::utils::Document const>> get_document() const;
 
-    Error load(Vector<std::uint8_t> const& p_data, String& p_err_msg);
+    /// \brief Replaces the Automerge document with another revision of it.
+    ///
+    /// \param[in] p_document An Automerge document.
+    /// \returns The replaced Automerge document, if any.
+    /// \note The next save compacts the file unless \p p_document contains
+    ///       the revision that was last saved to it.
+    std::optional<cavi::usdj_am::utils::Document> exchange_document(cavi::usdj_am::utils::Document&& p_document);
+
+    /// \param[in] p_data The contents of a file.
+    /// \param[in] p_path The path of the file that \p p_data was read from.
+    /// \param[out] p_err_msg A description of the error upon failure.
+    /// \note An incomplete change left at the end of the file by an
+    ///       interrupted save is discarded and truncated from the file.
+    Error load(Vector<std::uint8_t> const& p_data, String const& p_path, String& p_err_msg);
+
+    /// \brief Saves the Automerge document into a file.
+    ///
+    /// \param[in] p_path The path of a file.
+    /// \note The changes made since the document was last loaded from or
+    ///       saved to the same file are appended to it until they outgrow
+    ///       the compacted part of it.
+    Error save(String const& p_path);
 
 protected:
     static void _bind_methods();
 
 private:
+    std::size_t m_appended_size;
+    std::size_t m_compacted_size;
     std::optional<cavi::usdj_am::utils::Document> m_document;
+    /// \note The heads of the revision stored in the file at `m_saved_path`.
+    cavi::usdj_am::utils::Document::ResultPtr m_saved_heads;
+    String m_saved_path;
 };
 
 class ResourceFormatLoaderAutomerge : public ResourceFormatLoader {
@@ -35,6 +35,7 @@
 #include "automerge_resource.h"
 #include "register_types.h"
 #include "usdj_mediator.h"
+#include "usdj_relay.h"
 #include "usdj_static_body_3d.h"
 
 static Ref<ResourceFormatLoaderAutomerge> resource_loader_automerge;
@@ -46,6 +47,7 @@ void initialize_reality_merge_module(ModuleInitializationLevel p_level) {
     }
     GDREGISTER_CLASS(AutomergeResource);
     GDREGISTER_CLASS(UsdjMediator);
+    GDREGISTER_CLASS(UsdjRelay);
     GDREGISTER_CLASS(UsdjStaticBody3D);
 
     resource_loader_automerge.instantiate();
@@ -0,0 +1,117 @@
+/**************************************************************************/
+/* spsc_queue.h                                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef REALITY_MERGE_SPSC_QUEUE_H
+#define REALITY_MERGE_SPSC_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+/// \brief A bounded, lock-free queue for handing values from exactly one
+///        producer thread to exactly one consumer thread.
+///
+/// \tparam T A default-constructible and move-assignable type of value.
+/// \tparam N The capacity of the queue, which must be a power of two.
+template <typename T, std::size_t N>
+class SpscQueue {
+public:
+    static_assert(N && !(N & (N - 1)), "N must be a power of two");
+
+    SpscQueue() : m_head{0}, m_tail{0} {}
+
+    SpscQueue(SpscQueue const&) = delete;
+
+    SpscQueue& operator=(SpscQueue const&) = delete;
+
+    /// \returns `true` if there's no value to pop.
+    /// \note Must only be called from the consumer thread.
+    bool empty() const;
+
+    /// \returns `true` if there's no room to push a value.
+    /// \note Must only be called from the producer thread.
+    bool full() const;
+
+    /// \brief Removes the oldest value from the queue.
+    ///
+    /// \returns The oldest value or `std::nullopt` if the queue is empty.
+    /// \note Must only be called from the consumer thread.
+    std::optional<T> pop();
+
+    /// \brief Appends a value to the queue.
+    ///
+    /// \param[in] value A value to move into the queue.
+    /// \returns `false` if the queue is full and \p value was left untouched.
+    /// \note Must only be called from the producer thread.
+    bool push(T&& value);
+
+private:
+    static constexpr std::size_t MASK = N - 1;
+
+    /// \note The indices are kept on separate cache lines so that the
+    ///       producer and the consumer don't contend for the same one.
+    alignas(64) std::atomic<std::size_t> m_head;
+    alignas(64) std::atomic<std::size_t> m_tail;
+    std::array<T, N> m_slots;
+};
+
+template <typename T, std::size_t N>
+bool SpscQueue<T, N>::empty() const {
+    return m_head.load(std::memory_order_relaxed) == m_tail.load(std::memory_order_acquire);
+}
+
+template <typename T, std::size_t N>
+bool SpscQueue<T, N>::full() const {
+    return m_tail.load(std::memory_order_relaxed) - m_head.load(std::memory_order_acquire) == N;
+}
+
+template <typename T, std::size_t N>
+std::optional<T> SpscQueue<T, N>::pop() {
+    auto const head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail.load(std::memory_order_acquire))
+        return std::nullopt;
+    std::optional<T> result{std::move(m_slots[head & MASK])};
+    m_slots[head & MASK] = T{};
+    m_head.store(head + 1, std::memory_order_release);
+    return result;
+}
+
+template <typename T, std::size_t N>
+bool SpscQueue<T, N>::push(T&& value) {
+    auto const tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_head.load(std::memory_order_acquire) == N)
+        return false;
+    m_slots[tail & MASK] = std::move(value);
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+#endif  // REALITY_MERGE_SPSC_QUEUE_H
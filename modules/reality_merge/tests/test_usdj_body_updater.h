@@ -0,0 +1,475 @@
+/**************************************************************************/
+/* test_usdj_body_updater.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef REALITY_MERGE_TESTS_TEST_USDJ_BODY_UPDATER_H
+#define REALITY_MERGE_TESTS_TEST_USDJ_BODY_UPDATER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// third-party
+extern "C" {
+
+#include <automerge-c/automerge.h>
+}
+#include <cavi/usdj_am/utils/document.hpp>
+#include <cavi/usdj_am/utils/document_path.hpp>
+#include <cavi/usdj_am/utils/scene.hpp>
+
+// regional
+#include <core/math/basis.h>
+#include <core/math/color.h>
+#include <core/math/math_defs.h>
+#include <core/math/transform_3d.h>
+#include <core/math/vector3.h>
+#include <core/object/message_queue.h>
+#include <core/object/object.h>
+#include <core/object/object_id.h>
+#include <core/os/memory.h>
+#include <core/os/os.h>
+#include <core/string/ustring.h>
+#include <scene/3d/node_3d.h>
+#include <scene/main/scene_tree.h>
+#include <scene/main/window.h>
+#include <tests/test_macros.h>
+
+// local
+#include "../automerge_resource.h"
+#include "../usdj_body_updater.h"
+#include "../usdj_editor.h"
+#include "../usdj_mediator.h"
+#include "../usdj_static_body_3d.h"
+
+namespace TestUsdjBodyUpdater {
+
+using Document = cavi::usdj_am::utils::Document;
+using ResultPtr = Document::ResultPtr;
+
+/// \brief Gets the path of one of the USDJ-AM library's test documents.
+///
+/// \param[in] p_stem The document's file name without its extension.
+static std::filesystem::path get_document_path(char const* const p_stem) {
+    return std::filesystem::path{__FILE__}.parent_path().parent_path() / "thirdparty" / "cavi_usdj-am" / "test" /
+           "files" / (std::string{p_stem} + ".automerge");
+}
+
+/// \brief Makes a document with a list of map objects standing in for the
+///        "USDA_Definition" nodes of a scene's prims.
+///
+/// \param[in] p_count The count of map objects.
+/// \param[out] p_results The results that own the map objects' IDs.
+/// \returns The map objects' IDs in the order of the list.
+static std::vector<AMobjId const*> make_prims(Document const& p_document,
+                                              std::size_t const p_count,
+                                              std::vector<ResultPtr>& p_results) {
+    ResultPtr const list_result{AMmapPutObject(p_document, AM_ROOT, AMstr("prims"), AM_OBJ_TYPE_LIST), AMresultFree};
+    AMobjId const* const list = AMitemObjId(AMresultItem(list_result.get()));
+    std::vector<AMobjId const*> object_ids{};
+    object_ids.reserve(p_count);
+    for (std::size_t pos = 0; pos != p_count; ++pos) {
+        p_results.emplace_back(AMlistPutObject(p_document, list, SIZE_MAX, true, AM_OBJ_TYPE_MAP), AMresultFree);
+        object_ids.push_back(AMitemObjId(AMresultItem(p_results.back().get())));
+    }
+    return object_ids;
+}
+
+TEST_CASE("[Modules][RealityMerge] Object keys") {
+    Document const document{ResultPtr{AMcreate(nullptr), AMresultFree}};
+    std::vector<ResultPtr> results{};
+    auto const object_ids = make_prims(document, 2, results);
+    UsdjObjectKey const first{object_ids[0]};
+    UsdjObjectKey const second{object_ids[1]};
+    CHECK(first == UsdjObjectKey{object_ids[0]});
+    CHECK(first != second);
+    CHECK(first.matches(object_ids[0]));
+    CHECK_FALSE(first.matches(object_ids[1]));
+    CHECK(UsdjObjectKey::Hash{}(first) == UsdjObjectKey::Hash{}(UsdjObjectKey{object_ids[0]}));
+    // A prim's key within a compiled scene identifies the same object.
+    auto const actor_id = AMactorIdBytes(AMobjIdActorId(object_ids[1]));
+    UsdjObjectKey const scene_key{std::make_pair(
+        AMobjIdCounter(object_ids[1]), std::string_view{reinterpret_cast<char const*>(actor_id.src), actor_id.count})};
+    CHECK(scene_key == second);
+    CHECK(UsdjObjectKey::Hash{}(scene_key) == UsdjObjectKey::Hash{}(second));
+    UsdjBodyUpdater::Bodies bodies{};
+    bodies.emplace(first, ObjectID{std::uint64_t{1}});
+    bodies.emplace(second, ObjectID{std::uint64_t{2}});
+    CHECK(bodies.size() == 2);
+    CHECK(bodies.at(UsdjObjectKey{object_ids[1]}) == ObjectID{std::uint64_t{2}});
+}
+
+TEST_CASE("[Modules][RealityMerge][SceneTree] Freeing bodies when toggling instanced rendering") {
+    Ref<AutomergeResource> resource{};
+    resource.instantiate();
+    resource->exchange_document(Document::load(get_document_path("cube-island")));
+    auto const parent = memnew(Node3D);
+    SceneTree::get_singleton()->get_root()->add_child(parent);
+    auto const mediator = memnew(UsdjMediator);
+    parent->add_child(mediator);
+    mediator->set_document_resource(resource);
+    mediator->set_document_path("/data/scene");
+    mediator->set_document_scan(true);
+    // Runs the calls deferred by the mediator and its bodies, which defer
+    // calls of their own, along with the mediator's processing and the
+    // deletions that they queued.
+    auto const process = []() {
+        SceneTree::get_singleton()->process(0.0);
+        SceneTree::get_singleton()->process(0.0);
+    };
+    auto const get_body_ids = [parent]() {
+        auto const bodies = parent->find_children("*", "UsdjStaticBody3D", true, false);
+        std::vector<ObjectID> ids{};
+        for (int pos = 0; pos != bodies.size(); ++pos)
+            ids.push_back(Object::cast_to<Node>(bodies[pos])->get_instance_id());
+        return ids;
+    };
+    auto const get_bucket_count = [mediator]() {
+        return mediator->find_children("*", "MultiMeshInstance3D", false, false).size();
+    };
+    process();
+    auto const body_count = get_body_ids().size();
+    REQUIRE(body_count > 0);
+    CHECK(get_bucket_count() == 0);
+    std::optional<std::int64_t> instanced_bucket_count{};
+    for (auto const instanced : {true, false, true, false}) {
+        auto const previous_ids = get_body_ids();
+        mediator->set_rendering_instanced(instanced);
+        process();
+        // The bodies constructed for the other rendering mode are freed
+        // instead of only being detached.
+        for (auto const id : previous_ids)
+            CHECK(ObjectDB::get_instance(id) == nullptr);
+        CHECK(get_body_ids().size() == body_count);
+        auto const bucket_count = get_bucket_count();
+        if (!instanced) {
+            CHECK(bucket_count == 0);
+        } else if (!instanced_bucket_count) {
+            CHECK(bucket_count > 0);
+            instanced_bucket_count = bucket_count;
+        } else {
+            CHECK(bucket_count == *instanced_bucket_count);
+        }
+    }
+    memdelete(parent);
+}
+
+/// \brief Appends a map object of string and null fields to a list object.
+///
+/// \param[in] p_list The ID of the list object.
+/// \param[in] p_fields The map object's keys and values, where a `nullptr`
+///                     value is a null.
+/// \returns The result that owns the map object's ID.
+static ResultPtr add_node(Document const& p_document,
+                          AMobjId const* const p_list,
+                          std::initializer_list<std::pair<char const*, char const*>> const p_fields) {
+    ResultPtr result{AMlistPutObject(p_document, p_list, SIZE_MAX, true, AM_OBJ_TYPE_MAP), AMresultFree};
+    AMobjId const* const map = AMitemObjId(AMresultItem(result.get()));
+    for (auto const& field : p_fields) {
+        ResultPtr{(field.second) ? AMmapPutStr(p_document, map, AMstr(field.first), AMstr(field.second))
+                                 : AMmapPutNull(p_document, map, AMstr(field.first)),
+                  AMresultFree};
+    }
+    return result;
+}
+
+/// \brief Puts an object into a map object.
+///
+/// \returns The result that owns the object's ID.
+static ResultPtr put_object(Document const& p_document,
+                            AMobjId const* const p_map,
+                            char const* const p_key,
+                            AMobjType const p_obj_type) {
+    return ResultPtr{AMmapPutObject(p_document, p_map, AMstr(p_key), p_obj_type), AMresultFree};
+}
+
+/// \brief Gets the ID of the object that a result owns.
+static AMobjId const* get_object_id(ResultPtr const& p_result) {
+    return AMitemObjId(AMresultItem(p_result.get()));
+}
+
+/// \brief Makes a document whose scene at "/data/scene" has a default prim
+///        grouping a number of translated prims.
+///
+/// \param[in] p_count The count of prims within the default prim.
+static Document make_scene(std::size_t const p_count) {
+    Document document{ResultPtr{AMcreate(nullptr), AMresultFree}};
+    auto const data = put_object(document, AM_ROOT, "data", AM_OBJ_TYPE_MAP);
+    auto const scene = put_object(document, get_object_id(data), "scene", AM_OBJ_TYPE_MAP);
+    ResultPtr{AMmapPutF64(document, get_object_id(scene), AMstr("version"), 1.0), AMresultFree};
+    auto const descriptor = put_object(document, get_object_id(scene), "descriptor", AM_OBJ_TYPE_MAP);
+    ResultPtr{AMmapPutNull(document, get_object_id(descriptor), AMstr("description")), AMresultFree};
+    auto const assignments = put_object(document, get_object_id(descriptor), "assignments", AM_OBJ_TYPE_LIST);
+    add_node(document, get_object_id(assignments),
+             {{"type", "assignment"}, {"keyword", nullptr}, {"identifier", "defaultPrim"}, {"value", "world"}});
+    auto const statements = put_object(document, get_object_id(scene), "statements", AM_OBJ_TYPE_LIST);
+    auto const add_definition = [&document](AMobjId const* const p_statements, char const* const p_name) {
+        auto const definition = add_node(document, p_statements,
+                                         {{"type", "definition"},
+                                          {"subType", "def"},
+                                          {"defType", "Xform"},
+                                          {"name", p_name},
+                                          {"descriptor", nullptr}});
+        return put_object(document, get_object_id(definition), "statements", AM_OBJ_TYPE_LIST);
+    };
+    auto const world_statements = add_definition(get_object_id(statements), "world");
+    for (std::size_t pos = 0; pos != p_count; ++pos) {
+        auto const name = "prim" + std::to_string(pos);
+        auto const prim_statements = add_definition(get_object_id(world_statements), name.c_str());
+        auto const translate = add_node(document, get_object_id(prim_statements),
+                                        {{"type", "declaration"},
+                                         {"keyword", nullptr},
+                                         {"defineType", "double3"},
+                                         {"reference", "xformOp:translate"},
+                                         {"descriptor", nullptr}});
+        auto const offset = put_object(document, get_object_id(translate), "value", AM_OBJ_TYPE_LIST);
+        for (auto const number : {static_cast<double>(pos), 0.0, 0.0})
+            ResultPtr{AMlistPutF64(document, get_object_id(offset), SIZE_MAX, true, number), AMresultFree};
+        auto const order = add_node(document, get_object_id(prim_statements),
+                                    {{"type", "declaration"},
+                                     {"keyword", "uniform"},
+                                     {"defineType", "token[]"},
+                                     {"reference", "xformOpOrder"},
+                                     {"descriptor", nullptr}});
+        auto const tokens = put_object(document, get_object_id(order), "value", AM_OBJ_TYPE_LIST);
+        ResultPtr{AMlistPutStr(document, get_object_id(tokens), SIZE_MAX, true, AMstr("xformOp:translate")),
+                  AMresultFree};
+    }
+    return document;
+}
+
+TEST_CASE("[Modules][RealityMerge][SceneTree] Keeping transforms when a scene can't be compiled") {
+    Transform3D const transform{Basis{Vector3{0.0f, 1.0f, 0.0f}, Math_PI / 2.0f}, Vector3{1.0f, 2.0f, 3.0f}};
+    // Loads the cube moved by the transform, optionally with a declaration
+    // whose type isn't a string so that the scene can't be compiled although
+    // its prims can still be read.
+    auto const load = [&transform](bool const p_compilable) {
+        auto document = Document::load(get_document_path("a-cube"));
+        auto const cube = document.get_item("/data/scene/statements/0/statements/0");
+        UsdjEdits edits{"/data/scene", {}};
+        edits.edits.push_back(UsdjEdit{UsdjObjectKey{AMitemObjId(cube)}, std::nullopt, transform, std::nullopt,
+                                       std::nullopt});
+        REQUIRE(UsdjEditor{document}(edits) == 1);
+        if (!p_compilable) {
+            auto const statements = document.get_item("/data/scene/statements/0/statements/0/statements");
+            auto const declaration = add_node(document, AMitemObjId(statements),
+                                              {{"type", "declaration"},
+                                               {"keyword", nullptr},
+                                               {"reference", "custom:uncompilable"},
+                                               {"value", nullptr},
+                                               {"descriptor", nullptr}});
+            ResultPtr{AMmapPutF64(document, get_object_id(declaration), AMstr("defineType"), 0.0), AMresultFree};
+        }
+        return document;
+    };
+    Ref<AutomergeResource> resource{};
+    resource.instantiate();
+    resource->exchange_document(load(true));
+    auto const parent = memnew(Node3D);
+    SceneTree::get_singleton()->get_root()->add_child(parent);
+    auto const mediator = memnew(UsdjMediator);
+    parent->add_child(mediator);
+    mediator->set_document_resource(resource);
+    mediator->set_document_path("/data/scene");
+    mediator->set_document_scan(true);
+    // Runs the calls deferred by the mediator and its bodies.
+    auto const process = []() {
+        SceneTree::get_singleton()->process(0.0);
+        SceneTree::get_singleton()->process(0.0);
+    };
+    auto const get_cube = [parent]() {
+        return Object::cast_to<Node3D>(parent->find_child("myFirstCube", true, false));
+    };
+    process();
+    auto cube = get_cube();
+    REQUIRE(cube);
+    CHECK(cube->get_transform().is_equal_approx(transform));
+    // Every body is revised without a transform to apply.
+    resource->exchange_document(load(false));
+    mediator->set_document_scan(false);
+    mediator->set_document_scan(true);
+    process();
+    cube = get_cube();
+    REQUIRE(cube);
+    CHECK(cube->get_transform().is_equal_approx(transform));
+    memdelete(parent);
+}
+
+TEST_CASE("[Modules][RealityMerge][SceneTree] Placing bodies within a translated default prim") {
+    // Loads the cube within a translated default prim, optionally resetting
+    // the cube's transform stack.
+    auto const load = [](bool const p_reset) {
+        auto document = Document::load(get_document_path("a-cube"));
+        auto const world_statements = document.get_item("/data/scene/statements/0/statements");
+        auto const translate = add_node(document, AMitemObjId(world_statements),
+                                        {{"type", "declaration"},
+                                         {"keyword", nullptr},
+                                         {"defineType", "double3"},
+                                         {"reference", "xformOp:translate"},
+                                         {"descriptor", nullptr}});
+        auto const offset = put_object(document, get_object_id(translate), "value", AM_OBJ_TYPE_LIST);
+        for (auto const number : {10.0, 0.0, 0.0})
+            ResultPtr{AMlistPutF64(document, get_object_id(offset), SIZE_MAX, true, number), AMresultFree};
+        auto const order = add_node(document, AMitemObjId(world_statements),
+                                    {{"type", "declaration"},
+                                     {"keyword", "uniform"},
+                                     {"defineType", "token[]"},
+                                     {"reference", "xformOpOrder"},
+                                     {"descriptor", nullptr}});
+        auto const tokens = put_object(document, get_object_id(order), "value", AM_OBJ_TYPE_LIST);
+        ResultPtr{AMlistPutStr(document, get_object_id(tokens), SIZE_MAX, true, AMstr("xformOp:translate")),
+                  AMresultFree};
+        if (p_reset) {
+            auto const cube_order = document.get_item("/data/scene/statements/0/statements/0/statements/3");
+            auto const cube_tokens = put_object(document, AMitemObjId(cube_order), "value", AM_OBJ_TYPE_LIST);
+            for (char const* const token :
+                 {"!resetXformStack!", "xformOp:translate", "xformOp:rotateXYZ", "xformOp:scale"})
+                ResultPtr{AMlistPutStr(document, get_object_id(cube_tokens), SIZE_MAX, true, AMstr(token)),
+                          AMresultFree};
+        }
+        return document;
+    };
+    Ref<AutomergeResource> resource{};
+    resource.instantiate();
+    resource->exchange_document(load(false));
+    auto const parent = memnew(Node3D);
+    parent->set_position(Vector3{0.0f, 0.0f, 5.0f});
+    SceneTree::get_singleton()->get_root()->add_child(parent);
+    auto const mediator = memnew(UsdjMediator);
+    parent->add_child(mediator);
+    mediator->set_document_resource(resource);
+    mediator->set_document_path("/data/scene");
+    mediator->set_document_scan(true);
+    // Runs the calls deferred by the mediator and its bodies.
+    auto const process = []() {
+        SceneTree::get_singleton()->process(0.0);
+        SceneTree::get_singleton()->process(0.0);
+    };
+    auto const get_cube = [parent]() {
+        return Object::cast_to<Node3D>(parent->find_child("myFirstCube", true, false));
+    };
+    process();
+    auto cube = get_cube();
+    REQUIRE(cube);
+    // The default prim's translation applies to the prims within it.
+    CHECK(cube->get_global_transform().origin.is_equal_approx(Vector3{10.0f, 0.0f, 5.0f}));
+    // A prim that resets the transform stack ignores the default prim's
+    // translation but not the mediator's parent's.
+    resource->exchange_document(load(true));
+    mediator->set_document_scan(false);
+    mediator->set_document_scan(true);
+    process();
+    cube = get_cube();
+    REQUIRE(cube);
+    CHECK(cube->get_global_transform().origin.is_equal_approx(Vector3{0.0f, 0.0f, 5.0f}));
+    memdelete(parent);
+}
+
+/// \brief Measures updating the bodies of a document's scene after
+///        recoloring one of them and reports the timings.
+///
+/// \param[in] p_document An Automerge document with a scene at "/data/scene".
+/// \param[in] p_name The name of the document within the report.
+static void measure_updates(Document& p_document, char const* const p_name) {
+    using cavi::usdj_am::utils::DocumentPath;
+    using cavi::usdj_am::utils::Scene;
+
+    int const ROUNDS = 10;
+    DocumentPath const path{"/data/scene"};
+    UsdjBodyUpdater::Bodies bodies{};
+    std::optional<Scene> scene{};
+    auto const added_begin = OS::get_singleton()->get_ticks_usec();
+    auto const added = UsdjBodyUpdater{bodies}(p_document, path, scene);
+    auto const added_usecs = OS::get_singleton()->get_ticks_usec() - added_begin;
+    REQUIRE(added.count(UsdjBodyUpdater::Action::ADD) == added.size());
+    REQUIRE(!added.empty());
+    auto const body = added.begin()->second.body;
+    std::uint64_t revised_usecs = 0;
+    std::uint64_t pruned_usecs = 0;
+    for (int round = 0; round != ROUNDS; ++round) {
+        UsdjEdits edits{"/data/scene", {}};
+        edits.edits.push_back(UsdjEdit{UsdjObjectKey{body->get_object_id()},
+                                       Color::from_hsv(static_cast<float>(round) / ROUNDS, 1.0f, 1.0f), std::nullopt,
+                                       std::nullopt, std::nullopt});
+        REQUIRE(UsdjEditor{p_document}(edits) == 1);
+        // Every body is visited and revised without the scene of the
+        // previous revision to compare with.
+        std::optional<Scene> no_scene{};
+        auto const revised_begin = OS::get_singleton()->get_ticks_usec();
+        auto const revised = UsdjBodyUpdater{bodies}(p_document, path, no_scene);
+        revised_usecs += OS::get_singleton()->get_ticks_usec() - revised_begin;
+        CHECK(revised.count(UsdjBodyUpdater::Action::REVISE) == added.size());
+        auto const pruned_begin = OS::get_singleton()->get_ticks_usec();
+        auto const pruned = UsdjBodyUpdater{bodies}(p_document, path, scene);
+        pruned_usecs += OS::get_singleton()->get_ticks_usec() - pruned_begin;
+        CHECK(pruned.count(UsdjBodyUpdater::Action::REVISE) == 1);
+        CHECK(pruned.count(UsdjBodyUpdater::Action::ADD) == 0);
+        CHECK(pruned.count(UsdjBodyUpdater::Action::REMOVE) == 0);
+        CHECK(bodies.size() == added.size());
+        // Keep the calls deferred by the bodies from piling up.
+        MessageQueue::get_singleton()->flush();
+    }
+    auto const count = static_cast<int64_t>(added.size());
+    auto const added_text = vformat("Adding %d bodies of %s: %d us", count, p_name, added_usecs);
+    MESSAGE(added_text.utf8().get_data());
+    auto const revised_text =
+        vformat("Revising all %d bodies of %s: %d us per update", count, p_name, revised_usecs / ROUNDS);
+    MESSAGE(revised_text.utf8().get_data());
+    auto const pruned_text =
+        vformat("Comparing scenes of %d bodies of %s: %d us per update", count, p_name, pruned_usecs / ROUNDS);
+    MESSAGE(pruned_text.utf8().get_data());
+    for (auto const& item : added)
+        memdelete(item.second.body);
+}
+
+TEST_CASE("[Modules][RealityMerge][SceneTree][Benchmark] Updating bodies after recoloring one" * doctest::skip()) {
+    for (char const* const stem : {"a-cube", "cube-island", "foolish-ape-51"}) {
+        auto document = Document::load(get_document_path(stem));
+        measure_updates(document, stem);
+    }
+}
+
+// Each prim's body is looked up by its key so the time per update should
+// grow linearly with the count of prims.
+TEST_CASE("[Modules][RealityMerge][SceneTree][Benchmark] Updating bodies of generated prims" * doctest::skip()) {
+    for (std::size_t const count : {10, 100, 1000, 10000, 50000}) {
+        auto document = make_scene(count);
+        auto const name = std::to_string(count) + " generated prims";
+        measure_updates(document, name.c_str());
+    }
+}
+
+}  // namespace TestUsdjBodyUpdater
+
+#endif  // REALITY_MERGE_TESTS_TEST_USDJ_BODY_UPDATER_H
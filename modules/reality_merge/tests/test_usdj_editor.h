@@ -0,0 +1,129 @@
+/**************************************************************************/
+/* test_usdj_editor.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef REALITY_MERGE_TESTS_TEST_USDJ_EDITOR_H
+#define REALITY_MERGE_TESTS_TEST_USDJ_EDITOR_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <variant>
+
+// third-party
+extern "C" {
+
+#include <automerge-c/automerge.h>
+}
+#include <cavi/usdj_am/declaration.hpp>
+#include <cavi/usdj_am/definition.hpp>
+#include <cavi/usdj_am/definition_statement.hpp>
+#include <cavi/usdj_am/file.hpp>
+#include <cavi/usdj_am/statement.hpp>
+#include <cavi/usdj_am/utils/document.hpp>
+#include <cavi/usdj_am/utils/scene.hpp>
+#include <cavi/usdj_am/utils/xform_program.hpp>
+
+// regional
+#include <core/math/basis.h>
+#include <core/math/math_defs.h>
+#include <core/math/transform_3d.h>
+#include <core/math/vector3.h>
+#include <tests/test_macros.h>
+
+// local
+#include "../usdj_editor.h"
+#include "test_usdj_body_updater.h"
+
+namespace TestUsdjEditor {
+
+using Document = cavi::usdj_am::utils::Document;
+using ResultPtr = Document::ResultPtr;
+
+TEST_CASE("[Modules][RealityMerge] Writing a transform into a stack with a pivot") {
+    using cavi::usdj_am::Declaration;
+    using cavi::usdj_am::Definition;
+    using cavi::usdj_am::File;
+    using cavi::usdj_am::Statement;
+    using cavi::usdj_am::utils::Scene;
+    using cavi::usdj_am::utils::XformProgram;
+
+    auto document = Document::load(TestUsdjBodyUpdater::get_document_path("a-cube"));
+    std::string const path{"/data/scene"};
+    // Rotate the cube about a pivot, which can't be rewritten as a
+    // translate-rotate-scale.
+    std::optional<UsdjObjectKey> cube_key{};
+    for (auto const& statement : File{document, document.get_item(path)}.get_statements()) {
+        for (auto const& world_statement : std::get<Definition>(statement).get_statements()) {
+            auto const& cube = std::get<Definition>(std::get<Statement>(world_statement));
+            cube_key.emplace(cube.get_object_id());
+            for (auto const& cube_statement : cube.get_statements()) {
+                auto const declaration = std::get_if<Declaration>(&cube_statement);
+                if (!declaration || declaration->get_reference() != "xformOpOrder")
+                    continue;
+                ResultPtr const list_result{
+                    AMmapPutObject(document, declaration->get_object_id(), AMstr("value"), AM_OBJ_TYPE_LIST),
+                    AMresultFree};
+                auto const list = AMitemObjId(AMresultItem(list_result.get()));
+                for (char const* const token :
+                     {"xformOp:translate", "xformOp:rotateXYZ", "!invert!xformOp:translate"})
+                    ResultPtr{AMlistPutStr(document, list, SIZE_MAX, true, AMstr(token)), AMresultFree};
+            }
+        }
+    }
+    REQUIRE(cube_key);
+    Transform3D const transform{Basis{Vector3{0.0, 1.0, 0.0}, Math_PI / 2.0}, Vector3{1.0, 2.0, 3.0}};
+    Vector3 const velocity{4.0, 5.0, 6.0};
+    UsdjEdits edits{path, {}};
+    edits.edits.push_back(UsdjEdit{*cube_key, std::nullopt, transform, velocity, std::nullopt});
+    REQUIRE(UsdjEditor{document}(edits) == 1);
+    // The authored operations are replaced by one matrix instead of the edit
+    // being discarded.
+    Scene const scene{File{document, document.get_item(path)}};
+    XformProgram program{scene};
+    REQUIRE(program.get_prim_count() == 2);
+    CHECK(program.get_op_count(1) == 1);
+    program.evaluate_locals();
+    double matrix[XformProgram::MATRIX_SIZE];
+    program.get_local_matrix(1, matrix);
+    for (int row = 0; row != 3; ++row) {
+        for (int column = 0; column != 3; ++column)
+            CHECK(matrix[row * 4 + column] == doctest::Approx(transform.basis.rows[row][column]));
+        CHECK(matrix[row * 4 + 3] == doctest::Approx(transform.origin[row]));
+    }
+    auto const velocity_attribute = scene.find_attribute(1, "physics:velocity");
+    REQUIRE(velocity_attribute != Scene::NONE);
+    auto const values = scene.get_attribute_values(velocity_attribute);
+    REQUIRE(values.count == 3);
+    for (int axis = 0; axis != 3; ++axis)
+        CHECK(scene.get_numbers()[values.first + axis] == doctest::Approx(velocity[axis]));
+}
+
+}  // namespace TestUsdjEditor
+
+#endif  // REALITY_MERGE_TESTS_TEST_USDJ_EDITOR_H
@@ -0,0 +1,111 @@
+/**************************************************************************/
+/* test_usdj_material_cache.h                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef REALITY_MERGE_TESTS_TEST_USDJ_MATERIAL_CACHE_H
+#define REALITY_MERGE_TESTS_TEST_USDJ_MATERIAL_CACHE_H
+
+#include <utility>
+
+// regional
+#include <core/math/color.h>
+#include <core/object/object.h>
+#include <core/object/object_id.h>
+#include <core/object/ref_counted.h>
+#include <core/os/memory.h>
+#include <core/variant/array.h>
+#include <scene/3d/mesh_instance_3d.h>
+#include <scene/resources/mesh.h>
+#include <scene/resources/primitive_meshes.h>
+#include <tests/test_macros.h>
+
+// local
+#include "../usdj_material_cache.h"
+#include "../usdj_static_body_3d.h"
+
+namespace TestUsdjMaterialCache {
+
+/// \brief Makes a body drawn by a mesh with two surfaces.
+///
+/// \returns The body and the mesh's `MeshInstance3D` node.
+static std::pair<UsdjStaticBody3D*, MeshInstance3D*> make_body() {
+    Ref<BoxMesh> box_mesh{};
+    box_mesh.instantiate();
+    Array const arrays = box_mesh->get_mesh_arrays();
+    Ref<ArrayMesh> array_mesh{};
+    array_mesh.instantiate();
+    array_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
+    array_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
+    auto const body = memnew(UsdjStaticBody3D);
+    auto const mesh_instance_3d = memnew(MeshInstance3D);
+    mesh_instance_3d->set_mesh(array_mesh);
+    body->add_child(mesh_instance_3d);
+    return std::make_pair(body, mesh_instance_3d);
+}
+
+TEST_CASE("[Modules][RealityMerge][SceneTree] Sharing materials between bodies") {
+    // The cache is shared by all bodies so the colors mustn't be used by any
+    // other test.
+    Color const first_color{0.125f, 0.25f, 0.5f};
+    Color const second_color{0.5f, 0.25f, 0.125f};
+    UsdjMaterialCache::Key const first_key{first_color};
+    UsdjMaterialCache::Key const second_key{second_color};
+    REQUIRE(UsdjMaterialCache::get_use_count(first_key) == 0);
+    REQUIRE(UsdjMaterialCache::get_use_count(second_key) == 0);
+    auto const first = make_body();
+    auto const second = make_body();
+    REQUIRE(first.second->get_surface_override_material_count() == 2);
+    // Bodies with equal colors share one material for all of their surfaces.
+    first.first->set_display_color(first_color);
+    second.first->set_display_color(first_color);
+    CHECK(UsdjMaterialCache::get_use_count(first_key) == 2);
+    auto const material_id = first.second->get_surface_override_material(0)->get_instance_id();
+    for (auto const mesh_instance_3d : {first.second, second.second}) {
+        for (int surface = 0; surface != 2; ++surface)
+            CHECK(mesh_instance_3d->get_surface_override_material(surface)->get_instance_id() == material_id);
+    }
+    // A body whose color changes moves to another entry.
+    second.first->set_display_color(second_color);
+    CHECK(UsdjMaterialCache::get_use_count(first_key) == 1);
+    CHECK(UsdjMaterialCache::get_use_count(second_key) == 1);
+    CHECK(second.second->get_surface_override_material(0)->get_instance_id() != material_id);
+    CHECK(second.second->get_surface_override_material(1)->get_instance_id() != material_id);
+    CHECK(first.second->get_surface_override_material(0)->get_instance_id() == material_id);
+    // An entry is released along with the material once its last user is
+    // freed.
+    memdelete(first.first);
+    CHECK(UsdjMaterialCache::get_use_count(first_key) == 0);
+    CHECK(ObjectDB::get_instance(material_id) == nullptr);
+    CHECK(UsdjMaterialCache::get_use_count(second_key) == 1);
+    memdelete(second.first);
+    CHECK(UsdjMaterialCache::get_use_count(second_key) == 0);
+}
+
+}  // namespace TestUsdjMaterialCache
+
+#endif  // REALITY_MERGE_TESTS_TEST_USDJ_MATERIAL_CACHE_H
@@ -0,0 +1,157 @@
+/**************************************************************************/
+/* test_usdj_packet.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef REALITY_MERGE_TESTS_TEST_USDJ_PACKET_H
+#define REALITY_MERGE_TESTS_TEST_USDJ_PACKET_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// regional
+#include <core/io/json.h>
+#include <core/os/os.h>
+#include <core/string/ustring.h>
+#include <tests/test_macros.h>
+
+// local
+#include "../usdj_packet.h"
+
+namespace TestUsdjPacket {
+
+/// \brief Makes a binary frame shaped like an encoded sync message.
+static std::vector<std::uint8_t> make_sync_frame(std::size_t const size) {
+    std::vector<std::uint8_t> frame(size + 1);
+    frame[0] = 0;
+    // Change chunks are mostly compressed columns, i.e. arbitrary bytes.
+    std::uint32_t state = 0x9E3779B9u;
+    for (std::size_t pos = 1; pos != frame.size(); ++pos) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        frame[pos] = static_cast<std::uint8_t>(state);
+    }
+    return frame;
+}
+
+TEST_CASE("[Modules][RealityMerge] Packet classification") {
+    SUBCASE("Binary sync frame") {
+        auto const frame = make_sync_frame(16);
+        auto const packet = classify_packet(frame.data(), frame.size(), false);
+        CHECK(packet.type == UsdjPacketType::SYNC);
+        CHECK(packet.payload == frame.data() + 1);
+        CHECK(packet.size == frame.size() - 1);
+    }
+    SUBCASE("Tagged sync frame") {
+        auto const message = make_sync_frame(16);
+        auto const frame = frame_sync_message("foolish-ape-51", message.data(), message.size());
+        auto const packet = classify_packet(frame.data(), frame.size(), false);
+        CHECK(packet.type == UsdjPacketType::TAGGED_SYNC);
+        CHECK(packet.channel == "foolish-ape-51");
+        CHECK(packet.size == message.size());
+        CHECK(std::equal(message.begin(), message.end(), packet.payload));
+        auto const untagged = frame_sync_message({}, message.data() + 1, message.size() - 1);
+        CHECK(untagged == message);
+        CHECK(frame_sync_message(std::string(256, 'a'), message.data(), message.size()).empty());
+    }
+    SUBCASE("Truncated tagged sync frames") {
+        std::uint8_t const frame[] = {0x01, 0x04, 'a', 'b'};
+        CHECK(classify_packet(frame, sizeof(frame), false).type == UsdjPacketType::UNKNOWN);
+        CHECK(classify_packet(frame, 1, false).type == UsdjPacketType::UNKNOWN);
+        std::uint8_t const untagged[] = {0x01, 0x00, 0x00};
+        CHECK(classify_packet(untagged, sizeof(untagged), false).type == UsdjPacketType::UNKNOWN);
+    }
+    SUBCASE("Text control frame") {
+        std::uint8_t const frame[] = R"({"pong":"pong"})";
+        auto const packet = classify_packet(frame, sizeof(frame) - 1, true);
+        CHECK(packet.type == UsdjPacketType::CONTROL);
+        CHECK(packet.payload == frame);
+        CHECK(packet.size == sizeof(frame) - 1);
+    }
+    SUBCASE("Binary control frame") {
+        std::uint8_t const frame[] = R"({"pong":"pong"})";
+        CHECK(classify_packet(frame, sizeof(frame) - 1, false).type == UsdjPacketType::CONTROL);
+    }
+    SUBCASE("Unknown frames") {
+        std::uint8_t const frame[] = {0x7F, 0x00};
+        CHECK(classify_packet(frame, sizeof(frame), false).type == UsdjPacketType::UNKNOWN);
+        CHECK(classify_packet(frame, 0, false).type == UsdjPacketType::UNKNOWN);
+        CHECK(classify_packet(nullptr, 0, true).type == UsdjPacketType::UNKNOWN);
+    }
+}
+
+// The timings depend on the machine's load so they're only reported and the
+// benchmark only runs when skipped tests are requested with "--no-skip".
+TEST_CASE("[Modules][RealityMerge][Benchmark] Packet classification of an initial sync" * doctest::skip()) {
+    // An initial sync of a scene like "foolish-ape-51" arrives as one large
+    // message carrying the document's changes followed by smaller ones.
+    std::vector<std::vector<std::uint8_t>> frames{};
+    frames.push_back(make_sync_frame(256 * 1024));
+    for (int count = 0; count != 64; ++count)
+        frames.push_back(make_sync_frame(4 * 1024));
+    int const ROUNDS = 20;
+    std::size_t const packet_count = ROUNDS * frames.size();
+
+    Ref<JSON> json_parser;
+    json_parser.instantiate();
+    std::size_t legacy_sync_count = 0;
+    auto const legacy_begin = OS::get_singleton()->get_ticks_usec();
+    for (int round = 0; round != ROUNDS; ++round) {
+        for (auto const& frame : frames) {
+            // Every packet used to be converted into a string and parsed as
+            // JSON before being treated as a sync message.
+            String const json_string{reinterpret_cast<char const*>(frame.data()), static_cast<int>(frame.size())};
+            if (json_parser->parse(json_string) != OK)
+                ++legacy_sync_count;
+        }
+    }
+    auto const legacy_usecs = OS::get_singleton()->get_ticks_usec() - legacy_begin;
+
+    std::size_t framed_sync_count = 0;
+    auto const framed_begin = OS::get_singleton()->get_ticks_usec();
+    for (int round = 0; round != ROUNDS; ++round) {
+        for (auto const& frame : frames) {
+            if (classify_packet(frame.data(), frame.size(), false).type == UsdjPacketType::SYNC)
+                ++framed_sync_count;
+        }
+    }
+    auto const framed_usecs = OS::get_singleton()->get_ticks_usec() - framed_begin;
+
+    CHECK(legacy_sync_count == packet_count);
+    CHECK(framed_sync_count == packet_count);
+    auto const legacy_text = vformat("JSON-first: %f us per packet", static_cast<double>(legacy_usecs) / packet_count);
+    MESSAGE(legacy_text.utf8().get_data());
+    auto const framed_text = vformat("Classified: %f us per packet", static_cast<double>(framed_usecs) / packet_count);
+    MESSAGE(framed_text.utf8().get_data());
+}
+
+}  // namespace TestUsdjPacket
+
+#endif  // REALITY_MERGE_TESTS_TEST_USDJ_PACKET_H
@@ -72,12 +72,15 @@ public:
 
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param list_object[in] A pointer to a borrowed Automerge list object.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
     /// \pre \p list_object `!= nullptr`
     /// \pre `AMitemValType(` \p list_object `) == AM_VAL_TYPE_OBJ_TYPE`
     /// \pre `AMobjObjType(` \p document `, AMitemObjId(` \p list_object `)) == AM_OBJ_TYPE_LIST`
     /// \throws std::invalid_argument
-    ArrayInputIterator(AMdoc const* const document, AMitem const* const list_object);
+    ArrayInputIterator(AMdoc const* const document,
+                       AMitem const* const list_object,
+                       AMitems const* const heads = nullptr);
 
     ArrayInputIterator(ArrayInputIterator const&) = default;
 
@@ -95,6 +98,7 @@ private:
     enum Result { BEGIN__, ITEMS = BEGIN__, OBJ_ID, END__, SIZE__ = END__ - BEGIN__ };
 
     AMdoc const* const m_document;
+    AMitems const* const m_heads;
     std::optional<AMitems> m_items;
     std::array<ResultPtr, SIZE__> m_results;
 
@@ -52,11 +52,12 @@ public:
 
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param list_object[in] A pointer to a borrowed Automerge list object.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
     /// \pre \p list_object `!= nullptr`
     /// \pre `AMitemValType(` \p list_object `) == AM_VAL_TYPE_OBJ_TYPE`
     /// \pre `AMobjObjType(` \p document `, AMitemObjId(` \p list_object `)) == AM_OBJ_TYPE_LIST`
-    ArrayInputRange(AMdoc const* const document, AMitem const* const list_object);
+    ArrayInputRange(AMdoc const* const document, AMitem const* const list_object, AMitems const* const heads = nullptr);
 
     ArrayInputRange(ArrayInputRange const&) = default;
 
@@ -71,10 +72,13 @@ public:
 
     AMdoc const* get_document() const;
 
+    AMitems const* get_heads() const;
+
     AMobjId const* get_object_id() const;
 
 private:
     AMdoc const* const m_document;
+    AMitems const* const m_heads;
     typename ArrayInputIterator<T>::ResultPtr m_result;
 };
 
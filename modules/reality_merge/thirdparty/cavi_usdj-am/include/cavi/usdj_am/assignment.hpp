@@ -33,6 +33,7 @@
 #include <cstdint>
 #include <iosfwd>
 #include <optional>
+#include <string_view>
 
 // local
 #include "assignment_keyword.hpp"
@@ -75,13 +76,14 @@ class Assignment : public Node {
 public:
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param map_object[in] A pointer to a borrowed Automerge map object.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
     /// \pre \p map_object `!= nullptr`
     /// \pre `AMitemValType(` \p map_object `) == AM_VAL_TYPE_OBJ_TYPE`
     /// \pre `AMobjObjType(` \p document `, AMitemObjId(` \p map_object `)) == AM_OBJ_TYPE_MAP`
     /// \pre `AMobjSize(` \p document `, AMitemObjId(` \p map_object `)) == 4`
     /// \throws std::invalid_argument
-    Assignment(AMdoc const* const document, AMitem const* const map_object);
+    Assignment(AMdoc const* const document, AMitem const* const map_object, AMitems const* const heads = nullptr);
 
     Assignment(Assignment const&) = delete;
 
@@ -119,12 +121,24 @@ private:
     Assignment() = default;
 
     friend class ArrayInputIterator<Assignment>;
+
+    static constexpr Key IDENTIFIER{1, "identifier"};
+    static constexpr Key KEYWORD{2, "keyword"};
+    static constexpr Key TYPE{3, "type"};
+    static constexpr Key VALUE{4, "value"};
 };
 
 constexpr AssignmentType Assignment::get_type() const {
     return AssignmentType::ASSIGNMENT;
 }
 
+/// \brief Extracts a `AssignmentType` enum tag from a string view.
+///
+/// \param[in] view A UTF-8 string view.
+/// \returns The `AssignmentType` enum tag whose serialized form is \p view
+///          or `std::nullopt`.
+std::optional<AssignmentType> extract_AssignmentType(std::string_view const& view);
+
 std::istream& operator>>(std::istream& is, AssignmentType& out);
 
 std::ostream& operator<<(std::ostream& os, AssignmentType const& in);
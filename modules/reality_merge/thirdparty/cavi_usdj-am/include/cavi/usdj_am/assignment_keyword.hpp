@@ -32,6 +32,8 @@
 
 #include <cstdint>
 #include <iosfwd>
+#include <optional>
+#include <string_view>
 
 // export enum USDA_AssignmentKeyword {
 //     /**
@@ -75,6 +77,13 @@ enum class AssignmentKeyword : std::uint8_t {
     SIZE__ = END__ - BEGIN__
 };
 
+/// \brief Extracts a `AssignmentKeyword` enum tag from a string view.
+///
+/// \param[in] view A UTF-8 string view.
+/// \returns The `AssignmentKeyword` enum tag whose serialized form is \p view
+///          or `std::nullopt`.
+std::optional<AssignmentKeyword> extract_AssignmentKeyword(std::string_view const& view);
+
 std::istream& operator>>(std::istream& is, AssignmentKeyword& out);
 
 std::ostream& operator<<(std::ostream& os, AssignmentKeyword const& in);
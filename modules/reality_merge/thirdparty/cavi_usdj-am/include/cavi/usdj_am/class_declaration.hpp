@@ -59,12 +59,13 @@ struct ClassDeclaration : public std::variant<std::monostate, Definition, Declar
 
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param map_object[in] A pointer to a borrowed Automerge map object.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
     /// \pre \p map_object `!= nullptr`
     /// \pre `AMitemValType(` \p map_object `) == AM_VAL_TYPE_OBJ_TYPE`
     /// \pre `AMobjObjType(` \p document `, AMitemObjId(` \p map_object `)) == AM_OBJ_TYPE_MAP`
     /// \throws std::invalid_argument
-    ClassDeclaration(AMdoc const* const document, AMitem const* const map_object);
+    ClassDeclaration(AMdoc const* const document, AMitem const* const map_object, AMitems const* const heads = nullptr);
 
     ClassDeclaration(ClassDeclaration const&) = delete;
     ClassDeclaration& operator=(ClassDeclaration const&) = delete;
@@ -62,13 +62,14 @@ public:
 
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param map_object[in] A pointer to a borrowed Automerge map object.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
     /// \pre \p map_object `!= nullptr`
     /// \pre `AMitemValType(` \p map_object `) == AM_VAL_TYPE_OBJ_TYPE`
     /// \pre `AMobjObjType(` \p document `, AMitemObjId(` \p map_object `)) == AM_OBJ_TYPE_MAP`
     /// \pre `AMobjSize(` \p document `, AMitemObjId(` \p map_object `)) == 5`
     /// \throws std::invalid_argument
-    ClassDefinition(AMdoc const* const document, AMitem const* const map_object);
+    ClassDefinition(AMdoc const* const document, AMitem const* const map_object, AMitems const* const heads = nullptr);
 
     ClassDefinition(ClassDefinition const&) = delete;
 
@@ -113,6 +114,12 @@ public:
 
 private:
     ClassDefinition() = default;
+
+    static constexpr Key CLASS_DECLARATIONS{1, "classDeclarations"};
+    static constexpr Key DESCRIPTOR{2, "descriptor"};
+    static constexpr Key ID{3, "id"};
+    static constexpr Key NAME{4, "name"};
+    static constexpr Key TYPE{5, "type"};
 };
 
 constexpr StatementType ClassDefinition::get_type() const {
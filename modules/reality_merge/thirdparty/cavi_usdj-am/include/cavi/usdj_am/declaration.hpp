@@ -62,13 +62,14 @@ class Declaration : public Node {
 public:
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param map_object[in] A pointer to a borrowed Automerge map object.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
     /// \pre \p map_object `!= nullptr`
     /// \pre `AMitemValType(` \p map_object `) == AM_VAL_TYPE_OBJ_TYPE`
     /// \pre `AMobjObjType(` \p document `, AMitemObjId(` \p map_object `)) == AM_OBJ_TYPE_MAP`
     /// \pre `AMobjSize(` \p document `, AMitemObjId(` \p map_object `)) == 6`
     /// \throws std::invalid_argument
-    Declaration(AMdoc const* const document, AMitem const* const map_object);
+    Declaration(AMdoc const* const document, AMitem const* const map_object, AMitems const* const heads = nullptr);
 
     Declaration(Declaration const&) = delete;
 
@@ -118,6 +119,13 @@ public:
 
 private:
     Declaration();
+
+    static constexpr Key DEFINE_TYPE{1, "defineType"};
+    static constexpr Key DESCRIPTOR{2, "descriptor"};
+    static constexpr Key KEYWORD{3, "keyword"};
+    static constexpr Key REFERENCE{4, "reference"};
+    static constexpr Key TYPE{5, "type"};
+    static constexpr Key VALUE{6, "value"};
 };
 
 constexpr StatementType Declaration::get_type() const {
@@ -66,13 +66,14 @@ public:
 
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param map_object[in] A pointer to a borrowed Automerge map object.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
     /// \pre \p map_object `!= nullptr`
     /// \pre `AMitemValType(` \p map_object `) == AM_VAL_TYPE_OBJ_TYPE`
     /// \pre `AMobjObjType(` \p document `, AMitemObjId(` \p map_object `)) == AM_OBJ_TYPE_MAP`
     /// \pre `AMobjSize(` \p document `, AMitemObjId(` \p map_object `)) == 6`
     /// \throws std::invalid_argument
-    Definition(AMdoc const* const document, AMitem const* const map_object);
+    Definition(AMdoc const* const document, AMitem const* const map_object, AMitems const* const heads = nullptr);
 
     Definition(Definition const&) = delete;
 
@@ -124,6 +125,13 @@ private:
     Definition();
 
     friend class ArrayInputIterator<Definition>;
+
+    static constexpr Key DEF_TYPE{1, "defType"};
+    static constexpr Key DESCRIPTOR{2, "descriptor"};
+    static constexpr Key NAME{3, "name"};
+    static constexpr Key STATEMENTS{4, "statements"};
+    static constexpr Key SUB_TYPE{5, "subType"};
+    static constexpr Key TYPE{6, "type"};
 };
 
 constexpr StatementType Definition::get_type() const {
@@ -59,12 +59,15 @@ struct DefinitionStatement : public std::variant<std::monostate, Statement, Decl
 
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param map_object[in] A pointer to a borrowed Automerge map object.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
     /// \pre \p map_object `!= nullptr`
     /// \pre `AMitemValType(` \p map_object `) == AM_VAL_TYPE_OBJ_TYPE`
     /// \pre `AMobjObjType(` \p document `, AMitemObjId(` \p map_object `)) == AM_OBJ_TYPE_MAP`
     /// \throws std::invalid_argument
-    DefinitionStatement(AMdoc const* const document, AMitem const* const map_object);
+    DefinitionStatement(AMdoc const* const document,
+                        AMitem const* const map_object,
+                        AMitems const* const heads = nullptr);
 
     DefinitionStatement(DefinitionStatement const&) = delete;
     DefinitionStatement& operator=(DefinitionStatement const&) = delete;
@@ -66,11 +66,12 @@ public:
 
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param map_object[in] A pointer to a borrowed Automerge object object.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
     /// \pre \p map_object `!= nullptr`
     /// \pre `AMobjObjType(` \p document `,` \p map_object `) == AM_OBJ_TYPE_MAP`
     /// \pre `AMobjSize(` \p document `,` \p map_object `) == 2`
-    Descriptor(AMdoc const* const document, AMitem const* const map_object);
+    Descriptor(AMdoc const* const document, AMitem const* const map_object, AMitems const* const heads = nullptr);
 
     /// \brief Accepts a visitor that can only read this node.
     ///
@@ -87,6 +88,10 @@ public:
 
     /// \brief Gets the `.description` property.
     std::optional<String> get_description() const;
+
+private:
+    static constexpr Key ASSIGNMENTS{1, "assignments"};
+    static constexpr Key DESCRIPTION{2, "description"};
 };
 
 }  // namespace usdj_am
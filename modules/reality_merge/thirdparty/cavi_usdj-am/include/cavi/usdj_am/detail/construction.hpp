@@ -0,0 +1,146 @@
+/**************************************************************************/
+/* detail/construction.hpp                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef CAVI_USDJ_AM_DETAIL_CONSTRUCTION_HPP
+#define CAVI_USDJ_AM_DETAIL_CONSTRUCTION_HPP
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace cavi {
+namespace usdj_am {
+namespace detail {
+
+/// \brief Whether a node validates the shape of the Automerge object that
+///        it's constructed from and describes any violation in detail.
+///
+/// \note Defining `CAVI_USDJ_AM_TRUSTED_CONSTRUCTION` (see the
+///       `TRUSTED_CONSTRUCTION` CMake option) skips the checks that require a
+///       round-trip to the document and reduces every exception's message to
+///       the name of the throwing function.
+#if defined(CAVI_USDJ_AM_TRUSTED_CONSTRUCTION)
+inline constexpr bool CHECKED_CONSTRUCTION = false;
+#else
+inline constexpr bool CHECKED_CONSTRUCTION = true;
+#endif
+
+/// \brief Accumulates a description of the invalid arguments given to a
+///        function.
+///
+/// \tparam Checked Whether the description is recorded or only its presence.
+template <bool Checked>
+class BasicArguments;
+
+/// \brief A specialization that records the description in a string stream.
+template <>
+class BasicArguments<true> {
+public:
+    BasicArguments() = default;
+
+    BasicArguments(BasicArguments const&) = delete;
+
+    BasicArguments& operator=(BasicArguments const&) = delete;
+
+    template <typename T>
+    BasicArguments& operator<<(T const& value) {
+        m_oss << value;
+        return *this;
+    }
+
+    /// \brief Discards the description recorded so far.
+    void clear() { m_oss.str(""); }
+
+    /// \brief Checks whether no description has been recorded.
+    bool empty() const { return m_oss.str().empty(); }
+
+    /// \brief Throws an exception describing a failed call.
+    ///
+    /// \param[in] type_name The name of the throwing function's type.
+    /// \param[in] function The name of the throwing function.
+    /// \throws std::invalid_argument
+    [[noreturn]] void raise(char const* const type_name, char const* const function) const {
+        std::ostringstream what;
+        what << type_name << "::" << function << "(" << m_oss.str() << ")";
+        throw std::invalid_argument(what.str());
+    }
+
+    /// \brief Gets the description recorded so far.
+    std::string str() const { return m_oss.str(); }
+
+private:
+    std::ostringstream m_oss;
+};
+
+/// \brief A specialization that only records whether there is a description.
+template <>
+class BasicArguments<false> {
+public:
+    BasicArguments() = default;
+
+    BasicArguments(BasicArguments const&) = delete;
+
+    BasicArguments& operator=(BasicArguments const&) = delete;
+
+    template <typename T>
+    BasicArguments& operator<<(T const&) {
+        m_empty = false;
+        return *this;
+    }
+
+    /// \brief Discards the description recorded so far.
+    void clear() { m_empty = true; }
+
+    /// \brief Checks whether no description has been recorded.
+    bool empty() const { return m_empty; }
+
+    /// \brief Throws an exception naming a failed call.
+    ///
+    /// \param[in] type_name Ignored.
+    /// \param[in] function The name of the throwing function.
+    /// \throws std::invalid_argument
+    [[noreturn]] void raise(char const* const, char const* const function) const {
+        throw std::invalid_argument(function);
+    }
+
+    /// \brief Gets an empty description.
+    std::string str() const { return {}; }
+
+private:
+    bool m_empty = true;
+};
+
+/// \brief The description accumulator selected by the construction policy.
+using Arguments = BasicArguments<CHECKED_CONSTRUCTION>;
+
+}  // namespace detail
+}  // namespace usdj_am
+}  // namespace cavi
+
+#endif  // CAVI_USDJ_AM_DETAIL_CONSTRUCTION_HPP
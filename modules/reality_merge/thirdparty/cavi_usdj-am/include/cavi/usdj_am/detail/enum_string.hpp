@@ -30,13 +30,17 @@
 #ifndef CAVI_USDJ_AM_DETAIL_ENUM_STRING_HPP
 #define CAVI_USDJ_AM_DETAIL_ENUM_STRING_HPP
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <functional>
 #include <istream>
-#include <map>
 #include <optional>
 #include <set>
+#include <stdexcept>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -47,19 +51,144 @@ namespace cavi {
 namespace usdj_am {
 namespace detail {
 
+/// \brief An enum tag paired with its UTF-8 string view.
+///
+/// \tparam EnumT The type of enum tag.
+template <class EnumT>
+struct EnumTag {
+    std::string_view string;
+    EnumT tag;
+};
+
+/// \brief An immutable table of the UTF-8 string views of enum tags that's
+///        sorted at compile time so that a lookup selects the views of the
+///        same length and then compares only their bytes.
+///
+/// \tparam EnumT The type of enum tag.
+/// \tparam N The count of enum tags.
+template <class EnumT, std::size_t N>
+class EnumTable {
+public:
+    /// \brief The length of the longest UTF-8 string view that can be looked up.
+    static constexpr std::size_t MAX_LENGTH = 63;
+
+    EnumTable() = delete;
+
+    /// \param[in] tags An array of \p EnumT tags paired with unique UTF-8
+    ///                 string views no longer than `MAX_LENGTH`.
+    /// \throws std::invalid_argument
+    constexpr explicit EnumTable(EnumTag<EnumT> const (&tags)[N]);
+
+    /// \brief Find the enum tag corresponding to a given UTF-8 string view.
+    ///
+    /// \param[in] view A UTF-8 string view.
+    /// \returns The \p EnumT tag corresponding to \p view or `std::nullopt`.
+    std::optional<EnumT> find(std::string_view const& view) const;
+
+    /// \brief Find the UTF-8 string view corresponding to a given enum tag.
+    ///
+    /// \param[in] tag A \p EnumT tag.
+    /// \returns The UTF-8 string view corresponding to \p tag or `std::nullopt`.
+    std::optional<std::string_view> find(EnumT const tag) const;
+
+private:
+    using Underlying = std::underlying_type_t<EnumT>;
+
+    /// \brief Tags ordered by the length and then the bytes of their views.
+    std::array<EnumTag<EnumT>, N> m_by_string;
+    /// \brief Tags ordered by their underlying values.
+    std::array<EnumTag<EnumT>, N> m_by_tag;
+    /// \brief The position in `m_by_string` of the first view of each length.
+    std::array<std::size_t, MAX_LENGTH + 2> m_offsets;
+};
+
+template <class EnumT, std::size_t N>
+constexpr EnumTable<EnumT, N>::EnumTable(EnumTag<EnumT> const (&tags)[N]) : m_by_string{}, m_by_tag{}, m_offsets{} {
+    // The algorithms in <algorithm> aren't constexpr until C++20.
+    for (std::size_t pos = 0; pos != N; ++pos) {
+        if (tags[pos].string.size() > MAX_LENGTH) {
+            throw std::invalid_argument("EnumTable(tags): tags[pos].string.size() > MAX_LENGTH");
+        }
+        auto by_string = pos;
+        for (; by_string != 0; --by_string) {
+            auto const& prev = m_by_string[by_string - 1];
+            if (prev.string.size() < tags[pos].string.size() ||
+                (prev.string.size() == tags[pos].string.size() && prev.string.compare(tags[pos].string) < 0)) {
+                break;
+            } else if (prev.string == tags[pos].string) {
+                throw std::invalid_argument("EnumTable(tags): tags[pos].string isn't unique");
+            }
+            m_by_string[by_string] = prev;
+        }
+        m_by_string[by_string] = tags[pos];
+        auto by_tag = pos;
+        for (; by_tag != 0; --by_tag) {
+            auto const& prev = m_by_tag[by_tag - 1];
+            if (static_cast<Underlying>(prev.tag) < static_cast<Underlying>(tags[pos].tag)) {
+                break;
+            }
+            m_by_tag[by_tag] = prev;
+        }
+        m_by_tag[by_tag] = tags[pos];
+    }
+    std::size_t pos = 0;
+    for (std::size_t length = 0; length != m_offsets.size(); ++length) {
+        while (pos != N && m_by_string[pos].string.size() < length) {
+            ++pos;
+        }
+        m_offsets[length] = pos;
+    }
+}
+
+template <class EnumT, std::size_t N>
+std::optional<EnumT> EnumTable<EnumT, N>::find(std::string_view const& view) const {
+    auto const length = view.size();
+    if (length <= MAX_LENGTH) {
+        auto const first = m_by_string.begin() + m_offsets[length];
+        auto const last = m_by_string.begin() + m_offsets[length + 1];
+        // All of the views within [first, last) are as long as the given one.
+        auto const match = std::lower_bound(first, last, view, [length](auto const& lhs, auto const& rhs) {
+            return std::char_traits<char>::compare(lhs.string.data(), rhs.data(), length) < 0;
+        });
+        if (match != last && std::char_traits<char>::compare(match->string.data(), view.data(), length) == 0) {
+            return match->tag;
+        }
+    }
+    return std::nullopt;
+}
+
+template <class EnumT, std::size_t N>
+std::optional<std::string_view> EnumTable<EnumT, N>::find(EnumT const tag) const {
+    auto const match = std::lower_bound(m_by_tag.begin(), m_by_tag.end(), tag, [](auto const& lhs, auto const rhs) {
+        return static_cast<Underlying>(lhs.tag) < static_cast<Underlying>(rhs);
+    });
+    if (match != m_by_tag.end() && match->tag == tag) {
+        return match->string;
+    }
+    return std::nullopt;
+}
+
+/// \brief Makes an `EnumTable` at compile time.
+///
+/// \tparam EnumT The type of enum tag.
+/// \tparam N The count of enum tags.
+/// \param[in] tags An array of \p EnumT tags paired with unique UTF-8 string
+///                 views.
+/// \returns An `EnumTable` of \p tags.
+template <class EnumT, std::size_t N>
+constexpr EnumTable<EnumT, N> make_enum_table(EnumTag<EnumT> const (&tags)[N]) {
+    return EnumTable<EnumT, N>{tags};
+}
+
 /// \brief Find the enum tag corresponding to a given UTF-8 string view.
 ///
 /// \tparam EnumT The type of enum value to return.
-/// \param[in] tags A map from UTF-8 string views to \p EnumT tags.
+/// \param[in] tags A table of UTF-8 string views and \p EnumT tags.
 /// \param[in] view A UTF-8 string view.
 /// \returns The \p EnumT tag corresponding to \p view or `std::nullopt`.
-template <class EnumT>
-std::optional<EnumT> extract_enum_tag(std::map<std::string_view, EnumT> const& tags, std::string_view const& view) {
-    auto const match = tags.find(view);
-    if (match != tags.end()) {
-        return match->second;
-    }
-    return std::nullopt;
+template <class EnumT, std::size_t N>
+std::optional<EnumT> extract_enum_tag(EnumTable<EnumT, N> const& tags, std::string_view const& view) {
+    return tags.find(view);
 }
 
 /// \brief Extracts a sequence of enum tags corresponding to the UTF-8 string
@@ -67,12 +196,12 @@ std::optional<EnumT> extract_enum_tag(std::map<std::string_view, EnumT> const& t
 ///
 /// \tparam EnumT The type of enum value to append.
 /// \tparam SequenceT The type of sequence container to return.
-/// \param[in] tags A map from UTF-8 string views to \p EnumT tags.
+/// \param[in] tags A table of UTF-8 string views and \p EnumT tags.
 /// \param[in] value A `Value` in which to search for the serialized forms of
 ///                  \p EnumT tags.
 /// \returns A \p SequenceT of \p EnumT values that may be empty.
-template <class EnumT, class SequenceT = std::vector<EnumT>>
-SequenceT extract_enum_tag_sequence(std::map<std::string_view, EnumT> const& tags, Value const& value) {
+template <class EnumT, class SequenceT = std::vector<EnumT>, std::size_t N>
+SequenceT extract_enum_tag_sequence(EnumTable<EnumT, N> const& tags, Value const& value) {
     SequenceT tag_sequence{};
     auto const values_ptr = std::get_if<ValueRange>(&value);
     if (values_ptr) {
@@ -93,12 +222,12 @@ SequenceT extract_enum_tag_sequence(std::map<std::string_view, EnumT> const& tag
 ///
 /// \tparam EnumT The type of enum value to insert.
 /// \tparam SetT The type of set container to return.
-/// \param[in] tags A map from UTF-8 string views to \p EnumT tags.
+/// \param[in] tags A table of UTF-8 string views and \p EnumT tags.
 /// \param[in] value A `Value` in which to search for the serialized forms of
 ///                  \p EnumT tags.
 /// \returns A \p SetT of \p EnumT values that may be empty.
-template <class EnumT, class SetT = std::set<EnumT>>
-SetT extract_enum_tag_set(std::map<std::string_view, EnumT> const& tags, Value const& value) {
+template <class EnumT, class SetT = std::set<EnumT>, std::size_t N>
+SetT extract_enum_tag_set(EnumTable<EnumT, N> const& tags, Value const& value) {
     SetT tag_set;
     auto const values_ptr = std::get_if<ValueRange>(&value);
     if (values_ptr) {
@@ -117,28 +246,21 @@ SetT extract_enum_tag_set(std::map<std::string_view, EnumT> const& tags, Value c
 /// \brief Find the UTF-8 string view corresponding to a given enum tag.
 ///
 /// \tparam EnumT The type of \p tag.
-/// \param[in] tags A map from UTF-8 string views to \p EnumT tags.
+/// \param[in] tags A table of UTF-8 string views and \p EnumT tags.
 /// \param[in] tag A \p EnumT tag.
 /// \returns The UTF-8 string view corresponding to \p tag or `std::nullopt`.
-template <class EnumT>
-std::optional<std::string_view> extract_enum_string(std::map<std::string_view, EnumT> const& tags, EnumT const tag) {
-    for (auto item : tags) {
-        if (item.second == tag) {
-            return item.first;
-        }
-    }
-    return std::nullopt;
+template <class EnumT, std::size_t N>
+std::optional<std::string_view> extract_enum_string(EnumTable<EnumT, N> const& tags, EnumT const tag) {
+    return tags.find(tag);
 }
 
-template <class EnumT>
-std::istream& operator>>(std::istream& is,
-                         std::pair<std::reference_wrapper<std::map<std::string_view, EnumT> const>,
-                                   std::reference_wrapper<EnumT>> const args) {
+template <class EnumT, std::size_t N>
+std::istream& operator>>(std::istream& is, std::pair<EnumTable<EnumT, N> const&, EnumT&> const args) {
     std::string source;
     if (is >> source) {
         auto const result = extract_enum_tag<EnumT>(args.first, source);
         if (result) {
-            args.second.get() = *result;
+            args.second = *result;
             return is;
         }
     }
@@ -59,12 +59,15 @@ public:
 
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param map_object[in] A pointer to a borrowed Automerge map object.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
     /// \pre \p map_object `!= nullptr`
     /// \pre `AMobjObjType(` \p document `, AMitemObjId(` \p map_object `)) == AM_OBJ_TYPE_MAP`
     /// \pre `AMobjSize(` \p document `, AMitemObjId(` \p map_object `)) == 3`
     /// \throws std::invalid_argument
-    ExternalReference(AMdoc const* const document, AMitem const* const map_object);
+    ExternalReference(AMdoc const* const document,
+                      AMitem const* const map_object,
+                      AMitems const* const heads = nullptr);
 
     ExternalReference(ExternalReference const&) = default;
 
@@ -92,6 +95,11 @@ public:
 
     /// \brief Gets the `.type` property.
     constexpr ValueType get_type() const;
+
+private:
+    static constexpr Key REFERENCE_FILE{1, "referenceFile"};
+    static constexpr Key TO_IMPORT{2, "toImport"};
+    static constexpr Key TYPE{3, "type"};
 };
 
 constexpr ValueType ExternalReference::get_type() const {
@@ -57,12 +57,15 @@ public:
 
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param map_object[in] A pointer to a borrowed Automerge map object.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
     /// \pre \p map_object `!= nullptr`
     /// \pre `AMobjObjType(` \p document `, AMitemObjId(` \p map_object `)) == AM_OBJ_TYPE_MAP`
     /// \pre `AMobjSize(` \p document `, AMitemObjId(` \p map_object `)) == 3`
     /// \throws std::invalid_argument
-    ExternalReferenceImport(AMdoc const* const document, AMitem const* const map_object);
+    ExternalReferenceImport(AMdoc const* const document,
+                            AMitem const* const map_object,
+                            AMitems const* const heads = nullptr);
 
     ExternalReferenceImport(ExternalReferenceImport const&) = delete;
 
@@ -88,6 +91,11 @@ public:
 
     /// \brief Gets the `.type` property.
     constexpr ValueType get_type() const;
+
+private:
+    static constexpr Key FIELD{1, "field"};
+    static constexpr Key IMPORT_PATH{2, "importPath"};
+    static constexpr Key TYPE{3, "type"};
 };
 
 constexpr ValueType ExternalReferenceImport::get_type() const {
@@ -63,13 +63,14 @@ public:
 
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param map_object[in] A pointer to a borrowed Automerge map object.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
     /// \pre \p map_object `!= nullptr`
     /// \pre `AMitemValType(` \p map_object `) == AM_VAL_TYPE_OBJ_TYPE`
     /// \pre `AMobjObjType(` \p document `, AMitemObjId(` \p map_object `)) == AM_OBJ_TYPE_MAP`
     /// \pre `AMobjSize(` \p document `, AMitemObjId(` \p map_object `)) == 3`
     /// \throws std::invalid_argument
-    File(AMdoc const* const document, AMitem const* const map_object = nullptr);
+    File(AMdoc const* const document, AMitem const* const map_object = nullptr, AMitems const* const heads = nullptr);
 
     File(File const&) = default;
 
@@ -99,6 +100,11 @@ public:
     ///
     /// \throws std::invalid_argument
     Statements get_statements() const;
+
+private:
+    static constexpr Key DESCRIPTOR{1, "descriptor"};
+    static constexpr Key STATEMENTS{2, "statements"};
+    static constexpr Key VERSION{3, "version"};
 };
 
 }  // namespace usdj_am
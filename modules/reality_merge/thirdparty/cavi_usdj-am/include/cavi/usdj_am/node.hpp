@@ -30,8 +30,9 @@
 #ifndef CAVI_USDJ_AM_NODE_HPP
 #define CAVI_USDJ_AM_NODE_HPP
 
+#include <array>
 #include <cassert>
-#include <map>
+#include <cstddef>
 #include <memory>
 #include <optional>
 #include <sstream>
@@ -82,27 +83,57 @@ public:
 
     AMdoc const* get_document() const;
 
+    /// \returns A pointer to the borrowed heads of the revision that the node
+    ///          reads or `nullptr` if it reads the current revision.
+    AMitems const* get_heads() const;
+
     virtual AMobjId const* get_object_id() const;
 
 protected:
-    using ResultPtr = std::shared_ptr<AMresult>;
+    /// \brief The key of a property paired with the index of its slot within
+    ///        the cache of a node's results.
+    struct Key {
+        std::size_t index;
+        std::string_view name;
+    };
+
+    /// \brief Frees an `AMresult` without the shared ownership that would
+    ///        need a separately allocated, atomically counted control block.
+    struct ResultDeleter {
+        void operator()(AMresult* const result) const;
+    };
+
+    using ResultPtr = std::unique_ptr<AMresult, ResultDeleter>;
 
-    inline Node() : m_document{nullptr} {};
+    /// \brief The greatest count of properties that a node can have.
+    static constexpr std::size_t MAX_PROPERTIES = 6;
+
+    /// \brief The index of the slot preserving the `AMitem` storing the node's
+    ///        object ID.
+    static constexpr std::size_t SELF = 0;
+
+    inline Node() : m_document{nullptr}, m_heads{nullptr} {};
 
     /// \param document[in] A pointer to a borrowed Automerge document.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
-    Node(AMdoc const* const document);
+    Node(AMdoc const* const document, AMitems const* const heads = nullptr);
 
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param map_object[in] A pointer to a borrowed Automerge map object.
     /// \param map_size[in] The expected count of items in \p map_object.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
     /// \pre \p map_object `!= nullptr`
     /// \pre \p map_size `> 0`
     /// \pre `AMitemValType(` \p map_object `) == AM_VAL_TYPE_OBJ_TYPE`
     /// \pre `AMobjObjType(` \p document `, AMitemObjId(` \p map_object `)) == AM_OBJ_TYPE_MAP`
-    /// \pre `AMobjSize(` \p document `, AMitemObjId(` \p map_object `), nullptr) ==` \p map_size
-    Node(AMdoc const* const document, AMitem const* const map_object, int const map_size);
+    /// \pre `AMobjSize(` \p document `, AMitemObjId(` \p map_object `),` \p heads `) ==` \p map_size
+    /// \note \p heads must outlive the node and every node read from it.
+    Node(AMdoc const* const document,
+         AMitem const* const map_object,
+         int const map_size,
+         AMitems const* const heads = nullptr);
 
     Node(Node&&) = default;
 
@@ -112,67 +143,88 @@ protected:
     ///        tag value.
     ///
     /// \tparam EnumT A type of enum.
-    /// \param key[in] A pointer to a null-terminated byte string.
+    /// \param key[in] The key of a property declared by the node's type.
     /// \throws std::invalid_argument
     template <typename EnumT>
-    void check_enum_property(std::string const& key, EnumT const tag) const;
+    void check_enum_property(Key const& key, EnumT const tag) const;
 
     /// \brief Checks that the string property under a given key matches the
     ///        given string value.
     ///
-    /// \param key[in] A pointer to a null-terminated byte string.
-    /// \param value[in] A pointer to a null-terminated byte string.
+    /// \param key[in] The key of a property declared by the node's type.
+    /// \param value[in] A string view.
     /// \throws std::invalid_argument
-    void check_string_property(std::string const& key, std::string const& value) const;
+    void check_string_property(Key const& key, std::string_view const& value) const;
 
     /// \brief Gets the string property under a given key.
     ///
     /// \tparam InputRangeT A type satisfying the `std::ranges::array_range`
     ///         concept.
-    /// \param key[in] A pointer to a null-terminated byte string.
+    /// \param key[in] The key of a property declared by the node's type.
     template <typename InputRangeT>
-    InputRangeT get_array_property(std::string const& key) const;
+    InputRangeT get_array_property(Key const& key) const;
 
     /// \brief Gets the enum property under a given key.
     ///
     /// \tparam EnumT A type of enum.
-    /// \param key[in] A pointer to a null-terminated byte string.
+    /// \param key[in] The key of a property declared by the node's type.
     /// \throws std::invalid_argument
     template <typename EnumT>
-    EnumT get_enum_property(std::string const& key) const;
+    EnumT get_enum_property(Key const& key) const;
 
     /// \brief Gets the nullable enum property under a given key.
     ///
     /// \tparam EnumT A type of enum.
-    /// \param key[in] A pointer to a null-terminated byte string.
+    /// \param key[in] The key of a property declared by the node's type.
     /// \throws std::invalid_argument
     template <typename EnumT>
-    std::optional<EnumT> get_nullable_enum_property(std::string const& key) const;
+    std::optional<EnumT> get_nullable_enum_property(Key const& key) const;
 
     /// \brief Gets the nullable object property under a given key.
     ///
     /// \tparam ObjectT A type of object.
-    /// \param key[in] A pointer to a null-terminated byte string.
+    /// \param key[in] The key of a property declared by the node's type.
     /// \throws std::invalid_argument
     template <typename ObjectT>
-    std::optional<ObjectT> get_nullable_object_property(std::string const& key) const;
+    std::optional<ObjectT> get_nullable_object_property(Key const& key) const;
 
     /// \brief Gets the object property under a given key.
     ///
     /// \tparam ObjectT A type of object.
-    /// \param key[in] A pointer to a null-terminated byte string.
+    /// \param key[in] The key of a property declared by the node's type.
     /// \throws std::invalid_argument
     template <typename ObjectT>
-    ObjectT get_object_property(std::string const& key) const;
+    ObjectT get_object_property(Key const& key) const;
+
+    /// \brief Gets the result of looking up a property under a given key.
+    ///
+    /// \param key[in] The key of a property declared by the node's type.
+    /// \returns The slot of \p key within the cache of results, which is
+    ///          empty if the lookup failed.
+    /// \note A property is only looked up the first time that it's read so a
+    ///       node that reads the current revision doesn't see the changes
+    ///       made to its map object after that.
+    ResultPtr const& get_property(Key const& key) const;
 
     AMdoc const* const m_document;
-    mutable std::map<std::string, ResultPtr> m_results;
+    AMitems const* const m_heads;
+    /// \note Each of the node's properties has a fixed slot so reading one
+    ///       again neither allocates nor compares strings.
+    mutable std::array<ResultPtr, MAX_PROPERTIES + 1> m_results;
 };
 
 inline AMdoc const* Node::get_document() const {
     return m_document;
 }
 
+inline AMitems const* Node::get_heads() const {
+    return m_heads;
+}
+
+inline void Node::ResultDeleter::operator()(AMresult* const result) const {
+    AMresultFree(result);
+}
+
 }  // namespace usdj_am
 }  // namespace cavi
 
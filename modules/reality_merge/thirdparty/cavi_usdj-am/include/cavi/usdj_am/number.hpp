@@ -53,11 +53,14 @@ struct Number : public std::variant<double,        // AM_VAL_TYPE_F64
 
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param item[in] A pointer to a borrowed Automerge item.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
     /// \pre \p item `!= nullptr`
     /// \pre `AMitemValType(` \p item `) ∈ {AM_VAL_TYPE_F64, AM_VAL_TYPE_INT, AM_VAL_TYPE_UINT}`
     /// \throws std::invalid_argument
-    Number(AMdoc const* const document, AMitem const* const item);
+    /// \note \p heads is only accepted for uniformity with the other nodes
+    ///       because a scalar within \p item is already of its revision.
+    Number(AMdoc const* const document, AMitem const* const item, AMitems const* const heads = nullptr);
 
     Number(Number const&) = delete;
     Number& operator=(Number const&) = delete;
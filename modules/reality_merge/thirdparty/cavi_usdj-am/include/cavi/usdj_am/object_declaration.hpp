@@ -66,13 +66,16 @@ class ObjectDeclaration : public Node {
 public:
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param map_object[in] A pointer to a borrowed Automerge map object.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
     /// \pre \p map_object `!= nullptr`
     /// \pre `AMitemValType(` \p map_object `) == AM_VAL_TYPE_OBJ_TYPE`
     /// \pre `AMobjObjType(` \p document `, AMitemObjId(` \p map_object `)) == AM_OBJ_TYPE_MAP`
     /// \pre `AMobjSize(` \p document `, AMitemObjId(` \p map_object `)) == 4`
     /// \throws std::invalid_argument
-    ObjectDeclaration(AMdoc const* const document, AMitem const* const map_object);
+    ObjectDeclaration(AMdoc const* const document,
+                      AMitem const* const map_object,
+                      AMitems const* const heads = nullptr);
 
     ObjectDeclaration(ObjectDeclaration const&) = delete;
 
@@ -116,6 +119,11 @@ private:
     ObjectDeclaration() = default;
 
     friend class ArrayInputIterator<ObjectDeclaration>;
+
+    static constexpr Key DEFINE_TYPE{1, "defineType"};
+    static constexpr Key KEYWORD{2, "keyword"};
+    static constexpr Key REFERENCE{3, "reference"};
+    static constexpr Key VALUE{4, "value"};
 };
 
 }  // namespace usdj_am
@@ -56,13 +56,16 @@ public:
 
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param map_object[in] A pointer to a borrowed Automerge map object.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
     /// \pre \p map_object `!= nullptr`
     /// \pre `AMitemValType(` \p map_object `) == AM_VAL_TYPE_OBJ_TYPE`
     /// \pre `AMobjObjType(` \p document `, AMitemObjId(` \p map_object `)) == AM_OBJ_TYPE_MAP`
     /// \pre `AMobjSize(` \p document `, AMitemObjId(` \p map_object `)) == 2`
     /// \throws std::invalid_argument
-    ObjectDeclarationEntries(AMdoc const* const document, AMitem const* const map_object);
+    ObjectDeclarationEntries(AMdoc const* const document,
+                             AMitem const* const map_object,
+                             AMitems const* const heads = nullptr);
 
     ObjectDeclarationEntries(ObjectDeclarationEntries const&) = delete;
 
@@ -91,6 +94,10 @@ public:
     ///
     /// \throws std::invalid_argument
     Values get_values() const;
+
+private:
+    static constexpr Key TYPE{1, "type"};
+    static constexpr Key VALUES{2, "values"};
 };
 
 }  // namespace usdj_am
@@ -59,13 +59,16 @@ public:
 
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param map_object[in] A pointer to a borrowed Automerge map object.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
     /// \pre \p map_object `!= nullptr`
     /// \pre `AMitemValType(` \p map_object `) == AM_VAL_TYPE_OBJ_TYPE`
     /// \pre `AMobjObjType(` \p document `, AMitemObjId(` \p map_object `)) == AM_OBJ_TYPE_MAP`
     /// \pre `AMobjSize(` \p document `, AMitemObjId(` \p map_object `)) == 2`
     /// \throws std::invalid_argument
-    ObjectDeclarationList(AMdoc const* const document, AMitem const* const map_object);
+    ObjectDeclarationList(AMdoc const* const document,
+                          AMitem const* const map_object,
+                          AMitems const* const heads = nullptr);
 
     ObjectDeclarationList(ObjectDeclarationList const&) = delete;
 
@@ -94,6 +97,10 @@ public:
     ///
     /// \throws std::invalid_argument
     Values get_values() const;
+
+private:
+    static constexpr Key TYPE{1, "type"};
+    static constexpr Key VALUES{2, "values"};
 };
 
 }  // namespace usdj_am
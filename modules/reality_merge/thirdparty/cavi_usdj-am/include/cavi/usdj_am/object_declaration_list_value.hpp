@@ -56,13 +56,16 @@ class ObjectDeclarationListValue : public Node {
 public:
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param map_object[in] A pointer to a borrowed Automerge map object.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
     /// \pre \p map_object `!= nullptr`
     /// \pre `AMitemValType(` \p map_object `) == AM_VAL_TYPE_OBJ_TYPE`
     /// \pre `AMobjObjType(` \p document `, AMitemObjId(` \p map_object `)) == AM_OBJ_TYPE_MAP`
     /// \pre `AMobjSize(` \p document `, AMitemObjId(` \p map_object `)) == 2`
     /// \throws std::invalid_argument
-    ObjectDeclarationListValue(AMdoc const* const document, AMitem const* const map_object);
+    ObjectDeclarationListValue(AMdoc const* const document,
+                               AMitem const* const map_object,
+                               AMitems const* const heads = nullptr);
 
     ObjectDeclarationListValue(ObjectDeclarationListValue const&) = delete;
 
@@ -96,6 +99,9 @@ private:
     ObjectDeclarationListValue() = default;
 
     friend class ArrayInputIterator<ObjectDeclarationListValue>;
+
+    static constexpr Key INDEX{1, "index"};
+    static constexpr Key VALUE{2, "value"};
 };
 
 }  // namespace usdj_am
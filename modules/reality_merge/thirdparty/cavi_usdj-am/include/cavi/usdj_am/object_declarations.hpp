@@ -65,12 +65,15 @@ struct ObjectDeclarations : public std::variant<std::monostate, ObjectDeclaratio
 
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param map_object[in] A pointer to a borrowed Automerge map object.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
     /// \pre \p map_object `!= nullptr`
     /// \pre `AMitemValType(` \p map_object `) == AM_VAL_TYPE_OBJ_TYPE`
     /// \pre `AMobjObjType(` \p document `, AMitemObjId(` \p map_object `)) == AM_OBJ_TYPE_MAP`
     /// \throws std::invalid_argument
-    ObjectDeclarations(AMdoc const* const document, AMitem const* const map_object);
+    ObjectDeclarations(AMdoc const* const document,
+                       AMitem const* const map_object,
+                       AMitems const* const heads = nullptr);
 
     ObjectDeclarations(ObjectDeclarations const&) = delete;
     ObjectDeclarations& operator=(ObjectDeclarations const&) = delete;
@@ -53,12 +53,13 @@ public:
 
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param map_object[in] A pointer to a borrowed Automerge map object.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
     /// \pre \p map_object `!= nullptr`
     /// \pre `AMobjObjType(` \p document `, AMitemObjId(` \p map_object `)) == AM_OBJ_TYPE_MAP`
     /// \pre `AMobjSize(` \p document `, AMitemObjId(` \p map_object `)) == 2`
     /// \throws std::invalid_argument
-    ObjectValue(AMdoc const* const document, AMitem const* const map_object);
+    ObjectValue(AMdoc const* const document, AMitem const* const map_object, AMitems const* const heads = nullptr);
 
     ObjectValue(ObjectValue const&) = default;
 
@@ -81,6 +82,10 @@ public:
 
     /// \brief Gets the `.type` property.
     constexpr ValueType get_type() const;
+
+private:
+    static constexpr Key DECLARATIONS{1, "declarations"};
+    static constexpr Key TYPE{2, "type"};
 };
 
 constexpr ValueType ObjectValue::get_type() const {
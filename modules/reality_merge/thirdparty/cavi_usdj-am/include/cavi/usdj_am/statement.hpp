@@ -61,12 +61,13 @@ struct Statement : public std::variant<std::monostate, ClassDefinition, Definiti
 
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param map_object[in] A pointer to a borrowed Automerge map object.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
     /// \pre \p map_object `!= nullptr`
     /// \pre `AMitemValType(` \p map_object `) == AM_VAL_TYPE_OBJ_TYPE`
     /// \pre `AMobjObjType(` \p document `, AMitemObjId(` \p map_object `)) == AM_OBJ_TYPE_MAP`
     /// \throws std::invalid_argument
-    Statement(AMdoc const* const document, AMitem const* const map_object);
+    Statement(AMdoc const* const document, AMitem const* const map_object, AMitems const* const heads = nullptr);
 
     Statement(Statement const&) = delete;
     Statement& operator=(Statement const&) = delete;
@@ -32,6 +32,8 @@
 
 #include <cstdint>
 #include <iosfwd>
+#include <optional>
+#include <string_view>
 
 // export enum USDA_StatementType {
 //     Declaration = 'declaration',
@@ -57,6 +59,13 @@ enum class StatementType : std::uint8_t {
     SIZE__ = END__ - BEGIN__
 };
 
+/// \brief Extracts a `StatementType` enum tag from a string view.
+///
+/// \param[in] view A UTF-8 string view.
+/// \returns The `StatementType` enum tag whose serialized form is \p view
+///          or `std::nullopt`.
+std::optional<StatementType> extract_StatementType(std::string_view const& view);
+
 std::istream& operator>>(std::istream& is, StatementType& out);
 
 std::ostream& operator<<(std::ostream& os, StatementType const& in);
@@ -49,11 +49,12 @@ public:
 
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param item[in] A pointer to a borrowed Automerge str or text object.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
     /// \pre \p item `!= nullptr`
     /// \pre `AMitemValType(` \p item `) == AM_VAL_TYPE_OBJ_TYPE || AMitemValType(` \p item `) == AM_VAL_TYPE_STR`
     /// \throws std::invalid_argument
-    String(AMdoc const* const document, AMitem const* const item);
+    String(AMdoc const* const document, AMitem const* const item, AMitems const* const heads = nullptr);
 
     String(String const&) = default;
 
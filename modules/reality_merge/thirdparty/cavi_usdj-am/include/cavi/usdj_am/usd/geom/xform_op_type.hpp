@@ -54,6 +54,9 @@
 
 namespace cavi {
 namespace usdj_am {
+
+struct Value;
+
 namespace usd {
 namespace geom {
 
@@ -40,6 +40,7 @@
 
 struct AMdoc;
 struct AMitem;
+struct AMitems;
 struct AMresult;
 
 namespace cavi {
@@ -60,6 +61,21 @@ public:
     /// \throws std::invalid_argument
     static Document load(std::uint8_t const* const src, std::size_t const count);
 
+    /// \brief Load an Automerge document from the complete chunks at the
+    ///        start of a memory buffer.
+    ///
+    /// \param[in] src A pointer to an array of bytes.
+    /// \param[in] count The number of bytes to read.
+    /// \param[out] loaded_count The number of bytes that were loaded, which is
+    ///                          less than \p count when the last chunk that
+    ///                          was appended to a file is incomplete.
+    /// \pre \p src `!= nullptr`
+    /// \pre \p count `<= sizeof(*` \p src `)`
+    /// \throws std::invalid_argument
+    /// \note Recovers a file that `save_incremental()` was interrupted while
+    ///       appending to.
+    static Document load(std::uint8_t const* const src, std::size_t const count, std::size_t& loaded_count);
+
     /// \brief Load an Automerge document from a binary file.
     ///
     /// \param[in] filename A path to a binary file.
@@ -83,17 +99,29 @@ public:
 
     operator AMdoc*() const;
 
+    /// \brief Gets the heads of the document's current revision.
+    ///
+    /// \returns A managed pointer to an `AMresult` struct containing a
+    ///          sequence of change hashes.
+    /// \throws std::invalid_argument
+    ResultPtr get_heads() const;
+
     /// \brief Gets the root map object of the document.
     ///
+    /// \param[in] heads A pointer to borrowed heads of the revision to read or
+    ///                  `nullptr` for the current one.
     /// \returns An `Item`.
-    Item get_item() const;
+    Item get_item(AMitems const* const heads = nullptr) const;
 
     /// \brief Gets the item at an absolute POSIX path within the document.
     ///
     /// \param[in] posix_path An absolute POSIX path string.
+    /// \param[in] heads A pointer to borrowed heads of the revision to read or
+    ///                  `nullptr` for the current one.
     /// \returns An `Item`.
     /// \throws std::invalid_argument
-    Item get_item(std::string const& posix_path) const;
+    /// \see `DocumentPath::resolve()` for repeated lookups of the same path.
+    Item get_item(std::string const& posix_path, AMitems const* const heads = nullptr) const;
 
     /// \brief Saves a compact representation of the Automerge document to a binary file.
     ///
@@ -103,6 +131,18 @@ public:
     /// \throws std::runtime_error
     std::size_t save(std::filesystem::path const& filename) const;
 
+    /// \brief Appends the changes made since an earlier revision of the
+    ///        document to a binary file containing that revision.
+    ///
+    /// \param[in] filename A path to a binary file.
+    /// \param[in] heads A managed pointer to an `AMresult` struct containing
+    ///                  the heads of the earlier revision.
+    /// \returns The number of bytes that were appended.
+    /// \pre \p heads was returned by `get_heads()`.
+    /// \throws std::invalid_argument
+    /// \note `Document::load()` accepts a file that was appended to.
+    std::size_t save_incremental(std::filesystem::path const& filename, ResultPtr const& heads) const;
+
 private:
     AMdoc* m_document;
     ResultPtr m_result;
@@ -114,8 +154,8 @@ inline Document::operator AMdoc*() const {
     return m_document;
 }
 
-inline Item Document::get_item() const {
-    return Item(m_document);
+inline Item Document::get_item(AMitems const* const heads) const {
+    return Item(m_document, heads);
 }
 
 bool operator==(Document const& lhs, Document const& rhs);
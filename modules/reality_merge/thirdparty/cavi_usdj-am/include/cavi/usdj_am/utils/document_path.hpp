@@ -0,0 +1,129 @@
+/**************************************************************************/
+/* document_path.hpp                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef CAVI_USDJ_AM_UTILS_DOCUMENT_PATH_HPP
+#define CAVI_USDJ_AM_UTILS_DOCUMENT_PATH_HPP
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+// local
+#include "document.hpp"
+#include "item.hpp"
+
+struct AMdoc;
+struct AMresult;
+
+namespace cavi {
+namespace usdj_am {
+namespace utils {
+
+/// \brief Represents an absolute POSIX path to an item within an Automerge
+///        document that is parsed once and whose chain of object IDs is
+///        cached per heads.
+///
+/// \note A resolution is reused only while the document's heads are
+///       unchanged. Any other heads drop the whole chain, which is then
+///       looked up again from the root without re-parsing the path. An
+///       object ID can't be checked against a later revision for less than
+///       the cost of looking it up again.
+/// \note The heads identify a revision's contents so a resolution is also
+///       reused by a fork of the document that it was made within, e.g. a
+///       snapshot that replaces it.
+/// \warning The cache isn't synchronized so a `DocumentPath` mustn't be
+///          resolved by several threads at once.
+class DocumentPath {
+public:
+    /// \brief A key within a map object or a position within a list object.
+    using Element = std::variant<std::string, std::uint64_t>;
+    using Elements = std::vector<Element>;
+
+    DocumentPath() = delete;
+
+    /// \brief Parses an absolute POSIX path.
+    ///
+    /// \param[in] posix_path An absolute POSIX path string.
+    /// \throws std::invalid_argument
+    /// \note An element consisting solely of decimal digits is a position.
+    explicit DocumentPath(std::string_view const posix_path);
+
+    DocumentPath(DocumentPath const&) = delete;
+    DocumentPath& operator=(DocumentPath const&) = delete;
+
+    DocumentPath(DocumentPath&&) = default;
+    DocumentPath& operator=(DocumentPath&&) = default;
+
+    /// \brief Gets the parsed elements of the path.
+    ///
+    /// \returns A sequence of map keys and list positions.
+    Elements const& get_elements() const;
+
+    /// \brief Gets the path as it was given.
+    ///
+    /// \returns An absolute POSIX path string.
+    std::string const& get_posix_path() const;
+
+    /// \brief Gets the item at the path within a document.
+    ///
+    /// \param[in] document An Automerge document.
+    /// \returns An `Item`.
+    /// \throws std::invalid_argument
+    /// \note Costs a lookup per element whenever \p document has different
+    ///       heads from the last resolution.
+    Item resolve(Document const& document) const;
+
+private:
+    using ResultPtr = std::shared_ptr<AMresult>;
+
+    std::string m_posix_path;
+    Elements m_elements;
+    /// The heads of the revision that the cached chain was resolved at.
+    mutable std::optional<Document::ResultPtr> m_heads;
+    /// One result per element; an element's object ID is its child's parent.
+    mutable std::vector<ResultPtr> m_chain;
+};
+
+inline DocumentPath::Elements const& DocumentPath::get_elements() const {
+    return m_elements;
+}
+
+inline std::string const& DocumentPath::get_posix_path() const {
+    return m_posix_path;
+}
+
+}  // namespace utils
+}  // namespace usdj_am
+}  // namespace cavi
+
+#endif  // CAVI_USDJ_AM_UTILS_DOCUMENT_PATH_HPP
@@ -38,6 +38,7 @@
 
 struct AMdoc;
 struct AMitem;
+struct AMitems;
 struct AMresult;
 
 namespace cavi {
@@ -52,9 +53,11 @@ public:
     /// \brief Wraps the root map object of the given Automerge document.
     ///
     /// \param document[in] A pointer to a borrowed `AMdoc` struct.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
     /// \throws std::invalid_argument
-    Item(AMdoc const* const document);
+    /// \note \p heads must outlive the item and every item appended to it.
+    Item(AMdoc const* const document, AMitems const* const heads = nullptr);
 
     Item(Item const&) = default;
 
@@ -66,13 +69,20 @@ public:
 
     operator AMitem const*() const;
 
+    /// \returns A pointer to the borrowed heads of the revision that the item
+    ///          reads or `nullptr` if it reads the current revision.
+    AMitems const* get_heads() const;
+
 private:
     using ResultPtr = std::shared_ptr<AMresult>;
     using Results = std::vector<ResultPtr>;
 
     AMdoc const* const m_document;
+    AMitems const* const m_heads;
     Results m_results;
 
+    friend class DocumentPath;
+
     friend bool operator==(Item const& lhs, Item const& rhs);
 
     friend Item operator/(Item const& lhs, Item const& rhs);
@@ -84,6 +94,10 @@ private:
     friend std::ostream& operator<<(std::ostream& os, Item const& in);
 };
 
+inline AMitems const* Item::get_heads() const {
+    return m_heads;
+}
+
 bool operator==(Item const& lhs, Item const& rhs);
 
 inline bool operator!=(Item const& lhs, Item const& rhs) {
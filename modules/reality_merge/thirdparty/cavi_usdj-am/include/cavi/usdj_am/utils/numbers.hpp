@@ -0,0 +1,81 @@
+/**************************************************************************/
+/* numbers.hpp                                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef CAVI_USDJ_AM_UTILS_NUMBERS_HPP
+#define CAVI_USDJ_AM_UTILS_NUMBERS_HPP
+
+#include <cstddef>
+
+// local
+#include <cavi/usdj_am/value.hpp>
+
+namespace cavi {
+namespace usdj_am {
+namespace utils {
+
+/// \brief Reads an array of numbers straight into a contiguous buffer without
+///        constructing a `Value` for each of its elements.
+///
+/// \tparam NumberT An arithmetic type.
+/// \param[in] values An "Array<number>" value.
+/// \param[out] first A pointer to the first element of a buffer.
+/// \param[in] count The count of elements in the buffer.
+/// \returns The count of elements written, which is the lesser of \p count
+///          and `values.size()`.
+/// \pre \p first `!= nullptr` unless \p count `== 0`
+/// \throws std::invalid_argument if an element of \p values isn't a number.
+template <typename NumberT>
+std::size_t read_numbers(ValueRange const& values, NumberT* const first, std::size_t const count);
+
+/// \brief Reads an array of arrays of numbers with the same size, e.g. the
+///        points of a mesh or the rows of a matrix, straight into a
+///        contiguous buffer in row-major order.
+///
+/// \tparam NumberT An arithmetic type.
+/// \param[in] values An "Array<Array<number>>" value.
+/// \param[in] width The expected size of each nested array.
+/// \param[out] first A pointer to the first element of a buffer.
+/// \param[in] count The count of elements in the buffer.
+/// \returns The count of elements written, which is a multiple of \p width
+///          no greater than \p count.
+/// \pre \p width `> 0`
+/// \pre \p first `!= nullptr` unless \p count `== 0`
+/// \throws std::invalid_argument if an element of \p values isn't an array of
+///         \p width numbers.
+template <typename NumberT>
+std::size_t read_number_tuples(ValueRange const& values,
+                               std::size_t const width,
+                               NumberT* const first,
+                               std::size_t const count);
+
+}  // namespace utils
+}  // namespace usdj_am
+}  // namespace cavi
+
+#endif  // CAVI_USDJ_AM_UTILS_NUMBERS_HPP
@@ -0,0 +1,461 @@
+/**************************************************************************/
+/* scene.hpp                                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+
+#ifndef CAVI_USDJ_AM_UTILS_SCENE_HPP
+#define CAVI_USDJ_AM_UTILS_SCENE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+// local
+#include <cavi/usdj_am/assignment_keyword.hpp>
+#include <cavi/usdj_am/declaration_keyword.hpp>
+#include <cavi/usdj_am/definition_type.hpp>
+
+struct AMobjId;
+
+namespace cavi {
+namespace usdj_am {
+
+class File;
+
+namespace utils {
+
+/// \brief An immutable, flattened representation of the prims within a
+///        "USDA_File" node that is compiled in a single pass over it.
+///
+/// \note Every table is a contiguous array within one arena: the prims and
+///       attributes are stored as structs of arrays, strings are interned as
+///       tokens and numeric values are stored as `double`s in row-major
+///       order so that reading the scene never calls into Automerge.
+/// \note The prims are numbered in depth-first pre-order so the descendants
+///       of a prim are the prims within `[prim + 1, get_prim_end(prim))`.
+class Scene {
+public:
+    /// \brief The index of a row within one of the scene's tables.
+    using Index = std::uint32_t;
+
+    /// \brief The index of no row.
+    static constexpr Index NONE = std::numeric_limits<Index>::max();
+
+    /// \brief A half-open range of rows within one of the scene's tables.
+    struct Span {
+        Index first;
+        Index count;
+    };
+
+    /// \brief Where an attribute of a prim was assigned.
+    enum class Scope : std::uint8_t {
+        BEGIN__ = 1,
+        /// An "USDA_Assignment" node within the prim's descriptor.
+        METADATA = BEGIN__,
+        /// A "USDA_Declaration" node within the prim's statements.
+        PROPERTY,
+        END__,
+        SIZE__ = END__ - BEGIN__
+    };
+
+    /// \brief The kind of rows that an attribute's values span.
+    enum class ValueKind : std::uint8_t {
+        BEGIN__ = 1,
+        /// A value that isn't represented, e.g. `null` or an object.
+        EMPTY = BEGIN__,
+        /// Rows of `get_numbers()`, e.g. a number, a boolean or an array of
+        /// numbers or of arrays of numbers.
+        NUMBERS,
+        /// Rows of `get_token_values()`, e.g. a string, an array of strings
+        /// or the source of an external reference.
+        TOKENS,
+        END__,
+        SIZE__ = END__ - BEGIN__
+    };
+
+    Scene() = delete;
+
+    /// \brief Compiles the prims within a "USDA_File" node.
+    ///
+    /// \param[in] file A "USDA_File" node.
+    /// \throws std::invalid_argument
+    /// \note The scene reads the same revision as \p file but doesn't borrow
+    ///       anything from it.
+    explicit Scene(File const& file);
+
+    Scene(Scene const&) = delete;
+    Scene& operator=(Scene const&) = delete;
+
+    Scene(Scene&&) = default;
+    Scene& operator=(Scene&&) = default;
+
+    ~Scene();
+
+    /// \brief Gets the count of interned tokens.
+    std::size_t get_token_count() const;
+
+    /// \brief Gets an interned token.
+    ///
+    /// \param[in] token The index of a token.
+    /// \pre \p token `< get_token_count()`
+    std::string_view get_token(Index const token) const;
+
+    /// \brief Finds the index of an interned token.
+    ///
+    /// \param[in] view A UTF-8 string view.
+    /// \returns The index of \p view or `NONE`.
+    Index find_token(std::string_view const& view) const;
+
+    /// \brief Gets the count of prims.
+    std::size_t get_prim_count() const;
+
+    /// \brief Gets the root prim named by the file's "defaultPrim" metadata.
+    ///
+    /// \returns The index of a prim or `NONE`.
+    Index get_default_prim() const;
+
+    /// \brief Finds the prim compiled from a "USDA_Definition" node.
+    ///
+    /// \param[in] object_id The object ID of a "USDA_Definition" node.
+    /// \returns The index of a prim or `NONE`.
+    Index find_prim(AMobjId const* const object_id) const;
+
+    /// \brief Finds the prim compiled from the same "USDA_Definition" node as
+    ///        a prim of another scene.
+    ///
+    /// \param[in] scene A scene compiled from another revision of the same
+    ///                  document.
+    /// \param[in] prim The index of a prim within \p scene.
+    /// \returns The index of a prim or `NONE`.
+    /// \pre \p prim `<` \p scene `.get_prim_count()`
+    Index find_prim(Scene const& scene, Index const prim) const;
+
+    /// \brief Gets the attributes of a prim.
+    ///
+    /// \param[in] prim The index of a prim.
+    /// \returns A span of rows within the attribute table.
+    /// \pre \p prim `< get_prim_count()`
+    Span get_prim_attributes(Index const prim) const;
+
+    /// \brief Gets a digest of a prim's subtree.
+    ///
+    /// \param[in] prim The index of a prim.
+    /// \returns A hash of the names, types, attributes and values of the prim
+    ///          and its descendants along with their object IDs.
+    /// \pre \p prim `< get_prim_count()`
+    /// \note The digests of the same prim within two scenes only differ when
+    ///       its subtree was changed in between so they can be compared to
+    ///       find the prims touched by a merge.
+    std::uint64_t get_prim_digest(Index const prim) const;
+
+    /// \brief Gets a digest of a prim's own fields.
+    ///
+    /// \param[in] prim The index of a prim.
+    /// \returns A hash of the name, type, attributes and values of the prim
+    ///          alone.
+    /// \pre \p prim `< get_prim_count()`
+    /// \note Unlike `get_prim_digest()`, it doesn't change when only the
+    ///       prim's descendants were changed.
+    std::uint64_t get_prim_own_digest(Index const prim) const;
+
+    /// \brief Gets the key of the Automerge object that a prim was compiled
+    ///        from.
+    ///
+    /// \param[in] prim The index of a prim.
+    /// \returns The counter and the bytes of the actor ID of the object ID of
+    ///          a "USDA_Definition" node, which identify it in any revision.
+    /// \pre \p prim `< get_prim_count()`
+    std::pair<std::uint64_t, std::string_view> get_prim_object_key(Index const prim) const;
+
+    /// \brief Gets the end of a prim's subtree.
+    ///
+    /// \param[in] prim The index of a prim.
+    /// \returns The index after that of the prim's last descendant.
+    /// \pre \p prim `< get_prim_count()`
+    Index get_prim_end(Index const prim) const;
+
+    /// \brief Gets the name of a prim.
+    ///
+    /// \param[in] prim The index of a prim.
+    /// \returns The index of a token.
+    /// \pre \p prim `< get_prim_count()`
+    Index get_prim_name(Index const prim) const;
+
+    /// \brief Gets the parent of a prim.
+    ///
+    /// \param[in] prim The index of a prim.
+    /// \returns The index of a prim or `NONE` for a root prim.
+    /// \pre \p prim `< get_prim_count()`
+    Index get_prim_parent(Index const prim) const;
+
+    /// \brief Gets the specifier of a prim.
+    ///
+    /// \param[in] prim The index of a prim.
+    /// \pre \p prim `< get_prim_count()`
+    DefinitionType get_prim_sub_type(Index const prim) const;
+
+    /// \brief Gets the type name of a prim.
+    ///
+    /// \param[in] prim The index of a prim.
+    /// \returns The index of a token or `NONE` for a typeless prim.
+    /// \pre \p prim `< get_prim_count()`
+    Index get_prim_type(Index const prim) const;
+
+    /// \brief Finds an attribute of a prim by its name.
+    ///
+    /// \param[in] prim The index of a prim.
+    /// \param[in] name The name of an attribute.
+    /// \returns The index of an attribute or `NONE`.
+    /// \pre \p prim `< get_prim_count()`
+    Index find_attribute(Index const prim, std::string_view const& name) const;
+
+    /// \brief Gets the count of attributes of all prims.
+    std::size_t get_attribute_count() const;
+
+    /// \brief Gets the keyword of a metadata attribute.
+    ///
+    /// \param[in] attribute The index of an attribute.
+    /// \returns An `AssignmentKeyword` or `std::nullopt`.
+    /// \pre \p attribute `< get_attribute_count()`
+    std::optional<AssignmentKeyword> get_metadata_keyword(Index const attribute) const;
+
+    /// \brief Gets the keyword of a property attribute.
+    ///
+    /// \param[in] attribute The index of an attribute.
+    /// \returns A `DeclarationKeyword` or `std::nullopt`.
+    /// \pre \p attribute `< get_attribute_count()`
+    std::optional<DeclarationKeyword> get_property_keyword(Index const attribute) const;
+
+    /// \brief Gets the name of an attribute, which is either an assignment's
+    ///        identifier or a declaration's reference.
+    ///
+    /// \param[in] attribute The index of an attribute.
+    /// \returns The index of a token.
+    /// \pre \p attribute `< get_attribute_count()`
+    Index get_attribute_name(Index const attribute) const;
+
+    /// \brief Gets where an attribute was assigned.
+    ///
+    /// \param[in] attribute The index of an attribute.
+    /// \pre \p attribute `< get_attribute_count()`
+    Scope get_attribute_scope(Index const attribute) const;
+
+    /// \brief Gets the type name of an attribute.
+    ///
+    /// \param[in] attribute The index of an attribute.
+    /// \returns The index of a declaration's defined type token or `NONE`
+    ///          for metadata.
+    /// \pre \p attribute `< get_attribute_count()`
+    Index get_attribute_type(Index const attribute) const;
+
+    /// \brief Gets the kind of rows that an attribute's values span.
+    ///
+    /// \param[in] attribute The index of an attribute.
+    /// \pre \p attribute `< get_attribute_count()`
+    ValueKind get_attribute_value_kind(Index const attribute) const;
+
+    /// \brief Gets the values of an attribute.
+    ///
+    /// \param[in] attribute The index of an attribute.
+    /// \returns A span of rows within `get_numbers()` or `get_token_values()`.
+    /// \pre \p attribute `< get_attribute_count()`
+    Span get_attribute_values(Index const attribute) const;
+
+    /// \brief Gets the count of numbers in each row of an attribute's value,
+    ///        e.g. 3 for a "float3[]".
+    ///
+    /// \param[in] attribute The index of an attribute.
+    /// \pre \p attribute `< get_attribute_count()`
+    std::size_t get_attribute_width(Index const attribute) const;
+
+    /// \brief Gets the numeric values of all attributes.
+    double const* get_numbers() const;
+
+    /// \brief Gets the token values of all attributes.
+    Index const* get_token_values() const;
+
+private:
+    /// \brief Identifies an Automerge object in any revision of a document.
+    struct ObjectKey {
+        std::uint64_t counter;
+        /// The index of the span of `m_actor_characters` holding the bytes of
+        /// the actor ID.
+        Index actor;
+    };
+
+    struct Builder;
+
+    Index find_prim(std::pair<std::uint64_t, std::string_view> const& object_key) const;
+
+    /// \note The tables are laid out within one block that's allocated once
+    ///       the whole file has been read.
+    std::unique_ptr<std::max_align_t[]> m_arena;
+    /// Actor IDs are interned apart from the tokens because they're
+    /// arbitrary bytes that are never looked up as tokens.
+    char const* m_actor_characters;
+    Span const* m_actor_spans;
+    Index m_default_prim;
+    std::size_t m_token_count;
+    char const* m_characters;
+    Span const* m_token_spans;
+    /// Tokens ordered by their bytes.
+    Index const* m_sorted_tokens;
+    std::size_t m_prim_count;
+    Span const* m_prim_attributes;
+    std::uint64_t const* m_prim_digests;
+    Index const* m_prim_ends;
+    Index const* m_prim_names;
+    ObjectKey const* m_prim_object_keys;
+    std::uint64_t const* m_prim_own_digests;
+    Index const* m_prim_parents;
+    DefinitionType const* m_prim_sub_types;
+    Index const* m_prim_types;
+    /// Prims ordered by their object keys.
+    Index const* m_sorted_prims;
+    std::size_t m_attribute_count;
+    /// The underlying value of an `AssignmentKeyword` or a
+    /// `DeclarationKeyword` or zero.
+    std::uint8_t const* m_attribute_keywords;
+    Index const* m_attribute_names;
+    Scope const* m_attribute_scopes;
+    Index const* m_attribute_types;
+    ValueKind const* m_attribute_value_kinds;
+    Span const* m_attribute_values;
+    std::uint8_t const* m_attribute_widths;
+    double const* m_numbers;
+    Index const* m_token_values;
+};
+
+inline std::size_t Scene::get_token_count() const {
+    return m_token_count;
+}
+
+inline std::string_view Scene::get_token(Index const token) const {
+    auto const& span = m_token_spans[token];
+    return std::string_view{m_characters + span.first, span.count};
+}
+
+inline std::size_t Scene::get_prim_count() const {
+    return m_prim_count;
+}
+
+inline Scene::Index Scene::get_default_prim() const {
+    return m_default_prim;
+}
+
+inline Scene::Span Scene::get_prim_attributes(Index const prim) const {
+    return m_prim_attributes[prim];
+}
+
+inline std::uint64_t Scene::get_prim_digest(Index const prim) const {
+    return m_prim_digests[prim];
+}
+
+inline std::uint64_t Scene::get_prim_own_digest(Index const prim) const {
+    return m_prim_own_digests[prim];
+}
+
+inline Scene::Index Scene::get_prim_end(Index const prim) const {
+    return m_prim_ends[prim];
+}
+
+inline Scene::Index Scene::get_prim_name(Index const prim) const {
+    return m_prim_names[prim];
+}
+
+inline Scene::Index Scene::get_prim_parent(Index const prim) const {
+    return m_prim_parents[prim];
+}
+
+inline DefinitionType Scene::get_prim_sub_type(Index const prim) const {
+    return m_prim_sub_types[prim];
+}
+
+inline Scene::Index Scene::get_prim_type(Index const prim) const {
+    return m_prim_types[prim];
+}
+
+inline std::size_t Scene::get_attribute_count() const {
+    return m_attribute_count;
+}
+
+inline std::optional<AssignmentKeyword> Scene::get_metadata_keyword(Index const attribute) const {
+    if (m_attribute_scopes[attribute] != Scope::METADATA || !m_attribute_keywords[attribute]) {
+        return std::nullopt;
+    }
+    return static_cast<AssignmentKeyword>(m_attribute_keywords[attribute]);
+}
+
+inline std::optional<DeclarationKeyword> Scene::get_property_keyword(Index const attribute) const {
+    if (m_attribute_scopes[attribute] != Scope::PROPERTY || !m_attribute_keywords[attribute]) {
+        return std::nullopt;
+    }
+    return static_cast<DeclarationKeyword>(m_attribute_keywords[attribute]);
+}
+
+inline Scene::Index Scene::get_attribute_name(Index const attribute) const {
+    return m_attribute_names[attribute];
+}
+
+inline Scene::Scope Scene::get_attribute_scope(Index const attribute) const {
+    return m_attribute_scopes[attribute];
+}
+
+inline Scene::Index Scene::get_attribute_type(Index const attribute) const {
+    return m_attribute_types[attribute];
+}
+
+inline Scene::ValueKind Scene::get_attribute_value_kind(Index const attribute) const {
+    return m_attribute_value_kinds[attribute];
+}
+
+inline Scene::Span Scene::get_attribute_values(Index const attribute) const {
+    return m_attribute_values[attribute];
+}
+
+inline std::size_t Scene::get_attribute_width(Index const attribute) const {
+    return m_attribute_widths[attribute];
+}
+
+inline double const* Scene::get_numbers() const {
+    return m_numbers;
+}
+
+inline Scene::Index const* Scene::get_token_values() const {
+    return m_token_values;
+}
+
+}  // namespace utils
+}  // namespace usdj_am
+}  // namespace cavi
+
+#endif  // CAVI_USDJ_AM_UTILS_SCENE_HPP
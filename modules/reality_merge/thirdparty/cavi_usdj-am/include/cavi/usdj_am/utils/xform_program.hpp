@@ -0,0 +1,229 @@
+/**************************************************************************/
+/* xform_program.hpp                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+
+#ifndef CAVI_USDJ_AM_UTILS_XFORM_PROGRAM_HPP
+#define CAVI_USDJ_AM_UTILS_XFORM_PROGRAM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+// local
+#include <cavi/usdj_am/usd/geom/xform_op_type.hpp>
+#include <cavi/usdj_am/utils/scene.hpp>
+
+namespace cavi {
+namespace usdj_am {
+namespace utils {
+
+/// \brief A transform operation named by a token within a prim's
+///        "xformOpOrder" attribute.
+struct XformOp {
+    /// The name of the attribute holding the operation's value, e.g.
+    /// "xformOp:translate:pivot".
+    std::string_view name;
+    /// The suffix that distinguishes operations of the same type, e.g.
+    /// "pivot", which is empty when there isn't one.
+    std::string_view suffix;
+    usd::geom::XformOpType type;
+    /// Whether the token had an "!invert!" prefix so that the inverse of the
+    /// operation must be applied instead.
+    bool inverse;
+};
+
+/// \brief Extracts a transform operation from an "xformOpOrder" token.
+///
+/// \param[in] view A UTF-8 string view, e.g. "!invert!xformOp:translate:pivot".
+/// \returns An `XformOp` that borrows \p view or `std::nullopt`.
+std::optional<XformOp> extract_XformOp(std::string_view const& view);
+
+/// \brief The "xformOpOrder" attributes of all of the prims within a scene
+///        compiled into a compact program whose evaluation computes the
+///        local and world matrices of every prim in one pass.
+///
+/// \note The prims whose operations have the same types in the same order
+///       share a batch whose operands are stored as structs of arrays so that
+///       each operation is applied to all of the batch's prims at once.
+/// \note A matrix is an affine 3x4 matrix for column vectors, which is
+///       stored as `MATRIX_SIZE` arrays of one element for each prim in
+///       row-major order so that element `e` of prim `p` is at
+///       `e * get_prim_count() + p`.
+class XformProgram {
+public:
+    using Index = Scene::Index;
+
+    /// \brief The count of elements within a matrix.
+    static constexpr std::size_t MATRIX_SIZE = 12;
+
+    XformProgram() = delete;
+
+    /// \brief Compiles the "xformOpOrder" attributes of a scene's prims.
+    ///
+    /// \param[in] scene A `Scene`.
+    /// \note An operation whose attribute is missing or has the wrong count
+    ///       of numbers is skipped.
+    explicit XformProgram(Scene const& scene);
+
+    XformProgram(XformProgram const&) = delete;
+    XformProgram& operator=(XformProgram const&) = delete;
+
+    XformProgram(XformProgram&&) = default;
+    XformProgram& operator=(XformProgram&&) = default;
+
+    ~XformProgram();
+
+    /// \brief Computes the local and world matrices of all prims.
+    void evaluate();
+
+    /// \brief Computes the local matrices of all prims without composing
+    ///        their world matrices.
+    void evaluate_locals();
+
+    /// \brief Gets the count of batches of prims with the same operations.
+    std::size_t get_batch_count() const;
+
+    /// \brief Gets the count of prims.
+    std::size_t get_prim_count() const;
+
+    /// \brief Gets a prim's local matrix, which is its operations composed
+    ///        in the order of its "xformOpOrder" attribute.
+    ///
+    /// \param[in] prim The index of a prim.
+    /// \param[out] matrix An array of elements in row-major order.
+    /// \pre \p prim `< get_prim_count()`
+    /// \pre `evaluate()` or `evaluate_locals()` was called.
+    void get_local_matrix(Index const prim, double (&matrix)[MATRIX_SIZE]) const;
+
+    /// \brief Gets the local matrices of all prims.
+    double const* get_local_matrices() const;
+
+    /// \brief Gets the count of operations that were compiled for a prim.
+    ///
+    /// \param[in] prim The index of a prim.
+    /// \pre \p prim `< get_prim_count()`
+    std::size_t get_op_count(Index const prim) const;
+
+    /// \brief Gets whether a prim ignores the transforms of its ancestors
+    ///        because its "xformOpOrder" attribute begins with
+    ///        "!resetXformStack!".
+    ///
+    /// \param[in] prim The index of a prim.
+    /// \pre \p prim `< get_prim_count()`
+    bool get_reset(Index const prim) const;
+
+    /// \brief Gets the count of prims that reset the transform stack.
+    std::size_t get_reset_count() const;
+
+    /// \brief Gets a prim's world matrix, which is its local matrix composed
+    ///        with those of its ancestors.
+    ///
+    /// \param[in] prim The index of a prim.
+    /// \param[out] matrix An array of elements in row-major order.
+    /// \pre \p prim `< get_prim_count()`
+    /// \pre `evaluate()` was called.
+    void get_world_matrix(Index const prim, double (&matrix)[MATRIX_SIZE]) const;
+
+    /// \brief Gets the world matrices of all prims.
+    double const* get_world_matrices() const;
+
+private:
+    /// \brief The prims whose operations have the same types in the same
+    ///        order.
+    struct Batch {
+        /// Rows of `m_ops`.
+        Scene::Span ops;
+        /// Rows of `m_batch_prims`, which are the batch's lanes.
+        Scene::Span prims;
+        /// The first row of `m_operands` so that component `c` of lane `l`
+        /// is at `operands + c * prims.count + l`.
+        std::size_t operands;
+    };
+
+    struct Op {
+        usd::geom::XformOpType type;
+        bool inverse;
+    };
+
+    /// \brief Computes the local matrices of a batch's prims.
+    void evaluate(Batch const& batch);
+
+    std::vector<Batch> m_batches;
+    std::vector<Index> m_batch_prims;
+    /// The values of the operations in degrees, scales and distances.
+    std::vector<double> m_operands;
+    std::vector<Op> m_ops;
+    /// Spans of `m_level_prims` for the prims at each depth below a prim
+    /// without a parent or that resets the transform stack.
+    std::vector<Scene::Span> m_levels;
+    std::vector<Index> m_level_prims;
+    std::vector<Index> m_parents;
+    std::vector<Index> m_prim_batches;
+    std::size_t m_reset_count;
+    std::vector<std::uint8_t> m_resets;
+    std::vector<double> m_locals;
+    std::vector<double> m_worlds;
+    std::vector<double> m_scratch;
+};
+
+inline std::size_t XformProgram::get_batch_count() const {
+    return m_batches.size();
+}
+
+inline std::size_t XformProgram::get_prim_count() const {
+    return m_parents.size();
+}
+
+inline double const* XformProgram::get_local_matrices() const {
+    return m_locals.data();
+}
+
+inline std::size_t XformProgram::get_op_count(Index const prim) const {
+    return m_batches[m_prim_batches[prim]].ops.count;
+}
+
+inline bool XformProgram::get_reset(Index const prim) const {
+    return m_resets[prim];
+}
+
+inline std::size_t XformProgram::get_reset_count() const {
+    return m_reset_count;
+}
+
+inline double const* XformProgram::get_world_matrices() const {
+    return m_worlds.data();
+}
+
+}  // namespace utils
+}  // namespace usdj_am
+}  // namespace cavi
+
+#endif  // CAVI_USDJ_AM_UTILS_XFORM_PROGRAM_HPP
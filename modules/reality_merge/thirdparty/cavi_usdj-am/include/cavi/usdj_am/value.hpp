@@ -94,12 +94,13 @@ struct Value : public std::variant<std::monostate,  // undefined
 
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param item[in] A pointer to a borrowed Automerge item.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
     /// \pre \p item `!= nullptr`
     /// \pre `AMitemValType(` \p item `) ∈ {AM_VAL_TYPE_BOOL, AM_VAL_TYPE_F64, AM_VAL_TYPE_INT, AM_VAL_TYPE_NULL,
     ///                                     AM_VAL_TYPE_OBJ_TYPE, AM_VAL_TYPE_STR, AM_VAL_TYPE_UINT, AM_VAL_TYPE_VOID}`
     /// \throws std::invalid_argument
-    Value(AMdoc const* const document, AMitem const* const item);
+    Value(AMdoc const* const document, AMitem const* const item, AMitems const* const heads = nullptr);
 
     Value(Value const&) = delete;
     Value& operator=(Value const&) = delete;
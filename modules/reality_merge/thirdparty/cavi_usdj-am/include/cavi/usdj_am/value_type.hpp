@@ -32,6 +32,8 @@
 
 #include <cstdint>
 #include <iosfwd>
+#include <optional>
+#include <string_view>
 
 // export enum USDA_ValueType {
 //     ExternalReference = 'externalReference',
@@ -55,6 +57,13 @@ enum class ValueType : std::uint8_t {
     SIZE__ = END__ - BEGIN__
 };
 
+/// \brief Extracts a `ValueType` enum tag from a string view.
+///
+/// \param[in] view A UTF-8 string view.
+/// \returns The `ValueType` enum tag whose serialized form is \p view
+///          or `std::nullopt`.
+std::optional<ValueType> extract_ValueType(std::string_view const& view);
+
 std::istream& operator>>(std::istream& is, ValueType& out);
 
 std::ostream& operator<<(std::ostream& os, ValueType const& in);
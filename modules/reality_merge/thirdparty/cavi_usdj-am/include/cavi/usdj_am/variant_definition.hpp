@@ -67,13 +67,16 @@ public:
 
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param map_object[in] A pointer to a borrowed Automerge map object.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
     /// \pre \p map_object `!= nullptr`
     /// \pre `AMitemValType(` \p map_object `) == AM_VAL_TYPE_OBJ_TYPE`
     /// \pre `AMobjObjType(` \p document `, AMitemObjId(` \p map_object `)) == AM_OBJ_TYPE_MAP`
     /// \pre `AMobjSize(` \p document `, AMitemObjId(` \p map_object `)) == 4`
     /// \throws std::invalid_argument
-    VariantDefinition(AMdoc const* const document, AMitem const* const map_object);
+    VariantDefinition(AMdoc const* const document,
+                      AMitem const* const map_object,
+                      AMitems const* const heads = nullptr);
 
     VariantDefinition(VariantDefinition const&) = default;
 
@@ -111,6 +114,11 @@ private:
     VariantDefinition() = default;
 
     friend class ArrayInputIterator<VariantDefinition>;
+
+    static constexpr Key DEFINITIONS{1, "definitions"};
+    static constexpr Key DESCRIPTOR{2, "descriptor"};
+    static constexpr Key NAME{3, "name"};
+    static constexpr Key TYPE{4, "type"};
 };
 
 constexpr StatementType VariantDefinition::get_type() const {
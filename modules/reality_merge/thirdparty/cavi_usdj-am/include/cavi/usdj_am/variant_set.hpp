@@ -60,13 +60,14 @@ public:
 
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param map_object[in] A pointer to a borrowed Automerge map object.
+    /// \param heads[in] A pointer to borrowed heads of the revision to read or `nullptr` for the current one.
     /// \pre \p document `!= nullptr`
     /// \pre \p map_object `!= nullptr`
     /// \pre `AMitemValType(` \p map_object `) == AM_VAL_TYPE_OBJ_TYPE`
     /// \pre `AMobjObjType(` \p document `, AMitemObjId(` \p map_object `)) == AM_OBJ_TYPE_MAP`
     /// \pre `AMobjSize(` \p document `, AMitemObjId(` \p map_object `)) == 3`
     /// \throws std::invalid_argument
-    VariantSet(AMdoc const* const document, AMitem const* const map_object);
+    VariantSet(AMdoc const* const document, AMitem const* const map_object, AMitems const* const heads = nullptr);
 
     VariantSet(VariantSet const&) = default;
 
@@ -94,6 +95,11 @@ public:
 
     /// \brief Gets the `.type` property.
     constexpr StatementType get_type() const;
+
+private:
+    static constexpr Key DEFINITIONS{1, "definitions"};
+    static constexpr Key NAME{2, "name"};
+    static constexpr Key TYPE{3, "type"};
 };
 
 constexpr StatementType VariantSet::get_type() const {
@@ -27,7 +27,6 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
-#include <sstream>
 #include <stdexcept>
 #include <typeinfo>
 
@@ -45,6 +44,7 @@ extern "C" {
 #include "class_definition.hpp"
 #include "definition.hpp"
 #include "definition_statement.hpp"
+#include "detail/construction.hpp"
 #include "external_reference.hpp"
 #include "object_declaration.hpp"
 #include "object_declaration_list_value.hpp"
@@ -58,15 +58,17 @@ namespace cavi {
 namespace usdj_am {
 
 template <typename T>
-ArrayInputIterator<T>::ArrayInputIterator() : m_document{nullptr} {}
+ArrayInputIterator<T>::ArrayInputIterator() : m_document{nullptr}, m_heads{nullptr} {}
 
 template <typename T>
 ArrayInputIterator<T>::~ArrayInputIterator() {}
 
 template <typename T>
-ArrayInputIterator<T>::ArrayInputIterator(AMdoc const* const document, AMitem const* const list_object)
-    : m_document{document} {
-    std::ostringstream args;
+ArrayInputIterator<T>::ArrayInputIterator(AMdoc const* const document,
+                                          AMitem const* const list_object,
+                                          AMitems const* const heads)
+    : m_document{document}, m_heads{heads} {
+    detail::Arguments args;
     if (!document) {
         args << "document == nullptr, ..., ...";
     } else if (!list_object) {
@@ -76,7 +78,7 @@ ArrayInputIterator<T>::ArrayInputIterator(AMdoc const* const document, AMitem co
         if (val_type != AM_VAL_TYPE_OBJ_TYPE) {
             args << "..., "
                  << "AMitemValType(list_object) == " << AMvalTypeToString(val_type) << ", ...";
-        } else {
+        } else if constexpr (detail::CHECKED_CONSTRUCTION) {
             AMobjType const obj_type = AMobjObjType(document, AMitemObjId(list_object));
             if (obj_type != AM_OBJ_TYPE_LIST) {
                 args << "AMobjObjType(document, AMitemObjId(list_object)) == " << AMobjTypeToString(obj_type)
@@ -84,15 +86,13 @@ ArrayInputIterator<T>::ArrayInputIterator(AMdoc const* const document, AMitem co
             }
         }
     }
-    if (!args.str().empty()) {
-        std::ostringstream what;
-        what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
-        throw std::invalid_argument(what.str());
+    if (!args.empty()) {
+        args.raise(typeid(*this).name(), __func__);
     }
     // Preserve the AMitem storing the list object's ID.
     m_results[OBJ_ID] = ResultPtr{AMitemResult(list_object), AMresultFree};
     // Preserve the AMitems storing the list object's contents.
-    m_results[ITEMS] = ResultPtr{AMobjItems(document, AMitemObjId(list_object), nullptr), AMresultFree};
+    m_results[ITEMS] = ResultPtr{AMobjItems(document, AMitemObjId(list_object), heads), AMresultFree};
     m_items = AMresultItems(m_results[ITEMS].get());
 }
 
@@ -115,7 +115,7 @@ template <typename T>
 T ArrayInputIterator<T>::operator*() {
     AMitem const* const item = (m_items) ? AMitemsNext(&*m_items, 0) : nullptr;
     if (item) {
-        return T{m_document, item};
+        return T{m_document, item, m_heads};
     } else {
         return T{};
     }
@@ -55,12 +55,14 @@ bool operator!=(ArrayInputRange<T> const& lhs, ArrayInputRange<T> const& rhs) {
 }
 
 template <typename T>
-ArrayInputRange<T>::ArrayInputRange(AMdoc const* const document, AMitem const* const list_object)
-    : m_document{document}, m_result{AMitemResult(list_object), AMresultFree} {}
+ArrayInputRange<T>::ArrayInputRange(AMdoc const* const document,
+                                    AMitem const* const list_object,
+                                    AMitems const* const heads)
+    : m_document{document}, m_heads{heads}, m_result{AMitemResult(list_object), AMresultFree} {}
 
 template <typename T>
 ArrayInputIterator<T> ArrayInputRange<T>::begin() const {
-    return ArrayInputIterator<T>{m_document, AMresultItem(m_result.get())};
+    return ArrayInputIterator<T>{m_document, AMresultItem(m_result.get()), m_heads};
 }
 
 template <typename T>
@@ -70,7 +72,7 @@ ArrayInputIterator<T> ArrayInputRange<T>::end() const {
 
 template <typename T>
 std::size_t ArrayInputRange<T>::size() const {
-    return AMobjSize(m_document, get_object_id(), nullptr);
+    return AMobjSize(m_document, get_object_id(), m_heads);
 }
 
 template <typename T>
@@ -78,6 +80,11 @@ inline AMdoc const* ArrayInputRange<T>::get_document() const {
     return m_document;
 }
 
+template <typename T>
+inline AMitems const* ArrayInputRange<T>::get_heads() const {
+    return m_heads;
+}
+
 template <typename T>
 AMobjId const* ArrayInputRange<T>::get_object_id() const {
     return AMitemObjId(AMresultItem(m_result.get()));
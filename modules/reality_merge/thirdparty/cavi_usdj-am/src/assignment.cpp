@@ -28,7 +28,6 @@
 /**************************************************************************/
 
 #include <iostream>
-#include <map>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -43,6 +42,7 @@ extern "C" {
 // local
 #include "assignment.hpp"
 #include "assignment_keyword.hpp"
+#include "detail/enum_string.hpp"
 #include "string_.hpp"
 #include "visitor.hpp"
 
@@ -175,16 +175,18 @@ extern "C" {
 namespace {
 
 using cavi::usdj_am::AssignmentType;
+using cavi::usdj_am::detail::make_enum_table;
 
-static std::map<std::string_view, AssignmentType> const TAGS = {{"assignment", AssignmentType::ASSIGNMENT}};
+static constexpr auto TAGS = make_enum_table<AssignmentType>({{"assignment", AssignmentType::ASSIGNMENT}});
 
 }  // namespace
 
 namespace cavi {
 namespace usdj_am {
 
-Assignment::Assignment(AMdoc const* const document, AMitem const* const map_object) : Node(document, map_object, 4) {
-    check_enum_property("type", AssignmentType::ASSIGNMENT);
+Assignment::Assignment(AMdoc const* const document, AMitem const* const map_object, AMitems const* const heads)
+    : Node(document, map_object, 4, heads) {
+    check_enum_property(TYPE, AssignmentType::ASSIGNMENT);
 }
 
 void Assignment::accept(Visitor& visitor) const& {
@@ -196,38 +198,27 @@ void Assignment::accept(Visitor& visitor) && {
 }
 
 String Assignment::get_identifier() const {
-    return get_object_property<String>("identifier");
+    return get_object_property<String>(IDENTIFIER);
 }
 
 std::optional<AssignmentKeyword> Assignment::get_keyword() const {
-    return get_nullable_enum_property<AssignmentKeyword>("keyword");
+    return get_nullable_enum_property<AssignmentKeyword>(KEYWORD);
 }
 
 Value Assignment::get_value() const {
-    return get_object_property<Value>("value");
+    return get_object_property<Value>(VALUE);
+}
+
+std::optional<AssignmentType> extract_AssignmentType(std::string_view const& view) {
+    return detail::extract_enum_tag<AssignmentType>(TAGS, view);
 }
 
 std::istream& operator>>(std::istream& is, AssignmentType& out) {
-    std::string token;
-    if (is >> token) {
-        auto const match = TAGS.find(token);
-        if (match != TAGS.end()) {
-            out = match->second;
-            return is;
-        }
-    }
-    is.setstate(std::ios::failbit);
-    return is;
+    return detail::operator>><AssignmentType>(is, std::make_pair(std::cref(TAGS), std::ref(out)));
 }
 
 std::ostream& operator<<(std::ostream& os, AssignmentType const& in) {
-    for (auto item : TAGS) {
-        if (item.second == in) {
-            os << item.first;
-            return os;
-        }
-    }
-    os << "???";
+    os << detail::extract_enum_string<AssignmentType>(TAGS, in).value_or("???");
     return os;
 }
 
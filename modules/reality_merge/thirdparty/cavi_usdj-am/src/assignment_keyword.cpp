@@ -28,50 +28,40 @@
 /**************************************************************************/
 
 #include <iostream>
-#include <map>
 #include <string>
 #include <string_view>
 
 // local
 #include "assignment_keyword.hpp"
+#include "detail/enum_string.hpp"
 
 namespace {
 
 using cavi::usdj_am::AssignmentKeyword;
+using cavi::usdj_am::detail::make_enum_table;
 
-static std::map<std::string_view, AssignmentKeyword> const TAGS = {
+static constexpr auto TAGS = make_enum_table<AssignmentKeyword>({
     {"prepend", AssignmentKeyword::PREPEND},
     {"add", AssignmentKeyword::ADD},
     {"append", AssignmentKeyword::APPEND},
     {"delete", AssignmentKeyword::DELETE},
-};
+});
 
 }  // namespace
 
 namespace cavi {
 namespace usdj_am {
 
+std::optional<AssignmentKeyword> extract_AssignmentKeyword(std::string_view const& view) {
+    return detail::extract_enum_tag<AssignmentKeyword>(TAGS, view);
+}
+
 std::istream& operator>>(std::istream& is, AssignmentKeyword& out) {
-    std::string token;
-    if (is >> token) {
-        auto const match = TAGS.find(token);
-        if (match != TAGS.end()) {
-            out = match->second;
-            return is;
-        }
-    }
-    is.setstate(std::ios::failbit);
-    return is;
+    return detail::operator>><AssignmentKeyword>(is, std::make_pair(std::cref(TAGS), std::ref(out)));
 }
 
 std::ostream& operator<<(std::ostream& os, AssignmentKeyword const& in) {
-    for (auto item : TAGS) {
-        if (item.second == in) {
-            os << item.first;
-            return os;
-        }
-    }
-    os << "???";
+    os << detail::extract_enum_string<AssignmentKeyword>(TAGS, in).value_or("???");
     return os;
 }
 
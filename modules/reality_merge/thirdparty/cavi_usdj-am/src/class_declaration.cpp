@@ -27,7 +27,6 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
-#include <sstream>
 #include <stdexcept>
 #include <type_traits>
 #include <typeinfo>
@@ -40,44 +39,45 @@ extern "C" {
 
 // local
 #include "class_declaration.hpp"
+#include "detail/construction.hpp"
 #include "statement_type.hpp"
 #include "visitor.hpp"
 
 namespace cavi {
 namespace usdj_am {
 
-ClassDeclaration::ClassDeclaration(AMdoc const* const document, AMitem const* const map_object) {
+ClassDeclaration::ClassDeclaration(AMdoc const* const document,
+                                   AMitem const* const map_object,
+                                   AMitems const* const heads) {
     using Index = typename std::underlying_type<StatementType>::type;
 
-    std::ostringstream args;
+    detail::Arguments args;
     for (Index index = static_cast<Index>(StatementType::BEGIN__); index != static_cast<Index>(StatementType::END__);
          ++index) {
         try {
             switch (static_cast<StatementType>(index)) {
                 case StatementType::DECLARATION: {
-                    this->emplace<Declaration>(document, map_object);
+                    this->emplace<Declaration>(document, map_object, heads);
                     break;
                 }
                 case StatementType::DEFINITION: {
-                    this->emplace<Definition>(document, map_object);
+                    this->emplace<Definition>(document, map_object, heads);
                     break;
                 }
                 default:
                     continue;
             }
-            args.str("");
+            args.clear();
             break;
         } catch (std::invalid_argument const& thrown) {
-            if (!args.str().empty()) {
+            if (!args.empty()) {
                 args << " | ";
             }
             args << thrown.what();
         }
     }
-    if (!args.str().empty()) {
-        std::ostringstream what;
-        what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
-        throw std::invalid_argument(what.str());
+    if (!args.empty()) {
+        args.raise(typeid(*this).name(), __func__);
     }
 }
 
@@ -36,9 +36,11 @@
 namespace cavi {
 namespace usdj_am {
 
-ClassDefinition::ClassDefinition(AMdoc const* const document, AMitem const* const map_object)
-    : Node(document, map_object, 5) {
-    check_enum_property("type", StatementType::CLASS_DEFINITION);
+ClassDefinition::ClassDefinition(AMdoc const* const document,
+                                 AMitem const* const map_object,
+                                 AMitems const* const heads)
+    : Node(document, map_object, 5, heads) {
+    check_enum_property(TYPE, StatementType::CLASS_DEFINITION);
 }
 
 void ClassDefinition::accept(Visitor& visitor) const& {
@@ -50,19 +52,19 @@ void ClassDefinition::accept(Visitor& visitor) && {
 }
 
 ClassDefinition::ClassDeclarations ClassDefinition::get_class_declarations() const {
-    return get_array_property<ClassDeclarations>("classDeclarations");
+    return get_array_property<ClassDeclarations>(CLASS_DECLARATIONS);
 }
 
 std::optional<Descriptor> ClassDefinition::get_descriptor() const {
-    return get_nullable_object_property<Descriptor>("descriptor");
+    return get_nullable_object_property<Descriptor>(DESCRIPTOR);
 }
 
 std::optional<String> ClassDefinition::get_id() const {
-    return get_nullable_object_property<String>("id");
+    return get_nullable_object_property<String>(ID);
 }
 
 String ClassDefinition::get_name() const {
-    return get_object_property<String>("name");
+    return get_object_property<String>(NAME);
 }
 
 }  // namespace usdj_am
@@ -36,8 +36,9 @@ namespace usdj_am {
 
 Declaration::Declaration() {}
 
-Declaration::Declaration(AMdoc const* const document, AMitem const* const map_object) : Node(document, map_object, 6) {
-    check_enum_property("type", StatementType::DECLARATION);
+Declaration::Declaration(AMdoc const* const document, AMitem const* const map_object, AMitems const* const heads)
+    : Node(document, map_object, 6, heads) {
+    check_enum_property(TYPE, StatementType::DECLARATION);
 }
 
 void Declaration::accept(Visitor& visitor) const& {
@@ -49,23 +50,23 @@ void Declaration::accept(Visitor& visitor) && {
 }
 
 Typename Declaration::get_define_type() const {
-    return get_object_property<String>("defineType");
+    return get_object_property<String>(DEFINE_TYPE);
 }
 
 std::optional<Descriptor> Declaration::get_descriptor() const {
-    return get_nullable_object_property<Descriptor>("descriptor");
+    return get_nullable_object_property<Descriptor>(DESCRIPTOR);
 }
 
 std::optional<DeclarationKeyword> Declaration::get_keyword() const {
-    return get_nullable_enum_property<DeclarationKeyword>("keyword");
+    return get_nullable_enum_property<DeclarationKeyword>(KEYWORD);
 }
 
 String Declaration::get_reference() const {
-    return get_object_property<String>("reference");
+    return get_object_property<String>(REFERENCE);
 }
 
 Value Declaration::get_value() const {
-    return get_object_property<Value>("value");
+    return get_object_property<Value>(VALUE);
 }
 
 }  // namespace usdj_am
@@ -28,49 +28,39 @@
 /**************************************************************************/
 
 #include <iostream>
-#include <map>
 #include <string>
 #include <string_view>
 
 // local
 #include "declaration_keyword.hpp"
+#include "detail/enum_string.hpp"
 
 namespace {
 
 using cavi::usdj_am::DeclarationKeyword;
+using cavi::usdj_am::detail::make_enum_table;
 
-static std::map<std::string_view, DeclarationKeyword> const TAGS = {
+static constexpr auto TAGS = make_enum_table<DeclarationKeyword>({
     {"varying", DeclarationKeyword::VARYING}, {"uniform", DeclarationKeyword::UNIFORM},
     {"custom", DeclarationKeyword::CUSTOM},   {"prepend", DeclarationKeyword::PREPEND},
     {"append", DeclarationKeyword::APPEND},   {"delete", DeclarationKeyword::DELETE},
-    {"add", DeclarationKeyword::ADD}};
+    {"add", DeclarationKeyword::ADD}});
 
 }  // namespace
 
 namespace cavi {
 namespace usdj_am {
 
+std::optional<DeclarationKeyword> extract_DeclarationKeyword(std::string_view const& view) {
+    return detail::extract_enum_tag<DeclarationKeyword>(TAGS, view);
+}
+
 std::istream& operator>>(std::istream& is, DeclarationKeyword& out) {
-    std::string token;
-    if (is >> token) {
-        auto const match = TAGS.find(token);
-        if (match != TAGS.end()) {
-            out = match->second;
-            return is;
-        }
-    }
-    is.setstate(std::ios::failbit);
-    return is;
+    return detail::operator>><DeclarationKeyword>(is, std::make_pair(std::cref(TAGS), std::ref(out)));
 }
 
 std::ostream& operator<<(std::ostream& os, DeclarationKeyword const& in) {
-    for (auto item : TAGS) {
-        if (item.second == in) {
-            os << item.first;
-            return os;
-        }
-    }
-    os << "???";
+    os << detail::extract_enum_string<DeclarationKeyword>(TAGS, in).value_or("???");
     return os;
 }
 
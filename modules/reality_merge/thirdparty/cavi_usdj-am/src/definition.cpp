@@ -37,8 +37,9 @@ namespace usdj_am {
 
 Definition::Definition() {}
 
-Definition::Definition(AMdoc const* const document, AMitem const* const map_object) : Node(document, map_object, 6) {
-    check_enum_property("type", StatementType::DEFINITION);
+Definition::Definition(AMdoc const* const document, AMitem const* const map_object, AMitems const* const heads)
+    : Node(document, map_object, 6, heads) {
+    check_enum_property(TYPE, StatementType::DEFINITION);
 }
 
 void Definition::accept(Visitor& visitor) const& {
@@ -50,23 +51,23 @@ void Definition::accept(Visitor& visitor) && {
 }
 
 std::optional<Typename> Definition::get_def_type() const {
-    return get_nullable_object_property<String>("defType");
+    return get_nullable_object_property<String>(DEF_TYPE);
 }
 
 std::optional<Descriptor> Definition::get_descriptor() const {
-    return get_nullable_object_property<Descriptor>("descriptor");
+    return get_nullable_object_property<Descriptor>(DESCRIPTOR);
 }
 
 String Definition::get_name() const {
-    return get_object_property<String>("name");
+    return get_object_property<String>(NAME);
 }
 
 Definition::Statements Definition::get_statements() const {
-    return get_array_property<Statements>("statements");
+    return get_array_property<Statements>(STATEMENTS);
 }
 
 DefinitionType Definition::get_sub_type() const {
-    return get_enum_property<DefinitionType>("subType");
+    return get_enum_property<DefinitionType>(SUB_TYPE);
 }
 
 }  // namespace usdj_am
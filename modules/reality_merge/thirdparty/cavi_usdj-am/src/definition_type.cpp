@@ -28,46 +28,36 @@
 /**************************************************************************/
 
 #include <iostream>
-#include <map>
 #include <string>
 #include <string_view>
 
 // local
 #include "definition_type.hpp"
+#include "detail/enum_string.hpp"
 
 namespace {
 
 using cavi::usdj_am::DefinitionType;
+using cavi::usdj_am::detail::make_enum_table;
 
-static std::map<std::string_view, DefinitionType> const TAGS = {{"def", DefinitionType::DEF},
-                                                                {"over", DefinitionType::OVER}};
+static constexpr auto TAGS = make_enum_table<DefinitionType>({{"def", DefinitionType::DEF},
+                                                                {"over", DefinitionType::OVER}});
 
 }  // namespace
 
 namespace cavi {
 namespace usdj_am {
 
+std::optional<DefinitionType> extract_DefinitionType(std::string_view const& view) {
+    return detail::extract_enum_tag<DefinitionType>(TAGS, view);
+}
+
 std::istream& operator>>(std::istream& is, DefinitionType& out) {
-    std::string token;
-    if (is >> token) {
-        auto const match = TAGS.find(token);
-        if (match != TAGS.end()) {
-            out = match->second;
-            return is;
-        }
-    }
-    is.setstate(std::ios::failbit);
-    return is;
+    return detail::operator>><DefinitionType>(is, std::make_pair(std::cref(TAGS), std::ref(out)));
 }
 
 std::ostream& operator<<(std::ostream& os, DefinitionType const& in) {
-    for (auto item : TAGS) {
-        if (item.second == in) {
-            os << item.first;
-            return os;
-        }
-    }
-    os << "???";
+    os << detail::extract_enum_string<DefinitionType>(TAGS, in).value_or("???");
     return os;
 }
 
@@ -168,7 +168,8 @@ extern "C" {
 namespace cavi {
 namespace usdj_am {
 
-Descriptor::Descriptor(AMdoc const* const document, AMitem const* const map_object) : Node(document, map_object, 2) {}
+Descriptor::Descriptor(AMdoc const* const document, AMitem const* const map_object, AMitems const* const heads)
+    : Node(document, map_object, 2, heads) {}
 
 void Descriptor::accept(Visitor& visitor) const& {
     visitor.visit(*this);
@@ -179,11 +180,11 @@ void Descriptor::accept(Visitor& visitor) && {
 }
 
 Descriptor::Assignments Descriptor::get_assignments() const {
-    return get_array_property<Assignments>("assignments");
+    return get_array_property<Assignments>(ASSIGNMENTS);
 }
 
 std::optional<String> Descriptor::get_description() const {
-    return get_nullable_object_property<String>("description");
+    return get_nullable_object_property<String>(DESCRIPTION);
 }
 
 }  // namespace usdj_am
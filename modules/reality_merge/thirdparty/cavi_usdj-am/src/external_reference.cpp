@@ -35,9 +35,11 @@
 namespace cavi {
 namespace usdj_am {
 
-ExternalReference::ExternalReference(AMdoc const* const document, AMitem const* const map_object)
-    : Node(document, map_object, 3) {
-    check_enum_property("type", ValueType::EXTERNAL_REFERENCE);
+ExternalReference::ExternalReference(AMdoc const* const document,
+                                     AMitem const* const map_object,
+                                     AMitems const* const heads)
+    : Node(document, map_object, 3, heads) {
+    check_enum_property(TYPE, ValueType::EXTERNAL_REFERENCE);
 }
 
 void ExternalReference::accept(Visitor& visitor) const& {
@@ -49,11 +51,11 @@ void ExternalReference::accept(Visitor& visitor) && {
 }
 
 ReferenceFile ExternalReference::get_reference_file() const {
-    return get_object_property<ReferenceFile>("referenceFile");
+    return get_object_property<ReferenceFile>(REFERENCE_FILE);
 }
 
 std::optional<ExternalReferenceImport> ExternalReference::get_to_import() const {
-    return get_nullable_object_property<ExternalReferenceImport>("toImport");
+    return get_nullable_object_property<ExternalReferenceImport>(TO_IMPORT);
 }
 
 }  // namespace usdj_am
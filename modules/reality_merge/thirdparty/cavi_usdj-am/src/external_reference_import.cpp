@@ -34,9 +34,11 @@
 namespace cavi {
 namespace usdj_am {
 
-ExternalReferenceImport::ExternalReferenceImport(AMdoc const* const document, AMitem const* const map_object)
-    : Node(document, map_object, 3) {
-    check_enum_property("type", ValueType::EXTERNAL_REFERENCE_IMPORT);
+ExternalReferenceImport::ExternalReferenceImport(AMdoc const* const document,
+                                                 AMitem const* const map_object,
+                                                 AMitems const* const heads)
+    : Node(document, map_object, 3, heads) {
+    check_enum_property(TYPE, ValueType::EXTERNAL_REFERENCE_IMPORT);
 }
 
 void ExternalReferenceImport::accept(Visitor& visitor) const& {
@@ -48,11 +50,11 @@ void ExternalReferenceImport::accept(Visitor& visitor) && {
 }
 
 std::optional<String> ExternalReferenceImport::get_field() const {
-    return get_nullable_object_property<String>("field");
+    return get_nullable_object_property<String>(FIELD);
 }
 
 String ExternalReferenceImport::get_import_path() const {
-    return get_object_property<String>("importPath");
+    return get_object_property<String>(IMPORT_PATH);
 }
 
 }  // namespace usdj_am
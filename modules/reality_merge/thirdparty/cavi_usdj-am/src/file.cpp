@@ -38,6 +38,7 @@ extern "C" {
 
 // local
 #include "descriptor.hpp"
+#include "detail/construction.hpp"
 #include "file.hpp"
 #include "statement.hpp"
 #include "visitor.hpp"
@@ -45,10 +46,11 @@ extern "C" {
 namespace cavi {
 namespace usdj_am {
 
-File::File(AMdoc const* const document, AMitem const* const map_object) : Node(document) {
+File::File(AMdoc const* const document, AMitem const* const map_object, AMitems const* const heads)
+    : Node(document, heads) {
     static const std::size_t MAP_SIZE = 3;
 
-    std::ostringstream args;
+    detail::Arguments args;
     if (!document) {
         args << "document == nullptr, ...";
     } else {
@@ -60,27 +62,30 @@ File::File(AMdoc const* const document, AMitem const* const map_object) : Node(d
                      << "AMitemValType(map_object) == " << AMvalTypeToString(val_type);
             } else {
                 obj_id = AMitemObjId(map_object);
-                AMobjType const obj_type = AMobjObjType(document, obj_id);
-                if (obj_type != AM_OBJ_TYPE_MAP) {
-                    args << "AMobjObjType(document, AMitemObjId(map_object)) == " << AMobjTypeToString(obj_type);
+                if constexpr (detail::CHECKED_CONSTRUCTION) {
+                    AMobjType const obj_type = AMobjObjType(document, obj_id);
+                    if (obj_type != AM_OBJ_TYPE_MAP) {
+                        args << "AMobjObjType(document, AMitemObjId(map_object)) == " << AMobjTypeToString(obj_type);
+                    }
                 }
             }
         }
-        if (args.str().empty()) {
-            std::size_t const obj_size = AMobjSize(document, obj_id, nullptr);
-            if (obj_size != MAP_SIZE) {
-                args << "AMobjSize(document, AMitemObjId(map_object), nullptr) == " << obj_size << ", " << MAP_SIZE;
-            } else if (map_object) {
+        if (args.empty()) {
+            if constexpr (detail::CHECKED_CONSTRUCTION) {
+                std::size_t const obj_size = AMobjSize(document, obj_id, heads);
+                if (obj_size != MAP_SIZE) {
+                    args << "AMobjSize(document, AMitemObjId(map_object), heads) == " << obj_size << ", "
+                         << MAP_SIZE;
+                }
+            }
+            if (args.empty() && map_object) {
                 // Preserve the AMitem storing the node's object ID.
-                ResultPtr const result{AMitemResult(map_object), AMresultFree};
-                m_results.insert_or_assign("", result);
+                m_results[SELF] = ResultPtr{AMitemResult(map_object)};
             }
         }
     }
-    if (!args.str().empty()) {
-        std::ostringstream what;
-        what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
-        throw std::invalid_argument(what.str());
+    if (!args.empty()) {
+        args.raise(typeid(*this).name(), __func__);
     }
 }
 
@@ -93,7 +98,7 @@ void File::accept(Visitor& visitor) && {
 }
 
 AMobjId const* File::get_object_id() const {
-    if (m_results.count("")) {
+    if (m_results[SELF]) {
         return Node::get_object_id();
     } else {
         // The map object is the document itself.
@@ -102,15 +107,15 @@ AMobjId const* File::get_object_id() const {
 }
 
 Number File::get_version() const {
-    return get_object_property<Number>("version");
+    return get_object_property<Number>(VERSION);
 }
 
 std::optional<Descriptor> File::get_descriptor() const {
-    return get_nullable_object_property<Descriptor>("descriptor");
+    return get_nullable_object_property<Descriptor>(DESCRIPTOR);
 }
 
 File::Statements File::get_statements() const {
-    return get_array_property<Statements>("statements");
+    return get_array_property<Statements>(STATEMENTS);
 }
 
 }  // namespace usdj_am
@@ -28,6 +28,7 @@
 /**************************************************************************/
 
 #include <cstddef>
+#include <optional>
 #include <stdexcept>
 #include <string_view>
 #include <typeinfo>
@@ -46,6 +47,7 @@ extern "C" {
 #include "definition.hpp"
 #include "definition_type.hpp"
 #include "descriptor.hpp"
+#include "detail/construction.hpp"
 #include "external_reference_import.hpp"
 #include "file.hpp"
 #include "node.hpp"
@@ -60,23 +62,71 @@ extern "C" {
 #include "variant_definition.hpp"
 #include "variant_set.hpp"
 
+namespace {
+
+using cavi::usdj_am::AssignmentKeyword;
+using cavi::usdj_am::AssignmentType;
+using cavi::usdj_am::DeclarationKeyword;
+using cavi::usdj_am::DefinitionType;
+using cavi::usdj_am::StatementType;
+using cavi::usdj_am::ValueType;
+
+/// \brief Extracts an enum tag from a string view without copying it into a
+///        stream.
+template <typename EnumT>
+std::optional<EnumT> extract_enum_tag(std::string_view const& view);
+
+template <>
+std::optional<AssignmentKeyword> extract_enum_tag<AssignmentKeyword>(std::string_view const& view) {
+    return cavi::usdj_am::extract_AssignmentKeyword(view);
+}
+
+template <>
+std::optional<AssignmentType> extract_enum_tag<AssignmentType>(std::string_view const& view) {
+    return cavi::usdj_am::extract_AssignmentType(view);
+}
+
+template <>
+std::optional<DeclarationKeyword> extract_enum_tag<DeclarationKeyword>(std::string_view const& view) {
+    return cavi::usdj_am::extract_DeclarationKeyword(view);
+}
+
+template <>
+std::optional<DefinitionType> extract_enum_tag<DefinitionType>(std::string_view const& view) {
+    return cavi::usdj_am::extract_DefinitionType(view);
+}
+
+template <>
+std::optional<StatementType> extract_enum_tag<StatementType>(std::string_view const& view) {
+    return cavi::usdj_am::extract_StatementType(view);
+}
+
+template <>
+std::optional<ValueType> extract_enum_tag<ValueType>(std::string_view const& view) {
+    return cavi::usdj_am::extract_ValueType(view);
+}
+
+}  // namespace
+
 namespace cavi {
 namespace usdj_am {
 
-Node::Node(AMdoc const* const document) : m_document{document} {
-    std::ostringstream args;
+Node::Node(AMdoc const* const document, AMitems const* const heads) : m_document{document}, m_heads{heads} {
+    detail::Arguments args;
     if (!document) {
         args << "document == nullptr";
     }
-    if (!args.str().empty()) {
-        std::ostringstream what;
-        what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
-        throw std::invalid_argument(what.str());
+    if (!args.empty()) {
+        args.raise(typeid(*this).name(), __func__);
     }
 }
 
-Node::Node(AMdoc const* const document, AMitem const* const map_object, int const map_size) : m_document{document} {
-    std::ostringstream args;
+Node::Node(AMdoc const* const document,
+           AMitem const* const map_object,
+           int const map_size,
+           AMitems const* const heads)
+    : m_document{document}, m_heads{heads} {
+    detail::Arguments args;
     if (!document) {
         args << "document == nullptr, ..., ...";
     } else if (!map_object) {
@@ -84,119 +134,109 @@ Node::Node(AMdoc const* const document, AMitem const* const map_object, int cons
     } else if (!(map_size > 0)) {
         args << "..., ..., map_size == " << map_size;
     } else {
+        // A null property is only told apart by its value type so this check
+        // is never skipped.
         AMvalType const val_type = AMitemValType(map_object);
         if (val_type != AM_VAL_TYPE_OBJ_TYPE) {
             args << "..., "
                  << "AMitemValType(map_object) == " << AMvalTypeToString(val_type) << ", ...";
-        } else {
+        } else if constexpr (detail::CHECKED_CONSTRUCTION) {
             AMobjId const* const obj_id = AMitemObjId(map_object);
             AMobjType const obj_type = AMobjObjType(document, obj_id);
             if (obj_type != AM_OBJ_TYPE_MAP) {
                 args << "AMobjObjType(document, AMitemObjId(map_object)) == " << AMobjTypeToString(obj_type) << ", ...";
             } else {
-                std::size_t const obj_size = AMobjSize(document, obj_id, nullptr);
+                std::size_t const obj_size = AMobjSize(document, obj_id, heads);
                 if (obj_size != map_size) {
-                    args << "AMobjSize(document, AMitemObjId(map_object), nullptr) == " << obj_size << ", " << map_size;
+                    args << "AMobjSize(document, AMitemObjId(map_object), heads) == " << obj_size << ", " << map_size;
                 }
             }
         }
     }
-    if (!args.str().empty()) {
-        std::ostringstream what;
-        what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
-        throw std::invalid_argument(what.str());
+    if (!args.empty()) {
+        args.raise(typeid(*this).name(), __func__);
     }
     // Preserve the AMitem storing the node's object ID.
-    ResultPtr result{AMitemResult(map_object), AMresultFree};
-    m_results.insert_or_assign("", result);
+    m_results[SELF] = ResultPtr{AMitemResult(map_object)};
 }
 
 Node::~Node() {}
 
 template <typename EnumT>
-void Node::check_enum_property(std::string const& key, EnumT const tag) const {
-    std::ostringstream args;
+void Node::check_enum_property(Key const& key, EnumT const tag) const {
+    detail::Arguments args;
     try {
         if (get_enum_property<EnumT>(key) != tag) {
-            args << "AMmapGet(m_document, ..., AMstr(\"" << key << "\"), nullptr) == \""
+            args << "AMmapGet(m_document, ..., AMstr(\"" << key.name << "\"), m_heads) == \""
                  << get_object_property<String>(key) << "\", \"" << tag << "\"";
         }
     } catch (std::invalid_argument const& thrown) {
         args << thrown.what();
     }
     // Free the AMresult because we're finished with it.
-    m_results.erase(key);
-    if (!args.str().empty()) {
-        std::ostringstream what;
-        what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
-        throw std::invalid_argument(what.str());
+    m_results[key.index].reset();
+    if (!args.empty()) {
+        args.raise(typeid(*this).name(), __func__);
     }
 }
 
-void Node::check_string_property(std::string const& key, std::string const& value) const {
-    std::ostringstream args;
+void Node::check_string_property(Key const& key, std::string_view const& value) const {
+    detail::Arguments args;
     try {
         auto const property = get_object_property<String>(key);
         if (property != value) {
-            args << "AMmapGet(m_document, get_object_id, AMstr(\"" << key << "\"), nullptr) == \"" << property
+            args << "AMmapGet(m_document, get_object_id, AMstr(\"" << key.name << "\"), m_heads) == \"" << property
                  << "\", \"" << value << "\"";
         }
     } catch (std::invalid_argument const& thrown) {
         args << thrown.what();
     }
     // Free the AMresult because we're finished with it.
-    m_results.erase(key);
-    if (!args.str().empty()) {
-        std::ostringstream what;
-        what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
-        throw std::invalid_argument(what.str());
+    m_results[key.index].reset();
+    if (!args.empty()) {
+        args.raise(typeid(*this).name(), __func__);
     }
 }
 
 template <typename InputRangeT>
-InputRangeT Node::get_array_property(std::string const& key) const {
-    ResultPtr const result{AMmapGet(m_document, get_object_id(), utils::to_bytes(key), nullptr), AMresultFree};
-    auto [iter, inserted] = m_results.insert_or_assign(key, result);
-    return InputRangeT{m_document, AMresultItem(iter->second.get())};
+InputRangeT Node::get_array_property(Key const& key) const {
+    auto const& result = get_property(key);
+    return InputRangeT{m_document, AMresultItem(result.get()), m_heads};
 }
 
 template <typename EnumT>
-EnumT Node::get_enum_property(std::string const& key) const {
-    ResultPtr const result{AMmapGet(m_document, get_object_id(), utils::to_bytes(key), nullptr), AMresultFree};
-    std::ostringstream args;
+EnumT Node::get_enum_property(Key const& key) const {
+    auto const& result = get_property(key);
+    detail::Arguments args;
     if (!result) {
-        args << "AMmapGet(m_document, ..., AMstr(\"" << key << "\"), nullptr) == nullptr";
+        args << "AMmapGet(m_document, ..., AMstr(\"" << key.name << "\"), m_heads) == nullptr";
     } else {
-        auto [iter, inserted] = m_results.insert_or_assign(key, result);
         try {
-            String string{m_document, AMresultItem(iter->second.get())};
-            EnumT tag;
-            auto const buffer = std::string{string};
-            std::istringstream iss{buffer};
-            if (iss >> tag) {
-                return tag;
+            String string{m_document, AMresultItem(result.get()), m_heads};
+            auto const tag = extract_enum_tag<EnumT>(string);
+            if (tag) {
+                return *tag;
             } else {
-                args << "AMmapGet(m_document, ..., AMstr(\"" << key << "\"), nullptr) == \"" << string << "\"";
+                args << "AMmapGet(m_document, ..., AMstr(\"" << key.name << "\"), m_heads) == \"" << string << "\"";
             }
         } catch (std::invalid_argument const& thrown) {
             args << thrown.what();
         }
     }
-    if (!args.str().empty()) {
-        std::ostringstream what;
-        what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
-        throw std::invalid_argument(what.str());
+    if (!args.empty()) {
+        args.raise(typeid(*this).name(), __func__);
     }
     return EnumT{};
 }
 
 template <typename EnumT>
-std::optional<EnumT> Node::get_nullable_enum_property(std::string const& key) const {
+std::optional<EnumT> Node::get_nullable_enum_property(Key const& key) const {
     std::optional<EnumT> nullable_enum;
     try {
         nullable_enum.emplace(get_enum_property<EnumT>(key));
     } catch (std::invalid_argument const&) {
-        if (AMitemValType(AMresultItem(m_results.at(key).get())) != AM_VAL_TYPE_NULL) {
+        auto const& result = m_results[key.index];
+        if (!result || AMitemValType(AMresultItem(result.get())) != AM_VAL_TYPE_NULL) {
             throw;
         }
     }
@@ -204,12 +244,13 @@ std::optional<EnumT> Node::get_nullable_enum_property(std::string const& key) co
 }
 
 template <typename ObjectT>
-std::optional<ObjectT> Node::get_nullable_object_property(std::string const& key) const {
+std::optional<ObjectT> Node::get_nullable_object_property(Key const& key) const {
     std::optional<ObjectT> nullable_object;
     try {
         nullable_object.emplace(get_object_property<ObjectT>(key));
     } catch (std::invalid_argument const&) {
-        if (AMitemValType(AMresultItem(m_results.at(key).get())) != AM_VAL_TYPE_NULL) {
+        auto const& result = m_results[key.index];
+        if (!result || AMitemValType(AMresultItem(result.get())) != AM_VAL_TYPE_NULL) {
             throw;
         }
     }
@@ -217,82 +258,91 @@ std::optional<ObjectT> Node::get_nullable_object_property(std::string const& key
 }
 
 AMobjId const* Node::get_object_id() const {
-    return AMitemObjId(AMresultItem(m_results.at("").get()));
+    return AMitemObjId(AMresultItem(m_results[SELF].get()));
+}
+
+Node::ResultPtr const& Node::get_property(Key const& key) const {
+    assert(key.index != SELF && key.index < m_results.size());
+    auto& result = m_results[key.index];
+    // Only the first read of a property allocates an `AMresult`.
+    if (!result) {
+        result.reset(AMmapGet(m_document, get_object_id(), utils::to_bytes(key.name), m_heads));
+    }
+    return result;
 }
 
 template <typename ObjectT>
-ObjectT Node::get_object_property(std::string const& key) const {
-    ResultPtr const result{AMmapGet(m_document, get_object_id(), utils::to_bytes(key), nullptr), AMresultFree};
-    auto [iter, inserted] = m_results.insert_or_assign(key, result);
+ObjectT Node::get_object_property(Key const& key) const {
+    auto const& result = get_property(key);
     try {
-        return ObjectT{m_document, AMresultItem(iter->second.get())};
+        return ObjectT{m_document, AMresultItem(result.get()), m_heads};
     } catch (std::invalid_argument const& thrown) {
-        std::ostringstream what;
-        what << typeid(*this).name() << "::" << __func__ << "(" << thrown.what() << ")";
-        throw std::invalid_argument(what.str());
+        detail::Arguments args;
+        args << thrown.what();
+        args.raise(typeid(*this).name(), __func__);
     }
 }
 
 // Node::check_enum_property()
-template void Node::check_enum_property<AssignmentType>(std::string const&, AssignmentType const) const;
+template void Node::check_enum_property<AssignmentType>(Key const&, AssignmentType const) const;
 
-template void Node::check_enum_property<StatementType>(std::string const&, StatementType const) const;
+template void Node::check_enum_property<StatementType>(Key const&, StatementType const) const;
 
-template void Node::check_enum_property<ValueType>(std::string const&, ValueType const) const;
+template void Node::check_enum_property<ValueType>(Key const&, ValueType const) const;
 
 // Node::get_array_property()
 template ClassDefinition::ClassDeclarations Node::get_array_property<ClassDefinition::ClassDeclarations>(
-    std::string const&) const;
+    Key const&) const;
 
-template Definition::Statements Node::get_array_property<Definition::Statements>(std::string const&) const;
+template Definition::Statements Node::get_array_property<Definition::Statements>(Key const&) const;
 
-template Descriptor::Assignments Node::get_array_property<Descriptor::Assignments>(std::string const&) const;
+template Descriptor::Assignments Node::get_array_property<Descriptor::Assignments>(Key const&) const;
 
-template File::Statements Node::get_array_property<File::Statements>(std::string const&) const;
+template File::Statements Node::get_array_property<File::Statements>(Key const&) const;
 
 template ObjectDeclarationEntries::Values Node::get_array_property<ObjectDeclarationEntries::Values>(
-    std::string const&) const;
+    Key const&) const;
 
 template ObjectDeclarationList::Values Node::get_array_property<ObjectDeclarationList::Values>(
-    std::string const&) const;
+    Key const&) const;
 
 template VariantDefinition::Definitions Node::get_array_property<VariantDefinition::Definitions>(
-    std::string const&) const;
+    Key const&) const;
 
 template VariantSet::VariantDefinitions Node::get_array_property<VariantSet::VariantDefinitions>(
-    std::string const&) const;
+    Key const&) const;
 
 // Node::get_enum_property()
-template AssignmentKeyword Node::get_enum_property<AssignmentKeyword>(std::string const&) const;
+template AssignmentKeyword Node::get_enum_property<AssignmentKeyword>(Key const&) const;
 
-template DeclarationKeyword Node::get_enum_property<DeclarationKeyword>(std::string const&) const;
+template DeclarationKeyword Node::get_enum_property<DeclarationKeyword>(Key const&) const;
 
-template DefinitionType Node::get_enum_property<DefinitionType>(std::string const&) const;
+template DefinitionType Node::get_enum_property<DefinitionType>(Key const&) const;
 
 // Node::get_nullable_enum_property()
-template std::optional<AssignmentKeyword> Node::get_nullable_enum_property<AssignmentKeyword>(std::string const&) const;
+template std::optional<AssignmentKeyword> Node::get_nullable_enum_property<AssignmentKeyword>(Key const&) const;
 
 template std::optional<DeclarationKeyword> Node::get_nullable_enum_property<DeclarationKeyword>(
-    std::string const&) const;
+    Key const&) const;
 
 // Node::get_nullable_object_property()
-template std::optional<Descriptor> Node::get_nullable_object_property<Descriptor>(std::string const&) const;
+template std::optional<Descriptor> Node::get_nullable_object_property<Descriptor>(Key const&) const;
 
 template std::optional<ExternalReferenceImport> Node::get_nullable_object_property<ExternalReferenceImport>(
-    std::string const&) const;
+    Key const&) const;
 
-template std::optional<String> Node::get_nullable_object_property<String>(std::string const&) const;
+template std::optional<String> Node::get_nullable_object_property<String>(Key const&) const;
 
 // Node::get_object_property()
-template Number Node::get_object_property<Number>(std::string const&) const;
+template Number Node::get_object_property<Number>(Key const&) const;
 
-template ObjectDeclarations Node::get_object_property<ObjectDeclarations>(std::string const&) const;
+template ObjectDeclarations Node::get_object_property<ObjectDeclarations>(Key const&) const;
 
-template String Node::get_object_property<String>(std::string const&) const;
+template String Node::get_object_property<String>(Key const&) const;
 
-template ReferenceFile Node::get_object_property<ReferenceFile>(std::string const&) const;
+template ReferenceFile Node::get_object_property<ReferenceFile>(Key const&) const;
 
-template Value Node::get_object_property<Value>(std::string const&) const;
+template Value Node::get_object_property<Value>(Key const&) const;
 
 }  // namespace usdj_am
 }  // namespace cavi
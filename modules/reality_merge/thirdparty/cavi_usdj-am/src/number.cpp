@@ -28,7 +28,6 @@
 /**************************************************************************/
 
 #include <ostream>
-#include <sstream>
 #include <stdexcept>
 #include <typeinfo>
 
@@ -40,13 +39,14 @@ extern "C" {
 }
 
 // local
+#include "detail/construction.hpp"
 #include "number.hpp"
 
 namespace cavi {
 namespace usdj_am {
 
-Number::Number(AMdoc const* const document, AMitem const* const item) {
-    std::ostringstream args;
+Number::Number(AMdoc const* const document, AMitem const* const item, [[maybe_unused]] AMitems const* const heads) {
+    detail::Arguments args;
     AMvalType const val_type = AMitemValType(item);
     switch (val_type) {
         case AM_VAL_TYPE_F64: {
@@ -81,10 +81,8 @@ Number::Number(AMdoc const* const document, AMitem const* const item) {
             break;
         }
     }
-    if (!args.str().empty()) {
-        std::ostringstream what;
-        what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
-        throw std::invalid_argument(what.str());
+    if (!args.empty()) {
+        args.raise(typeid(*this).name(), __func__);
     }
 }
 
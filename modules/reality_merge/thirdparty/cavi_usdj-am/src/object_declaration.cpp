@@ -34,8 +34,10 @@
 namespace cavi {
 namespace usdj_am {
 
-ObjectDeclaration::ObjectDeclaration(AMdoc const* const document, AMitem const* const map_object)
-    : Node(document, map_object, 4) {}
+ObjectDeclaration::ObjectDeclaration(AMdoc const* const document,
+                                     AMitem const* const map_object,
+                                     AMitems const* const heads)
+    : Node(document, map_object, 4, heads) {}
 
 void ObjectDeclaration::accept(Visitor& visitor) const& {
     visitor.visit(*this);
@@ -46,19 +48,19 @@ void ObjectDeclaration::accept(Visitor& visitor) && {
 }
 
 TypeReference ObjectDeclaration::get_define_type() const {
-    return get_object_property<String>("defineType");
+    return get_object_property<String>(DEFINE_TYPE);
 }
 
 std::optional<DeclarationKeyword> ObjectDeclaration::get_keyword() const {
-    return get_nullable_enum_property<DeclarationKeyword>("keyword");
+    return get_nullable_enum_property<DeclarationKeyword>(KEYWORD);
 }
 
 Reference ObjectDeclaration::get_reference() const {
-    return get_object_property<String>("reference");
+    return get_object_property<String>(REFERENCE);
 }
 
 Value ObjectDeclaration::get_value() const {
-    return get_object_property<Value>("value");
+    return get_object_property<Value>(VALUE);
 }
 
 }  // namespace usdj_am
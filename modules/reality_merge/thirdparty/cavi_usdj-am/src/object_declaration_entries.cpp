@@ -34,9 +34,11 @@
 namespace cavi {
 namespace usdj_am {
 
-ObjectDeclarationEntries::ObjectDeclarationEntries(AMdoc const* const document, AMitem const* const map_object)
-    : Node(document, map_object, 2) {
-    check_string_property("type", "objectDeclarationEntries");
+ObjectDeclarationEntries::ObjectDeclarationEntries(AMdoc const* const document,
+                                                   AMitem const* const map_object,
+                                                   AMitems const* const heads)
+    : Node(document, map_object, 2, heads) {
+    check_string_property(TYPE, "objectDeclarationEntries");
 }
 
 void ObjectDeclarationEntries::accept(Visitor& visitor) const& {
@@ -48,11 +50,11 @@ void ObjectDeclarationEntries::accept(Visitor& visitor) && {
 }
 
 String ObjectDeclarationEntries::get_type() const {
-    return get_object_property<String>("type");
+    return get_object_property<String>(TYPE);
 }
 
 ObjectDeclarationEntries::Values ObjectDeclarationEntries::get_values() const {
-    return get_array_property<Values>("values");
+    return get_array_property<Values>(VALUES);
 }
 
 }  // namespace usdj_am
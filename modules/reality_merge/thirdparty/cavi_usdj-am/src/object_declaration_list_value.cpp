@@ -34,8 +34,10 @@
 namespace cavi {
 namespace usdj_am {
 
-ObjectDeclarationListValue::ObjectDeclarationListValue(AMdoc const* const document, AMitem const* const map_object)
-    : Node(document, map_object, 2) {}
+ObjectDeclarationListValue::ObjectDeclarationListValue(AMdoc const* const document,
+                                                       AMitem const* const map_object,
+                                                       AMitems const* const heads)
+    : Node(document, map_object, 2, heads) {}
 
 void ObjectDeclarationListValue::accept(Visitor& visitor) const& {
     visitor.visit(*this);
@@ -46,11 +48,11 @@ void ObjectDeclarationListValue::accept(Visitor& visitor) && {
 }
 
 Number ObjectDeclarationListValue::get_index() const {
-    return get_object_property<Number>("index");
+    return get_object_property<Number>(INDEX);
 }
 
 Value ObjectDeclarationListValue::get_value() const {
-    return get_object_property<Value>("value");
+    return get_object_property<Value>(VALUE);
 }
 
 }  // namespace usdj_am
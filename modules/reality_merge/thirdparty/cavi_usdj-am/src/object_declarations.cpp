@@ -28,7 +28,6 @@
 /**************************************************************************/
 
 #include <cstddef>
-#include <sstream>
 #include <stdexcept>
 #include <typeinfo>
 
@@ -39,41 +38,42 @@ extern "C" {
 }
 
 // local
+#include "detail/construction.hpp"
 #include "object_declarations.hpp"
 #include "visitor.hpp"
 
 namespace cavi {
 namespace usdj_am {
 
-ObjectDeclarations::ObjectDeclarations(AMdoc const* const document, AMitem const* const map_object) {
+ObjectDeclarations::ObjectDeclarations(AMdoc const* const document,
+                                       AMitem const* const map_object,
+                                       AMitems const* const heads) {
     enum { BEGIN__, LIST = BEGIN__, ENTRIES, END__, SIZE__ = END__ - BEGIN__ };
 
-    std::ostringstream args;
+    detail::Arguments args;
     for (std::size_t index = BEGIN__; index != END__; ++index) {
         try {
             switch (index) {
                 case LIST: {
-                    this->emplace<ObjectDeclarationList>(document, map_object);
+                    this->emplace<ObjectDeclarationList>(document, map_object, heads);
                     break;
                 }
                 case ENTRIES: {
-                    this->emplace<ObjectDeclarationEntries>(document, map_object);
+                    this->emplace<ObjectDeclarationEntries>(document, map_object, heads);
                     break;
                 }
             }
-            args.str("");
+            args.clear();
             break;
         } catch (std::invalid_argument const& thrown) {
-            if (!args.str().empty()) {
+            if (!args.empty()) {
                 args << " | ";
             }
             args << thrown.what();
         }
     }
-    if (!args.str().empty()) {
-        std::ostringstream what;
-        what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
-        throw std::invalid_argument(what.str());
+    if (!args.empty()) {
+        args.raise(typeid(*this).name(), __func__);
     }
 }
 
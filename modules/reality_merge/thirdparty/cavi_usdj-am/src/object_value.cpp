@@ -34,8 +34,9 @@
 namespace cavi {
 namespace usdj_am {
 
-ObjectValue::ObjectValue(AMdoc const* const document, AMitem const* const map_object) : Node(document, map_object, 2) {
-    check_enum_property("type", ValueType::OBJECT_VALUE);
+ObjectValue::ObjectValue(AMdoc const* const document, AMitem const* const map_object, AMitems const* const heads)
+    : Node(document, map_object, 2, heads) {
+    check_enum_property(TYPE, ValueType::OBJECT_VALUE);
 }
 
 void ObjectValue::accept(Visitor& visitor) const& {
@@ -47,7 +48,7 @@ void ObjectValue::accept(Visitor& visitor) && {
 }
 
 ObjectDeclarations ObjectValue::get_declarations() const {
-    return get_object_property<ObjectDeclarations>("declarations");
+    return get_object_property<ObjectDeclarations>(DECLARATIONS);
 }
 
 }  // namespace usdj_am
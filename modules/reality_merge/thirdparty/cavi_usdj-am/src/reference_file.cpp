@@ -35,9 +35,9 @@
 namespace cavi {
 namespace usdj_am {
 
-ReferenceFile::ReferenceFile(AMdoc const* const document, AMitem const* const map_object)
-    : Node(document, map_object, 3) {
-    check_enum_property("type", ValueType::EXTERNAL_REFERENCE_SRC);
+ReferenceFile::ReferenceFile(AMdoc const* const document, AMitem const* const map_object, AMitems const* const heads)
+    : Node(document, map_object, 3, heads) {
+    check_enum_property(TYPE, ValueType::EXTERNAL_REFERENCE_SRC);
 }
 
 void ReferenceFile::accept(Visitor& visitor) const& {
@@ -49,11 +49,11 @@ void ReferenceFile::accept(Visitor& visitor) && {
 }
 
 std::optional<Descriptor> ReferenceFile::get_descriptor() const {
-    return get_nullable_object_property<Descriptor>("descriptor");
+    return get_nullable_object_property<Descriptor>(DESCRIPTOR);
 }
 
 String ReferenceFile::get_src() const {
-    return get_object_property<String>("src");
+    return get_object_property<String>(SRC);
 }
 
 }  // namespace usdj_am
@@ -28,7 +28,6 @@
 /**************************************************************************/
 
 #include <functional>
-#include <sstream>
 #include <stdexcept>
 #include <type_traits>
 #include <typeinfo>
@@ -41,6 +40,7 @@ extern "C" {
 }
 
 // local
+#include "detail/construction.hpp"
 #include "statement.hpp"
 #include "statement_type.hpp"
 #include "visitor.hpp"
@@ -48,42 +48,40 @@ extern "C" {
 namespace cavi {
 namespace usdj_am {
 
-Statement::Statement(AMdoc const* const document, AMitem const* const map_object) {
+Statement::Statement(AMdoc const* const document, AMitem const* const map_object, AMitems const* const heads) {
     using Index = typename std::underlying_type<StatementType>::type;
 
-    std::ostringstream args;
+    detail::Arguments args;
     for (Index index = static_cast<Index>(StatementType::BEGIN__); index != static_cast<Index>(StatementType::END__);
          ++index) {
         try {
             switch (static_cast<StatementType>(index)) {
                 case StatementType::CLASS_DEFINITION: {
-                    this->emplace<ClassDefinition>(document, map_object);
+                    this->emplace<ClassDefinition>(document, map_object, heads);
                     break;
                 }
                 case StatementType::DEFINITION: {
-                    this->emplace<Definition>(document, map_object);
+                    this->emplace<Definition>(document, map_object, heads);
                     break;
                 }
                 case StatementType::VARIANT_SET: {
-                    this->emplace<VariantSet>(document, map_object);
+                    this->emplace<VariantSet>(document, map_object, heads);
                     break;
                 }
                 default:
                     continue;
             }
-            args.str("");
+            args.clear();
             break;
         } catch (std::invalid_argument const& thrown) {
-            if (!args.str().empty()) {
+            if (!args.empty()) {
                 args << " | ";
             }
             args << thrown.what();
         }
     }
-    if (!args.str().empty()) {
-        std::ostringstream what;
-        what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
-        throw std::invalid_argument(what.str());
+    if (!args.empty()) {
+        args.raise(typeid(*this).name(), __func__);
     }
 }
 
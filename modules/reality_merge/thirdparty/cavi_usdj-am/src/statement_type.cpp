@@ -28,49 +28,39 @@
 /**************************************************************************/
 
 #include <iostream>
-#include <map>
 #include <string>
 #include <string_view>
 
 // local
+#include "detail/enum_string.hpp"
 #include "statement_type.hpp"
 
 namespace {
 
 using cavi::usdj_am::StatementType;
+using cavi::usdj_am::detail::make_enum_table;
 
-static std::map<std::string_view, StatementType> const TAGS = {
+static constexpr auto TAGS = make_enum_table<StatementType>({
     {"declaration", StatementType::DECLARATION}, {"classDefinition", StatementType::CLASS_DEFINITION},
     {"definition", StatementType::DEFINITION},   {"variantSet", StatementType::VARIANT_SET},
     {"variantDef", StatementType::VARIANT_DEF},
-};
+});
 
 }  // namespace
 
 namespace cavi {
 namespace usdj_am {
 
+std::optional<StatementType> extract_StatementType(std::string_view const& view) {
+    return detail::extract_enum_tag<StatementType>(TAGS, view);
+}
+
 std::istream& operator>>(std::istream& is, StatementType& out) {
-    std::string token;
-    if (is >> token) {
-        auto const match = TAGS.find(token);
-        if (match != TAGS.end()) {
-            out = match->second;
-            return is;
-        }
-    }
-    is.setstate(std::ios::failbit);
-    return is;
+    return detail::operator>><StatementType>(is, std::make_pair(std::cref(TAGS), std::ref(out)));
 }
 
 std::ostream& operator<<(std::ostream& os, StatementType const& in) {
-    for (auto item : TAGS) {
-        if (item.second == in) {
-            os << item.first;
-            return os;
-        }
-    }
-    os << "???";
+    os << detail::extract_enum_string<StatementType>(TAGS, in).value_or("???");
     return os;
 }
 
@@ -28,7 +28,6 @@
 /**************************************************************************/
 
 #include <cassert>
-#include <sstream>
 #include <stdexcept>
 #include <typeinfo>
 
@@ -40,13 +39,15 @@ extern "C" {
 }
 
 // local
+#include "detail/construction.hpp"
 #include "string_.hpp"
 
 namespace cavi {
 namespace usdj_am {
 
-String::String(AMdoc const* const document, AMitem const* const item) : m_document{document} {
-    std::ostringstream args;
+String::String(AMdoc const* const document, AMitem const* const item, AMitems const* const heads)
+    : m_document{document} {
+    detail::Arguments args;
     if (!document) {
         args << "document == nullptr, ...";
     } else if (!item) {
@@ -56,12 +57,14 @@ String::String(AMdoc const* const document, AMitem const* const item) : m_docume
         switch (val_type) {
             case AM_VAL_TYPE_OBJ_TYPE: {
                 AMobjId const* const obj_id = AMitemObjId(item);
-                AMobjType const obj_type = AMobjObjType(document, obj_id);
+                // A trusted object is assumed to be a text object.
+                AMobjType const obj_type =
+                    detail::CHECKED_CONSTRUCTION ? AMobjObjType(document, obj_id) : AM_OBJ_TYPE_TEXT;
                 if (obj_type == AM_OBJ_TYPE_TEXT) {
                     // Preserve the AMitem storing the text object's ID.
                     m_results[OBJ_ID] = ResultPtr{AMitemResult(item), AMresultFree};
                     // Preserve the AMitem storing the text object's contents.
-                    m_results[ITEM] = ResultPtr{AMtext(m_document, obj_id, nullptr), AMresultFree};
+                    m_results[ITEM] = ResultPtr{AMtext(m_document, obj_id, heads), AMresultFree};
                 } else {
                     args << "AMobjObjType(document, AMitemObjId(item)) == " << AMobjTypeToString(obj_type);
                 }
@@ -78,10 +81,8 @@ String::String(AMdoc const* const document, AMitem const* const item) : m_docume
             }
         }
     }
-    if (!args.str().empty()) {
-        std::ostringstream what;
-        what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
-        throw std::invalid_argument(what.str());
+    if (!args.empty()) {
+        args.raise(typeid(*this).name(), __func__);
     }
 }
 
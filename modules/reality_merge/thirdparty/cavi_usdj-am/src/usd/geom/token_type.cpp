@@ -27,7 +27,6 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
-#include <map>
 #include <ostream>
 #include <sstream>
 #include <stdexcept>
@@ -39,8 +38,9 @@
 namespace {
 
 using cavi::usdj_am::usd::geom::TokenType;
+using cavi::usdj_am::detail::make_enum_table;
 
-static std::map<std::string_view, TokenType> const TAGS = {
+static constexpr auto TAGS = make_enum_table<TokenType>({
     {"accelerations", TokenType::ACCELERATIONS},
     {"all", TokenType::ALL},
     {"angularVelocities", TokenType::ANGULAR_VELOCITIES},
@@ -228,7 +228,7 @@ static std::map<std::string_view, TokenType> const TAGS = {
     {"VisibilityAPI", TokenType::VISIBILITY_API},
     {"Xform", TokenType::XFORM},
     {"Xformable", TokenType::XFORMABLE},
-    {"XformCommonAPI", TokenType::XFORM_COMMON_API}};
+    {"XformCommonAPI", TokenType::XFORM_COMMON_API}});
 
 }  // namespace
 
@@ -27,7 +27,6 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
-#include <map>
 #include <ostream>
 #include <sstream>
 #include <stdexcept>
@@ -39,15 +38,16 @@
 namespace {
 
 using cavi::usdj_am::usd::geom::XformOpType;
+using cavi::usdj_am::detail::make_enum_table;
 
-static std::map<std::string_view, XformOpType> const TAGS = {
+static constexpr auto TAGS = make_enum_table<XformOpType>({
     {"xformOp:translate", XformOpType::TRANSLATE},  {"xformOp:scale", XformOpType::SCALE},
     {"xformOp:rotateX", XformOpType::ROTATE_X},     {"xformOp:rotateY", XformOpType::ROTATE_Y},
     {"xformOp:rotateZ", XformOpType::ROTATE_Z},     {"xformOp:rotateXYZ", XformOpType::ROTATE_XYZ},
     {"xformOp:rotateXZY", XformOpType::ROTATE_XZY}, {"xformOp:rotateYXZ", XformOpType::ROTATE_YXZ},
     {"xformOp:rotateYZX", XformOpType::ROTATE_YZX}, {"xformOp:rotateZXY", XformOpType::ROTATE_ZXY},
     {"xformOp:rotateZYX", XformOpType::ROTATE_ZYX}, {"xformOp:orient", XformOpType::ORIENT},
-    {"xformOp:transform", XformOpType::TRANSFORM},  {"!resetXformStack!", XformOpType::RESET_XFORM_STACK}};
+    {"xformOp:transform", XformOpType::TRANSFORM},  {"!resetXformStack!", XformOpType::RESET_XFORM_STACK}});
 
 }  // namespace
 
@@ -27,7 +27,6 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
-#include <map>
 #include <ostream>
 #include <sstream>
 #include <stdexcept>
@@ -40,8 +39,9 @@
 namespace {
 
 using cavi::usdj_am::usd::physics::TokenType;
+using cavi::usdj_am::detail::make_enum_table;
 
-static std::map<std::string_view, TokenType> const TAGS = {
+static constexpr auto TAGS = make_enum_table<TokenType>({
     {"acceleration", TokenType::ACCELERATION},
     {"angular", TokenType::ANGULAR},
     {"boundingCube", TokenType::BOUNDING_CUBE},
@@ -131,7 +131,7 @@ static std::map<std::string_view, TokenType> const TAGS = {
     {"PhysicsRevoluteJoint", TokenType::PHYSICS_REVOLUTE_JOINT},
     {"PhysicsRigidBodyAPI", TokenType::PHYSICS_RIGIDBODY_API},
     {"PhysicsScene", TokenType::PHYSICS_SCENE},
-    {"PhysicsSphericalJoint", TokenType::PHYSICS_SPHERICAL_JOINT}};
+    {"PhysicsSphericalJoint", TokenType::PHYSICS_SPHERICAL_JOINT}});
 
 }  // namespace
 
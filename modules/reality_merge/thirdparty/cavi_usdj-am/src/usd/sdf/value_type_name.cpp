@@ -27,7 +27,6 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
-#include <map>
 #include <ostream>
 #include <sstream>
 #include <stdexcept>
@@ -39,8 +38,9 @@
 namespace {
 
 using cavi::usdj_am::usd::sdf::ValueTypeName;
+using cavi::usdj_am::detail::make_enum_table;
 
-static std::map<std::string_view, ValueTypeName> const TAGS = {
+static constexpr auto TAGS = make_enum_table<ValueTypeName>({
     {"bool", ValueTypeName::BOOL},
     {"uchar", ValueTypeName::UCHAR},
     {"int", ValueTypeName::INT},
@@ -149,7 +149,7 @@ static std::map<std::string_view, ValueTypeName> const TAGS = {
     {"texCoord3h[]", ValueTypeName::TEX_COORD_3H_ARRAY},
     {"texCoord3f[]", ValueTypeName::TEX_COORD_3F_ARRAY},
     {"texCoord3d[]", ValueTypeName::TEX_COORD_3D_ARRAY},
-};
+});
 
 }  // namespace
 
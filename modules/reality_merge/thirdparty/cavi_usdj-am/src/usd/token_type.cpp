@@ -27,7 +27,6 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
-#include <map>
 #include <ostream>
 #include <sstream>
 #include <stdexcept>
@@ -40,8 +39,9 @@
 namespace {
 
 using cavi::usdj_am::usd::TokenType;
+using cavi::usdj_am::detail::make_enum_table;
 
-static std::map<std::string_view, TokenType> const TAGS = {
+static constexpr auto TAGS = make_enum_table<TokenType>({
     {"apiSchemas", TokenType::API_SCHEMAS},
     {"clips", TokenType::CLIPS},
     {"clipSets", TokenType::CLIP_SETS},
@@ -61,7 +61,7 @@ static std::map<std::string_view, TokenType> const TAGS = {
     {"CollectionAPI", TokenType::COLLECTION_API},
     {"ModelAPI", TokenType::MODEL_API},
     {"Typed", TokenType::TYPED},
-};
+});
 
 }  // namespace
 
@@ -27,12 +27,15 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <fstream>
-#include <limits>
 #include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <typeinfo>
+#include <variant>
 #include <vector>
 
 // third-party
@@ -45,11 +48,37 @@ extern "C" {
 // local
 #include "utils/bytes.hpp"
 #include "utils/document.hpp"
+#include "utils/document_path.hpp"
 
 namespace {
 
 using ::cavi::usdj_am::utils::Document;
 
+/// \brief The bytes that every chunk of an Automerge file starts with.
+constexpr std::array<std::uint8_t, 4> CHUNK_MAGIC_BYTES = {0x85, 0x6f, 0x4a, 0x83};
+
+/// \brief The size of a chunk's magic bytes, checksum and type, which
+///        precede the LEB128-encoded size of its contents.
+constexpr std::size_t CHUNK_PREFIX_SIZE = 9;
+
+/// \returns The size of the chunk at the start of \p src or `0` if it's
+///          incomplete.
+std::size_t get_chunk_size(std::uint8_t const* const src, std::size_t const count) {
+    if (count < CHUNK_PREFIX_SIZE || !std::equal(CHUNK_MAGIC_BYTES.begin(), CHUNK_MAGIC_BYTES.end(), src)) {
+        return 0;
+    }
+    std::uint64_t contents_size = 0;
+    std::size_t pos = CHUNK_PREFIX_SIZE;
+    for (unsigned shift = 0; pos < count && shift < 64; shift += 7) {
+        auto const byte = src[pos++];
+        contents_size |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return (contents_size <= count - pos) ? pos + contents_size : 0;
+        }
+    }
+    return 0;
+}
+
 void throw_on_error(std::string const& func_name, std::string const& args_msg) {
     if (!args_msg.empty()) {
         std::ostringstream what;
@@ -74,6 +103,35 @@ Document Document::load(std::uint8_t const* const src, std::size_t const count)
     return Document(std::move(result));
 }
 
+Document Document::load(std::uint8_t const* const src, std::size_t const count, std::size_t& loaded_count) {
+    ResultPtr result{AMload(src, count), AMresultFree};
+    if (AMresultStatus(result.get()) == AM_STATUS_OK) {
+        loaded_count = count;
+        return Document(std::move(result));
+    }
+    // A file's chunks are self-delimiting so they can be loaded one at a time
+    // until one is incomplete.
+    loaded_count = get_chunk_size(src, count);
+    if (!loaded_count) {
+        std::ostringstream args;
+        args << "get_chunk_size(src, count) == 0";
+        throw_on_error(__func__, args.str());
+    }
+    auto document = load(src, loaded_count);
+    while (loaded_count < count) {
+        auto const chunk_size = get_chunk_size(src + loaded_count, count - loaded_count);
+        if (!chunk_size) {
+            break;
+        }
+        ResultPtr const chunk_result{AMloadIncremental(document, src + loaded_count, chunk_size), AMresultFree};
+        if (AMresultStatus(chunk_result.get()) != AM_STATUS_OK) {
+            break;
+        }
+        loaded_count += chunk_size;
+    }
+    return document;
+}
+
 Document Document::load(std::filesystem::path const& filename) {
     ResultPtr result{nullptr, AMresultFree};
     std::ostringstream args;
@@ -117,36 +175,24 @@ Document::Document(ResultPtr&& result) : m_document{nullptr}, m_result{std::move
     throw_on_error(__func__, args.str());
 }
 
-Item Document::get_item(std::string const& posix_path) const {
-    namespace fs = std::filesystem;
+Document::ResultPtr Document::get_heads() const {
+    std::ostringstream args;
+    ResultPtr result{AMgetHeads(m_document), AMresultFree};
+    if (AMresultStatus(result.get()) != AM_STATUS_OK) {
+        args << "AMresultError(AMgetHeads(...)) == \"" << from_bytes(AMresultError(result.get())) << "\"";
+    }
+    throw_on_error(__func__, args.str());
+    return result;
+}
 
+Item Document::get_item(std::string const& posix_path, AMitems const* const heads) const {
     std::ostringstream args;
     std::optional<Item> item;
-    std::istringstream iss;
     try {
-        auto path = fs::path{posix_path, fs::path::format::generic_format};
-        std::size_t count = 0;
-        for (auto const& element : path) {
-            if (!count++) {
-                if (!element.has_root_directory()) {
-                    args << typeid(path).name() << "{posix_path}.has_root_directory() == " << std::boolalpha << false
-                         << std::noboolalpha;
-                    break;
-                } else {
-                    item.emplace(std::move(get_item()));
-                }
-            } else {
-                std::istringstream iss{element.string()};
-                auto pos = std::numeric_limits<std::uint64_t>::max();
-                if (iss >> pos) {
-                    item.emplace(*item / pos);
-                } else {
-                    item.emplace(*item / iss.str());
-                }
-            }
-        }
-        if (!item) {
-            args << "posix_path == \"\"";
+        auto const path = DocumentPath{posix_path};
+        item.emplace(get_item(heads));
+        for (auto const& element : path.get_elements()) {
+            std::visit([&item](auto const& index) { item.emplace(*item / index); }, element);
         }
     } catch (std::exception const& thrown) {
         args << thrown.what();
@@ -189,6 +235,57 @@ std::size_t Document::save(std::filesystem::path const& filename) const {
     return count;
 }
 
+std::size_t Document::save_incremental(std::filesystem::path const& filename, ResultPtr const& heads) const {
+    std::ostringstream args;
+    std::size_t count = 0;
+    if (!heads) {
+        args << "heads.get() == nullptr";
+        throw_on_error(__func__, args.str());
+    }
+    // Unlike `AMsaveIncremental()`, this doesn't depend upon which `AMdoc`
+    // struct was saved last so it also works for forks of it.
+    AMitems const have_deps = AMresultItems(heads.get());
+    ResultPtr const result{AMgetChanges(m_document, &have_deps), AMresultFree};
+    if (AMresultStatus(result.get()) != AM_STATUS_OK) {
+        args << "AMresultError(AMgetChanges(...)) == \"" << from_bytes(AMresultError(result.get())) << "\"";
+    } else {
+        AMitems changes = AMresultItems(result.get());
+        if (!AMitemsSize(&changes)) {
+            // There's nothing to append.
+            return count;
+        }
+        std::ofstream ofs{filename, std::ios::binary | std::ios::out | std::ios::app};
+        if (!ofs.is_open()) {
+            args << typeid(decltype(ofs)).name() << "{" << filename << ", ...}.is_open() == " << std::boolalpha
+                 << false << std::noboolalpha;
+        } else {
+            // A change's raw bytes are a chunk that can follow a document's.
+            AMitem* item = nullptr;
+            while ((item = AMitemsNext(&changes, 1)) != nullptr) {
+                AMchange* change = nullptr;
+                if (!AMitemToChange(item, &change)) {
+                    args << "AMitemToChange(..., ...) == " << std::boolalpha << false << std::noboolalpha;
+                    break;
+                }
+                AMbyteSpan const bytes = AMchangeRawBytes(change);
+                ofs.write(reinterpret_cast<decltype(ofs)::char_type const*>(bytes.src), bytes.count);
+                if (!ofs.good()) {
+                    auto const fmtflags = args.flags();
+                    args << typeid(decltype(ofs)).name() << "{" << filename << ", ...}.write(" << std::showbase
+                         << std::hex << bytes.src << ", " << std::dec << bytes.count << ").good() == " << std::boolalpha
+                         << false;
+                    args.setf(fmtflags);
+                    break;
+                }
+                count += bytes.count;
+            }
+            ofs.close();
+        }
+    }
+    throw_on_error(__func__, args.str());
+    return count;
+}
+
 bool operator==(Document const& lhs, Document const& rhs) {
     /// \note `AMequal(nullptr, nullptr) == false`
     return (lhs.m_document == rhs.m_document) || AMequal(lhs.m_document, rhs.m_document);
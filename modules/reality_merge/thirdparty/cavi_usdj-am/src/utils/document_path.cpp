@@ -0,0 +1,156 @@
+/**************************************************************************/
+/* document_path.cpp                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include <charconv>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <typeinfo>
+
+// third-party
+extern "C" {
+
+#include <automerge-c/automerge.h>
+#include <automerge-c/utils/enum_string.h>
+}
+
+// local
+#include "utils/bytes.hpp"
+#include "utils/document_path.hpp"
+
+namespace {
+
+using ::cavi::usdj_am::utils::DocumentPath;
+
+void throw_on_error(std::string const& func_name, std::string const& args_msg) {
+    if (!args_msg.empty()) {
+        std::ostringstream what;
+        what << typeid(DocumentPath).name() << "::" << func_name << "(" << args_msg << ")";
+        throw std::invalid_argument(what.str());
+    }
+}
+
+}  // namespace
+
+namespace cavi {
+namespace usdj_am {
+namespace utils {
+
+DocumentPath::DocumentPath(std::string_view const posix_path)
+    : m_posix_path{posix_path} {
+    std::ostringstream args;
+    if (posix_path.empty()) {
+        args << "posix_path == \"\"";
+    } else if (posix_path.front() != '/') {
+        args << "posix_path == \"" << posix_path << "\"";
+    } else {
+        std::size_t first = 1;
+        while (first < posix_path.size()) {
+            auto last = posix_path.find('/', first);
+            if (last == std::string_view::npos) {
+                last = posix_path.size();
+            }
+            // Consecutive separators are equivalent to a single one.
+            if (last != first) {
+                auto const element = posix_path.substr(first, last - first);
+                auto pos = std::uint64_t{};
+                auto const [ptr, ec] = std::from_chars(element.data(), element.data() + element.size(), pos);
+                if (ec == std::errc{} && ptr == element.data() + element.size()) {
+                    m_elements.emplace_back(pos);
+                } else {
+                    m_elements.emplace_back(std::string{element});
+                }
+            }
+            first = last + 1;
+        }
+    }
+    throw_on_error(__func__, args.str());
+}
+
+Item DocumentPath::resolve(Document const& document) const {
+    AMdoc* const c_document = document;
+    auto heads = document.get_heads();
+    // The object IDs within the chain are the same within any document that
+    // has the same heads.
+    if (m_heads && m_chain.size() == m_elements.size()) {
+        AMitems const cached_heads = AMresultItems(m_heads->get());
+        AMitems const current_heads = AMresultItems(heads.get());
+        if (AMitemsEqual(&cached_heads, &current_heads)) {
+            Item item{c_document};
+            item.m_results = m_chain;
+            return item;
+        }
+    }
+    // The cache is per heads so the whole chain is stale now.
+    m_heads.reset();
+    m_chain.clear();
+    std::ostringstream args;
+    AMobjId const* obj_id = AM_ROOT;
+    for (auto const& element : m_elements) {
+        if (!m_chain.empty()) {
+            AMitem const* const parent = AMresultItem(m_chain.back().get());
+            if (AMitemValType(parent) != AM_VAL_TYPE_OBJ_TYPE) {
+                args << "AMitemValType(...) == " << AMvalTypeToString(AMitemValType(parent)) << " @ \""
+                     << m_posix_path << "\"";
+                break;
+            }
+            obj_id = AMitemObjId(parent);
+        }
+        ResultPtr result{std::visit(
+                             [c_document, obj_id](auto const& index) -> AMresult* {
+                                 using T = std::decay_t<decltype(index)>;
+                                 if constexpr (std::is_same_v<T, std::string>) {
+                                     return AMmapGet(c_document, obj_id, to_bytes(index), nullptr);
+                                 } else {
+                                     return AMlistGet(c_document, obj_id, index, nullptr);
+                                 }
+                             },
+                             element),
+                         AMresultFree};
+        if (AMresultStatus(result.get()) != AM_STATUS_OK) {
+            args << "AMresultError(...) == \"" << from_bytes(AMresultError(result.get())) << "\" @ \"" << m_posix_path
+                 << "\"";
+            break;
+        }
+        m_chain.push_back(std::move(result));
+    }
+    if (!args.str().empty()) {
+        m_chain.clear();
+        throw_on_error(__func__, args.str());
+    }
+    m_heads.emplace(std::move(heads));
+    Item item{c_document};
+    item.m_results = m_chain;
+    return item;
+}
+
+}  // namespace utils
+}  // namespace usdj_am
+}  // namespace cavi
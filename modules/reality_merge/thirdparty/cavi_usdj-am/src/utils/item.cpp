@@ -49,7 +49,7 @@ namespace cavi {
 namespace usdj_am {
 namespace utils {
 
-Item::Item(AMdoc const* const document) : m_document{document} {
+Item::Item(AMdoc const* const document, AMitems const* const heads) : m_document{document}, m_heads{heads} {
     if (!document) {
         std::ostringstream what;
         what << typeid(*this).name() << "::" << __func__ << "(document == nullptr)";
@@ -90,7 +90,7 @@ Item operator/(Item const& lhs, std::string const& key) {
             args << "AMobjObjType(..., AMitemObjId(" << lhs << ")) == " << AMobjTypeToString(obj_type) << ", ...";
         } else {
             if (args.str().empty()) {
-                Item::ResultPtr result{AMmapGet(lhs.m_document, obj_id, to_bytes(key), nullptr), AMresultFree};
+                Item::ResultPtr result{AMmapGet(lhs.m_document, obj_id, to_bytes(key), lhs.m_heads), AMresultFree};
                 if (AMresultStatus(result.get()) != AM_STATUS_OK) {
                     args << "AMresultError(AMmapGet(..., AMitemObjId(" << lhs << "), \"" << key << "\", nullptr)) == \""
                          << from_bytes(AMresultError(result.get())) << "\"";
@@ -128,7 +128,7 @@ Item operator/(Item const& lhs, std::uint64_t const pos) {
         }
     }
     if (args.str().empty()) {
-        Item::ResultPtr result{AMlistGet(lhs.m_document, obj_id, pos, nullptr), AMresultFree};
+        Item::ResultPtr result{AMlistGet(lhs.m_document, obj_id, pos, lhs.m_heads), AMresultFree};
         if (AMresultStatus(lhs.m_results.back().get()) != AM_STATUS_OK) {
             args << "AMresultError(AMlistGet(..., AMitemObjId(" << lhs << "), " << pos << ", nullptr)) == \""
                  << from_bytes(AMresultError(result.get())) << "\"";
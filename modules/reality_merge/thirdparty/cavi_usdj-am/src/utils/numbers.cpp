@@ -0,0 +1,206 @@
+/**************************************************************************/
+/* numbers.cpp                                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <typeinfo>
+
+// third-party
+extern "C" {
+
+#include <automerge-c/automerge.h>
+#include <automerge-c/utils/enum_string.h>
+}
+
+// local
+#include "utils/bytes.hpp"
+#include "utils/numbers.hpp"
+
+namespace {
+
+using ResultPtr = std::unique_ptr<AMresult, void (*)(AMresult*)>;
+
+/// \brief Converts an item into a number of the given type.
+///
+/// \returns `false` if \p item isn't a number.
+template <typename NumberT>
+bool to_number(AMitem const* const item, NumberT& number) {
+    switch (AMitemValType(item)) {
+        case AM_VAL_TYPE_F64: {
+            double f64;
+            if (AMitemToF64(item, &f64)) {
+                number = static_cast<NumberT>(f64);
+                return true;
+            }
+            break;
+        }
+        case AM_VAL_TYPE_INT: {
+            std::int64_t int_;
+            if (AMitemToInt(item, &int_)) {
+                number = static_cast<NumberT>(int_);
+                return true;
+            }
+            break;
+        }
+        case AM_VAL_TYPE_UINT: {
+            std::uint64_t uint;
+            if (AMitemToUint(item, &uint)) {
+                number = static_cast<NumberT>(uint);
+                return true;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return false;
+}
+
+/// \brief Reads the numbers in a list object into a buffer.
+///
+/// \param[out] size The count of items in the list object.
+/// \param[out] args The description of an item that isn't a number.
+/// \returns The count of numbers written.
+template <typename NumberT>
+std::size_t read_list(AMdoc const* const document,
+                      AMobjId const* const obj_id,
+                      AMitems const* const heads,
+                      NumberT* const first,
+                      std::size_t const count,
+                      std::size_t& size,
+                      std::ostringstream& args) {
+    ResultPtr const result{AMobjItems(document, obj_id, heads), AMresultFree};
+    if (AMresultStatus(result.get()) != AM_STATUS_OK) {
+        args << "AMresultError(AMobjItems(...)) == \"" << cavi::usdj_am::utils::from_bytes(AMresultError(result.get()))
+             << "\"";
+        return 0;
+    }
+    AMitems items = AMresultItems(result.get());
+    size = AMitemsSize(&items);
+    std::size_t pos = 0;
+    AMitem* item = nullptr;
+    while (pos != count && (item = AMitemsNext(&items, 1)) != nullptr) {
+        if (!to_number(item, first[pos])) {
+            args << "AMitemValType([" << pos << "]) == " << AMvalTypeToString(AMitemValType(item));
+            break;
+        }
+        ++pos;
+    }
+    return pos;
+}
+
+}  // namespace
+
+namespace cavi {
+namespace usdj_am {
+namespace utils {
+
+template <typename NumberT>
+std::size_t read_numbers(ValueRange const& values, NumberT* const first, std::size_t const count) {
+    std::ostringstream args;
+    std::size_t size = 0;
+    auto const written =
+        read_list(values.get_document(), values.get_object_id(), values.get_heads(), first, count, size, args);
+    if (!args.str().empty()) {
+        std::ostringstream what;
+        what << __func__ << "<" << typeid(NumberT).name() << ">(" << args.str() << ", ...)";
+        throw std::invalid_argument(what.str());
+    }
+    return written;
+}
+
+template <typename NumberT>
+std::size_t read_number_tuples(ValueRange const& values,
+                               std::size_t const width,
+                               NumberT* const first,
+                               std::size_t const count) {
+    std::ostringstream args;
+    std::size_t written = 0;
+    if (!width) {
+        args << "..., width == 0, ...";
+    } else {
+        AMdoc const* const document = values.get_document();
+        AMitems const* const heads = values.get_heads();
+        ResultPtr const result{AMobjItems(document, values.get_object_id(), heads), AMresultFree};
+        if (AMresultStatus(result.get()) != AM_STATUS_OK) {
+            args << "AMresultError(AMobjItems(...)) == \"" << from_bytes(AMresultError(result.get())) << "\", ...";
+        } else {
+            AMitems rows = AMresultItems(result.get());
+            std::size_t row = 0;
+            AMitem* item = nullptr;
+            while (written + width <= count && (item = AMitemsNext(&rows, 1)) != nullptr) {
+                AMvalType const val_type = AMitemValType(item);
+                if (val_type != AM_VAL_TYPE_OBJ_TYPE) {
+                    args << "AMitemValType([" << row << "]) == " << AMvalTypeToString(val_type) << ", ...";
+                    break;
+                }
+                std::size_t size = 0;
+                read_list(document, AMitemObjId(item), heads, first + written, width, size, args);
+                if (!args.str().empty()) {
+                    break;
+                } else if (size != width) {
+                    args << "AMobjSize([" << row << "]) == " << size << ", " << width << ", ...";
+                    break;
+                }
+                written += width;
+                ++row;
+            }
+        }
+    }
+    if (!args.str().empty()) {
+        std::ostringstream what;
+        what << __func__ << "<" << typeid(NumberT).name() << ">(" << args.str() << ")";
+        throw std::invalid_argument(what.str());
+    }
+    return written;
+}
+
+template std::size_t read_numbers<double>(ValueRange const&, double* const, std::size_t const);
+
+template std::size_t read_numbers<float>(ValueRange const&, float* const, std::size_t const);
+
+template std::size_t read_numbers<std::int32_t>(ValueRange const&, std::int32_t* const, std::size_t const);
+
+template std::size_t read_number_tuples<double>(ValueRange const&,
+                                                std::size_t const,
+                                                double* const,
+                                                std::size_t const);
+
+template std::size_t read_number_tuples<float>(ValueRange const&, std::size_t const, float* const, std::size_t const);
+
+template std::size_t read_number_tuples<std::int32_t>(ValueRange const&,
+                                                      std::size_t const,
+                                                      std::int32_t* const,
+                                                      std::size_t const);
+
+}  // namespace utils
+}  // namespace usdj_am
+}  // namespace cavi
@@ -0,0 +1,590 @@
+/**************************************************************************/
+/* scene.cpp                                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// third-party
+extern "C" {
+
+#include <automerge-c/automerge.h>
+}
+
+// local
+#include "assignment.hpp"
+#include "declaration.hpp"
+#include "definition.hpp"
+#include "definition_statement.hpp"
+#include "descriptor.hpp"
+#include "external_reference.hpp"
+#include "file.hpp"
+#include "reference_file.hpp"
+#include "statement.hpp"
+#include "utils/json_writer.hpp"
+#include "utils/numbers.hpp"
+#include "utils/scene.hpp"
+
+namespace cavi {
+namespace usdj_am {
+namespace utils {
+
+/// \brief The growable tables of a scene that's being compiled.
+struct Scene::Builder {
+    Builder();
+
+    /// \brief Interns a string as a token.
+    ///
+    /// \returns The index of the token.
+    Index intern(std::string_view const& view);
+
+    /// \brief Interns the bytes of an actor ID apart from the tokens.
+    ///
+    /// \returns The index of the actor ID.
+    Index intern_actor(std::string_view const& view);
+
+    /// \brief Appends an attribute and its values.
+    void add_attribute(Scope const scope,
+                       std::string_view const& name,
+                       Index const type,
+                       std::uint8_t const keyword,
+                       Value const& value);
+
+    /// \brief Appends a prim, its attributes and then its descendants.
+    void add_prim(Definition const& definition, Index const parent);
+
+    /// \brief Computes the digest of a prim's own fields.
+    std::uint64_t digest(Index const prim) const;
+
+    /// \brief Gets the bytes of an interned actor ID.
+    std::string_view get_actor(Index const actor) const;
+
+    /// \brief Gets an interned token.
+    std::string_view get_token(Index const token) const;
+
+    /// \brief Appends the values of an array.
+    ///
+    /// \returns The kind of rows that were appended.
+    ValueKind add_values(ValueRange const& values, std::uint8_t& width);
+
+    std::string actor_characters;
+    std::unordered_map<std::string, Index> actor_indices;
+    std::vector<Span> actor_spans;
+    std::string characters;
+    std::unordered_map<std::string, Index> token_indices;
+    std::vector<Span> token_spans;
+    std::vector<Span> prim_attributes;
+    std::vector<std::uint64_t> prim_digests;
+    std::vector<Index> prim_ends;
+    std::vector<Index> prim_names;
+    std::vector<ObjectKey> prim_object_keys;
+    std::vector<std::uint64_t> prim_own_digests;
+    std::vector<Index> prim_parents;
+    std::vector<DefinitionType> prim_sub_types;
+    std::vector<Index> prim_types;
+    std::vector<std::uint8_t> attribute_keywords;
+    std::vector<Index> attribute_names;
+    std::vector<Scope> attribute_scopes;
+    std::vector<Index> attribute_types;
+    /// The digests of the values that aren't represented, which are only
+    /// needed to compute the prims' digests.
+    std::vector<std::uint64_t> attribute_value_digests;
+    std::vector<ValueKind> attribute_value_kinds;
+    std::vector<Span> attribute_values;
+    std::vector<std::uint8_t> attribute_widths;
+    std::vector<double> numbers;
+    std::vector<Index> token_values;
+};
+
+}  // namespace utils
+}  // namespace usdj_am
+}  // namespace cavi
+
+namespace {
+
+using cavi::usdj_am::utils::Scene;
+
+/// \brief Lays out arrays one after another within a single block.
+class ArenaLayout {
+public:
+    ArenaLayout() : m_size{0} {}
+
+    /// \brief Reserves room for a copy of a vector.
+    ///
+    /// \returns The offset of the copy within the block.
+    template <typename T>
+    std::size_t reserve(std::vector<T> const& rows) {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        m_size = (m_size + alignof(T) - 1) / alignof(T) * alignof(T);
+        auto const offset = m_size;
+        m_size += rows.size() * sizeof(T);
+        return offset;
+    }
+
+    /// \brief Copies a vector into the block at an offset it reserved.
+    template <typename T>
+    static T const* place(std::max_align_t* const block, std::size_t const offset, std::vector<T> const& rows) {
+        auto const first = reinterpret_cast<unsigned char*>(block) + offset;
+        if (!rows.empty()) {
+            std::memcpy(first, rows.data(), rows.size() * sizeof(T));
+        }
+        return reinterpret_cast<T const*>(first);
+    }
+
+    /// \brief Gets the count of `std::max_align_t`s spanned by the block.
+    std::size_t get_count() const { return (m_size + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t); }
+
+private:
+    std::size_t m_size;
+};
+
+/// \brief Folds bytes into a 64-bit FNV-1a hash.
+std::uint64_t fold(std::uint64_t hash, void const* const src, std::size_t const count) {
+    auto const bytes = static_cast<unsigned char const*>(src);
+    for (std::size_t pos = 0; pos != count; ++pos) {
+        hash = (hash ^ bytes[pos]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/// \brief Folds a value into a 64-bit FNV-1a hash.
+template <typename T>
+std::uint64_t fold(std::uint64_t const hash, T const& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    return fold(hash, &value, sizeof(value));
+}
+
+/// \brief Folds a length-prefixed string into a 64-bit FNV-1a hash.
+std::uint64_t fold(std::uint64_t const hash, std::string_view const& view) {
+    return fold(fold(hash, view.size()), view.data(), view.size());
+}
+
+/// \brief Gets the sort key of an Automerge object ID.
+std::pair<std::uint64_t, std::string_view> to_sort_key(AMobjId const* const object_id) {
+    auto const bytes = AMactorIdBytes(AMobjIdActorId(object_id));
+    return {AMobjIdCounter(object_id), std::string_view{reinterpret_cast<char const*>(bytes.src), bytes.count}};
+}
+
+}  // namespace
+
+namespace cavi {
+namespace usdj_am {
+namespace utils {
+
+Scene::Builder::Builder() {}
+
+Scene::Index Scene::Builder::intern(std::string_view const& view) {
+    auto const [match, inserted] =
+        token_indices.try_emplace(std::string{view}, static_cast<Index>(token_spans.size()));
+    if (inserted) {
+        token_spans.push_back(Span{static_cast<Index>(characters.size()), static_cast<Index>(view.size())});
+        characters.append(view);
+    }
+    return match->second;
+}
+
+Scene::Index Scene::Builder::intern_actor(std::string_view const& view) {
+    auto const [match, inserted] =
+        actor_indices.try_emplace(std::string{view}, static_cast<Index>(actor_spans.size()));
+    if (inserted) {
+        actor_spans.push_back(Span{static_cast<Index>(actor_characters.size()), static_cast<Index>(view.size())});
+        actor_characters.append(view);
+    }
+    return match->second;
+}
+
+void Scene::Builder::add_attribute(Scope const scope,
+                                   std::string_view const& name,
+                                   Index const type,
+                                   std::uint8_t const keyword,
+                                   Value const& value) {
+    attribute_keywords.push_back(keyword);
+    attribute_names.push_back(intern(name));
+    attribute_scopes.push_back(scope);
+    attribute_types.push_back(type);
+    auto const first_number = static_cast<Index>(numbers.size());
+    auto const first_token = static_cast<Index>(token_values.size());
+    std::uint8_t width = 1;
+    ValueKind kind = ValueKind::EMPTY;
+    try {
+        kind = std::visit(
+            [this, &width](auto const& alt) -> ValueKind {
+                using T = std::decay_t<decltype(alt)>;
+                if constexpr (std::is_same_v<T, String>) {
+                    token_values.push_back(intern(alt));
+                    return ValueKind::TOKENS;
+                } else if constexpr (std::is_same_v<T, bool>) {
+                    numbers.push_back(alt ? 1.0 : 0.0);
+                    return ValueKind::NUMBERS;
+                } else if constexpr (std::is_same_v<T, Number>) {
+                    numbers.push_back(std::visit([](auto const number) { return static_cast<double>(number); }, alt));
+                    return ValueKind::NUMBERS;
+                } else if constexpr (std::is_same_v<T, ValueRange>) {
+                    return add_values(alt, width);
+                } else if constexpr (std::is_same_v<T, ExternalReference>) {
+                    token_values.push_back(intern(alt.get_reference_file().get_src()));
+                    return ValueKind::TOKENS;
+                } else {
+                    return ValueKind::EMPTY;
+                }
+            },
+            value);
+    } catch (std::invalid_argument const&) {
+        // A heterogeneous array isn't a table of numbers.
+        numbers.resize(first_number);
+        token_values.resize(first_token);
+        width = 1;
+        kind = ValueKind::EMPTY;
+    }
+    attribute_value_kinds.push_back(kind);
+    // A value that isn't represented is still told apart by its contents so
+    // that authoring or clearing it changes the prim's digest.
+    std::uint64_t value_digest = 0;
+    if (kind == ValueKind::EMPTY) {
+        value_digest = fold(0xcbf29ce484222325ULL, value.index());
+        if (!std::holds_alternative<std::monostate>(value) && !std::holds_alternative<std::nullptr_t>(value)) {
+            try {
+                JsonWriter writer{JsonWriter::Indenter{' ', 0}, std::numeric_limits<double>::max_digits10};
+                value.accept(writer);
+                value_digest = fold(value_digest, std::string_view{std::string{writer}});
+            } catch (std::invalid_argument const&) {
+                // An unreadable value only contributes its alternative.
+            }
+        }
+    }
+    attribute_value_digests.push_back(value_digest);
+    switch (kind) {
+        case ValueKind::NUMBERS: {
+            attribute_values.push_back(Span{first_number, static_cast<Index>(numbers.size()) - first_number});
+            break;
+        }
+        case ValueKind::TOKENS: {
+            attribute_values.push_back(Span{first_token, static_cast<Index>(token_values.size()) - first_token});
+            break;
+        }
+        default: {
+            attribute_values.push_back(Span{0, 0});
+            break;
+        }
+    }
+    attribute_widths.push_back(width);
+}
+
+void Scene::Builder::add_prim(Definition const& definition, Index const parent) {
+    auto const prim = static_cast<Index>(prim_names.size());
+    auto const object_id = definition.get_object_id();
+    auto const [counter, actor] = to_sort_key(object_id);
+    prim_names.push_back(intern(definition.get_name()));
+    prim_object_keys.push_back(ObjectKey{counter, intern_actor(actor)});
+    prim_parents.push_back(parent);
+    prim_sub_types.push_back(definition.get_sub_type());
+    auto const def_type = definition.get_def_type();
+    prim_types.push_back((def_type) ? intern(*def_type) : NONE);
+    prim_ends.push_back(NONE);
+    auto const first_attribute = static_cast<Index>(attribute_names.size());
+    if (auto const descriptor = definition.get_descriptor()) {
+        for (auto const& assignment : descriptor->get_assignments()) {
+            auto const keyword = assignment.get_keyword();
+            add_attribute(Scope::METADATA, assignment.get_identifier(), NONE,
+                          (keyword) ? static_cast<std::uint8_t>(*keyword) : 0, assignment.get_value());
+        }
+    }
+    // A prim's attributes must be contiguous so its children are appended
+    // after all of them.
+    std::vector<Definition> children;
+    for (auto&& definition_statement : definition.get_statements()) {
+        if (auto const declaration = std::get_if<Declaration>(&definition_statement)) {
+            auto const keyword = declaration->get_keyword();
+            add_attribute(Scope::PROPERTY, declaration->get_reference(), intern(declaration->get_define_type()),
+                          (keyword) ? static_cast<std::uint8_t>(*keyword) : 0, declaration->get_value());
+        } else if (auto const statement = std::get_if<Statement>(&definition_statement)) {
+            if (auto const child = std::get_if<Definition>(statement)) {
+                children.push_back(std::move(*child));
+            }
+        }
+    }
+    prim_attributes.push_back(Span{first_attribute, static_cast<Index>(attribute_names.size()) - first_attribute});
+    prim_own_digests.push_back(digest(prim));
+    // Recreating a prim with the same fields still changes its parent's
+    // subtree.
+    prim_digests.push_back(fold(fold(prim_own_digests.back(), counter), actor));
+    for (auto const& child : children) {
+        auto const child_prim = static_cast<Index>(prim_names.size());
+        add_prim(child, prim);
+        prim_digests[prim] = fold(prim_digests[prim], prim_digests[child_prim]);
+    }
+    prim_ends[prim] = static_cast<Index>(prim_names.size());
+}
+
+std::uint64_t Scene::Builder::digest(Index const prim) const {
+    // Tokens are folded in by value because their indices differ between
+    // scenes.
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    hash = fold(hash, get_token(prim_names[prim]));
+    hash = fold(hash, prim_types[prim] != NONE);
+    if (prim_types[prim] != NONE) {
+        hash = fold(hash, get_token(prim_types[prim]));
+    }
+    hash = fold(hash, prim_sub_types[prim]);
+    auto const attributes = prim_attributes[prim];
+    for (auto attribute = attributes.first; attribute != attributes.first + attributes.count; ++attribute) {
+        hash = fold(hash, get_token(attribute_names[attribute]));
+        hash = fold(hash, attribute_types[attribute] != NONE);
+        if (attribute_types[attribute] != NONE) {
+            hash = fold(hash, get_token(attribute_types[attribute]));
+        }
+        hash = fold(hash, attribute_keywords[attribute]);
+        hash = fold(hash, attribute_scopes[attribute]);
+        hash = fold(hash, attribute_value_kinds[attribute]);
+        hash = fold(hash, attribute_widths[attribute]);
+        auto const values = attribute_values[attribute];
+        hash = fold(hash, values.count);
+        switch (attribute_value_kinds[attribute]) {
+            case ValueKind::EMPTY: {
+                hash = fold(hash, attribute_value_digests[attribute]);
+                break;
+            }
+            case ValueKind::NUMBERS: {
+                hash = fold(hash, numbers.data() + values.first, values.count * sizeof(double));
+                break;
+            }
+            case ValueKind::TOKENS: {
+                for (auto pos = values.first; pos != values.first + values.count; ++pos) {
+                    hash = fold(hash, get_token(token_values[pos]));
+                }
+                break;
+            }
+            default: {
+                break;
+            }
+        }
+    }
+    return hash;
+}
+
+std::string_view Scene::Builder::get_actor(Index const actor) const {
+    auto const& span = actor_spans[actor];
+    return std::string_view{actor_characters}.substr(span.first, span.count);
+}
+
+std::string_view Scene::Builder::get_token(Index const token) const {
+    auto const& span = token_spans[token];
+    return std::string_view{characters}.substr(span.first, span.count);
+}
+
+Scene::ValueKind Scene::Builder::add_values(ValueRange const& values, std::uint8_t& width) {
+    auto const size = values.size();
+    if (!size) {
+        return ValueKind::NUMBERS;
+    }
+    auto first = values.begin();
+    auto const head = *first;
+    if (std::holds_alternative<Number>(head)) {
+        auto const offset = numbers.size();
+        numbers.resize(offset + size);
+        numbers.resize(offset + read_numbers(values, numbers.data() + offset, size));
+        return ValueKind::NUMBERS;
+    } else if (auto const row = std::get_if<ValueRange>(&head)) {
+        auto const row_size = row->size();
+        if (row_size && row_size <= std::numeric_limits<std::uint8_t>::max()) {
+            auto const offset = numbers.size();
+            numbers.resize(offset + size * row_size);
+            numbers.resize(offset + read_number_tuples(values, row_size, numbers.data() + offset, size * row_size));
+            width = static_cast<std::uint8_t>(row_size);
+            return ValueKind::NUMBERS;
+        }
+    } else if (std::holds_alternative<String>(head)) {
+        for (auto const& value : values) {
+            if (auto const string = std::get_if<String>(&value)) {
+                token_values.push_back(intern(*string));
+            }
+        }
+        return ValueKind::TOKENS;
+    }
+    return ValueKind::EMPTY;
+}
+
+Scene::Scene(File const& file) : m_default_prim{NONE} {
+    Builder builder;
+    std::optional<Index> default_prim_name;
+    if (auto const descriptor = file.get_descriptor()) {
+        for (auto const& assignment : descriptor->get_assignments()) {
+            if (!assignment.get_keyword() && assignment.get_identifier() == "defaultPrim") {
+                auto const value = assignment.get_value();
+                if (auto const string = std::get_if<String>(&value)) {
+                    default_prim_name = builder.intern(*string);
+                }
+            }
+        }
+    }
+    for (auto const& statement : file.get_statements()) {
+        if (auto const definition = std::get_if<Definition>(&statement)) {
+            auto const prim = static_cast<Index>(builder.prim_names.size());
+            builder.add_prim(*definition, NONE);
+            if (default_prim_name && m_default_prim == NONE && builder.prim_names[prim] == *default_prim_name) {
+                m_default_prim = prim;
+            }
+        }
+    }
+    std::vector<Index> sorted_tokens(builder.token_spans.size());
+    for (Index token = 0; token != sorted_tokens.size(); ++token) {
+        sorted_tokens[token] = token;
+    }
+    auto const token_view = [&builder](Index const token) { return builder.get_token(token); };
+    std::sort(sorted_tokens.begin(), sorted_tokens.end(),
+              [&token_view](Index const lhs, Index const rhs) { return token_view(lhs) < token_view(rhs); });
+    std::vector<Index> sorted_prims(builder.prim_names.size());
+    for (Index prim = 0; prim != sorted_prims.size(); ++prim) {
+        sorted_prims[prim] = prim;
+    }
+    auto const object_key = [&builder](Index const prim) {
+        auto const& key = builder.prim_object_keys[prim];
+        return std::make_pair(key.counter, builder.get_actor(key.actor));
+    };
+    std::sort(sorted_prims.begin(), sorted_prims.end(),
+              [&object_key](Index const lhs, Index const rhs) { return object_key(lhs) < object_key(rhs); });
+    // Freeze the tables into a single block.
+    std::vector<char> characters{builder.characters.begin(), builder.characters.end()};
+    std::vector<char> actor_characters{builder.actor_characters.begin(), builder.actor_characters.end()};
+    ArenaLayout layout;
+    auto const actor_characters_offset = layout.reserve(actor_characters);
+    auto const actor_spans_offset = layout.reserve(builder.actor_spans);
+    auto const characters_offset = layout.reserve(characters);
+    auto const token_spans_offset = layout.reserve(builder.token_spans);
+    auto const sorted_tokens_offset = layout.reserve(sorted_tokens);
+    auto const prim_attributes_offset = layout.reserve(builder.prim_attributes);
+    auto const prim_digests_offset = layout.reserve(builder.prim_digests);
+    auto const prim_ends_offset = layout.reserve(builder.prim_ends);
+    auto const prim_names_offset = layout.reserve(builder.prim_names);
+    auto const prim_object_keys_offset = layout.reserve(builder.prim_object_keys);
+    auto const prim_own_digests_offset = layout.reserve(builder.prim_own_digests);
+    auto const prim_parents_offset = layout.reserve(builder.prim_parents);
+    auto const prim_sub_types_offset = layout.reserve(builder.prim_sub_types);
+    auto const prim_types_offset = layout.reserve(builder.prim_types);
+    auto const sorted_prims_offset = layout.reserve(sorted_prims);
+    auto const attribute_keywords_offset = layout.reserve(builder.attribute_keywords);
+    auto const attribute_names_offset = layout.reserve(builder.attribute_names);
+    auto const attribute_scopes_offset = layout.reserve(builder.attribute_scopes);
+    auto const attribute_types_offset = layout.reserve(builder.attribute_types);
+    auto const attribute_value_kinds_offset = layout.reserve(builder.attribute_value_kinds);
+    auto const attribute_values_offset = layout.reserve(builder.attribute_values);
+    auto const attribute_widths_offset = layout.reserve(builder.attribute_widths);
+    auto const numbers_offset = layout.reserve(builder.numbers);
+    auto const token_values_offset = layout.reserve(builder.token_values);
+    m_arena.reset(new std::max_align_t[std::max<std::size_t>(layout.get_count(), 1)]);
+    auto const block = m_arena.get();
+    m_actor_characters = ArenaLayout::place(block, actor_characters_offset, actor_characters);
+    m_actor_spans = ArenaLayout::place(block, actor_spans_offset, builder.actor_spans);
+    m_token_count = builder.token_spans.size();
+    m_characters = ArenaLayout::place(block, characters_offset, characters);
+    m_token_spans = ArenaLayout::place(block, token_spans_offset, builder.token_spans);
+    m_sorted_tokens = ArenaLayout::place(block, sorted_tokens_offset, sorted_tokens);
+    m_prim_count = builder.prim_names.size();
+    m_prim_attributes = ArenaLayout::place(block, prim_attributes_offset, builder.prim_attributes);
+    m_prim_digests = ArenaLayout::place(block, prim_digests_offset, builder.prim_digests);
+    m_prim_ends = ArenaLayout::place(block, prim_ends_offset, builder.prim_ends);
+    m_prim_names = ArenaLayout::place(block, prim_names_offset, builder.prim_names);
+    m_prim_object_keys = ArenaLayout::place(block, prim_object_keys_offset, builder.prim_object_keys);
+    m_prim_own_digests = ArenaLayout::place(block, prim_own_digests_offset, builder.prim_own_digests);
+    m_prim_parents = ArenaLayout::place(block, prim_parents_offset, builder.prim_parents);
+    m_prim_sub_types = ArenaLayout::place(block, prim_sub_types_offset, builder.prim_sub_types);
+    m_prim_types = ArenaLayout::place(block, prim_types_offset, builder.prim_types);
+    m_sorted_prims = ArenaLayout::place(block, sorted_prims_offset, sorted_prims);
+    m_attribute_count = builder.attribute_names.size();
+    m_attribute_keywords = ArenaLayout::place(block, attribute_keywords_offset, builder.attribute_keywords);
+    m_attribute_names = ArenaLayout::place(block, attribute_names_offset, builder.attribute_names);
+    m_attribute_scopes = ArenaLayout::place(block, attribute_scopes_offset, builder.attribute_scopes);
+    m_attribute_types = ArenaLayout::place(block, attribute_types_offset, builder.attribute_types);
+    m_attribute_value_kinds = ArenaLayout::place(block, attribute_value_kinds_offset, builder.attribute_value_kinds);
+    m_attribute_values = ArenaLayout::place(block, attribute_values_offset, builder.attribute_values);
+    m_attribute_widths = ArenaLayout::place(block, attribute_widths_offset, builder.attribute_widths);
+    m_numbers = ArenaLayout::place(block, numbers_offset, builder.numbers);
+    m_token_values = ArenaLayout::place(block, token_values_offset, builder.token_values);
+}
+
+Scene::~Scene() {}
+
+Scene::Index Scene::find_token(std::string_view const& view) const {
+    auto const first = m_sorted_tokens;
+    auto const last = m_sorted_tokens + m_token_count;
+    auto const match = std::lower_bound(first, last, view, [this](Index const lhs, std::string_view const& rhs) {
+        return get_token(lhs) < rhs;
+    });
+    return (match != last && get_token(*match) == view) ? *match : NONE;
+}
+
+Scene::Index Scene::find_prim(AMobjId const* const object_id) const {
+    if (!object_id) {
+        return NONE;
+    }
+    return find_prim(to_sort_key(object_id));
+}
+
+Scene::Index Scene::find_prim(Scene const& scene, Index const prim) const {
+    return find_prim(scene.get_prim_object_key(prim));
+}
+
+Scene::Index Scene::find_prim(std::pair<std::uint64_t, std::string_view> const& object_key) const {
+    auto const first = m_sorted_prims;
+    auto const last = m_sorted_prims + m_prim_count;
+    auto const match = std::lower_bound(first, last, object_key, [this](Index const lhs, auto const& rhs) {
+        return get_prim_object_key(lhs) < rhs;
+    });
+    return (match != last && get_prim_object_key(*match) == object_key) ? *match : NONE;
+}
+
+std::pair<std::uint64_t, std::string_view> Scene::get_prim_object_key(Index const prim) const {
+    auto const& object_key = m_prim_object_keys[prim];
+    auto const& span = m_actor_spans[object_key.actor];
+    return std::make_pair(object_key.counter, std::string_view{m_actor_characters + span.first, span.count});
+}
+
+Scene::Index Scene::find_attribute(Index const prim, std::string_view const& name) const {
+    auto const token = find_token(name);
+    if (token != NONE) {
+        auto const attributes = m_prim_attributes[prim];
+        for (auto attribute = attributes.first; attribute != attributes.first + attributes.count; ++attribute) {
+            if (m_attribute_names[attribute] == token) {
+                return attribute;
+            }
+        }
+    }
+    return NONE;
+}
+
+}  // namespace utils
+}  // namespace usdj_am
+}  // namespace cavi
@@ -0,0 +1,543 @@
+/**************************************************************************/
+/* xform_program.cpp                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#if !defined(CAVI_USDJ_AM_NO_SIMD) && \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define CAVI_USDJ_AM_SSE2
+#include <emmintrin.h>
+#endif
+
+// local
+#include "usd/geom/xform_op_type.hpp"
+#include "utils/scene.hpp"
+#include "utils/xform_program.hpp"
+
+namespace {
+
+using cavi::usdj_am::usd::geom::XformOpType;
+using cavi::usdj_am::utils::XformProgram;
+
+static constexpr double DEGREES_TO_RADIANS = 3.14159265358979323846 / 180.0;
+
+static constexpr std::string_view INVERT_PREFIX = "!invert!";
+
+static constexpr std::string_view OP_NAMESPACE = "xformOp:";
+
+static constexpr std::size_t MATRIX_SIZE = XformProgram::MATRIX_SIZE;
+
+/// \brief Gets the index of an element within a matrix.
+constexpr std::size_t at(std::size_t const row, std::size_t const column) {
+    return row * 4 + column;
+}
+
+/// \brief Gets the count of numbers within the value of an operation.
+std::size_t get_width(XformOpType const type) {
+    switch (type) {
+        case XformOpType::ROTATE_X:
+        case XformOpType::ROTATE_Y:
+        case XformOpType::ROTATE_Z:
+            return 1;
+        case XformOpType::ORIENT:
+            return 4;
+        case XformOpType::TRANSFORM:
+            return 16;
+        case XformOpType::RESET_XFORM_STACK:
+            return 0;
+        default:
+            return 3;
+    }
+}
+
+/// \brief Gets the axes of an Euler rotation in the order that they're
+///        applied, e.g. X, Y and then Z for "xformOp:rotateXYZ".
+std::optional<std::array<std::size_t, 3>> get_axes(XformOpType const type) {
+    switch (type) {
+        case XformOpType::ROTATE_XYZ:
+            return std::array<std::size_t, 3>{0, 1, 2};
+        case XformOpType::ROTATE_XZY:
+            return std::array<std::size_t, 3>{0, 2, 1};
+        case XformOpType::ROTATE_YXZ:
+            return std::array<std::size_t, 3>{1, 0, 2};
+        case XformOpType::ROTATE_YZX:
+            return std::array<std::size_t, 3>{1, 2, 0};
+        case XformOpType::ROTATE_ZXY:
+            return std::array<std::size_t, 3>{2, 0, 1};
+        case XformOpType::ROTATE_ZYX:
+            return std::array<std::size_t, 3>{2, 1, 0};
+        default:
+            return std::nullopt;
+    }
+}
+
+/// \brief Sets the lanes of a block of matrices to the identity matrix.
+void set_identity(double* const matrices, std::size_t const count) {
+    std::fill(matrices, matrices + MATRIX_SIZE * count, 0.0);
+    for (std::size_t row = 0; row != 3; ++row) {
+        std::fill_n(matrices + at(row, row) * count, count, 1.0);
+    }
+}
+
+/// \brief Pre-multiplies a lane's 3x3 rotation by a rotation about an axis.
+///
+/// \param[in,out] matrices A block of matrices.
+/// \param[in] count The count of lanes within \p matrices.
+/// \param[in] lane A lane within \p matrices.
+/// \param[in] axis 0, 1 or 2 for the X, Y or Z axis.
+/// \param[in] radians An angle of rotation.
+void rotate(double* const matrices,
+            std::size_t const count,
+            std::size_t const lane,
+            std::size_t const axis,
+            double const radians) {
+    auto const cosine = std::cos(radians);
+    auto const sine = std::sin(radians);
+    // The rows of the plane of rotation, e.g. Y and Z for the X axis.
+    auto const first = (axis + 1) % 3;
+    auto const second = (axis + 2) % 3;
+    for (std::size_t column = 0; column != 3; ++column) {
+        auto& lhs = matrices[at(first, column) * count + lane];
+        auto& rhs = matrices[at(second, column) * count + lane];
+        auto const lhs_value = lhs;
+        lhs = cosine * lhs_value - sine * rhs;
+        rhs = sine * lhs_value + cosine * rhs;
+    }
+}
+
+/// \brief Sets the lanes of a block of matrices to those of an operation.
+///
+/// \param[in] type The type of an operation.
+/// \param[in] operands The operation's values for each lane as a struct of
+///                     arrays.
+/// \param[in] count The count of lanes.
+/// \param[out] matrices A block of matrices.
+void load(XformOpType const type, double const* const operands, std::size_t const count, double* const matrices) {
+    auto const operand = [operands, count](std::size_t const component, std::size_t const lane) {
+        return operands[component * count + lane];
+    };
+    auto const element = [matrices, count](std::size_t const row, std::size_t const column) {
+        return matrices + at(row, column) * count;
+    };
+    set_identity(matrices, count);
+    switch (type) {
+        case XformOpType::TRANSLATE: {
+            for (std::size_t row = 0; row != 3; ++row) {
+                std::copy_n(operands + row * count, count, element(row, 3));
+            }
+            break;
+        }
+        case XformOpType::SCALE: {
+            for (std::size_t row = 0; row != 3; ++row) {
+                std::copy_n(operands + row * count, count, element(row, row));
+            }
+            break;
+        }
+        case XformOpType::ROTATE_X:
+        case XformOpType::ROTATE_Y:
+        case XformOpType::ROTATE_Z: {
+            auto const axis = static_cast<std::size_t>(type) - static_cast<std::size_t>(XformOpType::ROTATE_X);
+            for (std::size_t lane = 0; lane != count; ++lane) {
+                rotate(matrices, count, lane, axis, operand(0, lane) * DEGREES_TO_RADIANS);
+            }
+            break;
+        }
+        case XformOpType::ORIENT: {
+            // A quaternion is written with its real part first.
+            for (std::size_t lane = 0; lane != count; ++lane) {
+                auto const w = operand(0, lane);
+                auto const x = operand(1, lane);
+                auto const y = operand(2, lane);
+                auto const z = operand(3, lane);
+                auto const norm = w * w + x * x + y * y + z * z;
+                if (norm == 0.0) {
+                    continue;
+                }
+                auto const s = 2.0 / norm;
+                element(0, 0)[lane] = 1.0 - s * (y * y + z * z);
+                element(0, 1)[lane] = s * (x * y - w * z);
+                element(0, 2)[lane] = s * (x * z + w * y);
+                element(1, 0)[lane] = s * (x * y + w * z);
+                element(1, 1)[lane] = 1.0 - s * (x * x + z * z);
+                element(1, 2)[lane] = s * (y * z - w * x);
+                element(2, 0)[lane] = s * (x * z - w * y);
+                element(2, 1)[lane] = s * (y * z + w * x);
+                element(2, 2)[lane] = 1.0 - s * (x * x + y * y);
+            }
+            break;
+        }
+        case XformOpType::TRANSFORM: {
+            // A "matrix4d" is for row vectors so it's transposed and its
+            // projective column is dropped.
+            for (std::size_t row = 0; row != 3; ++row) {
+                for (std::size_t column = 0; column != 4; ++column) {
+                    std::copy_n(operands + (column * 4 + row) * count, count, element(row, column));
+                }
+            }
+            break;
+        }
+        case XformOpType::RESET_XFORM_STACK: {
+            break;
+        }
+        default: {
+            if (auto const axes = get_axes(type)) {
+                for (std::size_t lane = 0; lane != count; ++lane) {
+                    for (auto const axis : *axes) {
+                        rotate(matrices, count, lane, axis, operand(axis, lane) * DEGREES_TO_RADIANS);
+                    }
+                }
+            }
+            break;
+        }
+    }
+}
+
+/// \brief Inverts the lanes of a block of matrices.
+///
+/// \note A singular matrix is left as is.
+void invert(double* const matrices, std::size_t const count) {
+    for (std::size_t lane = 0; lane != count; ++lane) {
+        double m[MATRIX_SIZE];
+        for (std::size_t element = 0; element != MATRIX_SIZE; ++element) {
+            m[element] = matrices[element * count + lane];
+        }
+        double const cofactors[9] = {
+            m[at(1, 1)] * m[at(2, 2)] - m[at(1, 2)] * m[at(2, 1)],
+            m[at(0, 2)] * m[at(2, 1)] - m[at(0, 1)] * m[at(2, 2)],
+            m[at(0, 1)] * m[at(1, 2)] - m[at(0, 2)] * m[at(1, 1)],
+            m[at(1, 2)] * m[at(2, 0)] - m[at(1, 0)] * m[at(2, 2)],
+            m[at(0, 0)] * m[at(2, 2)] - m[at(0, 2)] * m[at(2, 0)],
+            m[at(0, 2)] * m[at(1, 0)] - m[at(0, 0)] * m[at(1, 2)],
+            m[at(1, 0)] * m[at(2, 1)] - m[at(1, 1)] * m[at(2, 0)],
+            m[at(0, 1)] * m[at(2, 0)] - m[at(0, 0)] * m[at(2, 1)],
+            m[at(0, 0)] * m[at(1, 1)] - m[at(0, 1)] * m[at(1, 0)],
+        };
+        auto const determinant =
+            m[at(0, 0)] * cofactors[0] + m[at(0, 1)] * cofactors[3] + m[at(0, 2)] * cofactors[6];
+        if (determinant == 0.0) {
+            continue;
+        }
+        for (std::size_t row = 0; row != 3; ++row) {
+            double translation = 0.0;
+            for (std::size_t column = 0; column != 3; ++column) {
+                auto const value = cofactors[row * 3 + column] / determinant;
+                matrices[at(row, column) * count + lane] = value;
+                translation -= value * m[at(column, 3)];
+            }
+            matrices[at(row, 3) * count + lane] = translation;
+        }
+    }
+}
+
+/// \brief Multiplies the lanes of two blocks of matrices.
+///
+/// \param[in] lhs A block of matrices.
+/// \param[in] rhs A block of matrices.
+/// \param[out] out A block of matrices that aliases neither \p lhs nor
+///                 \p rhs.
+/// \param[in] count The count of lanes within each block.
+void multiply(double const* const lhs, double const* const rhs, double* const out, std::size_t const count) {
+    std::size_t lane = 0;
+#if defined(CAVI_USDJ_AM_SSE2)
+    for (; lane + 2 <= count; lane += 2) {
+        for (std::size_t row = 0; row != 3; ++row) {
+            __m128d const lhs_0 = _mm_loadu_pd(lhs + at(row, 0) * count + lane);
+            __m128d const lhs_1 = _mm_loadu_pd(lhs + at(row, 1) * count + lane);
+            __m128d const lhs_2 = _mm_loadu_pd(lhs + at(row, 2) * count + lane);
+            for (std::size_t column = 0; column != 4; ++column) {
+                __m128d sum = _mm_mul_pd(lhs_0, _mm_loadu_pd(rhs + at(0, column) * count + lane));
+                sum = _mm_add_pd(sum, _mm_mul_pd(lhs_1, _mm_loadu_pd(rhs + at(1, column) * count + lane)));
+                sum = _mm_add_pd(sum, _mm_mul_pd(lhs_2, _mm_loadu_pd(rhs + at(2, column) * count + lane)));
+                if (column == 3) {
+                    sum = _mm_add_pd(sum, _mm_loadu_pd(lhs + at(row, 3) * count + lane));
+                }
+                _mm_storeu_pd(out + at(row, column) * count + lane, sum);
+            }
+        }
+    }
+#endif
+    for (; lane < count; ++lane) {
+        for (std::size_t row = 0; row != 3; ++row) {
+            for (std::size_t column = 0; column != 4; ++column) {
+                auto sum = lhs[at(row, 0) * count + lane] * rhs[at(0, column) * count + lane] +
+                           lhs[at(row, 1) * count + lane] * rhs[at(1, column) * count + lane] +
+                           lhs[at(row, 2) * count + lane] * rhs[at(2, column) * count + lane];
+                if (column == 3) {
+                    sum += lhs[at(row, 3) * count + lane];
+                }
+                out[at(row, column) * count + lane] = sum;
+            }
+        }
+    }
+}
+
+}  // namespace
+
+namespace cavi {
+namespace usdj_am {
+namespace utils {
+
+std::optional<XformOp> extract_XformOp(std::string_view const& view) {
+    using usd::geom::extract_XformOpType;
+
+    XformOp op{view, std::string_view{}, XformOpType{}, false};
+    if (op.name.substr(0, INVERT_PREFIX.size()) == INVERT_PREFIX) {
+        op.name.remove_prefix(INVERT_PREFIX.size());
+        op.inverse = true;
+    }
+    auto type_name = op.name;
+    if (op.name.substr(0, OP_NAMESPACE.size()) == OP_NAMESPACE) {
+        auto const separator = op.name.find(':', OP_NAMESPACE.size());
+        if (separator != std::string_view::npos) {
+            type_name = op.name.substr(0, separator);
+            op.suffix = op.name.substr(separator + 1);
+            if (op.suffix.empty()) {
+                return std::nullopt;
+            }
+        }
+    }
+    auto const type = extract_XformOpType(type_name);
+    if (!type || (*type == XformOpType::RESET_XFORM_STACK && (op.inverse || !op.suffix.empty()))) {
+        return std::nullopt;
+    }
+    op.type = *type;
+    return op;
+}
+
+XformProgram::XformProgram(Scene const& scene) : m_reset_count{0} {
+    auto const prim_count = scene.get_prim_count();
+    m_parents.resize(prim_count);
+    m_prim_batches.resize(prim_count);
+    m_resets.resize(prim_count, 0);
+    // The operands of each batch's lanes are gathered before they're
+    // transposed into structs of arrays.
+    struct Pending {
+        std::vector<Op> ops;
+        std::vector<Index> prims;
+        std::vector<double> operands;
+    };
+    std::vector<Pending> pendings;
+    std::unordered_map<std::string, Index> batch_indices;
+    std::string signature;
+    std::vector<Op> ops;
+    std::vector<double> operands;
+    for (Index prim = 0; prim != prim_count; ++prim) {
+        m_parents[prim] = scene.get_prim_parent(prim);
+        signature.clear();
+        ops.clear();
+        operands.clear();
+        auto const xform_op_order = scene.find_attribute(prim, "xformOpOrder");
+        if (xform_op_order != Scene::NONE &&
+            scene.get_attribute_value_kind(xform_op_order) == Scene::ValueKind::TOKENS) {
+            auto const tokens = scene.get_attribute_values(xform_op_order);
+            for (auto pos = tokens.first; pos != tokens.first + tokens.count; ++pos) {
+                auto const op = extract_XformOp(scene.get_token(scene.get_token_values()[pos]));
+                if (!op) {
+                    continue;
+                }
+                if (op->type == XformOpType::RESET_XFORM_STACK) {
+                    // It's only meaningful as the first operation.
+                    if (pos == tokens.first) {
+                        m_resets[prim] = 1;
+                        ++m_reset_count;
+                    }
+                    continue;
+                }
+                auto const attribute = scene.find_attribute(prim, op->name);
+                if (attribute == Scene::NONE ||
+                    scene.get_attribute_value_kind(attribute) != Scene::ValueKind::NUMBERS) {
+                    continue;
+                }
+                auto const values = scene.get_attribute_values(attribute);
+                if (values.count != get_width(op->type)) {
+                    continue;
+                }
+                auto const numbers = scene.get_numbers() + values.first;
+                operands.insert(operands.end(), numbers, numbers + values.count);
+                ops.push_back(Op{op->type, op->inverse});
+                signature.push_back(static_cast<char>(op->type));
+                signature.push_back(static_cast<char>(op->inverse));
+            }
+        }
+        auto const match = batch_indices.emplace(signature, static_cast<Index>(pendings.size()));
+        if (match.second) {
+            pendings.push_back(Pending{ops, {}, {}});
+        }
+        auto& pending = pendings[match.first->second];
+        pending.prims.push_back(prim);
+        pending.operands.insert(pending.operands.end(), operands.begin(), operands.end());
+        m_prim_batches[prim] = match.first->second;
+    }
+    // Transpose each batch's operands so that each component is contiguous
+    // across its lanes.
+    for (auto const& pending : pendings) {
+        Batch batch{};
+        batch.ops = Scene::Span{static_cast<Index>(m_ops.size()), static_cast<Index>(pending.ops.size())};
+        batch.prims = Scene::Span{static_cast<Index>(m_batch_prims.size()), static_cast<Index>(pending.prims.size())};
+        batch.operands = m_operands.size();
+        m_ops.insert(m_ops.end(), pending.ops.begin(), pending.ops.end());
+        m_batch_prims.insert(m_batch_prims.end(), pending.prims.begin(), pending.prims.end());
+        auto const lane_count = pending.prims.size();
+        auto const width = (lane_count) ? pending.operands.size() / lane_count : 0;
+        m_operands.resize(m_operands.size() + pending.operands.size());
+        for (std::size_t lane = 0; lane != lane_count; ++lane) {
+            for (std::size_t component = 0; component != width; ++component) {
+                m_operands[batch.operands + component * lane_count + lane] =
+                    pending.operands[lane * width + component];
+            }
+        }
+        m_batches.push_back(batch);
+    }
+    // Sort the prims by their depth below a prim whose world matrix is its
+    // local matrix so that all of the parents at one depth are evaluated
+    // before any of their children.
+    std::vector<Index> depths(prim_count);
+    Index depth_count = (prim_count) ? 1 : 0;
+    for (Index prim = 0; prim != prim_count; ++prim) {
+        auto const parent = m_parents[prim];
+        // The prims are in pre-order so a parent precedes its children.
+        depths[prim] = (parent == Scene::NONE || m_resets[prim]) ? 0 : depths[parent] + 1;
+        depth_count = std::max(depth_count, depths[prim] + 1);
+    }
+    m_levels.assign(depth_count, Scene::Span{0, 0});
+    for (auto const depth : depths) {
+        ++m_levels[depth].count;
+    }
+    for (std::size_t depth = 1; depth < m_levels.size(); ++depth) {
+        m_levels[depth].first = m_levels[depth - 1].first + m_levels[depth - 1].count;
+    }
+    m_level_prims.resize(prim_count);
+    std::vector<Index> ends(m_levels.size());
+    for (std::size_t depth = 0; depth != m_levels.size(); ++depth) {
+        ends[depth] = m_levels[depth].first;
+    }
+    for (Index prim = 0; prim != prim_count; ++prim) {
+        m_level_prims[ends[depths[prim]]++] = prim;
+    }
+    m_locals.resize(MATRIX_SIZE * prim_count);
+    m_worlds.resize(MATRIX_SIZE * prim_count);
+}
+
+XformProgram::~XformProgram() {}
+
+void XformProgram::evaluate() {
+    auto const prim_count = get_prim_count();
+    evaluate_locals();
+    if (m_levels.empty()) {
+        return;
+    }
+    // The prims at the top of each hierarchy have no transforms to inherit.
+    auto const& roots = m_levels.front();
+    for (auto pos = roots.first; pos != roots.first + roots.count; ++pos) {
+        auto const prim = m_level_prims[pos];
+        for (std::size_t element = 0; element != MATRIX_SIZE; ++element) {
+            m_worlds[element * prim_count + prim] = m_locals[element * prim_count + prim];
+        }
+    }
+    for (auto level = m_levels.begin() + 1; level != m_levels.end(); ++level) {
+        auto const count = level->count;
+        m_scratch.resize(std::max(m_scratch.size(), 3 * MATRIX_SIZE * count));
+        auto const parents = m_scratch.data();
+        auto const locals = parents + MATRIX_SIZE * count;
+        auto const worlds = locals + MATRIX_SIZE * count;
+        auto const prims = m_level_prims.data() + level->first;
+        for (std::size_t element = 0; element != MATRIX_SIZE; ++element) {
+            auto const row = element * prim_count;
+            for (std::size_t lane = 0; lane != count; ++lane) {
+                parents[element * count + lane] = m_worlds[row + m_parents[prims[lane]]];
+                locals[element * count + lane] = m_locals[row + prims[lane]];
+            }
+        }
+        multiply(parents, locals, worlds, count);
+        for (std::size_t element = 0; element != MATRIX_SIZE; ++element) {
+            auto const row = element * prim_count;
+            for (std::size_t lane = 0; lane != count; ++lane) {
+                m_worlds[row + prims[lane]] = worlds[element * count + lane];
+            }
+        }
+    }
+}
+
+void XformProgram::evaluate_locals() {
+    for (auto const& batch : m_batches) {
+        evaluate(batch);
+    }
+}
+
+void XformProgram::evaluate(Batch const& batch) {
+    auto const prim_count = get_prim_count();
+    auto const count = batch.prims.count;
+    m_scratch.resize(std::max(m_scratch.size(), 3 * MATRIX_SIZE * count));
+    auto product = m_scratch.data();
+    auto op = product + MATRIX_SIZE * count;
+    auto accumulator = op + MATRIX_SIZE * count;
+    set_identity(product, count);
+    auto operands = m_operands.data() + batch.operands;
+    for (auto pos = batch.ops.first; pos != batch.ops.first + batch.ops.count; ++pos) {
+        load(m_ops[pos].type, operands, count, op);
+        if (m_ops[pos].inverse) {
+            invert(op, count);
+        }
+        // The operations are applied to a point from last to first.
+        std::swap(product, accumulator);
+        multiply(accumulator, op, product, count);
+        operands += get_width(m_ops[pos].type) * count;
+    }
+    auto const prims = m_batch_prims.data() + batch.prims.first;
+    for (std::size_t element = 0; element != MATRIX_SIZE; ++element) {
+        auto const row = element * prim_count;
+        for (std::size_t lane = 0; lane != count; ++lane) {
+            m_locals[row + prims[lane]] = product[element * count + lane];
+        }
+    }
+}
+
+void XformProgram::get_local_matrix(Index const prim, double (&matrix)[MATRIX_SIZE]) const {
+    auto const prim_count = get_prim_count();
+    for (std::size_t element = 0; element != MATRIX_SIZE; ++element) {
+        matrix[element] = m_locals[element * prim_count + prim];
+    }
+}
+
+void XformProgram::get_world_matrix(Index const prim, double (&matrix)[MATRIX_SIZE]) const {
+    auto const prim_count = get_prim_count();
+    for (std::size_t element = 0; element != MATRIX_SIZE; ++element) {
+        matrix[element] = m_worlds[element * prim_count + prim];
+    }
+}
+
+}  // namespace utils
+}  // namespace usdj_am
+}  // namespace cavi
@@ -27,7 +27,6 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
-#include <sstream>
 #include <stdexcept>
 #include <type_traits>
 #include <typeinfo>
@@ -40,6 +39,7 @@ extern "C" {
 }
 
 // local
+#include "detail/construction.hpp"
 #include "external_reference.hpp"
 #include "external_reference_import.hpp"
 #include "object_value.hpp"
@@ -50,8 +50,8 @@ extern "C" {
 namespace cavi {
 namespace usdj_am {
 
-Value::Value(AMdoc const* const document, AMitem const* const item) {
-    std::ostringstream args;
+Value::Value(AMdoc const* const document, AMitem const* const item, AMitems const* const heads) {
+    detail::Arguments args;
     try {
         AMvalType const val_type = AMitemValType(item);
         switch (val_type) {
@@ -67,7 +67,7 @@ Value::Value(AMdoc const* const document, AMitem const* const item) {
             case AM_VAL_TYPE_F64:
             case AM_VAL_TYPE_INT:
             case AM_VAL_TYPE_UINT: {
-                this->emplace<Number>(document, item);
+                this->emplace<Number>(document, item, heads);
                 break;
             }
             case AM_VAL_TYPE_NULL: {
@@ -78,7 +78,7 @@ Value::Value(AMdoc const* const document, AMitem const* const item) {
                 AMobjType const obj_type = AMobjObjType(document, AMitemObjId(item));
                 switch (obj_type) {
                     case AM_OBJ_TYPE_LIST: {
-                        this->emplace<ValueRange>(document, item);
+                        this->emplace<ValueRange>(document, item, heads);
                         break;
                     }
                     case AM_OBJ_TYPE_MAP: {
@@ -89,24 +89,24 @@ Value::Value(AMdoc const* const document, AMitem const* const item) {
                             try {
                                 switch (static_cast<ValueType>(index)) {
                                     case ValueType::EXTERNAL_REFERENCE: {
-                                        this->emplace<ExternalReference>(document, item);
+                                        this->emplace<ExternalReference>(document, item, heads);
                                         break;
                                     }
                                     case ValueType::EXTERNAL_REFERENCE_IMPORT: {
-                                        this->emplace<ExternalReferenceImport>(document, item);
+                                        this->emplace<ExternalReferenceImport>(document, item, heads);
                                         break;
                                     }
                                     case ValueType::OBJECT_VALUE: {
-                                        this->emplace<ObjectValue>(document, item);
+                                        this->emplace<ObjectValue>(document, item, heads);
                                         break;
                                     }
                                     default:
                                         continue;
                                 }
-                                args.str("");
+                                args.clear();
                                 break;
                             } catch (std::invalid_argument const& thrown) {
-                                if (!args.str().empty()) {
+                                if (!args.empty()) {
                                     args << " | ";
                                 }
                                 args << thrown.what();
@@ -115,14 +115,14 @@ Value::Value(AMdoc const* const document, AMitem const* const item) {
                         break;
                     }
                     case AM_OBJ_TYPE_TEXT: {
-                        this->emplace<String>(document, item);
+                        this->emplace<String>(document, item, heads);
                         break;
                     }
                 }
                 break;
             }
             case AM_VAL_TYPE_STR: {
-                this->emplace<String>(document, item);
+                this->emplace<String>(document, item, heads);
                 break;
             }
             case AM_VAL_TYPE_VOID: {
@@ -137,10 +137,8 @@ Value::Value(AMdoc const* const document, AMitem const* const item) {
     } catch (std::invalid_argument const& thrown) {
         args << thrown.what();
     }
-    if (!args.str().empty()) {
-        std::ostringstream what;
-        what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
-        throw std::invalid_argument(what.str());
+    if (!args.empty()) {
+        args.raise(typeid(*this).name(), __func__);
     }
 }
 
@@ -28,49 +28,39 @@
 /**************************************************************************/
 
 #include <iostream>
-#include <map>
 #include <string>
 #include <string_view>
 
 // local
+#include "detail/enum_string.hpp"
 #include "value_type.hpp"
 
 namespace {
 
 using cavi::usdj_am::ValueType;
+using cavi::usdj_am::detail::make_enum_table;
 
-static std::map<std::string_view, ValueType> const TAGS = {
+static constexpr auto TAGS = make_enum_table<ValueType>({
     {"externalReference", ValueType::EXTERNAL_REFERENCE},
     {"externalReferenceImport", ValueType::EXTERNAL_REFERENCE_IMPORT},
     {"externalReferenceSrc", ValueType::EXTERNAL_REFERENCE_SRC},
-    {"objectValue", ValueType::OBJECT_VALUE}};
+    {"objectValue", ValueType::OBJECT_VALUE}});
 
 }  // namespace
 
 namespace cavi {
 namespace usdj_am {
 
+std::optional<ValueType> extract_ValueType(std::string_view const& view) {
+    return detail::extract_enum_tag<ValueType>(TAGS, view);
+}
+
 std::istream& operator>>(std::istream& is, ValueType& out) {
-    std::string token;
-    if (is >> token) {
-        auto const match = TAGS.find(token);
-        if (match != TAGS.end()) {
-            out = match->second;
-            return is;
-        }
-    }
-    is.setstate(std::ios::failbit);
-    return is;
+    return detail::operator>><ValueType>(is, std::make_pair(std::cref(TAGS), std::ref(out)));
 }
 
 std::ostream& operator<<(std::ostream& os, ValueType const& in) {
-    for (auto item : TAGS) {
-        if (item.second == in) {
-            os << item.first;
-            return os;
-        }
-    }
-    os << "???";
+    os << detail::extract_enum_string<ValueType>(TAGS, in).value_or("???");
     return os;
 }
 
@@ -35,9 +35,11 @@
 namespace cavi {
 namespace usdj_am {
 
-VariantDefinition::VariantDefinition(AMdoc const* const document, AMitem const* const map_object)
-    : Node(document, map_object, 4) {
-    check_enum_property("type", StatementType::VARIANT_DEF);
+VariantDefinition::VariantDefinition(AMdoc const* const document,
+                                     AMitem const* const map_object,
+                                     AMitems const* const heads)
+    : Node(document, map_object, 4, heads) {
+    check_enum_property(TYPE, StatementType::VARIANT_DEF);
 }
 
 void VariantDefinition::accept(Visitor& visitor) const& {
@@ -49,15 +51,15 @@ void VariantDefinition::accept(Visitor& visitor) && {
 }
 
 VariantDefinition::Definitions VariantDefinition::get_definitions() const {
-    return get_array_property<Definitions>("definitions");
+    return get_array_property<Definitions>(DEFINITIONS);
 }
 
 std::optional<Descriptor> VariantDefinition::get_descriptor() const {
-    return get_nullable_object_property<Descriptor>("descriptor");
+    return get_nullable_object_property<Descriptor>(DESCRIPTOR);
 }
 
 String VariantDefinition::get_name() const {
-    return get_object_property<String>("name");
+    return get_object_property<String>(NAME);
 }
 
 }  // namespace usdj_am
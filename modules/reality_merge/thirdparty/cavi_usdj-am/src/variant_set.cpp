@@ -34,8 +34,9 @@
 namespace cavi {
 namespace usdj_am {
 
-VariantSet::VariantSet(AMdoc const* const document, AMitem const* const map_object) : Node(document, map_object, 3) {
-    check_enum_property("type", StatementType::VARIANT_SET);
+VariantSet::VariantSet(AMdoc const* const document, AMitem const* const map_object, AMitems const* const heads)
+    : Node(document, map_object, 3, heads) {
+    check_enum_property(TYPE, StatementType::VARIANT_SET);
 }
 
 void VariantSet::accept(Visitor& visitor) const& {
@@ -47,11 +48,11 @@ void VariantSet::accept(Visitor& visitor) && {
 }
 
 String VariantSet::get_name() const {
-    return get_object_property<String>("name");
+    return get_object_property<String>(NAME);
 }
 
 VariantSet::VariantDefinitions VariantSet::get_definitions() const {
-    return get_array_property<VariantDefinitions>("definitions");
+    return get_array_property<VariantDefinitions>(DEFINITIONS);
 }
 
 }  // namespace usdj_am
@@ -1,27 +1,57 @@
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <optional>
+#include <sstream>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include <vector>
 
 // third-party
 #if defined(_MSC_VER)
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
 #else
 
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 #include <catch2/catch.hpp>
 #endif
+extern "C" {
+
+#include <automerge-c/automerge.h>
+}
 
 // regional
 #include <cavi/usdj_am/assignment.hpp>
+#include <cavi/usdj_am/declaration.hpp>
+#include <cavi/usdj_am/declaration_keyword.hpp>
+#include <cavi/usdj_am/definition.hpp>
+#include <cavi/usdj_am/definition_statement.hpp>
 #include <cavi/usdj_am/descriptor.hpp>
 #include <cavi/usdj_am/file.hpp>
+#include <cavi/usdj_am/statement.hpp>
+#include <cavi/usdj_am/statement_type.hpp>
+#include <cavi/usdj_am/usd/geom/token_type.hpp>
+#include <cavi/usdj_am/usd/geom/xform_op_type.hpp>
+#include <cavi/usdj_am/usd/physics/token_type.hpp>
+#include <cavi/usdj_am/usd/sdf/value_type_name.hpp>
+#include <cavi/usdj_am/utils/bytes.hpp>
 #include <cavi/usdj_am/utils/document.hpp>
+#include <cavi/usdj_am/utils/document_path.hpp>
 #include <cavi/usdj_am/utils/item.hpp>
 #include <cavi/usdj_am/utils/json_writer.hpp>
+#include <cavi/usdj_am/utils/numbers.hpp>
+#include <cavi/usdj_am/utils/scene.hpp>
+#include <cavi/usdj_am/utils/xform_program.hpp>
 
 using std::filesystem::exists;
 using std::filesystem::file_size;
@@ -32,6 +62,156 @@ path const ASSETS = "assets";
 
 path const ROOT = "files";
 
+namespace {
+
+/// \brief The numbers and strings within a declaration's value.
+using Values = std::vector<std::variant<double, std::string_view>>;
+
+/// \brief Finds a prim's "USDA_Definition" node beneath another one.
+std::optional<cavi::usdj_am::Definition> find_definition(cavi::usdj_am::Definition&& definition,
+                                                         std::string_view const& name) {
+    using namespace cavi::usdj_am;
+
+    if (definition.get_name() == name) {
+        return std::move(definition);
+    }
+    for (auto&& definition_statement : definition.get_statements()) {
+        if (auto const statement = std::get_if<Statement>(&definition_statement)) {
+            if (auto const child = std::get_if<Definition>(statement)) {
+                if (auto found = find_definition(std::move(*child), name)) {
+                    return found;
+                }
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+/// \brief Finds a prim's "USDA_Definition" node within a test document.
+std::optional<cavi::usdj_am::Definition> find_definition(cavi::usdj_am::utils::Document& document,
+                                                         std::string_view const& name) {
+    using namespace cavi::usdj_am;
+
+    for (auto&& statement : File{document, document.get_item() / "data" / "scene"}.get_statements()) {
+        if (auto const definition = std::get_if<Definition>(&statement)) {
+            if (auto found = find_definition(std::move(*definition), name)) {
+                return found;
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+/// \brief Replaces the "value" field of a declaration's map.
+void put_values(cavi::usdj_am::utils::Document& document, AMobjId const* const map_object, Values const& values) {
+    using namespace cavi::usdj_am;
+
+    utils::Document::ResultPtr const list_result{
+        AMmapPutObject(document, map_object, AMstr("value"), AM_OBJ_TYPE_LIST), AMresultFree};
+    REQUIRE(AMresultStatus(list_result.get()) == AM_STATUS_OK);
+    auto const list_object = AMitemObjId(AMresultItem(list_result.get()));
+    for (auto const& value : values) {
+        if (auto const number = std::get_if<double>(&value)) {
+            utils::Document::ResultPtr{AMlistPutF64(document, list_object, SIZE_MAX, true, *number), AMresultFree};
+        } else {
+            utils::Document::ResultPtr{
+                AMlistPutStr(document, list_object, SIZE_MAX, true, utils::to_bytes(std::get<std::string_view>(value))),
+                AMresultFree};
+        }
+    }
+}
+
+/// \brief Rewrites a prim's declaration within a test document.
+///
+/// \param[in] document A test document.
+/// \param[in] prim_name The name of the prim.
+/// \param[in] reference The name of the declaration.
+/// \param[in] new_reference The declaration's new name.
+/// \param[in] values The declaration's new value.
+/// \returns `false` if the prim has no such declaration.
+bool put_declaration(cavi::usdj_am::utils::Document& document,
+                     std::string_view const& prim_name,
+                     std::string_view const& reference,
+                     std::string_view const& new_reference,
+                     Values const& values) {
+    using namespace cavi::usdj_am;
+
+    auto const definition = find_definition(document, prim_name);
+    if (!definition) {
+        return false;
+    }
+    for (auto&& definition_statement : definition->get_statements()) {
+        auto const declaration = std::get_if<Declaration>(&definition_statement);
+        if (declaration && declaration->get_reference() == reference) {
+            auto const map_object = declaration->get_object_id();
+            if (new_reference != reference) {
+                utils::Document::ResultPtr{
+                    AMmapPutStr(document, map_object, AMstr("reference"), utils::to_bytes(new_reference)),
+                    AMresultFree};
+            }
+            put_values(document, map_object, values);
+            return true;
+        }
+    }
+    return false;
+}
+
+/// \brief Appends a declaration to a prim within a test document.
+///
+/// \param[in] document A test document.
+/// \param[in] prim_name The name of the prim.
+/// \param[in] define_type The type of the declaration.
+/// \param[in] reference The name of the declaration.
+/// \param[in] values The declaration's value.
+/// \returns `false` if the prim wasn't found.
+bool add_declaration(cavi::usdj_am::utils::Document& document,
+                     std::string_view const& prim_name,
+                     std::string_view const& define_type,
+                     std::string_view const& reference,
+                     Values const& values) {
+    using namespace cavi::usdj_am;
+
+    auto const definition = find_definition(document, prim_name);
+    if (!definition) {
+        return false;
+    }
+    utils::Document::ResultPtr const statements_result{
+        AMmapGet(document, definition->get_object_id(), AMstr("statements"), nullptr), AMresultFree};
+    REQUIRE(AMresultStatus(statements_result.get()) == AM_STATUS_OK);
+    utils::Document::ResultPtr const map_result{
+        AMlistPutObject(document, AMitemObjId(AMresultItem(statements_result.get())), SIZE_MAX, true,
+                        AM_OBJ_TYPE_MAP),
+        AMresultFree};
+    REQUIRE(AMresultStatus(map_result.get()) == AM_STATUS_OK);
+    auto const map_object = AMitemObjId(AMresultItem(map_result.get()));
+    utils::Document::ResultPtr{AMmapPutStr(document, map_object, AMstr("type"), AMstr("declaration")), AMresultFree};
+    utils::Document::ResultPtr{AMmapPutNull(document, map_object, AMstr("keyword")), AMresultFree};
+    utils::Document::ResultPtr{
+        AMmapPutStr(document, map_object, AMstr("defineType"), utils::to_bytes(define_type)), AMresultFree};
+    utils::Document::ResultPtr{
+        AMmapPutStr(document, map_object, AMstr("reference"), utils::to_bytes(reference)), AMresultFree};
+    put_values(document, map_object, values);
+    utils::Document::ResultPtr{AMmapPutNull(document, map_object, AMstr("descriptor")), AMresultFree};
+    return true;
+}
+
+/// \brief Checks a transform matrix against an expected one.
+///
+/// \param[in] matrix A matrix of the form `cavi::usdj_am::utils::XformProgram`
+///                   writes.
+/// \param[in] expected The expected matrix.
+/// \param[in] tolerance The largest difference allowed for any element.
+void check_matrix(double const (&matrix)[cavi::usdj_am::utils::XformProgram::MATRIX_SIZE],
+                  double const (&expected)[cavi::usdj_am::utils::XformProgram::MATRIX_SIZE],
+                  double const tolerance = 1e-9) {
+    for (std::size_t pos = 0; pos != cavi::usdj_am::utils::XformProgram::MATRIX_SIZE; ++pos) {
+        INFO("element " << pos);
+        CHECK(std::abs(matrix[pos] - expected[pos]) < tolerance);
+    }
+}
+
+}  // namespace
+
 TEST_CASE("Validate `Document` loading and saving", "[Document]") {
     using namespace cavi::usdj_am;
 
@@ -54,6 +234,57 @@ TEST_CASE("Validate `Document` loading and saving", "[Document]") {
     CHECK(file_mismatch.first == std::istreambuf_iterator<std::ifstream::char_type>());
 }
 
+TEST_CASE("Validate `Document` incremental saving", "[Document]") {
+    using namespace cavi::usdj_am;
+
+    path const TEMP = temp_directory_path();
+    auto document = utils::Document::load(ROOT / "a-cube.automerge");
+    auto const save_path = TEMP / "a-cube.incremental.automerge";
+    auto const saved_count = document.save(save_path);
+    auto const heads = document.get_heads();
+    CHECK(document.save_incremental(save_path, heads) == 0);
+    CHECK(file_size(save_path) == saved_count);
+    utils::Document::ResultPtr{AMmapPutStr(document, AM_ROOT, AMstr("incremental"), AMstr("save")), AMresultFree};
+    utils::Document::ResultPtr{AMcommit(document, AMstr("incremental save"), nullptr), AMresultFree};
+    auto const appended_count = document.save_incremental(save_path, heads);
+    CHECK(appended_count > 0);
+    CHECK(file_size(save_path) == saved_count + appended_count);
+    auto const reloaded = utils::Document::load(save_path);
+    CHECK(reloaded == document);
+}
+
+TEST_CASE("Validate `Document` loading after an interrupted incremental save", "[Document]") {
+    using namespace cavi::usdj_am;
+
+    path const TEMP = temp_directory_path();
+    auto document = utils::Document::load(ROOT / "a-cube.automerge");
+    auto const save_path = TEMP / "a-cube.interrupted.automerge";
+    auto const saved_count = document.save(save_path);
+    auto const heads = document.get_heads();
+    utils::Document::ResultPtr{AMmapPutStr(document, AM_ROOT, AMstr("incremental"), AMstr("save")), AMresultFree};
+    utils::Document::ResultPtr{AMcommit(document, AMstr("incremental save"), nullptr), AMresultFree};
+    auto const appended_count = document.save_incremental(save_path, heads);
+    REQUIRE(appended_count > 1);
+    std::ifstream ifs(save_path, std::ios::binary | std::ios::in);
+    std::vector<std::uint8_t> const buffer{std::istreambuf_iterator<std::ifstream::char_type>(ifs),
+                                           std::istreambuf_iterator<std::ifstream::char_type>()};
+    REQUIRE(buffer.size() == saved_count + appended_count);
+    // Cut the appended change short as if the save had been interrupted.
+    auto const truncated_count = buffer.size() - 1;
+    CHECK_THROWS_AS(utils::Document::load(buffer.data(), truncated_count), std::invalid_argument);
+    std::size_t loaded_count = 0;
+    auto const recovered = utils::Document::load(buffer.data(), truncated_count, loaded_count);
+    CHECK(loaded_count == saved_count);
+    auto const recovered_heads = recovered.get_heads();
+    AMitems recovered_items = AMresultItems(recovered_heads.get());
+    AMitems heads_items = AMresultItems(heads.get());
+    CHECK(AMitemsEqual(&recovered_items, &heads_items));
+    // A complete buffer is loaded entirely.
+    auto const reloaded = utils::Document::load(buffer.data(), buffer.size(), loaded_count);
+    CHECK(loaded_count == buffer.size());
+    CHECK(reloaded == document);
+}
+
 TEST_CASE("Load a USDJ-AM file", "[File]") {
     using namespace cavi::usdj_am;
 
@@ -137,6 +368,21 @@ TEST_CASE("Validate nested `File` with USDA.JSON files", "[File]") {
     CHECK(lhs_jq_json == rhs_jq_json);
 }
 
+TEST_CASE("Benchmark traversing nested `File`", "[File][!benchmark]") {
+    using namespace cavi::usdj_am;
+
+    // Writing JSON reads every property of every node in the syntax tree.
+    auto STEM = GENERATE(as<std::string>{}, "a-cube", "cube-island", "foolish-ape-51");
+    auto document = utils::Document::load(ROOT / (STEM + ".automerge"));
+    auto const item = document.get_item() / "data" / "scene";
+    BENCHMARK("Traverse " + STEM) {
+        auto file = File{document, item};
+        utils::JsonWriter json_writer{utils::JsonWriter::Indenter{' ', 2}};
+        file.accept(json_writer);
+        return json_writer.operator std::string().size();
+    };
+}
+
 TEST_CASE("Validate `Item` path parsing with key leaf", "[utils::Item]") {
     using namespace cavi::usdj_am;
 
@@ -176,4 +422,469 @@ TEST_CASE("Validate `Item` path parsing with pos leaf", "[utils::Item]") {
     auto parsed_assignment = Assignment{document, parsed_item};
     CHECK(parsed_assignment.get_document() == unparsed_assignment.get_document());
     CHECK(AMobjIdEqual(parsed_assignment.get_object_id(), unparsed_assignment.get_object_id()));
-}
\ No newline at end of file
+}
+
+TEST_CASE("Validate `DocumentPath` parsing and resolution", "[utils::DocumentPath]") {
+    using namespace cavi::usdj_am;
+
+    CHECK_THROWS_AS(utils::DocumentPath{""}, std::invalid_argument);
+    CHECK_THROWS_AS(utils::DocumentPath{"data/scene"}, std::invalid_argument);
+    auto const path = utils::DocumentPath{"/data/scene/descriptor/assignments/0"};
+    REQUIRE(path.get_elements().size() == 5);
+    CHECK(std::get<std::string>(path.get_elements().front()) == "data");
+    CHECK(std::get<std::uint64_t>(path.get_elements().back()) == 0);
+    auto document = utils::Document::load(ROOT / "brave-ape-49.automerge");
+    CHECK(utils::DocumentPath{"/"}.resolve(document) == document.get_item());
+    auto const unparsed_item = document.get_item() / "data" / "scene" / "descriptor" / "assignments" / 0;
+    auto const resolved_item = path.resolve(document);
+    CHECK(resolved_item == unparsed_item);
+    // The same revision is served from the cached chain.
+    CHECK(path.resolve(document) == resolved_item);
+    utils::Document::ResultPtr{AMmapPutStr(document, AM_ROOT, AMstr("resolve"), AMstr("again")), AMresultFree};
+    utils::Document::ResultPtr{AMcommit(document, AMstr("resolve again"), nullptr), AMresultFree};
+    // A new revision is resolved again.
+    CHECK(path.resolve(document) == unparsed_item);
+    // A fork of the same revision, e.g. a snapshot swapped in for the
+    // document, is also served from the cached chain.
+    auto const cached_item = path.resolve(document);
+    auto const fork = utils::Document{utils::Document::ResultPtr{AMfork(document, nullptr), AMresultFree}};
+    auto const forked_item = path.resolve(fork);
+    CHECK(static_cast<AMitem const*>(forked_item) == static_cast<AMitem const*>(cached_item));
+    CHECK(AMobjIdEqual(AMitemObjId(forked_item), AMitemObjId(unparsed_item)));
+    CHECK_THROWS_AS(utils::DocumentPath{"/data/scene/descriptor/0"}.resolve(document), std::invalid_argument);
+    CHECK_THROWS_AS(utils::DocumentPath{"/data/scene/missing/0"}.resolve(document), std::invalid_argument);
+}
+
+TEST_CASE("Validate `File` reading at a snapshot of heads", "[File]") {
+    using namespace cavi::usdj_am;
+
+    auto document = utils::Document::load(ROOT / "a-cube.automerge");
+    auto const heads_result = document.get_heads();
+    AMitems const heads = AMresultItems(heads_result.get());
+    auto const scene = document.get_item("/data/scene", &heads);
+    CHECK(scene.get_heads() == &heads);
+    auto const statement_count = File{document, scene}.get_statements().size();
+    REQUIRE(statement_count > 0);
+    utils::Document::ResultPtr{AMmapPutStr(document, AMitemObjId(scene), AMstr("statements"), AMstr("replaced")),
+                               AMresultFree};
+    utils::Document::ResultPtr{AMcommit(document, AMstr("replace statements"), nullptr), AMresultFree};
+    CHECK_THROWS_AS((File{document, document.get_item("/data/scene")}.get_statements().begin()),
+                    std::invalid_argument);
+    auto const file = File{document, scene, &heads};
+    CHECK(file.get_heads() == &heads);
+    auto const statements = file.get_statements();
+    CHECK(statements.size() == statement_count);
+    for (auto const& statement : statements) {
+        // The nodes read out of a snapshot read the same snapshot.
+        CHECK(std::visit(
+                  [](auto const& alt) -> AMitems const* {
+                      using T = std::decay_t<decltype(alt)>;
+                      if constexpr (std::is_same_v<T, std::monostate>) {
+                          return nullptr;
+                      } else {
+                          return alt.get_heads();
+                      }
+                  },
+                  statement) == &heads);
+    }
+}
+
+TEST_CASE("Validate dense reading of number arrays", "[utils::numbers]") {
+    using namespace cavi::usdj_am;
+
+    utils::Document document{utils::Document::ResultPtr{AMcreate(nullptr), AMresultFree}};
+    utils::Document::ResultPtr const numbers_result{
+        AMmapPutObject(document, AM_ROOT, AMstr("numbers"), AM_OBJ_TYPE_LIST), AMresultFree};
+    AMitem const* const numbers = AMresultItem(numbers_result.get());
+    utils::Document::ResultPtr{AMlistPutF64(document, AMitemObjId(numbers), SIZE_MAX, true, 0.5), AMresultFree};
+    utils::Document::ResultPtr{AMlistPutInt(document, AMitemObjId(numbers), SIZE_MAX, true, -2), AMresultFree};
+    utils::Document::ResultPtr{AMlistPutUint(document, AMitemObjId(numbers), SIZE_MAX, true, 3), AMresultFree};
+    ValueRange const values{document, numbers};
+    double buffer[4] = {};
+    CHECK(utils::read_numbers(values, buffer, 4) == 3);
+    CHECK(buffer[0] == 0.5);
+    CHECK(buffer[1] == -2.0);
+    CHECK(buffer[2] == 3.0);
+    // The buffer's count bounds the count of elements written.
+    float narrow[2] = {};
+    CHECK(utils::read_numbers(values, narrow, 2) == 2);
+    CHECK(narrow[1] == -2.0f);
+    // The elements read match the ones read through `Value`.
+    std::size_t pos = 0;
+    for (auto const& value : values) {
+        auto const& number = std::get<Number>(value);
+        CHECK(std::visit([](auto const alt) { return static_cast<double>(alt); }, number) == buffer[pos++]);
+    }
+    utils::Document::ResultPtr const rows_result{AMmapPutObject(document, AM_ROOT, AMstr("rows"), AM_OBJ_TYPE_LIST),
+                                                 AMresultFree};
+    AMitem const* const rows = AMresultItem(rows_result.get());
+    for (std::size_t row = 0; row != 2; ++row) {
+        utils::Document::ResultPtr const row_result{
+            AMlistPutObject(document, AMitemObjId(rows), SIZE_MAX, true, AM_OBJ_TYPE_LIST), AMresultFree};
+        AMobjId const* const row_obj_id = AMitemObjId(AMresultItem(row_result.get()));
+        for (std::size_t column = 0; column != 3; ++column) {
+            utils::Document::ResultPtr{
+                AMlistPutF64(document, row_obj_id, SIZE_MAX, true, static_cast<double>(row * 3 + column)),
+                AMresultFree};
+        }
+    }
+    double matrix[6] = {};
+    CHECK(utils::read_number_tuples(ValueRange{document, rows}, 3, matrix, 6) == 6);
+    for (std::size_t pos = 0; pos != 6; ++pos) {
+        CHECK(matrix[pos] == static_cast<double>(pos));
+    }
+    CHECK_THROWS_AS(utils::read_number_tuples(ValueRange{document, rows}, 2, matrix, 6), std::invalid_argument);
+    utils::Document::ResultPtr{AMlistPutStr(document, AMitemObjId(numbers), SIZE_MAX, true, AMstr("four")),
+                               AMresultFree};
+    CHECK_THROWS_AS(utils::read_numbers(values, buffer, 4), std::invalid_argument);
+}
+
+TEST_CASE("Validate enum tag lookups", "[detail::EnumTable]") {
+    using namespace cavi::usdj_am;
+
+    // Every tag with a serialized form is found by it and parsed from it.
+    auto const check_round_trips = [](auto const begin, auto const end, auto const extract) {
+        using EnumT = std::decay_t<decltype(begin)>;
+        using Underlying = std::underlying_type_t<EnumT>;
+        for (auto value = static_cast<Underlying>(begin); value != static_cast<Underlying>(end); ++value) {
+            auto const tag = static_cast<EnumT>(value);
+            std::ostringstream oss;
+            oss << tag;
+            if (oss.str() != "???") {
+                CHECK(extract(oss.str()) == tag);
+                std::istringstream iss{oss.str()};
+                EnumT parsed{};
+                CHECK(static_cast<bool>(iss >> parsed));
+                CHECK(parsed == tag);
+            }
+        }
+    };
+    check_round_trips(DeclarationKeyword::BEGIN__, DeclarationKeyword::END__, extract_DeclarationKeyword);
+    check_round_trips(StatementType::BEGIN__, StatementType::END__, extract_StatementType);
+    check_round_trips(usd::geom::TokenType::BEGIN__, usd::geom::TokenType::END__, usd::geom::extract_TokenType);
+    check_round_trips(usd::geom::XformOpType::BEGIN__, usd::geom::XformOpType::END__, usd::geom::extract_XformOpType);
+    check_round_trips(
+        usd::physics::TokenType::BEGIN__, usd::physics::TokenType::END__, usd::physics::extract_TokenType);
+    check_round_trips(
+        usd::sdf::ValueTypeName::BEGIN__, usd::sdf::ValueTypeName::END__, usd::sdf::extract_ValueTypeName);
+    CHECK(usd::sdf::extract_ValueTypeName("float") == usd::sdf::ValueTypeName::FLOAT);
+    CHECK(usd::sdf::extract_ValueTypeName("float3") == usd::sdf::ValueTypeName::FLOAT_3);
+    CHECK_FALSE(usd::sdf::extract_ValueTypeName("float3x"));
+    CHECK_FALSE(usd::sdf::extract_ValueTypeName("floa"));
+    CHECK_FALSE(usd::sdf::extract_ValueTypeName(""));
+    CHECK_FALSE(usd::sdf::extract_ValueTypeName(std::string(128, 'f')));
+}
+
+TEST_CASE("Benchmark looking up enum tags", "[detail::EnumTable][!benchmark]") {
+    using namespace cavi::usdj_am;
+
+    // Every string within the USDA JSON is looked up as a token.
+    auto STEM = GENERATE(as<std::string>{}, "a-cube", "cube-island", "foolish-ape-51");
+    auto document = utils::Document::load(ROOT / (STEM + ".automerge"));
+    utils::JsonWriter json_writer{utils::JsonWriter::Indenter{' ', 2}};
+    File{document, document.get_item() / "data" / "scene"}.accept(json_writer);
+    auto const json = json_writer.operator std::string();
+    std::vector<std::string> tokens;
+    for (auto first = json.find('"'); first != std::string::npos; first = json.find('"', first)) {
+        auto const last = json.find('"', first + 1);
+        if (last == std::string::npos) {
+            break;
+        }
+        tokens.emplace_back(json, first + 1, last - first - 1);
+        first = last + 1;
+    }
+    REQUIRE(!tokens.empty());
+    BENCHMARK("Look up tokens in " + STEM) {
+        std::size_t count = 0;
+        for (auto const& token : tokens) {
+            count += usd::geom::extract_TokenType(token).has_value();
+            count += usd::physics::extract_TokenType(token).has_value();
+            count += usd::sdf::extract_ValueTypeName(token).has_value();
+        }
+        return count;
+    };
+    BENCHMARK("Parse tokens from streams in " + STEM) {
+        std::size_t count = 0;
+        for (auto const& token : tokens) {
+            usd::geom::TokenType geom_token_type;
+            usd::physics::TokenType physics_token_type;
+            usd::sdf::ValueTypeName value_type_name;
+            std::istringstream geom_iss{token};
+            count += static_cast<bool>(geom_iss >> geom_token_type);
+            std::istringstream physics_iss{token};
+            count += static_cast<bool>(physics_iss >> physics_token_type);
+            std::istringstream sdf_iss{token};
+            count += static_cast<bool>(sdf_iss >> value_type_name);
+        }
+        return count;
+    };
+}
+
+TEST_CASE("Validate `Scene` compilation of nested `File`", "[utils::Scene]") {
+    using namespace cavi::usdj_am;
+
+    auto document = utils::Document::load(ROOT / "a-cube.automerge");
+    auto const file = File{document, document.get_item() / "data" / "scene"};
+    utils::Scene const scene{file};
+    REQUIRE(scene.get_prim_count() == 2);
+    auto const world = scene.get_default_prim();
+    REQUIRE(world == 0);
+    CHECK(scene.get_token(scene.get_prim_name(world)) == "world");
+    CHECK(scene.get_token(scene.get_prim_type(world)) == "Xform");
+    CHECK(scene.get_prim_parent(world) == utils::Scene::NONE);
+    CHECK(scene.get_prim_end(world) == 2);
+    auto const cube = world + 1;
+    CHECK(scene.get_token(scene.get_prim_name(cube)) == "myFirstCube");
+    CHECK(scene.get_prim_type(cube) == utils::Scene::NONE);
+    CHECK(scene.get_prim_parent(cube) == world);
+    CHECK(scene.get_prim_sub_type(cube) == DefinitionType::DEF);
+    // The prims can be found by the IDs of their Automerge objects.
+    for (auto const& statement : file.get_statements()) {
+        auto const& definition = std::get<Definition>(statement);
+        CHECK(scene.find_prim(definition.get_object_id()) == world);
+        // Their actor IDs aren't interned as tokens.
+        auto const actor_id = AMactorIdBytes(AMobjIdActorId(definition.get_object_id()));
+        CHECK(scene.find_token(std::string_view{reinterpret_cast<char const*>(actor_id.src), actor_id.count}) ==
+              utils::Scene::NONE);
+    }
+    auto const references = scene.find_attribute(cube, "references");
+    REQUIRE(references != utils::Scene::NONE);
+    CHECK(scene.get_attribute_scope(references) == utils::Scene::Scope::METADATA);
+    CHECK(scene.get_metadata_keyword(references) == AssignmentKeyword::PREPEND);
+    CHECK(scene.get_attribute_value_kind(references) == utils::Scene::ValueKind::TOKENS);
+    auto const reference = scene.get_attribute_values(references);
+    REQUIRE(reference.count == 1);
+    CHECK(scene.get_token(scene.get_token_values()[reference.first]) == "cube.usda");
+    auto const xform_op_order = scene.find_attribute(cube, "xformOpOrder");
+    REQUIRE(xform_op_order != utils::Scene::NONE);
+    CHECK(scene.get_token(scene.get_attribute_type(xform_op_order)) == "token[]");
+    CHECK(scene.get_property_keyword(xform_op_order) == DeclarationKeyword::UNIFORM);
+    auto const ops = scene.get_attribute_values(xform_op_order);
+    REQUIRE(ops.count == 3);
+    CHECK(scene.get_token(scene.get_token_values()[ops.first]) == "xformOp:translate");
+    CHECK(scene.get_token(scene.get_token_values()[ops.first + 1]) == "xformOp:rotateXYZ");
+    CHECK(scene.get_token(scene.get_token_values()[ops.first + 2]) == "xformOp:scale");
+    auto const scale = scene.find_attribute(cube, "xformOp:scale");
+    REQUIRE(scale != utils::Scene::NONE);
+    CHECK(scene.get_attribute_value_kind(scale) == utils::Scene::ValueKind::NUMBERS);
+    auto const scale_values = scene.get_attribute_values(scale);
+    REQUIRE(scale_values.count == 3);
+    for (auto pos = scale_values.first; pos != scale_values.first + scale_values.count; ++pos) {
+        CHECK(scene.get_numbers()[pos] == 1.0);
+    }
+    CHECK(scene.find_attribute(world, "xformOp:scale") == utils::Scene::NONE);
+    CHECK(scene.find_token("xformOp:translate:pivot") == utils::Scene::NONE);
+}
+
+TEST_CASE("Validate `Scene` digests of changed prims", "[utils::Scene]") {
+    using namespace cavi::usdj_am;
+
+    auto document = utils::Document::load(ROOT / "a-cube.automerge");
+    auto const item = document.get_item() / "data" / "scene";
+    utils::Scene const before{File{document, item}};
+    REQUIRE(before.get_prim_count() == 2);
+    // A scene compiled from the same revision has the same digests.
+    utils::Scene const again{File{document, item}};
+    CHECK(again.get_prim_digest(0) == before.get_prim_digest(0));
+    CHECK(again.get_prim_digest(1) == before.get_prim_digest(1));
+    CHECK(again.get_prim_own_digest(1) == before.get_prim_own_digest(1));
+    // The same prims are found within either scene.
+    CHECK(again.find_prim(before, 1) == 1);
+    CHECK(again.get_prim_object_key(1) == before.get_prim_object_key(1));
+    CHECK(again.get_prim_object_key(0) != before.get_prim_object_key(1));
+    // Scale the cube along its X axis.
+    REQUIRE(put_declaration(document, "myFirstCube", "xformOp:scale", "xformOp:scale", {2.0, 1.0, 1.0}));
+    utils::Scene const after{File{document, item}};
+    REQUIRE(after.get_prim_count() == 2);
+    // The change is reflected by the digests of the cube and its ancestors.
+    CHECK(after.get_prim_digest(1) != before.get_prim_digest(1));
+    CHECK(after.get_prim_digest(0) != before.get_prim_digest(0));
+    // Only the cube's own fields were changed.
+    CHECK(after.get_prim_own_digest(1) != before.get_prim_own_digest(1));
+    CHECK(after.get_prim_own_digest(0) == before.get_prim_own_digest(0));
+    auto const values = after.get_attribute_values(after.find_attribute(1, "xformOp:scale"));
+    CHECK(after.get_numbers()[values.first] == 2.0);
+}
+
+TEST_CASE("Benchmark compiling nested `File` into a `Scene`", "[utils::Scene][!benchmark]") {
+    using namespace cavi::usdj_am;
+
+    auto STEM = GENERATE(as<std::string>{}, "a-cube", "cube-island", "foolish-ape-51");
+    auto document = utils::Document::load(ROOT / (STEM + ".automerge"));
+    auto const item = document.get_item() / "data" / "scene";
+    BENCHMARK("Compile " + STEM) {
+        auto file = File{document, item};
+        return utils::Scene{file}.get_attribute_count();
+    };
+}
+
+TEST_CASE("Validate `XformOp` extraction", "[utils::XformProgram]") {
+    using namespace cavi::usdj_am;
+    using usd::geom::XformOpType;
+
+    auto const translate = utils::extract_XformOp("xformOp:translate");
+    REQUIRE(translate);
+    CHECK(translate->type == XformOpType::TRANSLATE);
+    CHECK(translate->name == "xformOp:translate");
+    CHECK(translate->suffix.empty());
+    CHECK(!translate->inverse);
+    // Two operations of the same type are distinguished by their suffixes.
+    auto const pivot = utils::extract_XformOp("!invert!xformOp:translate:pivot");
+    REQUIRE(pivot);
+    CHECK(pivot->type == XformOpType::TRANSLATE);
+    CHECK(pivot->name == "xformOp:translate:pivot");
+    CHECK(pivot->suffix == "pivot");
+    CHECK(pivot->inverse);
+    auto const reset = utils::extract_XformOp("!resetXformStack!");
+    REQUIRE(reset);
+    CHECK(reset->type == XformOpType::RESET_XFORM_STACK);
+    CHECK(!utils::extract_XformOp("!invert!!resetXformStack!"));
+    CHECK(!utils::extract_XformOp("xformOp:translate:"));
+    CHECK(!utils::extract_XformOp("xformOp:shear"));
+}
+
+TEST_CASE("Validate `XformProgram` evaluation of nested `File`", "[utils::XformProgram]") {
+    using namespace cavi::usdj_am;
+
+    auto document = utils::Document::load(ROOT / "a-cube.automerge");
+    auto const item = document.get_item() / "data" / "scene";
+    // Double the cube's scale along its X axis.
+    REQUIRE(put_declaration(document, "myFirstCube", "xformOp:scale", "xformOp:scale", {2.0, 1.0, 1.0}));
+    utils::Scene const scene{File{document, item}};
+    utils::XformProgram program{scene};
+    REQUIRE(program.get_prim_count() == 2);
+    CHECK(program.get_op_count(0) == 0);
+    CHECK(program.get_op_count(1) == 3);
+    CHECK(!program.get_reset(1));
+    CHECK(program.get_reset_count() == 0);
+    double const expected[utils::XformProgram::MATRIX_SIZE] = {2.0, 0.0, 0.0, 0.0, 0.0, 1.0,
+                                                               0.0, 0.0, 0.0, 0.0, 1.0, 0.0};
+    double matrix[utils::XformProgram::MATRIX_SIZE];
+    // The local matrices can be evaluated without the world ones.
+    program.evaluate_locals();
+    program.get_local_matrix(1, matrix);
+    CHECK(std::equal(std::begin(matrix), std::end(matrix), std::begin(expected)));
+    program.evaluate();
+    program.get_local_matrix(1, matrix);
+    CHECK(std::equal(std::begin(matrix), std::end(matrix), std::begin(expected)));
+    // The world has no transform so the cube's world matrix is its local one.
+    program.get_world_matrix(1, matrix);
+    CHECK(std::equal(std::begin(matrix), std::end(matrix), std::begin(expected)));
+}
+
+TEST_CASE("Validate `XformProgram` operations of nested `File`", "[utils::XformProgram]") {
+    using namespace cavi::usdj_am;
+
+    auto document = utils::Document::load(ROOT / "a-cube.automerge");
+    double local[utils::XformProgram::MATRIX_SIZE];
+    double world[utils::XformProgram::MATRIX_SIZE];
+    // Evaluates the cube's matrices and reports whether it resets its
+    // transform stack.
+    auto const evaluate = [&]() {
+        utils::Scene const scene{File{document, document.get_item() / "data" / "scene"}};
+        utils::XformProgram program{scene};
+        REQUIRE(program.get_prim_count() == 2);
+        program.evaluate();
+        program.get_local_matrix(1, local);
+        program.get_world_matrix(1, world);
+        CHECK(program.get_reset_count() == static_cast<std::size_t>(program.get_reset(1)));
+        return program.get_reset(1);
+    };
+    SECTION("Euler rotations are applied in the order of their axes") {
+        REQUIRE(put_declaration(document, "myFirstCube", "xformOp:rotateXYZ", "xformOp:rotateXYZ", {90.0, 0.0, 90.0}));
+        CHECK(!evaluate());
+        // Rz(90) * Rx(90)
+        check_matrix(local, {0.0, 0.0, 1.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0});
+        REQUIRE(put_declaration(document, "myFirstCube", "xformOp:rotateXYZ", "xformOp:rotateZYX", {90.0, 0.0, 90.0}));
+        REQUIRE(put_declaration(document, "myFirstCube", "xformOpOrder", "xformOpOrder",
+                                {"xformOp:translate", "xformOp:rotateZYX", "xformOp:scale"}));
+        CHECK(!evaluate());
+        // Rx(90) * Rz(90)
+        check_matrix(local, {0.0, -1.0, 0.0, 0.0, 0.0, 0.0, -1.0, 0.0, 1.0, 0.0, 0.0, 0.0});
+    }
+    SECTION("A quaternion is written with its real part first") {
+        // 90 degrees about Z rather than about X.
+        REQUIRE(put_declaration(document, "myFirstCube", "xformOp:rotateXYZ", "xformOp:orient", {1.0, 0.0, 0.0, 1.0}));
+        REQUIRE(put_declaration(document, "myFirstCube", "xformOpOrder", "xformOpOrder",
+                                {"xformOp:translate", "xformOp:orient", "xformOp:scale"}));
+        CHECK(!evaluate());
+        check_matrix(local, {0.0, -1.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0});
+    }
+    SECTION("An inverted operation is undone") {
+        REQUIRE(put_declaration(document, "myFirstCube", "xformOp:translate", "xformOp:translate", {1.0, 2.0, 3.0}));
+        REQUIRE(put_declaration(document, "myFirstCube", "xformOp:scale", "xformOp:scale", {2.0, 4.0, 8.0}));
+        REQUIRE(put_declaration(document, "myFirstCube", "xformOpOrder", "xformOpOrder",
+                                {"xformOp:translate", "!invert!xformOp:scale"}));
+        CHECK(!evaluate());
+        check_matrix(local, {0.5, 0.0, 0.0, 1.0, 0.0, 0.25, 0.0, 2.0, 0.0, 0.0, 0.125, 3.0});
+    }
+    SECTION("A rotation about a pivot keeps the pivot in place") {
+        REQUIRE(put_declaration(document, "myFirstCube", "xformOp:translate", "xformOp:translate:pivot",
+                                {1.0, 0.0, 0.0}));
+        REQUIRE(put_declaration(document, "myFirstCube", "xformOp:rotateXYZ", "xformOp:rotateXYZ", {0.0, 0.0, 90.0}));
+        REQUIRE(put_declaration(document, "myFirstCube", "xformOpOrder", "xformOpOrder",
+                                {"xformOp:translate:pivot", "xformOp:rotateXYZ", "!invert!xformOp:translate:pivot"}));
+        CHECK(!evaluate());
+        check_matrix(local, {0.0, -1.0, 0.0, 1.0, 1.0, 0.0, 0.0, -1.0, 0.0, 0.0, 1.0, 0.0});
+    }
+    SECTION("A reset transform stack ignores the parent's transform") {
+        REQUIRE(add_declaration(document, "world", "double3", "xformOp:translate", {10.0, 0.0, 0.0}));
+        REQUIRE(add_declaration(document, "world", "token[]", "xformOpOrder", {"xformOp:translate"}));
+        REQUIRE(put_declaration(document, "myFirstCube", "xformOp:translate", "xformOp:translate", {1.0, 2.0, 3.0}));
+        CHECK(!evaluate());
+        check_matrix(local, {1.0, 0.0, 0.0, 1.0, 0.0, 1.0, 0.0, 2.0, 0.0, 0.0, 1.0, 3.0});
+        check_matrix(world, {1.0, 0.0, 0.0, 11.0, 0.0, 1.0, 0.0, 2.0, 0.0, 0.0, 1.0, 3.0});
+        REQUIRE(put_declaration(document, "myFirstCube", "xformOpOrder", "xformOpOrder",
+                                {"!resetXformStack!", "xformOp:translate", "xformOp:rotateXYZ", "xformOp:scale"}));
+        CHECK(evaluate());
+        check_matrix(local, {1.0, 0.0, 0.0, 1.0, 0.0, 1.0, 0.0, 2.0, 0.0, 0.0, 1.0, 3.0});
+        check_matrix(world, local);
+    }
+}
+
+TEST_CASE("Validate `XformProgram` world matrices of nested `File`", "[utils::XformProgram]") {
+    using namespace cavi::usdj_am;
+
+    auto document = utils::Document::load(ROOT / "cube-island.automerge");
+    utils::Scene const scene{File{document, document.get_item() / "data" / "scene"}};
+    utils::XformProgram program{scene};
+    REQUIRE(program.get_prim_count() == scene.get_prim_count());
+    CHECK(program.get_batch_count() > 1);
+    program.evaluate();
+    // The world has no transform so every world matrix is its local one.
+    for (utils::Scene::Index prim = 0; prim != program.get_prim_count(); ++prim) {
+        double local[utils::XformProgram::MATRIX_SIZE];
+        double world[utils::XformProgram::MATRIX_SIZE];
+        program.get_local_matrix(prim, local);
+        program.get_world_matrix(prim, world);
+        check_matrix(world, local);
+    }
+    // T * Rz * Ry * Rx * S for the rotated cube "Def55", whose operands may
+    // have been rounded to single precision.
+    auto prim = utils::Scene::Index{0};
+    while (prim != scene.get_prim_count() && scene.get_token(scene.get_prim_name(prim)) != "Def55") {
+        ++prim;
+    }
+    REQUIRE(prim != scene.get_prim_count());
+    double world[utils::XformProgram::MATRIX_SIZE];
+    program.get_world_matrix(prim, world);
+    check_matrix(world, {-0.257511060285, -0.130482723095, -0.123098828633, 3.426234, -1.808179271913, 0.396880846533,
+                         -0.000000054441, -2.619843, 1.161877358134, 0.588729069345, -0.027282921126, 7.90734},
+                 1e-6);
+}
+
+TEST_CASE("Benchmark evaluating an `XformProgram`", "[utils::XformProgram][!benchmark]") {
+    using namespace cavi::usdj_am;
+
+    auto STEM = GENERATE(as<std::string>{}, "a-cube", "cube-island", "foolish-ape-51");
+    auto document = utils::Document::load(ROOT / (STEM + ".automerge"));
+    utils::Scene const scene{File{document, document.get_item() / "data" / "scene"}};
+    BENCHMARK("Compile " + STEM) {
+        return utils::XformProgram{scene}.get_batch_count();
+    };
+    utils::XformProgram program{scene};
+    BENCHMARK("Evaluate " + STEM) {
+        program.evaluate();
+        return program.get_world_matrices()[0];
+    };
+}
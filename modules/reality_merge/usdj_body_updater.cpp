@@ -27,7 +27,6 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
-#include <algorithm>
 #include <cassert>
 #include <sstream>
 #include <stdexcept>
@@ -47,6 +46,7 @@ extern "C" {
 #include <cavi/usdj_am/statement.hpp>
 #include <cavi/usdj_am/usd/geom/token_type.hpp>
 #include <cavi/usdj_am/utils/document.hpp>
+#include <cavi/usdj_am/utils/document_path.hpp>
 
 // regional
 #include <core/error/error_macros.h>
@@ -58,35 +58,59 @@ extern "C" {
 #include "usdj_body_updater.h"
 #include "usdj_static_body_3d.h"
 
-UsdjBodyUpdater::UsdjBodyUpdater(TypedArray<Node> const& nodes) : m_visited_default_prim{false} {
-    for (int pos = 0; pos != nodes.size(); ++pos) {
-        auto const body = Object::cast_to<Body>(nodes[pos]);
-        if (body)
-            m_bodies.push_back(body);
-    }
-}
+UsdjBodyUpdater::UsdjBodyUpdater(Bodies& bodies, bool const instanced)
+    : m_bodies{bodies},
+      m_instanced{instanced},
+      m_parent_body{nullptr},
+      m_pruning{false},
+      m_visited_default_prim{false} {}
 
 UsdjBodyUpdater::~UsdjBodyUpdater() {}
 
 UsdjBodyUpdater::Updates UsdjBodyUpdater::operator()(cavi::usdj_am::utils::Document const& document,
-                                                     std::string const& path) {
+                                                     cavi::usdj_am::utils::DocumentPath const& path,
+                                                     std::optional<cavi::usdj_am::utils::Scene>& scene) {
     using cavi::usdj_am::File;
 
     m_updates.clear();
+    m_previous_scene = std::move(scene);
+    m_scene.reset();
+    m_pruning = false;
     try {
-        auto const file = File{document, document.get_item(path)};
+        auto const file = File{document, path.resolve(document)};
+        try {
+            // Automerge can't report which objects a merge touched so they're
+            // found by comparing the scenes compiled before and after it.
+            m_scene.emplace(file);
+            // A subtree can only be skipped if it's within the same default
+            // prim as before.
+            auto const default_prim = m_scene->get_default_prim();
+            m_pruning = m_previous_scene && default_prim != Scene::NONE &&
+                        m_previous_scene->get_default_prim() != Scene::NONE &&
+                        m_scene->find_prim(*m_previous_scene, m_previous_scene->get_default_prim()) == default_prim;
+        } catch (std::invalid_argument const&) {
+            // Every prim is visited and every body is revised instead.
+            m_scene.reset();
+        }
         file.accept(*this);
     } catch (std::invalid_argument const&) {
         // The document may be incomplete because it hasn't been fully
         // downloaded from the server yet.
     }
-    // Any remaining bodies should be removed because they originated
-    // from expired USD prims.
-    while (!m_bodies.empty()) {
-        auto const body = m_bodies.front();
-        m_updates.insert(Updates::value_type{Action::REMOVE, body});
-        m_bodies.pop_front();
+    scene = std::move(m_scene);
+    m_previous_scene.reset();
+    if (!m_pruning) {
+        // Any remaining bodies should be removed because they originated
+        // from expired USD prims.
+        for (auto const& item : m_bodies) {
+            if (auto const body = Object::cast_to<Body>(ObjectDB::get_instance(item.second)))
+                m_updates.insert(Updates::value_type{Action::REMOVE, Update{body, nullptr}});
+        }
+        m_bodies.clear();
     }
+    // The remaining bodies are within unchanged subtrees otherwise.
+    m_bodies.merge(m_visited_bodies);
+    m_visited_bodies.clear();
     return m_updates;
 }
 
@@ -109,36 +133,63 @@ void UsdjBodyUpdater::visit(cavi::usdj_am::Definition const& definition) {
     using cavi::usdj_am::usd::geom::extract_TokenType;
     using cavi::usdj_am::usd::geom::TokenType;
 
+    auto const body_id = definition.get_object_id();
+    auto key = UsdjObjectKey{body_id};
+    auto const previous_prim = (m_pruning) ? m_previous_scene->find_prim(body_id) : Scene::NONE;
+    if (is_unchanged(body_id)) {
+        // The prim and its descendants are left as they were unless its body
+        // was freed by something other than an update.
+        auto const match = m_bodies.find(key);
+        if (match == m_bodies.end() || ObjectDB::get_instance(match->second))
+            return;
+    }
     if (definition.get_sub_type() != DefinitionType::DEF) {
+        if (m_visited_default_prim)
+            remove_subtree(previous_prim);
         return;
     }
+    auto const def_type = definition.get_def_type();
+    auto const is_xform = def_type && extract_TokenType(*def_type).value_or(TokenType{}) == TokenType::XFORM;
     if (!m_visited_default_prim) {
-        auto const def_type = definition.get_def_type();
-        if (def_type && extract_TokenType(*def_type).value_or(TokenType{}) == TokenType::XFORM && m_default_prim &&
-            definition.get_name() == *m_default_prim) {
-            m_visited_default_prim = true;
-            for (auto&& definition_statement : definition.get_statements()) {
-                std::forward<decltype(definition_statement)>(definition_statement).accept(*this);
-            }
-        }
-        return;
-    }
-    auto const descriptor = definition.get_descriptor();
-    if (!descriptor) {
+        // Only the default prim and its descendants have bodies; the default
+        // prim's body groups the others so that its transform applies to
+        // them.
+        if (!(is_xform && m_default_prim && definition.get_name() == *m_default_prim))
+            return;
+        m_visited_default_prim = true;
+    } else if (!definition.get_descriptor() && !is_xform) {
+        // A prim that's neither described nor a group of other prims is
+        // skipped along with its descendants.
+        remove_subtree(previous_prim);
         return;
     }
-    auto const body_id = definition.get_object_id();
-    auto const match = std::find_if(m_bodies.begin(), m_bodies.end(), [body_id](auto const& body) {
-        auto const static_body_3d = dynamic_cast<UsdjStaticBody3D*>(body);
-        return static_body_3d && AMobjIdEqual(static_body_3d->get_object_id(), body_id);
-    });
-    if (match == m_bodies.end()) {
-        auto const usd_body = memnew(UsdjStaticBody3D{std::move(m_definition.value())});
-        m_updates.insert({Action::ADD, usd_body});
+    // The nested prims are read after the definition has been moved into
+    // its body.
+    auto const definition_statements = definition.get_statements();
+    auto node = m_bodies.extract(key);
+    // The body may have been freed by something other than an update.
+    auto body = (node) ? Object::cast_to<Body>(ObjectDB::get_instance(node.mapped())) : nullptr;
+    if (!body) {
+        body = memnew(UsdjStaticBody3D{std::move(m_definition.value()), m_instanced});
+        m_updates.insert({Action::ADD, Update{body, m_parent_body}});
+        m_visited_bodies.emplace(std::move(key), body->get_instance_id());
     } else {
-        m_updates.insert({Action::KEEP, *match});
-        m_bodies.erase(match);
+        // A group whose own attributes are unchanged is kept even when its
+        // descendants were changed because they're revised by themselves.
+        auto const action = (is_changed(body_id)) ? Action::REVISE : Action::KEEP;
+        // The document may be a newer revision than the one the body was
+        // constructed from.
+        body->set_definition(std::move(m_definition.value()));
+        m_updates.insert({action, Update{body, m_parent_body}});
+        m_visited_bodies.insert(std::move(node));
+    }
+    auto const parent_body = m_parent_body;
+    m_parent_body = body;
+    for (auto&& definition_statement : definition_statements) {
+        std::forward<decltype(definition_statement)>(definition_statement).accept(*this);
     }
+    m_parent_body = parent_body;
+    remove_missing_children(previous_prim);
 }
 
 void UsdjBodyUpdater::visit(cavi::usdj_am::DefinitionStatement&& definition_statement) {
@@ -178,6 +229,47 @@ void UsdjBodyUpdater::visit(cavi::usdj_am::File const& file) {
     }
 }
 
+bool UsdjBodyUpdater::is_changed(AMobjId const* const object_id) const {
+    if (!(m_previous_scene && m_scene))
+        return true;
+    auto const previous = m_previous_scene->find_prim(object_id);
+    auto const current = m_scene->find_prim(object_id);
+    return previous == Scene::NONE || current == Scene::NONE ||
+           m_previous_scene->get_prim_own_digest(previous) != m_scene->get_prim_own_digest(current);
+}
+
+bool UsdjBodyUpdater::is_unchanged(AMobjId const* const object_id) const {
+    if (!m_pruning)
+        return false;
+    auto const previous = m_previous_scene->find_prim(object_id);
+    auto const current = m_scene->find_prim(object_id);
+    return previous != Scene::NONE && current != Scene::NONE &&
+           m_previous_scene->get_prim_digest(previous) == m_scene->get_prim_digest(current);
+}
+
+void UsdjBodyUpdater::remove_missing_children(Scene::Index const previous_prim) {
+    if (previous_prim == Scene::NONE)
+        return;
+    auto const end = m_previous_scene->get_prim_end(previous_prim);
+    for (auto child = previous_prim + 1; child != end; child = m_previous_scene->get_prim_end(child)) {
+        if (m_scene->find_prim(*m_previous_scene, child) == Scene::NONE)
+            remove_subtree(child);
+    }
+}
+
+void UsdjBodyUpdater::remove_subtree(Scene::Index const previous_prim) {
+    if (previous_prim == Scene::NONE)
+        return;
+    auto const end = m_previous_scene->get_prim_end(previous_prim);
+    for (auto prim = previous_prim; prim != end; ++prim) {
+        auto node = m_bodies.extract(UsdjObjectKey{m_previous_scene->get_prim_object_key(prim)});
+        if (!node)
+            continue;
+        if (auto const body = Object::cast_to<Body>(ObjectDB::get_instance(node.mapped())))
+            m_updates.insert(Updates::value_type{Action::REMOVE, Update{body, nullptr}});
+    }
+}
+
 void UsdjBodyUpdater::visit(cavi::usdj_am::Statement&& statement) {
     using cavi::usdj_am::Definition;
 
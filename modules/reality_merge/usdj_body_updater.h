@@ -31,21 +31,23 @@
 #define REALITY_MERGE_USDJ_BODY_UPDATER_H
 
 #include <cstdint>
-#include <list>
 #include <map>
 #include <memory>
 #include <optional>
 #include <string>
+#include <unordered_map>
 
 // third-party
 #include <cavi/usdj_am/definition.hpp>
+#include <cavi/usdj_am/utils/scene.hpp>
 #include <cavi/usdj_am/visitor.hpp>
 
 // regional
+#include <core/object/object_id.h>
 #include <core/typedefs.h>
-#include <core/variant/typed_array.h>
 
 // local
+#include "usdj_editor.h"
 #include "usdj_static_body_3d.h"
 
 namespace cavi {
@@ -53,6 +55,7 @@ namespace usdj_am {
 namespace utils {
 
 class Document;
+class DocumentPath;
 
 }  // namespace utils
 }  // namespace usdj_am
@@ -62,34 +65,67 @@ class UsdjBodyUpdater : public cavi::usdj_am::Visitor {
 public:
     using Body = UsdjStaticBody3D;
 
-    enum class Action : std::uint8_t { BEGIN__ = 1, ADD = BEGIN__, KEEP, REMOVE, END__, SIZE__ = END__ - BEGIN__ };
-
-    using Updates = std::multimap<Action, Body*>;
+    /// \note A kept body was rebound to the latest revision of its
+    ///       "USDA_Definition" but nothing within it changed whereas a
+    ///       revised body must be revised to reflect the changes within it.
+    enum class Action : std::uint8_t {
+        BEGIN__ = 1,
+        ADD = BEGIN__,
+        KEEP,
+        REVISE,
+        REMOVE,
+        END__,
+        SIZE__ = END__ - BEGIN__
+    };
+
+    /// \brief An index of physics bodies by the object IDs of the
+    ///        "USDA_Definition" nodes that they were constructed from.
+    using Bodies = std::unordered_map<UsdjObjectKey, ObjectID, UsdjObjectKey::Hash>;
+
+    /// \brief A physics body and the body constructed from the parent of its
+    ///        prim, which is `nullptr` for the default prim.
+    struct Update {
+        Body* body;
+        Body* parent;
+    };
+
+    using Updates = std::multimap<Action, Update>;
 
     UsdjBodyUpdater() = delete;
 
-    /// \brief Borrows nodes that represent physics bodies within a scene.
+    /// \brief Borrows an index of the physics bodies within a scene.
     ///
-    /// \param[in] nodes An array of child nodes in a scene node.
-    UsdjBodyUpdater(TypedArray<Node> const& nodes);
+    /// \param[in,out] bodies The index of the physics bodies constructed by the
+    ///                       previous update, which is replaced by an index of
+    ///                       the ones that aren't removed by this update.
+    /// \param[in] instanced A toggle for constructing new physics bodies
+    ///                      whose meshes are drawn by a
+    ///                      `UsdjMultiMeshInstancer`.
+    UsdjBodyUpdater(Bodies& bodies, bool const instanced = false);
 
     UsdjBodyUpdater(UsdjBodyUpdater const&) = delete;
 
-    UsdjBodyUpdater(UsdjBodyUpdater&&) = default;
-
     ~UsdjBodyUpdater();
 
     UsdjBodyUpdater& operator=(UsdjBodyUpdater const&) = delete;
 
-    UsdjBodyUpdater& operator=(UsdjBodyUpdater&&) = default;
-
     /// \brief Creates new physics bodies and sorts pre-existing ones into
-    ///        categories of forgotten, kept and removed.
+    ///        categories of forgotten, kept, revised and removed.
     ///
     /// \param[in] document An Automerge document.
     /// \param[in] path A POSIX path to a "USDA_File" node within \p document.
-    /// \returns A multimap of categories to physics bodies.
-    Updates operator()(cavi::usdj_am::utils::Document const& document, std::string const& path);
+    /// \param[in,out] scene The scene compiled from the revision of the
+    ///                      "USDA_File" node that was updated from last,
+    ///                      which is replaced by the one compiled from this
+    ///                      revision, or `std::nullopt` to revise every body.
+    /// \returns A multimap of categories to physics bodies in which the body
+    ///          of a prim precedes those of the prims nested within it.
+    /// \note The bodies within a subtree whose digest is the same in both
+    ///       scenes are neither visited nor listed so that an update costs
+    ///       what changed instead of what exists.
+    Updates operator()(cavi::usdj_am::utils::Document const& document,
+                       cavi::usdj_am::utils::DocumentPath const& path,
+                       std::optional<cavi::usdj_am::utils::Scene>& scene);
 
     void visit(cavi::usdj_am::Assignment const& assignment) override;
 
@@ -104,12 +140,53 @@ public:
     void visit(cavi::usdj_am::Statement&& statement) override;
 
 private:
-    using Bodies = std::list<Body*>;
+    using Scene = cavi::usdj_am::utils::Scene;
+
+    /// \brief Compares the digests of a prim's own fields within the previous
+    ///        and current scenes.
+    ///
+    /// \param[in] object_id The object ID of a "USDA_Definition" node.
+    /// \returns `true` if the prim itself may have changed since the previous
+    ///          update.
+    bool is_changed(AMobjId const* const object_id) const;
+
+    /// \brief Compares the digests of a prim's subtree within the previous
+    ///        and current scenes.
+    ///
+    /// \param[in] object_id The object ID of a "USDA_Definition" node.
+    /// \returns `true` if neither the prim nor its descendants changed since
+    ///          the previous update.
+    bool is_unchanged(AMobjId const* const object_id) const;
+
+    /// \brief Removes the bodies of the children of a prim within the
+    ///        previous scene that are missing from the current one.
+    ///
+    /// \param[in] previous_prim The index of a prim within the previous
+    ///                          scene or `Scene::NONE`.
+    void remove_missing_children(Scene::Index const previous_prim);
+
+    /// \brief Removes the bodies of a prim within the previous scene and of
+    ///        its descendants.
+    ///
+    /// \param[in] previous_prim The index of a prim within the previous
+    ///                          scene or `Scene::NONE`.
+    void remove_subtree(Scene::Index const previous_prim);
 
-    Bodies m_bodies;
+    Bodies& m_bodies;
     std::optional<std::string> m_default_prim;
     std::optional<cavi::usdj_am::Definition> m_definition;
+    bool m_instanced;
+    /// \note The body of the prim whose nested prims are being visited.
+    Body* m_parent_body;
+    std::optional<Scene> m_previous_scene;
+    /// \note `true` if the subtrees that are unchanged since the previous
+    ///       update are skipped, which needs the scenes of both revisions.
+    bool m_pruning;
+    std::optional<Scene> m_scene;
     Updates m_updates;
+    /// \note The bodies that are still described by the "USDA_File" node
+    ///       are moved here from `m_bodies` as they're visited.
+    Bodies m_visited_bodies;
     bool m_visited_default_prim;
 };
 
@@ -0,0 +1,543 @@
+/**************************************************************************/
+/* usdj_editor.cpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// third-party
+extern "C" {
+
+#include <automerge-c/automerge.h>
+}
+#include <cavi/usdj_am/declaration.hpp>
+#include <cavi/usdj_am/definition.hpp>
+#include <cavi/usdj_am/definition_statement.hpp>
+#include <cavi/usdj_am/file.hpp>
+#include <cavi/usdj_am/statement.hpp>
+#include <cavi/usdj_am/usd/geom/token_type.hpp>
+#include <cavi/usdj_am/usd/geom/xform_op_type.hpp>
+#include <cavi/usdj_am/usd/physics/token_type.hpp>
+#include <cavi/usdj_am/utils/document.hpp>
+#include <cavi/usdj_am/utils/xform_program.hpp>
+#include <cavi/usdj_am/value.hpp>
+
+// regional
+#include <core/error/error_macros.h>
+#include <core/math/basis.h>
+#include <core/math/math_funcs.h>
+#include <core/string/ustring.h>
+
+// local
+#include "usdj_editor.h"
+
+namespace {
+
+using cavi::usdj_am::utils::Document;
+using cavi::usdj_am::usd::geom::XformOpType;
+using cavi::usdj_am::usd::geom::XformOpTypeOrder;
+using ResultPtr = Document::ResultPtr;
+
+/// \brief The Euler rotation that's written when a definition doesn't have
+///        one already.
+static XformOpType const DEFAULT_ROTATE_OP = XformOpType::ROTATE_XYZ;
+
+template <typename T>
+std::string to_string(T const& tag) {
+    std::ostringstream os;
+    os << tag;
+    return os.str();
+}
+
+/// \note A USD rotation such as "rotateXYZ" applies its X angle first whereas
+///       a Godot `EulerOrder` such as `XYZ` applies its Z angle first so
+///       their orders are reversed.
+std::optional<EulerOrder> to_euler_order(XformOpType const op) {
+    switch (op) {
+        case XformOpType::ROTATE_XYZ:
+            return EulerOrder::ZYX;
+        case XformOpType::ROTATE_XZY:
+            return EulerOrder::YZX;
+        case XformOpType::ROTATE_YXZ:
+            return EulerOrder::ZXY;
+        case XformOpType::ROTATE_YZX:
+            return EulerOrder::XZY;
+        case XformOpType::ROTATE_ZXY:
+            return EulerOrder::YXZ;
+        case XformOpType::ROTATE_ZYX:
+            return EulerOrder::XYZ;
+        default:
+            return std::nullopt;
+    }
+}
+
+/// \brief Extracts the order of the transform operations within the value of
+///        an "xformOpOrder" attribute that can be rewritten from a Godot
+///        transform.
+///
+/// \param[in] value The value of an "xformOpOrder" attribute.
+/// \returns The operations within \p value or `std::nullopt` if they aren't
+///          an unsuffixed translation, Euler rotation and scale in that
+///          order, any of which may be missing.
+/// \note A stack with a pivot, an orientation, a matrix, an inverse or a
+///       reset can't be rewritten without discarding what was authored so
+///       it's replaced by a matrix instead.
+std::optional<XformOpTypeOrder> extract_rewritable_order(cavi::usdj_am::Value const& value) {
+    using cavi::usdj_am::ValueRange;
+    using cavi::usdj_am::utils::extract_XformOp;
+
+    XformOpTypeOrder order;
+    auto const values_ptr = std::get_if<ValueRange>(&value);
+    if (!values_ptr)
+        return order;
+    int previous_rank = -1;
+    for (auto const& sub_value : *values_ptr) {
+        auto const string_ptr = std::get_if<cavi::usdj_am::String>(&sub_value);
+        if (!string_ptr)
+            return std::nullopt;
+        auto const op = extract_XformOp(*string_ptr);
+        if (!op || op->inverse || !op->suffix.empty())
+            return std::nullopt;
+        int rank = 1;
+        if (op->type == XformOpType::TRANSLATE)
+            rank = 0;
+        else if (op->type == XformOpType::SCALE)
+            rank = 2;
+        else if (!to_euler_order(op->type))
+            return std::nullopt;
+        if (rank <= previous_rank)
+            return std::nullopt;
+        previous_rank = rank;
+        order.push_back(op->type);
+    }
+    return order;
+}
+
+/// \brief Gets whether the value of an "xformOpOrder" attribute begins with
+///        "!resetXformStack!".
+bool is_reset(cavi::usdj_am::Value const& value) {
+    using cavi::usdj_am::ValueRange;
+    using cavi::usdj_am::utils::extract_XformOp;
+
+    auto const values_ptr = std::get_if<ValueRange>(&value);
+    if (!values_ptr || !values_ptr->size())
+        return false;
+    auto const first = *values_ptr->begin();
+    auto const string_ptr = std::get_if<cavi::usdj_am::String>(&first);
+    if (!string_ptr)
+        return false;
+    auto const op = extract_XformOp(*string_ptr);
+    return op && op->type == XformOpType::RESET_XFORM_STACK;
+}
+
+/// \brief Interns the bytes of an actor ID so that they're only allocated
+///        once for all of the keys that share them.
+///
+/// \returns A pointer to bytes that live until the program exits.
+std::string const* intern_actor_id(std::string_view const& view) {
+    static std::mutex mutex;
+    static std::set<std::string, std::less<>> actor_ids;
+
+    std::lock_guard<std::mutex> const lock{mutex};
+    auto match = actor_ids.find(view);
+    if (match == actor_ids.end())
+        match = actor_ids.emplace(view).first;
+    return &*match;
+}
+
+/// \brief Frees a result after reporting the error that it may contain.
+///
+/// \returns `true` if \p result was successful.
+bool succeeded(AMresult* const result) {
+    ResultPtr const ptr{result, AMresultFree};
+    if (AMresultStatus(ptr.get()) != AM_STATUS_OK) {
+        auto const error = AMresultError(ptr.get());
+        ERR_FAIL_V_MSG(false, String::utf8(reinterpret_cast<char const*>(error.src), static_cast<int>(error.count)));
+    }
+    return true;
+}
+
+/// \returns The list object ID within \p result or `nullptr`.
+AMobjId const* to_list(Document const& document, ResultPtr const& result) {
+    if (!result || AMresultStatus(result.get()) != AM_STATUS_OK)
+        return nullptr;
+    auto const item = AMresultItem(result.get());
+    if (AMitemValType(item) != AM_VAL_TYPE_OBJ_TYPE || AMobjObjType(document, AMitemObjId(item)) != AM_OBJ_TYPE_LIST)
+        return nullptr;
+    return AMitemObjId(item);
+}
+
+/// \brief Gets the list stored under a key of a map object, replacing any
+///        other kind of value stored there.
+ResultPtr put_list(Document const& document, AMobjId const* const map, char const* const key) {
+    ResultPtr result{AMmapGet(document, map, AMstr(key), nullptr), AMresultFree};
+    if (!to_list(document, result))
+        result.reset(AMmapPutObject(document, map, AMstr(key), AM_OBJ_TYPE_LIST));
+    return result;
+}
+
+/// \brief Gets the list stored at a position of a list object, replacing any
+///        other kind of value stored there.
+///
+/// \note A list is appended when \p pos is past the end.
+ResultPtr put_list_at(Document const& document, AMobjId const* const list, std::size_t const pos) {
+    if (AMobjSize(document, list, nullptr) > pos) {
+        ResultPtr result{AMlistGet(document, list, pos, nullptr), AMresultFree};
+        if (to_list(document, result))
+            return result;
+        return ResultPtr{AMlistPutObject(document, list, pos, false, AM_OBJ_TYPE_LIST), AMresultFree};
+    }
+    return ResultPtr{AMlistPutObject(document, list, SIZE_MAX, true, AM_OBJ_TYPE_LIST), AMresultFree};
+}
+
+/// \brief Shortens a list object to a given length.
+bool truncate(Document const& document, AMobjId const* const list, std::size_t const size) {
+    ERR_FAIL_NULL_V(list, false);
+    for (auto pos = AMobjSize(document, list, nullptr); pos > size; --pos) {
+        if (!succeeded(AMlistDelete(document, list, pos - 1)))
+            return false;
+    }
+    return true;
+}
+
+/// \brief Overwrites the elements of a list object with numbers.
+bool put_reals(Document const& document, AMobjId const* const list, std::vector<double> const& values) {
+    ERR_FAIL_NULL_V(list, false);
+    auto const size = AMobjSize(document, list, nullptr);
+    for (std::size_t pos = 0; pos != values.size(); ++pos) {
+        auto const insert = pos >= size;
+        if (!succeeded(AMlistPutF64(document, list, (insert) ? SIZE_MAX : pos, insert, values[pos])))
+            return false;
+    }
+    return truncate(document, list, values.size());
+}
+
+/// \brief Overwrites the elements of a list object with strings.
+bool put_strings(Document const& document, AMobjId const* const list, std::vector<std::string> const& values) {
+    ERR_FAIL_NULL_V(list, false);
+    auto const size = AMobjSize(document, list, nullptr);
+    for (std::size_t pos = 0; pos != values.size(); ++pos) {
+        auto const insert = pos >= size;
+        auto const value = AMbytes(reinterpret_cast<std::uint8_t const*>(values[pos].data()), values[pos].size());
+        if (!succeeded(AMlistPutStr(document, list, (insert) ? SIZE_MAX : pos, insert, value)))
+            return false;
+    }
+    return truncate(document, list, values.size());
+}
+
+/// \brief Appends a new "USDA_Declaration" node to a list of statements.
+///
+/// \returns A result containing the new node's map object ID or `nullptr`.
+ResultPtr put_declaration(Document const& document,
+                          AMobjId const* const statements,
+                          char const* const keyword,
+                          std::string const& define_type,
+                          std::string const& reference) {
+    ResultPtr result{AMlistPutObject(document, statements, SIZE_MAX, true, AM_OBJ_TYPE_MAP), AMresultFree};
+    if (AMresultStatus(result.get()) != AM_STATUS_OK)
+        return ResultPtr{nullptr, AMresultFree};
+    auto const declaration = AMitemObjId(AMresultItem(result.get()));
+    auto const put_str = [&](char const* const key, std::string const& value) {
+        auto const bytes = AMbytes(reinterpret_cast<std::uint8_t const*>(value.data()), value.size());
+        return succeeded(AMmapPutStr(document, declaration, AMstr(key), bytes));
+    };
+    auto const put_keyword = [&]() {
+        if (keyword)
+            return put_str("keyword", keyword);
+        return succeeded(AMmapPutNull(document, declaration, AMstr("keyword")));
+    };
+    if (put_str("type", "declaration") && put_keyword() && put_str("defineType", define_type) &&
+        put_str("reference", reference) && succeeded(AMmapPutNull(document, declaration, AMstr("descriptor"))) &&
+        succeeded(AMmapPutObject(document, declaration, AMstr("value"), AM_OBJ_TYPE_LIST)))
+        return result;
+    return ResultPtr{nullptr, AMresultFree};
+}
+
+}  // namespace
+
+UsdjObjectKey::UsdjObjectKey(AMobjId const* const p_object_id)
+    : m_actor_id{nullptr}, m_counter{AMobjIdCounter(p_object_id)} {
+    auto const bytes = AMactorIdBytes(AMobjIdActorId(p_object_id));
+    m_actor_id = intern_actor_id(std::string_view{reinterpret_cast<char const*>(bytes.src), bytes.count});
+}
+
+UsdjObjectKey::UsdjObjectKey(std::pair<std::uint64_t, std::string_view> const& p_object_key)
+    : m_actor_id{intern_actor_id(p_object_key.second)}, m_counter{p_object_key.first} {}
+
+bool UsdjObjectKey::matches(AMobjId const* const p_object_id) const {
+    if (!p_object_id || AMobjIdCounter(p_object_id) != m_counter)
+        return false;
+    auto const bytes = AMactorIdBytes(AMobjIdActorId(p_object_id));
+    return std::equal(m_actor_id->begin(), m_actor_id->end(), bytes.src, bytes.src + bytes.count,
+                      [](char const lhs, std::uint8_t const rhs) { return static_cast<std::uint8_t>(lhs) == rhs; });
+}
+
+std::size_t UsdjObjectKey::Hash::operator()(UsdjObjectKey const& p_key) const {
+    // Equal actor IDs are interned at the same address.
+    auto const seed = std::hash<std::string const*>{}(p_key.m_actor_id);
+    // An object's counter varies far more than its actor ID between objects.
+    return seed ^ (std::hash<std::uint64_t>{}(p_key.m_counter) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+bool operator==(UsdjObjectKey const& p_lhs, UsdjObjectKey const& p_rhs) {
+    return p_lhs.m_counter == p_rhs.m_counter && p_lhs.m_actor_id == p_rhs.m_actor_id;
+}
+
+UsdjEditor::UsdjEditor(cavi::usdj_am::utils::Document& p_document)
+    : m_count{0}, m_document{p_document}, m_failed{nullptr} {}
+
+UsdjEditor::~UsdjEditor() {}
+
+std::size_t UsdjEditor::operator()(UsdjEdits const& p_edits) {
+    using cavi::usdj_am::File;
+
+    std::vector<UsdjEdit const*> rejected;
+    do {
+        m_count = 0;
+        m_failed = nullptr;
+        m_pending.clear();
+        for (auto const& edit : p_edits.edits) {
+            if (std::find(rejected.begin(), rejected.end(), &edit) == rejected.end())
+                m_pending.push_back(&edit);
+        }
+        try {
+            auto const file = File{m_document, m_document.get_item(p_edits.path)};
+            file.accept(*this);
+        } catch (std::invalid_argument const& thrown) {
+            // The document may have been restructured remotely since the edits
+            // were made.
+            WARN_PRINT(thrown.what());
+        }
+        m_pending.clear();
+        if (m_failed) {
+            // A partially-written edit mustn't be committed so the frame's
+            // other edits are written again without it.
+            AMrollback(m_document);
+            rejected.push_back(m_failed);
+        }
+    } while (m_failed);
+    if (m_count) {
+        // A frame's worth of edits becomes a single change in the history.
+        succeeded(AMcommit(m_document, AMstr("RealityMerge edit"), nullptr));
+    }
+    return m_count;
+}
+
+void UsdjEditor::visit(cavi::usdj_am::Definition const& definition) {
+    auto const object_id = definition.get_object_id();
+    auto const match = std::find_if(m_pending.begin(), m_pending.end(),
+                                    [object_id](auto const& edit) { return edit->definition.matches(object_id); });
+    if (match != m_pending.end()) {
+        if (!write(definition, **match)) {
+            // Stop visiting so that the document can be rolled back.
+            m_failed = *match;
+            m_pending.clear();
+            return;
+        }
+        ++m_count;
+        m_pending.erase(match);
+    }
+    // Definitions can be nested within definitions.
+    for (auto const& definition_statement : definition.get_statements()) {
+        if (m_pending.empty())
+            break;
+        definition_statement.accept(*this);
+    }
+}
+
+void UsdjEditor::visit(cavi::usdj_am::DefinitionStatement const& definition_statement) {
+    using cavi::usdj_am::Statement;
+
+    std::visit(
+        [this](auto const& alt) {
+            using T = std::decay_t<decltype(alt)>;
+            if constexpr (std::is_same_v<T, Statement>)
+                alt.accept(*this);
+        },
+        definition_statement);
+}
+
+void UsdjEditor::visit(cavi::usdj_am::File const& file) {
+    for (auto const& statement : file.get_statements()) {
+        if (m_pending.empty())
+            break;
+        statement.accept(*this);
+    }
+}
+
+void UsdjEditor::visit(cavi::usdj_am::Statement const& statement) {
+    using cavi::usdj_am::Definition;
+
+    std::visit(
+        [this](auto const& alt) {
+            using T = std::decay_t<decltype(alt)>;
+            if constexpr (std::is_same_v<T, Definition>)
+                alt.accept(*this);
+        },
+        statement);
+}
+
+bool UsdjEditor::write(cavi::usdj_am::Definition const& p_definition, UsdjEdit const& p_edit) {
+    using cavi::usdj_am::Declaration;
+    using cavi::usdj_am::usd::geom::TokenType;
+
+    ResultPtr const statements_result{
+        AMmapGet(m_document, p_definition.get_object_id(), AMstr("statements"), nullptr), AMresultFree};
+    auto const statements = to_list(m_document, statements_result);
+    ERR_FAIL_NULL_V(statements, false);
+    // Index the declarations by their references.
+    std::map<std::string, Declaration> declarations;
+    for (auto&& definition_statement : p_definition.get_statements()) {
+        std::visit(
+            [&declarations](auto&& alt) {
+                using T = std::decay_t<decltype(alt)>;
+                if constexpr (std::is_same_v<T, Declaration>) {
+                    if (!alt.get_descriptor()) {
+                        auto reference = std::string{alt.get_reference()};
+                        declarations.emplace(std::move(reference), std::forward<decltype(alt)>(alt));
+                    }
+                }
+            },
+            std::forward<decltype(definition_statement)>(definition_statement));
+    }
+    // Declarations that don't exist yet are appended to the definition.
+    std::vector<ResultPtr> appended;
+    auto const get_value = [&](std::string const& reference, char const* const keyword,
+                               char const* const define_type) -> ResultPtr {
+        AMobjId const* declaration = nullptr;
+        auto const match = declarations.find(reference);
+        if (match != declarations.end()) {
+            declaration = match->second.get_object_id();
+        } else {
+            appended.push_back(put_declaration(m_document, statements, keyword, define_type, reference));
+            if (!appended.back())
+                return ResultPtr{nullptr, AMresultFree};
+            declaration = AMitemObjId(AMresultItem(appended.back().get()));
+        }
+        return put_list(m_document, declaration, "value");
+    };
+    bool result = true;
+    auto const order_reference = to_string(TokenType::XFORM_OP_ORDER);
+    auto const order_match = declarations.find(order_reference);
+    auto const authored_order = (order_match != declarations.end())
+                                    ? extract_rewritable_order(order_match->second.get_value())
+                                    : std::make_optional<XformOpTypeOrder>();
+    if (p_edit.transform && !authored_order) {
+        // The authored operations are replaced by a "matrix4d" for row
+        // vectors, which reproduces the transform exactly, instead of losing
+        // the edit.
+        auto const& transform = *p_edit.transform;
+        auto const transform_value = get_value(to_string(XformOpType::TRANSFORM), nullptr, "matrix4d");
+        auto const rows = to_list(m_document, transform_value);
+        result = rows && truncate(m_document, rows, 4);
+        for (std::size_t row = 0; result && row != 4; ++row) {
+            auto const vector = (row < 3) ? transform.basis.get_column(row) : transform.origin;
+            auto const row_value = put_list_at(m_document, rows, row);
+            result = put_reals(m_document, to_list(m_document, row_value),
+                               {vector.x, vector.y, vector.z, (row < 3) ? 0.0 : 1.0});
+        }
+        if (result) {
+            // A reset must stay the first operation to keep its meaning.
+            std::vector<std::string> tokens;
+            if (is_reset(order_match->second.get_value()))
+                tokens.push_back(to_string(XformOpType::RESET_XFORM_STACK));
+            tokens.push_back(to_string(XformOpType::TRANSFORM));
+            auto const order_value = get_value(order_reference, "uniform", "token[]");
+            result = put_strings(m_document, to_list(m_document, order_value), tokens);
+        }
+    } else if (p_edit.transform) {
+        auto const& transform = *p_edit.transform;
+        auto const& order = *authored_order;
+        // Preserve the kind of Euler rotation that's already in use.
+        auto const rotate_op =
+            std::find_if(order.begin(), order.end(), [](auto const op) { return to_euler_order(op).has_value(); });
+        auto const rotate = (rotate_op != order.end()) ? *rotate_op : DEFAULT_ROTATE_OP;
+        // The rotations of transform operations are in degrees.
+        auto const euler = transform.basis.get_euler_normalized(*to_euler_order(rotate));
+        auto const scale = transform.basis.get_scale();
+        auto const& origin = transform.origin;
+        auto const translate_value = get_value(to_string(XformOpType::TRANSLATE), nullptr, "double3");
+        auto const rotate_value = get_value(to_string(rotate), nullptr, "float3");
+        auto const scale_value = get_value(to_string(XformOpType::SCALE), nullptr, "float3");
+        result = put_reals(m_document, to_list(m_document, translate_value), {origin.x, origin.y, origin.z}) &&
+                 put_reals(m_document, to_list(m_document, rotate_value),
+                           {Math::rad_to_deg(euler.x), Math::rad_to_deg(euler.y), Math::rad_to_deg(euler.z)}) &&
+                 put_reals(m_document, to_list(m_document, scale_value), {scale.x, scale.y, scale.z});
+        // Any missing operations are identities so adding them to the order
+        // doesn't change how the others apply.
+        XformOpTypeOrder const target_order{XformOpType::TRANSLATE, rotate, XformOpType::SCALE};
+        if (result && order != target_order) {
+            std::vector<std::string> tokens;
+            std::transform(target_order.begin(), target_order.end(), std::back_inserter(tokens),
+                           [](auto const op) { return to_string(op); });
+            auto const order_value = get_value(order_reference, "uniform", "token[]");
+            result = put_strings(m_document, to_list(m_document, order_value), tokens);
+        }
+    }
+    if (result && p_edit.display_color) {
+        auto const& color = *p_edit.display_color;
+        // A display color is an array of colors but a single one applies to
+        // the whole prim.
+        auto const color_value = get_value(to_string(TokenType::PRIMVARS_DISPLAY_COLOR), nullptr, "color3f[]");
+        auto const colors = to_list(m_document, color_value);
+        auto const first_color = (colors) ? put_list_at(m_document, colors, 0) : ResultPtr{nullptr, AMresultFree};
+        result = put_reals(m_document, to_list(m_document, first_color), {color.r, color.g, color.b}) &&
+                 truncate(m_document, colors, 1);
+        auto const opacity_reference = to_string(TokenType::PRIMVARS_DISPLAY_OPACITY);
+        if (result && (color.a != 1.0f || declarations.count(opacity_reference))) {
+            auto const opacity_value = get_value(opacity_reference, nullptr, "float[]");
+            result = put_reals(m_document, to_list(m_document, opacity_value), {color.a});
+        }
+    }
+    if (result && (p_edit.velocity || p_edit.angular_velocity)) {
+        using cavi::usdj_am::usd::physics::TokenType;
+
+        for (auto const& item : {std::make_pair(TokenType::PHYSICS_VELOCITY, &p_edit.velocity),
+                                 std::make_pair(TokenType::PHYSICS_ANGULAR_VELOCITY, &p_edit.angular_velocity)}) {
+            if (!result || !*item.second)
+                continue;
+            auto const& velocity = **item.second;
+            auto const velocity_value = get_value(to_string(item.first), nullptr, "vector3f");
+            result = put_reals(m_document, to_list(m_document, velocity_value), {velocity.x, velocity.y, velocity.z});
+        }
+    }
+    return result;
+}
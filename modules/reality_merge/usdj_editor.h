@@ -0,0 +1,172 @@
+/**************************************************************************/
+/* usdj_editor.h                                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef REALITY_MERGE_USDJ_EDITOR_H
+#define REALITY_MERGE_USDJ_EDITOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// third-party
+#include <cavi/usdj_am/visitor.hpp>
+
+// regional
+#include <core/math/color.h>
+#include <core/math/transform_3d.h>
+#include <core/math/vector3.h>
+
+struct AMobjId;
+
+namespace cavi {
+namespace usdj_am {
+namespace utils {
+
+class Document;
+
+}  // namespace utils
+}  // namespace usdj_am
+}  // namespace cavi
+
+/// \brief Identifies an Automerge object in any revision of the document in
+///        which it was created.
+class UsdjObjectKey {
+public:
+    /// \brief Hashes a key for an unordered container.
+    struct Hash {
+        std::size_t operator()(UsdjObjectKey const& p_key) const;
+    };
+
+    UsdjObjectKey() = delete;
+
+    /// \param[in] p_object_id A borrowed Automerge object ID.
+    /// \pre \p p_object_id `!= nullptr`
+    UsdjObjectKey(AMobjId const* const p_object_id);
+
+    /// \param[in] p_object_key The counter and the bytes of the actor ID of an
+    ///                         Automerge object ID, e.g. those of a prim
+    ///                         within a `cavi::usdj_am::utils::Scene`.
+    UsdjObjectKey(std::pair<std::uint64_t, std::string_view> const& p_object_key);
+
+    /// \param[in] p_object_id A borrowed Automerge object ID.
+    /// \returns `true` if \p p_object_id identifies the same object.
+    bool matches(AMobjId const* const p_object_id) const;
+
+private:
+    /// The actor ID's bytes are interned so that copying a key doesn't
+    /// allocate.
+    std::string const* m_actor_id;
+    std::uint64_t m_counter;
+
+    friend bool operator==(UsdjObjectKey const& p_lhs, UsdjObjectKey const& p_rhs);
+};
+
+bool operator==(UsdjObjectKey const& p_lhs, UsdjObjectKey const& p_rhs);
+
+inline bool operator!=(UsdjObjectKey const& p_lhs, UsdjObjectKey const& p_rhs) {
+    return !operator==(p_lhs, p_rhs);
+}
+
+/// \brief A change made to a physics body locally that must be written into
+///        the "USDA_Definition" node that it was constructed from.
+struct UsdjEdit {
+    UsdjObjectKey definition;
+    std::optional<Color> display_color;
+    std::optional<Transform3D> transform;
+    /// \note "physics:velocity" in the units that it's authored in.
+    std::optional<Vector3> velocity;
+    /// \note "physics:angularVelocity" in the units that it's authored in.
+    std::optional<Vector3> angular_velocity;
+};
+
+/// \brief The changes made to physics bodies locally during a single frame.
+struct UsdjEdits {
+    /// A POSIX path to the "USDA_File" node containing the edited definitions.
+    std::string path;
+    std::vector<UsdjEdit> edits;
+};
+
+/// \brief A writer of local changes into the "USDA_Definition" nodes of an
+///        Automerge document.
+class UsdjEditor : public cavi::usdj_am::Visitor {
+public:
+    UsdjEditor() = delete;
+
+    /// \param[in] p_document A borrowed Automerge document to write into.
+    UsdjEditor(cavi::usdj_am::utils::Document& p_document);
+
+    UsdjEditor(UsdjEditor const&) = delete;
+
+    UsdjEditor(UsdjEditor&&) = default;
+
+    ~UsdjEditor();
+
+    UsdjEditor& operator=(UsdjEditor const&) = delete;
+
+    UsdjEditor& operator=(UsdjEditor&&) = default;
+
+    /// \brief Writes a frame's worth of changes into the Automerge document as
+    ///        a single change.
+    ///
+    /// \param[in] p_edits The changes made to physics bodies within a frame.
+    /// \returns The number of definitions that were changed.
+    /// \note Edits of definitions that no longer exist are discarded.
+    /// \note Edits that can't be written completely are rolled back and
+    ///       discarded.
+    /// \note A transform written into a prim whose "xformOpOrder" isn't a
+    ///       translate-rotate-scale replaces its operations with a matrix.
+    std::size_t operator()(UsdjEdits const& p_edits);
+
+    void visit(cavi::usdj_am::Definition const& definition) override;
+
+    void visit(cavi::usdj_am::DefinitionStatement const& definition_statement) override;
+
+    void visit(cavi::usdj_am::File const& file) override;
+
+    void visit(cavi::usdj_am::Statement const& statement) override;
+
+private:
+    /// \brief Writes a change into the "USDA_Definition" node that it targets.
+    ///
+    /// \param[in] p_definition The node targeted by \p p_edit.
+    /// \param[in] p_edit A change made to a physics body locally.
+    /// \returns `false` if the node couldn't be written into completely.
+    bool write(cavi::usdj_am::Definition const& p_definition, UsdjEdit const& p_edit);
+
+    std::size_t m_count;
+    cavi::usdj_am::utils::Document& m_document;
+    UsdjEdit const* m_failed;
+    std::vector<UsdjEdit const*> m_pending;
+};
+
+#endif  // REALITY_MERGE_USDJ_EDITOR_H
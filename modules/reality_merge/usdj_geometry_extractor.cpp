@@ -45,7 +45,6 @@
 #include <core/object/ref_counted.h>
 #include <core/os/memory.h>
 #include <scene/resources/box_shape_3d.h>
-#include <scene/resources/material.h>
 #include <scene/resources/primitive_meshes.h>
 
 // local
@@ -73,12 +72,8 @@ std::pair<UsdjGeometryExtractor::MeshPtr, UsdjGeometryExtractor::Shape3dPtr> Usd
         }
             /// \todo Handle other types of gprim.
     }
-    if (!geometry.first.is_null()) {
-        // Assign material to the surface(s).
-        /// \todo Handle multiple surfaces.
-        auto const material = Ref<BaseMaterial3D>{memnew(BaseMaterial3D{false})};
-        geometry.first->surface_set_material(0, material);
-    }
+    // The material is shared with other bodies by the one that the mesh
+    // belongs to.
     return geometry;
 }
 
@@ -0,0 +1,114 @@
+/**************************************************************************/
+/* usdj_heartbeat.cpp                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// local
+#include "usdj_heartbeat.h"
+
+namespace {
+
+/// \brief Picks a percentile out of sorted samples by the nearest-rank method.
+UsdjHeartbeat::Duration percentile(std::vector<UsdjHeartbeat::Duration> const& sorted, double const fraction) {
+    if (sorted.empty())
+        return UsdjHeartbeat::Duration::zero();
+    auto const rank = static_cast<std::size_t>(std::ceil(fraction * sorted.size()));
+    return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+}
+
+}  // namespace
+
+UsdjHeartbeat::UsdjHeartbeat()
+    : m_answers_pings{false},
+      m_count{0},
+      m_samples{},
+      m_smoothed{Duration::zero()},
+      m_variation{Duration::zero()} {}
+
+UsdjHeartbeat::Statistics UsdjHeartbeat::get_statistics() const {
+    std::vector<Duration> sorted{m_samples.begin(), m_samples.begin() + std::min(m_count, SAMPLE_COUNT)};
+    std::sort(sorted.begin(), sorted.end());
+    return Statistics{m_count,
+                      m_smoothed,
+                      m_variation,
+                      percentile(sorted, 0.50),
+                      percentile(sorted, 0.90),
+                      percentile(sorted, 0.99)};
+}
+
+bool UsdjHeartbeat::is_dead(Clock::time_point const now, Duration const timeout) const {
+    return m_answers_pings && m_unanswered_since && (now - *m_unanswered_since >= timeout) &&
+           (now - m_last_packet >= timeout);
+}
+
+bool UsdjHeartbeat::is_due(Clock::time_point const now, Duration const interval) const {
+    return now - m_last_ping >= interval;
+}
+
+void UsdjHeartbeat::on_packet(Clock::time_point const now) {
+    m_last_packet = now;
+}
+
+void UsdjHeartbeat::on_ping(Clock::time_point const now) {
+    // A ping that's still pending is presumed lost.
+    m_pending_ping = now;
+    m_last_ping = now;
+    if (!m_unanswered_since)
+        m_unanswered_since = now;
+}
+
+void UsdjHeartbeat::on_pong(Clock::time_point const now) {
+    m_answers_pings = true;
+    m_unanswered_since.reset();
+    if (!m_pending_ping)
+        return;
+    auto const sample = std::chrono::duration_cast<Duration>(now - *m_pending_ping);
+    m_pending_ping.reset();
+    // Smooth the samples the same way that TCP does (RFC 6298).
+    if (!m_count) {
+        m_smoothed = sample;
+        m_variation = sample / 2;
+    } else {
+        auto const deviation = (m_smoothed > sample) ? m_smoothed - sample : sample - m_smoothed;
+        m_variation = (3 * m_variation + deviation) / 4;
+        m_smoothed = (7 * m_smoothed + sample) / 8;
+    }
+    m_samples[m_count % SAMPLE_COUNT] = sample;
+    ++m_count;
+}
+
+void UsdjHeartbeat::reset(Clock::time_point const now) {
+    m_answers_pings = false;
+    m_last_packet = now;
+    m_last_ping = now;
+    m_pending_ping.reset();
+    m_unanswered_since.reset();
+}
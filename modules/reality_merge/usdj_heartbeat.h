@@ -0,0 +1,113 @@
+/**************************************************************************/
+/* usdj_heartbeat.h                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef REALITY_MERGE_USDJ_HEARTBEAT_H
+#define REALITY_MERGE_USDJ_HEARTBEAT_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+
+/// \brief Schedules the pings that keep a connection to a server alive,
+///        estimates the round-trip time from the server's pongs and detects
+///        when the server has stopped responding.
+class UsdjHeartbeat {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Duration = std::chrono::microseconds;
+
+    /// \brief Round-trip time statistics.
+    struct Statistics {
+        /// The count of round trips measured.
+        std::size_t count;
+        /// The exponentially weighted moving average.
+        Duration smoothed;
+        /// The exponentially weighted moving average of the deviation from
+        /// \p smoothed.
+        Duration variation;
+        /// The percentiles of the most recent round trips.
+        Duration p50;
+        Duration p90;
+        Duration p99;
+    };
+
+    UsdjHeartbeat();
+
+    /// \returns The round-trip time statistics.
+    Statistics get_statistics() const;
+
+    /// \param[in] now The current time.
+    /// \param[in] timeout The longest time to wait for any response to a ping.
+    /// \returns `true` if the server has stopped responding.
+    /// \note A server is only considered dead after it has answered a ping so
+    ///       that a server that never answers them isn't mistaken for one.
+    bool is_dead(Clock::time_point const now, Duration const timeout) const;
+
+    /// \param[in] now The current time.
+    /// \param[in] interval The period between pings.
+    /// \returns `true` if a ping should be sent.
+    bool is_due(Clock::time_point const now, Duration const interval) const;
+
+    /// \brief Records that any packet was received from the server.
+    ///
+    /// \param[in] now The current time.
+    void on_packet(Clock::time_point const now);
+
+    /// \brief Records that a ping was sent to the server.
+    ///
+    /// \param[in] now The current time.
+    void on_ping(Clock::time_point const now);
+
+    /// \brief Records that the server answered the most recent ping.
+    ///
+    /// \param[in] now The current time.
+    void on_pong(Clock::time_point const now);
+
+    /// \brief Forgets the state of the previous connection but not its
+    ///        round-trip time statistics.
+    ///
+    /// \param[in] now The current time.
+    void reset(Clock::time_point const now);
+
+private:
+    static std::size_t const SAMPLE_COUNT = 64;
+
+    bool m_answers_pings;
+    std::size_t m_count;
+    Clock::time_point m_last_packet;
+    Clock::time_point m_last_ping;
+    std::optional<Clock::time_point> m_pending_ping;
+    std::array<Duration, SAMPLE_COUNT> m_samples;
+    Duration m_smoothed;
+    std::optional<Clock::time_point> m_unanswered_since;
+    Duration m_variation;
+};
+
+#endif  // REALITY_MERGE_USDJ_HEARTBEAT_H
@@ -1,5 +1,5 @@
 /**************************************************************************/
-/* usdj_box_size_extractor.h                                              */
+/* usdj_material_cache.cpp                                                */
 /**************************************************************************/
 /*                         This file is part of:                          */
 /*                             RealityMerge                               */
@@ -27,54 +27,62 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
-#ifndef REALITY_MERGE_USDJ_BOX_SIZE_EXTRACTOR_H
-#define REALITY_MERGE_USDJ_BOX_SIZE_EXTRACTOR_H
+#include <cstddef>
+#include <map>
 
-#include <memory>
-#include <optional>
+// regional
+#include <core/object/object.h>
+#include <core/object/object_id.h>
+#include <core/os/memory.h>
 
-// third-party
-#include <cavi/usdj_am/visitor.hpp>
+// local
+#include "usdj_material_cache.h"
 
-struct Vector3;
+namespace {
 
-/// \brief An extractor of a box's size value embedded within a "USDA_Definition"
-///        node.
-class UsdjBoxSizeExtractor : public cavi::usdj_am::Visitor {
-public:
-    UsdjBoxSizeExtractor() = delete;
-
-    UsdjBoxSizeExtractor(cavi::usdj_am::Definition const& p_definition);
-
-    UsdjBoxSizeExtractor(UsdjBoxSizeExtractor const&) = delete;
-
-    UsdjBoxSizeExtractor(UsdjBoxSizeExtractor&&) = default;
-
-    ~UsdjBoxSizeExtractor();
-
-    UsdjBoxSizeExtractor& operator=(UsdjBoxSizeExtractor const&) = delete;
-
-    UsdjBoxSizeExtractor& operator=(UsdjBoxSizeExtractor&&) = default;
-
-    std::optional<Vector3> operator()();
-
-    void visit(cavi::usdj_am::Assignment const& assignment) override;
-
-    void visit(cavi::usdj_am::Declaration const& declaration) override;
-
-    void visit(cavi::usdj_am::Definition const& definition) override;
-
-    void visit(cavi::usdj_am::DefinitionStatement const& definition_statement) override;
-
-    void visit(cavi::usdj_am::Descriptor const& descriptor) override;
-
-    void visit(cavi::usdj_am::ExternalReference const& external_reference) override;
-
-    void visit(cavi::usdj_am::ReferenceFile const& reference_file) override;
-
-private:
-    cavi::usdj_am::Definition const& m_definition;
-    std::optional<Vector3> m_size;
+struct Entry {
+    /// \note The material is owned by the bodies that use it so that the
+    ///       cache never keeps one alive past the engine's shutdown.
+    ObjectID material_id;
+    std::size_t use_count;
 };
 
-#endif  // REALITY_MERGE_USDJ_BOX_SIZE_EXTRACTOR_H
+static std::map<UsdjMaterialCache::Key, Entry> s_entries{};
+
+}  // namespace
+
+Ref<Material> UsdjMaterialCache::acquire(Key const& p_key) {
+    auto& entry = s_entries[p_key];
+    Ref<Material> material{Object::cast_to<Material>(ObjectDB::get_instance(entry.material_id))};
+    if (material.is_null()) {
+        auto const base_material_3d = Ref<BaseMaterial3D>{memnew(BaseMaterial3D{false})};
+        base_material_3d->set_albedo(p_key.display_color);
+        if (p_key.display_color.a < 1.0)
+            base_material_3d->set_transparency(BaseMaterial3D::TRANSPARENCY_ALPHA);
+        material = base_material_3d;
+        entry.material_id = material->get_instance_id();
+    }
+    ++entry.use_count;
+    return material;
+}
+
+std::size_t UsdjMaterialCache::get_use_count(Key const& p_key) {
+    auto const entry = s_entries.find(p_key);
+    return (entry != s_entries.end()) ? entry->second.use_count : 0;
+}
+
+void UsdjMaterialCache::release(Key const& p_key) {
+    auto const entry = s_entries.find(p_key);
+    if (entry == s_entries.end())
+        return;
+    if (--entry->second.use_count == 0)
+        s_entries.erase(entry);
+}
+
+bool operator<(UsdjMaterialCache::Key const& lhs, UsdjMaterialCache::Key const& rhs) {
+    return lhs.display_color < rhs.display_color;
+}
+
+bool operator==(UsdjMaterialCache::Key const& lhs, UsdjMaterialCache::Key const& rhs) {
+    return lhs.display_color == rhs.display_color;
+}
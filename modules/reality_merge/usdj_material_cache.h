@@ -1,5 +1,5 @@
 /**************************************************************************/
-/* usdj_velocity_extractor.h                                              */
+/* usdj_material_cache.h                                                  */
 /**************************************************************************/
 /*                         This file is part of:                          */
 /*                             RealityMerge                               */
@@ -27,48 +27,59 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
-#ifndef REALITY_MERGE_USDJ_VELOCITY_EXTRACTOR_H
-#define REALITY_MERGE_USDJ_VELOCITY_EXTRACTOR_H
+#ifndef REALITY_MERGE_USDJ_MATERIAL_CACHE_H
+#define REALITY_MERGE_USDJ_MATERIAL_CACHE_H
 
-#include <optional>
+#include <cstddef>
 
-// third-party
-#include <cavi/usdj_am/usd/physics/token_type.hpp>
-#include <cavi/usdj_am/visitor.hpp>
+// regional
+#include <core/math/color.h>
+#include <core/object/ref_counted.h>
+#include <scene/resources/material.h>
 
-struct Vector3;
-
-/// \brief An extractor of a velocity value embedded within a "USDA_Definition"
-///        node.
-class UsdjVelocityExtractor : public cavi::usdj_am::Visitor {
+/// \brief A cache of the materials of physics bodies so that bodies with the
+///        same appearance share one material.
+///
+/// \note An entry is evicted when no body uses it anymore.
+class UsdjMaterialCache {
 public:
-    UsdjVelocityExtractor() = delete;
-
-    UsdjVelocityExtractor(cavi::usdj_am::Definition const& p_definition);
-
-    UsdjVelocityExtractor(UsdjVelocityExtractor const&) = delete;
-
-    UsdjVelocityExtractor(UsdjVelocityExtractor&&) = default;
-
-    ~UsdjVelocityExtractor();
-
-    UsdjVelocityExtractor& operator=(UsdjVelocityExtractor const&) = delete;
-
-    UsdjVelocityExtractor& operator=(UsdjVelocityExtractor&&) = default;
-
-    /// \throws std::invalid_argument
-    std::optional<Vector3> operator()(cavi::usdj_am::usd::physics::TokenType const reference);
-
-    void visit(cavi::usdj_am::Declaration const& declaration) override;
+    /// \brief The resolved surface parameters of a prim.
+    ///
+    /// \note A field is added for each input of a surface shader that the
+    ///       materials are made from.
+    struct Key {
+        /// \note "primvars:displayColor" with "primvars:displayOpacity" as
+        ///       its alpha.
+        Color display_color;
+    };
+
+    UsdjMaterialCache() = delete;
+
+    /// \brief Gets the material for the given surface parameters, making it
+    ///        if no body uses it yet.
+    ///
+    /// \param[in] p_key The resolved surface parameters of a prim.
+    /// \returns A material shared with the other users of \p p_key.
+    /// \note Each call must be matched by a call to `release()`.
+    static Ref<Material> acquire(Key const& p_key);
+
+    /// \param[in] p_key The resolved surface parameters of a prim.
+    /// \returns The number of users of the material for \p p_key.
+    static std::size_t get_use_count(Key const& p_key);
+
+    /// \brief Stops using the material for the given surface parameters.
+    ///
+    /// \param[in] p_key The resolved surface parameters of a prim that were
+    ///                  passed to `acquire()`.
+    static void release(Key const& p_key);
+};
 
-    void visit(cavi::usdj_am::Definition const& definition) override;
+bool operator<(UsdjMaterialCache::Key const& lhs, UsdjMaterialCache::Key const& rhs);
 
-    void visit(cavi::usdj_am::DefinitionStatement const& definition_statement) override;
+bool operator==(UsdjMaterialCache::Key const& lhs, UsdjMaterialCache::Key const& rhs);
 
-private:
-    cavi::usdj_am::Definition const& m_definition;
-    std::optional<cavi::usdj_am::usd::physics::TokenType> m_reference;
-    std::optional<Vector3> m_velocity;
-};
+inline bool operator!=(UsdjMaterialCache::Key const& lhs, UsdjMaterialCache::Key const& rhs) {
+    return !operator==(lhs, rhs);
+}
 
-#endif  // REALITY_MERGE_USDJ_VELOCITY_EXTRACTOR_H
+#endif  // REALITY_MERGE_USDJ_MATERIAL_CACHE_H
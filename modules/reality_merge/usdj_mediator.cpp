@@ -27,11 +27,14 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
+#include <memory>
 #include <optional>
 #include <stdexcept>
 #include <string>
-#include <thread>
+#include <utility>
 #include <vector>
 
 // third-party
@@ -39,48 +42,33 @@ extern "C" {
 
 #include <automerge-c/automerge.h>
 }
+#include <cavi/usdj_am/utils/xform_program.hpp>
 
 // regional
 #include <core/config/project_settings.h>
 #include <core/error/error_macros.h>
 #include <core/io/dir_access.h>
-#include <core/io/json.h>
+#include <core/io/file_access.h>
 #include <core/io/resource_loader.h>
-#include <core/templates/vector.h>
-#include <core/variant/dictionary.h>
+#include <core/math/transform_3d.h>
+#include <core/object/callable_method_pointer.h>
 
 // local
 #include "usdj_body_updater.h"
+#include "usdj_editor.h"
+#include "usdj_heartbeat.h"
 #include "usdj_mediator.h"
+#include "usdj_prim_attributes_extractor.h"
 #include "usdj_static_body_3d.h"
 #include "uuid.h"
 
 namespace {
 
-static int const BUFFER_SIZE = (1 << 23) - 1;
-
-static int MAX_QUEUED_MESSAGES() {
-    static std::optional<int> value{};
-
-    if (!value)
-        value.emplace(static_cast<int>(GLOBAL_GET("network/limits/debugger/max_queued_messages")));
-    return *value;
-}
-
-static String PING_TEXT() {
-    static std::optional<String> text{};
+static char const* const RESOURCE_TYPE_NAME = "AutomergeResource";
 
-    if (!text) {
-        Dictionary request{};
-        request["ping"] = "ping";
-        Ref<JSON> json;
-        json.instantiate();
-        text = json->stringify(request, "\t", false);
-    }
-    return *text;
-}
+static char const* const SYNC_STATE_DIRECTORY = "user://reality_merge";
 
-static char const* const RESOURCE_TYPE_NAME = "AutomergeResource";
+static char const* const SYNC_STATE_EXTENSION = "amsync";
 
 static String RESOURCE_EXTENSION() {
     static std::optional<String> extension{};
@@ -94,6 +82,52 @@ static String RESOURCE_EXTENSION() {
     return *extension;
 }
 
+UsdjHeartbeat::Duration to_duration(double const seconds) {
+    return std::chrono::duration_cast<UsdjHeartbeat::Duration>(std::chrono::duration<double>{seconds});
+}
+
+/// \brief Converts an affine matrix evaluated by an `XformProgram` into a
+///        Godot transform.
+Transform3D to_Transform3D(double const (&matrix)[cavi::usdj_am::utils::XformProgram::MATRIX_SIZE]) {
+    return Transform3D{static_cast<real_t>(matrix[0]), static_cast<real_t>(matrix[1]),
+                       static_cast<real_t>(matrix[2]), static_cast<real_t>(matrix[4]),
+                       static_cast<real_t>(matrix[5]), static_cast<real_t>(matrix[6]),
+                       static_cast<real_t>(matrix[8]), static_cast<real_t>(matrix[9]),
+                       static_cast<real_t>(matrix[10]), static_cast<real_t>(matrix[3]),
+                       static_cast<real_t>(matrix[7]), static_cast<real_t>(matrix[11])};
+}
+
+double to_seconds(UsdjHeartbeat::Duration const duration) {
+    return std::chrono::duration<double>{duration}.count();
+}
+
+std::string to_std_string(String const& string) {
+    auto const buffer = string.to_utf8_buffer();
+    return std::string{reinterpret_cast<std::string::const_pointer>(buffer.ptr()),
+                       static_cast<std::string::size_type>(buffer.size())};
+}
+
+/// \brief Replaces the contents of a file by renaming a temporary file over
+///        it so that a crash never leaves it partially written.
+Error store_file(String const& path, std::vector<std::uint8_t> const& contents) {
+    auto const temporary_path = path + ".tmp";
+    auto error = OK;
+    {
+        auto const file = FileAccess::open(temporary_path, FileAccess::WRITE, &error);
+        ERR_FAIL_COND_V_MSG(file.is_null(), ERR_FILE_CANT_WRITE, vformat("Unable to write \"%s\".", temporary_path));
+        file->store_buffer(contents.data(), contents.size());
+        file->flush();
+        error = file->get_error();
+    }
+    if (error == OK)
+        error = DirAccess::rename_absolute(temporary_path, path);
+    if (error != OK) {
+        DirAccess::remove_absolute(temporary_path);
+        ERR_FAIL_V_MSG(error, vformat("Unable to write \"%s\".", path));
+    }
+    return OK;
+}
+
 String find_document(String const& basename) {
     List<String> extensions{};
     ResourceLoader::get_recognized_extensions_for_type(RESOURCE_TYPE_NAME, &extensions);
@@ -117,103 +151,97 @@ String find_document(String const& basename) {
 }  // namespace
 
 UsdjMediator::UsdjMediator()
-    : m_document_scan{false}, m_init_result{nullptr, nullptr}, m_init_syncing{false}, m_server_sync{false} {}
-
-UsdjMediator::~UsdjMediator() {}
+    : m_acknowledged_edits{0},
+      m_document_scan{false},
+      m_edit_generation{0},
+      m_edit_generation_base{0},
+      m_rendering_instanced{false},
+      m_server_keepalive_interval{5.0},
+      m_server_keepalive_timeout{15.0},
+      m_server_multiplex{false},
+      m_server_sync{false},
+      m_server_sync_budget{4000},
+      m_server_tls{true} {}
+
+UsdjMediator::~UsdjMediator() {
+    stop_sync();
+}
 
 void UsdjMediator::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_document_path"), &UsdjMediator::get_document_path);
     ClassDB::bind_method(D_METHOD("get_document_resource"), &UsdjMediator::get_document_resource);
     ClassDB::bind_method(D_METHOD("get_document_scan"), &UsdjMediator::get_document_scan);
+    ClassDB::bind_method(D_METHOD("get_rendering_instanced"), &UsdjMediator::get_rendering_instanced);
+    ClassDB::bind_method(D_METHOD("get_round_trip_time"), &UsdjMediator::get_round_trip_time);
+    ClassDB::bind_method(D_METHOD("get_round_trip_time_statistics"), &UsdjMediator::get_round_trip_time_statistics);
     ClassDB::bind_method(D_METHOD("get_server_domain_name"), &UsdjMediator::get_server_domain_name);
+    ClassDB::bind_method(D_METHOD("get_server_keepalive_interval"), &UsdjMediator::get_server_keepalive_interval);
+    ClassDB::bind_method(D_METHOD("get_server_keepalive_timeout"), &UsdjMediator::get_server_keepalive_timeout);
+    ClassDB::bind_method(D_METHOD("get_server_multiplex"), &UsdjMediator::get_server_multiplex);
     ClassDB::bind_method(D_METHOD("get_server_path"), &UsdjMediator::get_server_path);
     ClassDB::bind_method(D_METHOD("get_server_sync"), &UsdjMediator::get_server_sync);
+    ClassDB::bind_method(D_METHOD("get_server_sync_budget"), &UsdjMediator::get_server_sync_budget);
+    ClassDB::bind_method(D_METHOD("get_server_tls"), &UsdjMediator::get_server_tls);
     ClassDB::bind_method(D_METHOD("set_document_path"), &UsdjMediator::set_document_path);
     ClassDB::bind_method(D_METHOD("set_document_resource"), &UsdjMediator::set_document_resource);
     ClassDB::bind_method(D_METHOD("set_document_scan"), &UsdjMediator::set_document_scan);
+    ClassDB::bind_method(D_METHOD("set_rendering_instanced"), &UsdjMediator::set_rendering_instanced);
     ClassDB::bind_method(D_METHOD("set_server_domain_name"), &UsdjMediator::set_server_domain_name);
+    ClassDB::bind_method(D_METHOD("set_server_keepalive_interval"), &UsdjMediator::set_server_keepalive_interval);
+    ClassDB::bind_method(D_METHOD("set_server_keepalive_timeout"), &UsdjMediator::set_server_keepalive_timeout);
+    ClassDB::bind_method(D_METHOD("set_server_multiplex"), &UsdjMediator::set_server_multiplex);
     ClassDB::bind_method(D_METHOD("set_server_path"), &UsdjMediator::set_server_path);
     ClassDB::bind_method(D_METHOD("set_server_sync"), &UsdjMediator::set_server_sync);
+    ClassDB::bind_method(D_METHOD("set_server_sync_budget"), &UsdjMediator::set_server_sync_budget);
+    ClassDB::bind_method(D_METHOD("set_server_tls"), &UsdjMediator::set_server_tls);
 
     ADD_GROUP("Document", "document_");
     ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "document_resource", PROPERTY_HINT_RESOURCE_TYPE, RESOURCE_TYPE_NAME),
                  "set_document_resource", "get_document_resource");
     ADD_PROPERTY(PropertyInfo(Variant::STRING, "document_path"), "set_document_path", "get_document_path");
     ADD_PROPERTY(PropertyInfo(Variant::BOOL, "document_scan"), "set_document_scan", "get_document_scan");
+    ADD_GROUP("Rendering", "rendering_");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "rendering_instanced"), "set_rendering_instanced",
+                 "get_rendering_instanced");
     ADD_GROUP("Server", "server_");
     ADD_PROPERTY(PropertyInfo(Variant::STRING, "server_domain_name"), "set_server_domain_name",
                  "get_server_domain_name");
     ADD_PROPERTY(PropertyInfo(Variant::STRING, "server_path"), "set_server_path", "get_server_path");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "server_tls"), "set_server_tls", "get_server_tls");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "server_multiplex"), "set_server_multiplex", "get_server_multiplex");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "server_keepalive_interval", PROPERTY_HINT_RANGE, "0.1,60,0.1,suffix:s"),
+                 "set_server_keepalive_interval", "get_server_keepalive_interval");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "server_keepalive_timeout", PROPERTY_HINT_RANGE, "0.1,300,0.1,suffix:s"),
+                 "set_server_keepalive_timeout", "get_server_keepalive_timeout");
     ADD_PROPERTY(PropertyInfo(Variant::BOOL, "server_sync"), "set_server_sync", "get_server_sync");
+    ADD_PROPERTY(
+        PropertyInfo(Variant::INT, "server_sync_budget", PROPERTY_HINT_RANGE, "0,100000,1,or_greater,suffix:us"),
+        "set_server_sync_budget", "get_server_sync_budget");
 }
 
 void UsdjMediator::_notification(int p_what) {
     switch (p_what) {
         case NOTIFICATION_PROCESS: {
-            if (receive_changes()) {
+            if (m_server_sync && !m_sync_channel)
+                start_sync();
+            send_changes();
+            if (receive_changes())
                 update_bodies();
-            } else {
-                // Keep the connection, if there is one, alive.
-                send_ping();
-            }
+            m_instancer.update(*this);
             break;
         }
         case NOTIFICATION_READY: {
             set_process(true);
             break;
         }
+        case NOTIFICATION_EXIT_TREE: {
+            // Don't synchronize outside of the scene tree.
+            stop_sync();
+            break;
+        }
     }
 }
 
-Error UsdjMediator::ensure_connection() {
-    if (m_server_socket.is_null()) {
-        m_server_socket = Ref<WebSocketPeer>(WebSocketPeer::create());
-        ERR_FAIL_COND_V(m_server_socket.is_null(), ERR_CANT_CREATE);
-        Vector<String> protocols;
-        protocols.push_back("binary");
-        m_server_socket->set_supported_protocols(protocols);
-        m_server_socket->set_max_queued_packets(MAX_QUEUED_MESSAGES());
-        m_server_socket->set_inbound_buffer_size(BUFFER_SIZE);
-        m_server_socket->set_outbound_buffer_size(BUFFER_SIZE);
-    }
-    auto ready_state = m_server_socket->get_ready_state();
-    if (ready_state == WebSocketPeer::STATE_OPEN) {
-        return OK;
-    }
-    auto const url = String{"wss://"} + m_server_domain_name;
-    ERR_FAIL_COND_V(m_server_socket->connect_to_url(url, TLSOptions::client()) != OK, ERR_CANT_CONNECT);
-    m_server_socket->poll();
-    ready_state = m_server_socket->get_ready_state();
-    if (ready_state != WebSocketPeer::STATE_CONNECTING && ready_state != WebSocketPeer::STATE_OPEN) {
-        m_server_socket.unref();
-        ERR_FAIL_V_MSG(ERR_CANT_CONNECT,
-                       vformat("Unable to connect to server \"%s\": state is %s.", m_server_domain_name, ready_state));
-    }
-    // Wait for the WebSocket connection to open.
-    while (ready_state == WebSocketPeer::STATE_CONNECTING) {
-        m_server_socket->poll();
-        ready_state = m_server_socket->get_ready_state();
-    }
-    if (ready_state == WebSocketPeer::STATE_OPEN) {
-        // Disable Nagle's algorithm.
-        m_server_socket->set_no_delay(true);
-        // Request updates of the Automerge document.
-        Dictionary request{};
-        request["wa"] = "open";
-        Dictionary body{};
-        body["strateId"] = m_server_path;
-        if (m_server_peer_id.is_empty())
-            m_server_peer_id = generate_uuidv4();
-        body["peerId"] = m_server_peer_id;
-        request["body"] = body;
-        Ref<JSON> json;
-        json.instantiate();
-        ERR_FAIL_COND_V(m_server_socket->send_text(json->stringify(request, "\t", false)) != OK, ERR_QUERY_FAILED);
-        m_init_syncing = true;
-    }
-    return OK;
-}
-
 PackedStringArray UsdjMediator::get_configuration_warnings() const {
     PackedStringArray warnings = Node::get_configuration_warnings();
 
@@ -246,10 +274,46 @@ bool UsdjMediator::get_document_scan() const {
     return m_document_scan;
 }
 
+bool UsdjMediator::get_rendering_instanced() const {
+    return m_rendering_instanced;
+}
+
+double UsdjMediator::get_round_trip_time() const {
+    if (!m_sync_worker)
+        return 0.0;
+    return to_seconds(m_sync_worker->get_round_trip_statistics().smoothed);
+}
+
+Dictionary UsdjMediator::get_round_trip_time_statistics() const {
+    Dictionary result{};
+    if (m_sync_worker) {
+        auto const statistics = m_sync_worker->get_round_trip_statistics();
+        result["count"] = static_cast<std::uint64_t>(statistics.count);
+        result["smoothed"] = to_seconds(statistics.smoothed);
+        result["variation"] = to_seconds(statistics.variation);
+        result["p50"] = to_seconds(statistics.p50);
+        result["p90"] = to_seconds(statistics.p90);
+        result["p99"] = to_seconds(statistics.p99);
+    }
+    return result;
+}
+
 String UsdjMediator::get_server_domain_name() const {
     return m_server_domain_name;
 }
 
+double UsdjMediator::get_server_keepalive_interval() const {
+    return m_server_keepalive_interval;
+}
+
+double UsdjMediator::get_server_keepalive_timeout() const {
+    return m_server_keepalive_timeout;
+}
+
+bool UsdjMediator::get_server_multiplex() const {
+    return m_server_multiplex;
+}
+
 String UsdjMediator::get_server_path() const {
     return m_server_path;
 }
@@ -258,27 +322,40 @@ bool UsdjMediator::get_server_sync() const {
     return m_server_sync;
 }
 
-Error UsdjMediator::send_ping() {
-    if (!m_server_sync)
-        return OK;
-    ensure_connection();
-    m_server_socket->poll();
-    auto ready_state = m_server_socket->get_ready_state();
-    // Wait for the WebSocket connection to open.
-    while (ready_state == WebSocketPeer::STATE_CONNECTING) {
-        m_server_socket->poll();
-        ready_state = m_server_socket->get_ready_state();
-    }
-    if (ready_state == WebSocketPeer::STATE_OPEN) {
-        // Send a ping message.
-        ERR_FAIL_COND_V(m_server_socket->send_text(PING_TEXT()) != OK, FAILED);
-    }
-    return OK;
+int UsdjMediator::get_server_sync_budget() const {
+    return m_server_sync_budget;
+}
+
+bool UsdjMediator::get_server_tls() const {
+    return m_server_tls;
+}
+
+String UsdjMediator::get_sync_state_path() const {
+    if (m_document_resource.is_null())
+        return String{};
+    auto const path = m_document_resource->get_path();
+    if (!path.is_resource_file())
+        return String{};
+    // A document can be synchronized with more than one server.
+    auto const key = path + "|" + m_server_domain_name + "/" + m_server_path;
+    auto const file = path.get_file().get_basename() + "." + key.md5_text() + "." + SYNC_STATE_EXTENSION;
+    return String{SYNC_STATE_DIRECTORY}.path_join(file);
+}
+
+void UsdjMediator::on_body_edited(ObjectID const p_id) {
+    m_edited_bodies.insert(p_id);
+}
+
+void UsdjMediator::on_body_instance_changed(ObjectID const p_id) {
+    m_instancer.invalidate(p_id);
 }
 
 void UsdjMediator::set_document_path(String const& p_path) {
     if (p_path != m_document_path) {
         m_document_path = p_path;
+        m_parsed_document_path.reset();
+        m_scene.reset();
+        m_bodies.reset();
         if (m_document_path.is_empty())
             update_bodies();
         /// \note The user must reactivate document scanning to indicate when
@@ -289,13 +366,15 @@ void UsdjMediator::set_document_path(String const& p_path) {
 
 void UsdjMediator::set_document_resource(Ref<AutomergeResource> const& p_resource) {
     if (p_resource != m_document_resource) {
+        // Discard the synchronization state associated with the previous
+        // Automerge document after persisting it.
+        stop_sync();
         m_document_resource = p_resource;
-        if (!m_document_resource.is_null()) {
-            // Reset the Automerge document's associated synchronization state.
-            m_init_result = ResultPtr{AMsyncStateInit(), AMresultFree};
-        } else {
+        m_retired_document.reset();
+        m_scene.reset();
+        m_bodies.reset();
+        if (m_document_resource.is_null()) {
             // There is no document to synchronize at this point.
-            m_init_result.reset();
             set_server_sync(false);
         }
         /// \note The user must reactivate document scanning to indicate when
@@ -312,8 +391,21 @@ void UsdjMediator::set_document_scan(bool const p_scan) {
     }
 }
 
+void UsdjMediator::set_rendering_instanced(bool const p_instanced) {
+    if (p_instanced != m_rendering_instanced) {
+        m_rendering_instanced = p_instanced;
+        // The bodies constructed for the other rendering mode are replaced.
+        m_scene.reset();
+        m_bodies.reset();
+        if (m_document_scan)
+            update_bodies();
+    }
+}
+
 void UsdjMediator::set_server_domain_name(String const& p_domain_name) {
     if (p_domain_name != m_server_domain_name) {
+        // Persist the synchronization state with the previous server.
+        stop_sync();
         m_server_domain_name = p_domain_name;
         /// \note The user must reactivate server synchronization to indicate
         ///       when they're finished editing the domain name of the URL.
@@ -321,8 +413,33 @@ void UsdjMediator::set_server_domain_name(String const& p_domain_name) {
     }
 }
 
+void UsdjMediator::set_server_keepalive_interval(double const p_interval) {
+    m_server_keepalive_interval = p_interval;
+    if (m_sync_channel)
+        m_sync_channel->set_keepalive(to_duration(m_server_keepalive_interval),
+                                      to_duration(m_server_keepalive_timeout));
+}
+
+void UsdjMediator::set_server_keepalive_timeout(double const p_timeout) {
+    m_server_keepalive_timeout = p_timeout;
+    if (m_sync_channel)
+        m_sync_channel->set_keepalive(to_duration(m_server_keepalive_interval),
+                                      to_duration(m_server_keepalive_timeout));
+}
+
+void UsdjMediator::set_server_multiplex(bool const p_multiplex) {
+    if (p_multiplex != m_server_multiplex) {
+        m_server_multiplex = p_multiplex;
+        /// \note The user must reactivate server synchronization to indicate
+        ///       when they're finished editing the connection.
+        set_server_sync(false);
+    }
+}
+
 void UsdjMediator::set_server_path(String const& p_path) {
     if (p_path != m_server_path) {
+        // Persist the synchronization state with the previous server.
+        stop_sync();
         m_server_path = p_path;
         /// \note The user must reactivate server synchronization to indicate
         ///       when they're finished editing the path of the URL.
@@ -336,9 +453,8 @@ void UsdjMediator::set_server_sync(bool const p_sync) {
 
     if (p_sync != m_server_sync) {
         m_server_sync = p_sync && !(m_server_domain_name.is_empty() || m_server_path.is_empty());
-        if (!m_server_sync && !m_server_socket.is_null()) {
-            m_server_socket->close();
-            m_server_socket.unref();
+        if (!m_server_sync) {
+            stop_sync();
         } else if (m_server_sync && m_document_resource.is_null()) {
             // Search for an Automerge document named after the server path.
             auto path = find_document(m_server_path);
@@ -362,117 +478,298 @@ void UsdjMediator::set_server_sync(bool const p_sync) {
     }
 }
 
-bool UsdjMediator::receive_changes() {
-    static Ref<JSON> json_parser;
+void UsdjMediator::set_server_sync_budget(int const p_budget) {
+    m_server_sync_budget = MAX(p_budget, 0);
+    if (m_sync_channel)
+        m_sync_channel->set_budget(UsdjHeartbeat::Duration{m_server_sync_budget});
+}
+
+void UsdjMediator::set_server_tls(bool const p_tls) {
+    if (p_tls != m_server_tls) {
+        m_server_tls = p_tls;
+        /// \note The user must reactivate server synchronization to indicate
+        ///       when they're finished editing the connection.
+        set_server_sync(false);
+    }
+}
 
-    if (!m_server_sync || ensure_connection() != OK)
+bool UsdjMediator::load_replica(String const& p_path) {
+    if (!FileAccess::exists(p_path))
         return false;
-    bool result = false;
-    m_server_socket->poll();
-    auto const ready_state = m_server_socket->get_ready_state();
-    switch (ready_state) {
-        case WebSocketPeer::STATE_OPEN: {
-            auto document = m_document_resource->get_document();
-            AMsyncState* client_state = nullptr;
-            ERR_FAIL_COND_V(!AMitemToSyncState(AMresultItem(m_init_result.get()), &client_state), false);
-            auto packet_count = m_server_socket->get_available_packet_count();
-            while (packet_count && m_server_socket->get_ready_state() == WebSocketPeer::STATE_OPEN) {
-                std::uint8_t const* r_buffer = nullptr;
-                int r_buffer_size = 0;
-                auto const error = m_server_socket->get_packet(&r_buffer, r_buffer_size);
-                ERR_FAIL_COND_V(error != OK, false);
-                ERR_FAIL_COND_V(r_buffer_size <= 0, false);
-                // Ignore a JSON message.
-                String const json_string{reinterpret_cast<char const*>(r_buffer), static_cast<int>(r_buffer_size)};
-                if (json_parser.is_null())
-                    json_parser.instantiate();
-                if (json_parser->parse(json_string) != OK) {
-                    // Ignore the prepended message type signifier byte.
-                    ResultPtr const decode_result{AMsyncMessageDecode(r_buffer + 1, r_buffer_size - 1), AMresultFree};
-                    AMsyncMessage const* server_message = nullptr;
-                    if (AMitemToSyncMessage(AMresultItem(decode_result.get()), &server_message)) {
-                        ResultPtr const receive_result{
-                            AMreceiveSyncMessage(document->get(), client_state, server_message), AMresultFree};
-                        ERR_FAIL_COND_V(AMresultStatus(receive_result.get()) != AM_STATUS_OK, ERR_BUG);
-                        result = true;
-                    }
-                }
-                --packet_count;
-            }
-            if (result || m_init_syncing) {
-                ResultPtr const generate_result{AMgenerateSyncMessage(document->get(), client_state), AMresultFree};
-                AMsyncMessage const* client_message = nullptr;
-                if (AMitemToSyncMessage(AMresultItem(generate_result.get()), &client_message)) {
-                    ResultPtr const encode_result{AMsyncMessageEncode(client_message), AMresultFree};
-                    AMbyteSpan client_message_bytes = {0};
-                    ERR_FAIL_COND_V(!AMitemToBytes(AMresultItem(encode_result.get()), &client_message_bytes), false);
-                    // Prepend a message type signifier byte.
-                    std::vector<std::uint8_t> client_buffer{0};
-                    client_buffer.reserve(client_buffer.size() + client_message_bytes.count);
-                    client_buffer.insert(client_buffer.end(), client_message_bytes.src,
-                                         client_message_bytes.src + client_message_bytes.count);
-                    ERR_FAIL_COND_V(m_server_socket->put_packet(client_buffer.data(), client_buffer.size()) != OK,
-                                    false);
-                    m_init_syncing = false;
-                }
+    auto const bytes = FileAccess::get_file_as_bytes(p_path);
+    ResultPtr const load_result{AMload(bytes.ptr(), bytes.size()), AMresultFree};
+    AMdoc* replica = nullptr;
+    ERR_FAIL_COND_V_MSG(!AMitemToDoc(AMresultItem(load_result.get()), &replica), false,
+                        vformat("Unable to load \"%s\".", p_path));
+    auto const document = m_document_resource->get_document();
+    ERR_FAIL_COND_V(!document, false);
+    try {
+        Document merged{ResultPtr{AMfork(document->get(), nullptr), AMresultFree}};
+        ResultPtr const merge_result{AMmerge(merged, replica), AMresultFree};
+        ERR_FAIL_COND_V(AMresultStatus(merge_result.get()) != AM_STATUS_OK, false);
+        // The document may have been saved since the replica was.
+        auto change_hashes = AMresultItems(merge_result.get());
+        if (!AMitemsSize(&change_hashes))
+            return false;
+        m_retired_document = m_document_resource->exchange_document(std::move(merged));
+    } catch (std::invalid_argument const& thrown) {
+        ERR_FAIL_V_MSG(false, thrown.what());
+    }
+    return true;
+}
+
+bool UsdjMediator::receive_changes() {
+    if (!m_sync_channel || m_document_resource.is_null())
+        return false;
+    auto snapshot = m_sync_channel->take_snapshot();
+    if (!snapshot)
+        return false;
+    m_acknowledged_edits = m_edit_generation_base + snapshot->edit_count;
+    m_retired_document = m_document_resource->exchange_document(std::move(snapshot->document));
+    return true;
+}
+
+Error UsdjMediator::save_sync_state() {
+    auto const path = get_sync_state_path();
+    if (path.is_empty())
+        return ERR_UNCONFIGURED;
+    auto const sync_state = m_sync_channel->encode_sync_state();
+    ERR_FAIL_COND_V(sync_state.empty(), ERR_INVALID_DATA);
+    // The synchronization state claims changes that were only received by
+    // the replica so the replica must be saved along with it.
+    auto const replica = m_sync_channel->encode_replica();
+    ERR_FAIL_COND_V(replica.empty(), ERR_INVALID_DATA);
+    auto const error = DirAccess::make_dir_recursive_absolute(path.get_base_dir());
+    ERR_FAIL_COND_V_MSG(error != OK, error, vformat("Unable to create \"%s\".", path.get_base_dir()));
+    // The replica is replaced first so that a synchronization state is never
+    // left claiming changes that its replica lacks.
+    auto const replica_path = path.get_basename() + "." + RESOURCE_EXTENSION();
+    auto const replica_error = store_file(replica_path, replica);
+    if (replica_error != OK)
+        return replica_error;
+    return store_file(path, sync_state);
+}
+
+void UsdjMediator::send_changes() {
+    if (!m_sync_channel || m_edited_bodies.empty() || !m_sync_channel->can_push_edits())
+        return;
+    auto edits = std::make_unique<UsdjEdits>();
+    edits->path = to_std_string(m_document_path);
+    auto const generation = m_edit_generation + 1;
+    for (auto const id : m_edited_bodies) {
+        if (auto const body = Object::cast_to<UsdjStaticBody3D>(ObjectDB::get_instance(id))) {
+            if (auto edit = body->take_edit(generation)) {
+                edits->edits.push_back(std::move(*edit));
+                m_unacknowledged_bodies.insert(id);
             }
-            break;
-        }
-        case WebSocketPeer::STATE_CLOSING:
-            // Keep polling until it's closed.
-            break;
-        case WebSocketPeer::STATE_CLOSED: {
-            auto const code = m_server_socket->get_close_code();
-            auto const reason = m_server_socket->get_close_reason();
-            WARN_PRINT(vformat("WebSocket closed with code %d and reason \"%s\".", code, reason));
-            m_server_socket.unref();
-            break;
         }
     }
-    return result;
+    m_edited_bodies.clear();
+    if (!edits->edits.empty() && m_sync_channel->push_edits(std::move(edits)))
+        m_edit_generation = generation;
+}
+
+Error UsdjMediator::start_sync() {
+    if (m_document_resource.is_null() || !m_document_resource->get_document()) {
+        // Don't try again until the user reactivates server synchronization.
+        m_server_sync = false;
+        ERR_FAIL_V_MSG(ERR_UNCONFIGURED, vformat("There is no %s to synchronize.", RESOURCE_TYPE_NAME));
+    }
+    if (m_server_peer_id.is_empty())
+        m_server_peer_id = generate_uuidv4();
+    // Resume from the replica and synchronization state persisted by the last
+    // synchronization so that only the changes missed since then are
+    // exchanged.
+    std::vector<std::uint8_t> sync_state;
+    auto const sync_state_path = get_sync_state_path();
+    if (!sync_state_path.is_empty() && FileAccess::exists(sync_state_path)) {
+        if (load_replica(sync_state_path.get_basename() + "." + RESOURCE_EXTENSION()))
+            update_bodies();
+        auto const bytes = FileAccess::get_file_as_bytes(sync_state_path);
+        sync_state.assign(bytes.ptr(), bytes.ptr() + bytes.size());
+    }
+    auto const document = m_document_resource->get_document();
+    std::shared_ptr<UsdjSyncChannel> channel{};
+    try {
+        channel = std::make_shared<UsdjSyncChannel>(document->get(), m_server_path, m_server_peer_id, sync_state);
+    } catch (std::invalid_argument const& thrown) {
+        // Don't try again until the user reactivates server synchronization.
+        m_server_sync = false;
+        ERR_FAIL_V_MSG(ERR_CANT_CREATE, thrown.what());
+    }
+    channel->set_budget(UsdjHeartbeat::Duration{m_server_sync_budget});
+    channel->set_keepalive(to_duration(m_server_keepalive_interval), to_duration(m_server_keepalive_timeout));
+    // Mediators of documents on the same server can share one connection.
+    auto worker = (m_server_multiplex) ? UsdjSyncWorker::acquire(m_server_domain_name, m_server_tls)
+                                       : std::make_shared<UsdjSyncWorker>(m_server_domain_name, m_server_tls);
+    if (!worker->subscribe(channel)) {
+        // Don't try again until the user reactivates server synchronization.
+        m_server_sync = false;
+        ERR_FAIL_V_MSG(ERR_ALREADY_IN_USE,
+                       vformat("Document \"%s\" is already being synchronized with server \"%s\".", m_server_path,
+                               m_server_domain_name));
+    }
+    m_edit_generation_base = m_edit_generation;
+    m_sync_channel = std::move(channel);
+    m_sync_worker = std::move(worker);
+    m_sync_worker->start();
+    return OK;
+}
+
+void UsdjMediator::stop_sync() {
+    if (!m_sync_channel)
+        return;
+    // The channel's state is only consistent once the connection's thread is
+    // done with it.
+    m_sync_worker->unsubscribe(m_sync_channel);
+    m_sync_worker.reset();
+    save_sync_state();
+    m_sync_channel.reset();
 }
 
 void UsdjMediator::update_bodies() {
+    using cavi::usdj_am::utils::XformProgram;
+
     auto parent = get_parent();
     if (!parent)
         return;
-    auto physics_bodies = parent->find_children("*", "PhysicsBody3D", false, false);
-    if (!m_document_scan) {
-        // Remove all bodies constructed by a previous update.
+    if (!m_document_scan || !m_bodies) {
+        m_scene.reset();
+        m_bodies.emplace();
+        m_instancer.clear();
+        // Free all bodies constructed by a previous update except for the
+        // ones that can be matched to their prims again, including those of
+        // nested prims, in the same rendering mode.
+        auto const physics_bodies = parent->find_children("*", "PhysicsBody3D", true, false);
         for (int pos = 0; pos != physics_bodies.size(); ++pos) {
-            if (UsdjStaticBody3D* body = Object::cast_to<UsdjStaticBody3D>(physics_bodies[pos]))
-                parent->call_deferred(SNAME("remove_child"), body);
+            if (UsdjStaticBody3D* body = Object::cast_to<UsdjStaticBody3D>(physics_bodies[pos])) {
+                auto const object_id = body->get_object_id();
+                if (m_document_scan && object_id && body->is_instanced() == m_rendering_instanced) {
+                    m_bodies->emplace(UsdjObjectKey{object_id}, body->get_instance_id());
+                    if (m_rendering_instanced)
+                        m_instancer.invalidate(body->get_instance_id());
+                } else {
+                    body->get_parent()->call_deferred(SNAME("remove_child"), body);
+                    body->queue_free();
+                }
+            }
+        }
+        if (!m_document_scan) {
+            m_bodies.reset();
+            return;
         }
-        return;
     }
     auto document = m_document_resource->get_document();
     if (document) {
-        auto updater = UsdjBodyUpdater{physics_bodies};
-        auto const buffer = m_document_path.to_utf8_buffer();
-        auto const path = std::string{reinterpret_cast<std::string::const_pointer>(buffer.ptr()),
-                                      static_cast<std::string::size_type>(buffer.size())};
-        auto updates = updater(document->get(), path);
+        if (!m_parsed_document_path) {
+            try {
+                m_parsed_document_path.emplace(to_std_string(m_document_path));
+            } catch (std::invalid_argument const& thrown) {
+                ERR_FAIL_MSG(thrown.what());
+            }
+        }
+        auto updater = UsdjBodyUpdater{*m_bodies, m_rendering_instanced};
+        auto updates = updater(document->get(), *m_parsed_document_path, m_scene);
+        // A body whose last revision was skipped because of its local edits
+        // must be revised again once they're acknowledged even if its prim
+        // hasn't changed since.
+        std::vector<UsdjStaticBody3D*> stale_bodies{};
+        for (auto pos = m_unacknowledged_bodies.begin(); pos != m_unacknowledged_bodies.end();) {
+            auto const body = Object::cast_to<UsdjStaticBody3D>(ObjectDB::get_instance(*pos));
+            if (body) {
+                body->acknowledge_edits(m_acknowledged_edits);
+                if (body->is_edited()) {
+                    ++pos;
+                    continue;
+                }
+                if (body->is_stale())
+                    stale_bodies.push_back(body);
+            }
+            pos = m_unacknowledged_bodies.erase(pos);
+        }
+        // The transforms of all prims are evaluated in one batch instead of
+        // once for each body that's added or revised.
+        std::optional<XformProgram> xform_program{};
+        auto const revising = !stale_bodies.empty() || updates.count(UsdjBodyUpdater::Action::ADD) ||
+                              updates.count(UsdjBodyUpdater::Action::REVISE);
+        if (m_scene && revising) {
+            xform_program.emplace(*m_scene);
+            xform_program->evaluate_locals();
+        }
+        // A prim's transform is relative to its parent's, as is the transform
+        // of the body nested within its parent's body, so that moving a group
+        // of prims only revises the group's body. The default prim's body is
+        // nested within the mediator's parent.
+        // A prim that resets the transform stack has a top-level body placed
+        // by its local matrix within the mediator's parent instead.
+        // Its attributes are read from the scene instead of its
+        // "USDA_Definition" too.
+        auto const parent_3d = Object::cast_to<Node3D>(parent);
+        auto const parent_transform =
+            (parent_3d && parent_3d->is_inside_tree()) ? parent_3d->get_global_transform() : Transform3D{};
+        auto const set_prim_transform = [this, &parent_transform, &xform_program](UsdjStaticBody3D* const body) {
+            if (!xform_program)
+                return;
+            auto const prim = m_scene->find_prim(body->get_object_id());
+            if (prim == Scene::NONE)
+                return;
+            body->set_prim_attributes(extract_UsdjPrimAttributes(*m_scene, prim));
+            double matrix[XformProgram::MATRIX_SIZE];
+            xform_program->get_local_matrix(prim, matrix);
+            if (xform_program->get_reset(prim))
+                body->set_prim_transform(parent_transform * to_Transform3D(matrix), true);
+            else
+                body->set_prim_transform(to_Transform3D(matrix));
+        };
         for (auto const& item : updates) {
             switch (item.first) {
                 case UsdjBodyUpdater::Action::ADD: {
                     // It's a physics body that wasn't described by the USDJ
                     // previously.
-                    parent->call_deferred(SNAME("add_child"), item.second);
-                    item.second->call_deferred(SNAME("set_owner"), parent);
+                    // The body of a nested prim is a child of its parent's
+                    // body, which was added before it.
+                    auto const body = item.second.body;
+                    Node* const body_parent = (item.second.parent) ? item.second.parent : parent;
+                    set_prim_transform(body);
+                    body_parent->call_deferred(SNAME("add_child"), body);
+                    body->call_deferred(SNAME("set_owner"), parent);
+                    body->connect(SNAME("edited"),
+                                  callable_mp(this, &UsdjMediator::on_body_edited).bind(body->get_instance_id()));
+                    if (body->is_instanced()) {
+                        body->connect(SNAME("instance_changed"),
+                                      callable_mp(this, &UsdjMediator::on_body_instance_changed)
+                                          .bind(body->get_instance_id()));
+                        m_instancer.invalidate(body->get_instance_id());
+                    }
                     break;
                 }
                 case UsdjBodyUpdater::Action::KEEP: {
-                    // It's a physics body that's still described by the USDJ.
-                    item.second->call_deferred(SNAME("revise"));
+                    // It's a physics body that's still described by the USDJ
+                    // without any changes to the prim itself.
+                    break;
+                }
+                case UsdjBodyUpdater::Action::REVISE: {
+                    // It's a physics body that's still described by the USDJ
+                    // with some changes.
+                    item.second.body->acknowledge_edits(m_acknowledged_edits);
+                    set_prim_transform(item.second.body);
+                    item.second.body->call_deferred(SNAME("revise"));
                     break;
                 }
                 case UsdjBodyUpdater::Action::REMOVE: {
                     // It's a physics body that's no longer described by the
                     // USDJ.
-                    parent->call_deferred(SNAME("remove_child"), item.second);
+                    m_instancer.erase(item.second.body->get_instance_id());
+                    if (auto const body_parent = item.second.body->get_parent())
+                        body_parent->call_deferred(SNAME("remove_child"), item.second.body);
+                    item.second.body->queue_free();
                     break;
                 }
             }
         }
+        for (auto const body : stale_bodies) {
+            set_prim_transform(body);
+            body->call_deferred(SNAME("revise"));
+        }
     }
 }
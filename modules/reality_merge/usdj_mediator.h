@@ -32,29 +32,34 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
+#include <set>
 
 // third-party
 #include <cavi/usdj_am/utils/document.hpp>
+#include <cavi/usdj_am/utils/document_path.hpp>
+#include <cavi/usdj_am/utils/scene.hpp>
 
 // regional
 #include <core/error/error_list.h>
+#include <core/object/object_id.h>
 #include <core/object/ref_counted.h>
 #include <core/string/ustring.h>
+#include <core/variant/dictionary.h>
 #include <core/variant/variant.h>
-#include <modules/websocket/websocket_peer.h>
 #include <scene/3d/node_3d.h>
 
 // local
 #include "automerge_resource.h"
-
-struct AMresult;
+#include "usdj_body_updater.h"
+#include "usdj_multi_mesh_instancer.h"
+#include "usdj_sync_channel.h"
+#include "usdj_sync_worker.h"
 
 class UsdjMediator : public Node3D {
     GDCLASS(UsdjMediator, Node3D);
 
 public:
-    static std::uint64_t const HANDSHAKE_TIMEOUT_MSECS = 6000;
-
     UsdjMediator();
 
     ~UsdjMediator();
@@ -70,15 +75,41 @@ public:
     /// \returns The Automerge document scan toggle.
     bool get_document_scan() const;
 
+    /// \returns The instanced rendering toggle.
+    bool get_rendering_instanced() const;
+
+    /// \returns The smoothed round-trip time to the server in seconds.
+    double get_round_trip_time() const;
+
+    /// \returns The statistics of the round trips to the server in seconds.
+    Dictionary get_round_trip_time_statistics() const;
+
     /// \returns The server's URL domain name component.
     String get_server_domain_name() const;
 
+    /// \returns The period between pings to the server in seconds.
+    double get_server_keepalive_interval() const;
+
+    /// \returns The time to wait for the server to respond in seconds.
+    double get_server_keepalive_timeout() const;
+
+    /// \returns The toggle for sharing one connection with the mediators of
+    ///          other documents on the same server.
+    bool get_server_multiplex() const;
+
     /// \returns The server's URL path component.
     String get_server_path() const;
 
+    /// \returns The time to spend applying sync messages per pump in
+    ///          microseconds.
+    int get_server_sync_budget() const;
+
     /// \returns The server synchronization toggle.
     bool get_server_sync() const;
 
+    /// \returns The server connection's TLS toggle.
+    bool get_server_tls() const;
+
     /// \param[in] p_path A POSIX path to a map object within an Automerge
     ///                   document.
     void set_document_path(String const& p_path);
@@ -89,44 +120,150 @@ public:
     /// \param[in] p_scan A document scan toggle.
     void set_document_scan(bool const p_scan);
 
+    /// \param[in] p_instanced A toggle for drawing the meshes of bodies whose
+    ///                        geometry comes from the same source through
+    ///                        one `MultiMeshInstance3D` per material instead
+    ///                        of one `MeshInstance3D` per body.
+    void set_rendering_instanced(bool const p_instanced);
+
     /// \param[in] p_domain_name A server's URL domain name component.
     void set_server_domain_name(String const& p_domain_name);
 
+    /// \param[in] p_interval A period between pings to a server in seconds.
+    /// \note A multiplexed connection pings at the shortest interval of the
+    ///       mediators sharing it.
+    void set_server_keepalive_interval(double const p_interval);
+
+    /// \param[in] p_timeout A time to wait for a server to respond in seconds
+    ///                      before reconnecting to it.
+    /// \note A multiplexed connection waits for the shortest timeout of the
+    ///       mediators sharing it.
+    void set_server_keepalive_timeout(double const p_timeout);
+
+    /// \param[in] p_multiplex A toggle for sharing one connection with the
+    ///                        mediators of other documents on the same
+    ///                        server, which it must support.
+    void set_server_multiplex(bool const p_multiplex);
+
     /// \param[in] p_path A server's URL path component.
     void set_server_path(String const& p_path);
 
     /// \param[in] p_sync A server synchronization toggle.
     void set_server_sync(bool const p_sync);
 
+    /// \param[in] p_budget A time to spend applying sync messages per pump in
+    ///                     microseconds or zero for no limit.
+    /// \note A multiplexed connection spends the smallest budget of the
+    ///       mediators sharing it on all of their documents.
+    void set_server_sync_budget(int const p_budget);
+
+    /// \param[in] p_tls A toggle for securing the server connection with TLS,
+    ///                  which only a local relay can do without.
+    void set_server_tls(bool const p_tls);
+
 protected:
     static void _bind_methods();
 
     void _notification(int p_what);
 
-    /// \brief Ensures that there's a connection to the server.
+    /// \brief Merges the replica persisted by the last synchronization with
+    ///        the server into the Automerge document resource.
     ///
-    /// \returns `Error::OK` if a connection exists.
-    Error ensure_connection();
+    /// \param[in] p_path The path of the file storing the replica.
+    /// \returns `true` if the Automerge document was changed.
+    /// \note The file of the Automerge document resource isn't changed.
+    bool load_replica(String const& p_path);
 
+    /// \brief Swaps the most recent snapshot published by the synchronization
+    ///        channel into the Automerge document resource.
+    ///
+    /// \returns `true` if the Automerge document was changed.
     bool receive_changes();
 
-    Error send_ping();
+    /// \brief Saves the synchronization state alongside the replica that it
+    ///        was negotiated for so that the next synchronization can resume
+    ///        from it.
+    ///
+    /// \returns `Error::OK` if both were saved.
+    /// \pre The synchronization channel is unsubscribed.
+    /// \note Both are saved into the user data directory instead of the
+    ///       Automerge document resource's file, which may be tracked by
+    ///       version control or read-only within an exported project.
+    Error save_sync_state();
+
+    /// \brief Hands the edits made to the physics bodies during the frame to
+    ///        the synchronization channel as a single batch.
+    void send_changes();
+
+    /// \brief Starts synchronizing the Automerge document with the server on
+    ///        a background thread.
+    ///
+    /// \returns `Error::OK` if the synchronization channel is subscribed.
+    Error start_sync();
+
+    /// \brief Stops synchronizing the Automerge document with the server.
+    void stop_sync();
 
     void update_bodies();
 
 private:
-    using ResultPtr = cavi::usdj_am::utils::Document::ResultPtr;
+    using Document = cavi::usdj_am::utils::Document;
+    using DocumentPath = cavi::usdj_am::utils::DocumentPath;
+    using ResultPtr = Document::ResultPtr;
+    using Scene = cavi::usdj_am::utils::Scene;
+
+    /// \returns The path of the file within the user data directory that
+    ///          persists the synchronization state of the Automerge document
+    ///          with the server or an empty string if the document isn't
+    ///          stored in a file.
+    String get_sync_state_path() const;
+
+    void on_body_edited(ObjectID const p_id);
+
+    void on_body_instance_changed(ObjectID const p_id);
 
+    /// \note The generation of the most recent batch of edits reflected by
+    ///       the Automerge document.
+    std::uint64_t m_acknowledged_edits;
     String m_document_path;
     Ref<AutomergeResource> m_document_resource;
     bool m_document_scan;
-    ResultPtr m_init_result;
-    bool m_init_syncing;
+    /// \note The document path is parsed once per assignment and caches its
+    ///       resolution between revisions of the Automerge document.
+    std::optional<DocumentPath> m_parsed_document_path;
+    std::set<ObjectID> m_edited_bodies;
+    /// \note The generation of the most recent batch of edits sent.
+    std::uint64_t m_edit_generation;
+    /// \note The generation of the edits sent before the current
+    ///       synchronization channel was subscribed.
+    std::uint64_t m_edit_generation_base;
+    UsdjMultiMeshInstancer m_instancer;
+    bool m_rendering_instanced;
+    /// \note The revision of the Automerge document that was replaced last is
+    ///       retained so that calls deferred against it remain valid.
+    std::optional<Document> m_retired_document;
+    /// \note The scene compiled from the revision of the "USDA_File" node
+    ///       that the bodies were updated from last so that only the bodies
+    ///       whose prims were changed since then are revised.
+    std::optional<Scene> m_scene;
+    /// \note The index of the bodies constructed by the previous update is
+    ///       kept so that matching them to their prims costs O(1) each.
+    ///       It's `std::nullopt` until the bodies are found in the scene tree.
+    std::optional<UsdjBodyUpdater::Bodies> m_bodies;
     String m_server_domain_name;
+    double m_server_keepalive_interval;
+    double m_server_keepalive_timeout;
+    bool m_server_multiplex;
     String m_server_path;
     String m_server_peer_id;
-    Ref<WebSocketPeer> m_server_socket;
     bool m_server_sync;
+    int m_server_sync_budget;
+    bool m_server_tls;
+    std::shared_ptr<UsdjSyncChannel> m_sync_channel;
+    std::shared_ptr<UsdjSyncWorker> m_sync_worker;
+    /// \note The bodies whose edits were sent but not acknowledged yet so
+    ///       that acknowledging them doesn't visit every body.
+    std::set<ObjectID> m_unacknowledged_bodies;
 };
 
 #endif  // REALITY_MERGE_USDJ_MEDIATOR_H
@@ -0,0 +1,153 @@
+/**************************************************************************/
+/* usdj_multi_mesh_instancer.cpp                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+// regional
+#include <core/object/object.h>
+#include <core/os/memory.h>
+#include <core/typedefs.h>
+#include <scene/3d/multimesh_instance_3d.h>
+#include <scene/main/node.h>
+#include <scene/resources/material.h>
+
+// local
+#include "usdj_multi_mesh_instancer.h"
+#include "usdj_static_body_3d.h"
+
+UsdjMultiMeshInstancer::UsdjMultiMeshInstancer() {}
+
+UsdjMultiMeshInstancer::~UsdjMultiMeshInstancer() {}
+
+void UsdjMultiMeshInstancer::clear() {
+    for (auto const& item : m_buckets) {
+        if (auto const node = Object::cast_to<Node>(ObjectDB::get_instance(item.second.node_id)))
+            node->queue_free();
+    }
+    m_buckets.clear();
+    m_invalidated.clear();
+    m_slots.clear();
+}
+
+void UsdjMultiMeshInstancer::erase(ObjectID const p_id) {
+    m_invalidated.erase(p_id);
+    auto const slot = m_slots.find(p_id);
+    if (slot == m_slots.end())
+        return;
+    auto const bucket = m_buckets.find(slot->second.key);
+    auto& bodies = bucket->second.bodies;
+    // The last instance takes the place of the removed one so that the
+    // visible instances stay contiguous.
+    auto const last = bodies.back();
+    if (last != p_id) {
+        bodies[slot->second.index] = last;
+        m_slots[last].index = slot->second.index;
+        m_invalidated.insert(last);
+    }
+    bodies.pop_back();
+    m_slots.erase(slot);
+    if (bodies.empty()) {
+        if (auto const node = Object::cast_to<Node>(ObjectDB::get_instance(bucket->second.node_id)))
+            node->queue_free();
+        m_buckets.erase(bucket);
+    }
+}
+
+void UsdjMultiMeshInstancer::invalidate(ObjectID const p_id) {
+    m_invalidated.insert(p_id);
+}
+
+void UsdjMultiMeshInstancer::update(Node& p_owner) {
+    // Sort the invalidated bodies into their buckets before writing any
+    // instances because moving a body out of a bucket invalidates another.
+    auto const invalidated = m_invalidated;
+    for (auto const id : invalidated) {
+        auto const body = Object::cast_to<UsdjStaticBody3D>(ObjectDB::get_instance(id));
+        if (!(body && body->is_instanced() && body->get_geom_type())) {
+            erase(id);
+            continue;
+        }
+        // The body's transform and color are only final once it's inside of
+        // the scene tree.
+        if (!body->is_inside_tree())
+            continue;
+        Key const key{*body->get_geom_type(), body->get_display_color().a < 1.0};
+        auto const slot = m_slots.find(id);
+        if (slot != m_slots.end()) {
+            if (slot->second.key == key)
+                continue;
+            erase(id);
+            m_invalidated.insert(id);
+        }
+        auto& bucket = m_buckets[key];
+        if (bucket.multi_mesh.is_null()) {
+            // The mesh of the bucket's first body is shared by all of its
+            // instances, which are scaled to their own sizes instead.
+            bucket.multi_mesh.instantiate();
+            bucket.multi_mesh->set_transform_format(MultiMesh::TRANSFORM_3D);
+            bucket.multi_mesh->set_use_colors(true);
+            bucket.multi_mesh->set_mesh(body->get_instance_mesh());
+            auto const material = Ref<BaseMaterial3D>{memnew(BaseMaterial3D{false})};
+            material->set_flag(BaseMaterial3D::FLAG_ALBEDO_FROM_VERTEX_COLOR, true);
+            if (key.second)
+                material->set_transparency(BaseMaterial3D::TRANSPARENCY_ALPHA);
+            auto const node = memnew(MultiMeshInstance3D);
+            node->set_multimesh(bucket.multi_mesh);
+            node->set_material_override(material);
+            // The instances' transforms are global like those of the bodies.
+            node->set_as_top_level(true);
+            p_owner.add_child(node);
+            bucket.node_id = node->get_instance_id();
+        }
+        m_slots[id] = Slot{key, static_cast<int>(bucket.bodies.size())};
+        bucket.bodies.push_back(id);
+    }
+    for (auto& item : m_buckets) {
+        auto& bucket = item.second;
+        auto const count = static_cast<int>(bucket.bodies.size());
+        auto const capacity = bucket.multi_mesh->get_instance_count();
+        if (count > capacity) {
+            // Resizing the buffer discards its contents so its capacity is
+            // doubled to amortize rewriting them.
+            bucket.multi_mesh->set_instance_count(MAX(count, capacity * 2));
+            m_invalidated.insert(bucket.bodies.begin(), bucket.bodies.end());
+        }
+        bucket.multi_mesh->set_visible_instance_count(count);
+    }
+    for (auto pos = m_invalidated.begin(); pos != m_invalidated.end();) {
+        auto const slot = m_slots.find(*pos);
+        auto const body = Object::cast_to<UsdjStaticBody3D>(ObjectDB::get_instance(*pos));
+        if (slot == m_slots.end() || !(body && body->is_inside_tree())) {
+            ++pos;
+            continue;
+        }
+        auto const& multi_mesh = m_buckets[slot->second.key].multi_mesh;
+        multi_mesh->set_instance_transform(slot->second.index, body->get_instance_transform());
+        multi_mesh->set_instance_color(slot->second.index, body->get_display_color());
+        pos = m_invalidated.erase(pos);
+    }
+}
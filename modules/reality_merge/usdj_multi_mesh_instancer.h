@@ -0,0 +1,107 @@
+/**************************************************************************/
+/* usdj_multi_mesh_instancer.h                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef REALITY_MERGE_USDJ_MULTI_MESH_INSTANCER_H
+#define REALITY_MERGE_USDJ_MULTI_MESH_INSTANCER_H
+
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+// third-party
+#include <cavi/usdj_am/usd/geom/token_type.hpp>
+
+// regional
+#include <core/object/object_id.h>
+#include <core/object/ref_counted.h>
+#include <scene/resources/multimesh.h>
+
+class Node;
+
+/// \brief A renderer of the meshes of physics bodies whose geometry comes
+///        from the same source through one `MultiMeshInstance3D` per
+///        material bucket instead of one `MeshInstance3D` per body.
+///
+/// \note The bodies must be constructed as instanced.
+class UsdjMultiMeshInstancer {
+public:
+    UsdjMultiMeshInstancer();
+
+    UsdjMultiMeshInstancer(UsdjMultiMeshInstancer const&) = delete;
+
+    ~UsdjMultiMeshInstancer();
+
+    UsdjMultiMeshInstancer& operator=(UsdjMultiMeshInstancer const&) = delete;
+
+    /// \brief Removes the instances of all bodies and frees the
+    ///        `MultiMeshInstance3D` nodes that drew them.
+    void clear();
+
+    /// \brief Removes a body's instance.
+    ///
+    /// \param[in] p_id The instance ID of a physics body.
+    void erase(ObjectID const p_id);
+
+    /// \brief Schedules a body's instance to be added or rewritten by the
+    ///        next update.
+    ///
+    /// \param[in] p_id The instance ID of an instanced physics body.
+    void invalidate(ObjectID const p_id);
+
+    /// \brief Writes the transforms and colors of the invalidated bodies
+    ///        that are inside of the scene tree into the multimesh buffers.
+    ///
+    /// \param[in,out] p_owner The node to add new `MultiMeshInstance3D`
+    ///                        nodes to as its children.
+    void update(Node& p_owner);
+
+private:
+    /// \brief The source of a body's geometry and whether its material is
+    ///        transparent.
+    using Key = std::pair<cavi::usdj_am::usd::geom::TokenType, bool>;
+
+    struct Bucket {
+        Ref<MultiMesh> multi_mesh;
+        ObjectID node_id;
+        /// \note The bodies by instance index.
+        std::vector<ObjectID> bodies;
+    };
+
+    struct Slot {
+        Key key;
+        int index;
+    };
+
+    std::map<Key, Bucket> m_buckets;
+    std::set<ObjectID> m_invalidated;
+    std::map<ObjectID, Slot> m_slots;
+};
+
+#endif  // REALITY_MERGE_USDJ_MULTI_MESH_INSTANCER_H
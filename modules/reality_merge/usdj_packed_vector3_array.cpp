@@ -1,5 +1,5 @@
 /**************************************************************************/
-/* usdj_color_extractor.h                                                 */
+/* usdj_packed_vector3_array.cpp                                          */
 /**************************************************************************/
 /*                         This file is part of:                          */
 /*                             RealityMerge                               */
@@ -27,49 +27,45 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
-#ifndef REALITY_MERGE_USDJ_COLOR_EXTRACTOR_H
-#define REALITY_MERGE_USDJ_COLOR_EXTRACTOR_H
-
-#include <cstdint>
-#include <map>
-#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <typeinfo>
 
 // third-party
-#include <cavi/usdj_am/visitor.hpp>
-
-struct Color;
-
-/// \brief An extractor of a color value embedded within a "USDA_Definition"
-///        node.
-class UsdjColorExtractor : public cavi::usdj_am::Visitor {
-public:
-    UsdjColorExtractor() = delete;
-
-    UsdjColorExtractor(cavi::usdj_am::Definition const& p_definition);
-
-    UsdjColorExtractor(UsdjColorExtractor const&) = delete;
-
-    UsdjColorExtractor(UsdjColorExtractor&&) = default;
-
-    ~UsdjColorExtractor();
-
-    UsdjColorExtractor& operator=(UsdjColorExtractor const&) = delete;
-
-    UsdjColorExtractor& operator=(UsdjColorExtractor&&) = default;
-
-    std::optional<Color> operator()();
-
-    void visit(cavi::usdj_am::Declaration const& declaration) override;
-
-    void visit(cavi::usdj_am::Definition const& definition) override;
-
-    void visit(cavi::usdj_am::DefinitionStatement const& definition_statement) override;
-
-private:
-    enum class Component : std::uint8_t { BEGIN__ = 1, R = BEGIN__, G, B, A, END__, SIZE__ = END__ - BEGIN__ };
-
-    cavi::usdj_am::Definition const& m_definition;
-    std::map<Component, float> m_components;
-};
-
-#endif  // REALITY_MERGE_USDJ_COLOR_EXTRACTOR_H
+#include <cavi/usdj_am/utils/numbers.hpp>
+#include <cavi/usdj_am/value.hpp>
+
+// regional
+#include <core/math/vector3.h>
+
+// local
+#include "usdj_packed_vector3_array.h"
+
+PackedVector3Array to_PackedVector3Array(cavi::usdj_am::Value const& value) {
+    using cavi::usdj_am::ValueRange;
+    using cavi::usdj_am::utils::read_number_tuples;
+
+    static_assert(sizeof(Vector3) == Vector3::AXIS_COUNT * sizeof(real_t), "A Vector3 isn't a tuple of reals.");
+
+    std::ostringstream args;
+    PackedVector3Array result;
+    try {
+        auto const& rows = std::get<ValueRange>(value);
+        result.resize(rows.size());
+        /// \note The array is filled in place instead of appending a vector
+        ///       at a time.
+        auto const written = read_number_tuples(
+            rows, Vector3::AXIS_COUNT, reinterpret_cast<real_t*>(result.ptrw()), result.size() * Vector3::AXIS_COUNT);
+        result.resize(written / Vector3::AXIS_COUNT);
+    } catch (std::bad_variant_access const& thrown) {
+        args << "std::get<ValueRange>(value): " << thrown.what();
+    } catch (std::invalid_argument const& thrown) {
+        args << thrown.what();
+    }
+    if (!args.str().empty()) {
+        std::ostringstream what;
+        what << __func__ << "(" << args.str() << ")";
+        throw std::invalid_argument(what.str());
+    }
+    return result;
+}
@@ -1,5 +1,5 @@
 /**************************************************************************/
-/* usdj_transform_3d_extractor.h                                          */
+/* usdj_packed_vector3_array.h                                            */
 /**************************************************************************/
 /*                         This file is part of:                          */
 /*                             RealityMerge                               */
@@ -27,48 +27,25 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
-#ifndef REALITY_MERGE_USDJ_TRANSFORM_3D_EXTRACTOR_H
-#define REALITY_MERGE_USDJ_TRANSFORM_3D_EXTRACTOR_H
+#ifndef REALITY_MERGE_USDJ_PACKED_VECTOR3_ARRAY_H
+#define REALITY_MERGE_USDJ_PACKED_VECTOR3_ARRAY_H
 
-#include <memory>
-#include <optional>
+// regional
+#include <core/variant/variant.h>
 
-// third-party
-#include <cavi/usdj_am/visitor.hpp>
+namespace cavi {
+namespace usdj_am {
 
-struct Transform3D;
+struct Value;
 
-/// \brief An extractor of a transform value embedded within a "USDA_Definition"
-///        node.
-class UsdjTransform3dExtractor : public cavi::usdj_am::Visitor {
-public:
-    UsdjTransform3dExtractor() = delete;
+}  // namespace usdj_am
+}  // namespace cavi
 
-    UsdjTransform3dExtractor(cavi::usdj_am::Definition const& p_definition);
+/// \brief Converts a USDJ value into a Godot packed array of 3D vectors.
+///
+/// \param[in] value A USDA-to-JSON `Value`.
+/// \return A Godot `PackedVector3Array` instance.
+/// \throws std::invalid_argument
+PackedVector3Array to_PackedVector3Array(cavi::usdj_am::Value const& value);
 
-    UsdjTransform3dExtractor(UsdjTransform3dExtractor const&) = delete;
-
-    UsdjTransform3dExtractor(UsdjTransform3dExtractor&&) = default;
-
-    ~UsdjTransform3dExtractor();
-
-    UsdjTransform3dExtractor& operator=(UsdjTransform3dExtractor const&) = delete;
-
-    UsdjTransform3dExtractor& operator=(UsdjTransform3dExtractor&&) = default;
-
-    std::optional<Transform3D> operator()();
-
-    void visit(cavi::usdj_am::Definition const& definition) override;
-
-    void visit(cavi::usdj_am::DefinitionStatement const& definition_statement) override;
-
-    void visit(cavi::usdj_am::Declaration const& declaration) override;
-
-private:
-    struct Data;
-
-    cavi::usdj_am::Definition const& m_definition;
-    std::unique_ptr<Data> m_data;
-};
-
-#endif  // REALITY_MERGE_USDJ_TRANSFORM_3D_EXTRACTOR_H
+#endif  // REALITY_MERGE_USDJ_PACKED_VECTOR3_ARRAY_H
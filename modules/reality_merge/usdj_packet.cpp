@@ -0,0 +1,92 @@
+/**************************************************************************/
+/* usdj_packet.cpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include <limits>
+
+// local
+#include "usdj_packet.h"
+
+namespace {
+
+/// \brief The message type signifier byte prepended to a sync message.
+static std::uint8_t const SYNC_MESSAGE_TYPE = 0;
+
+/// \brief The message type signifier byte prepended to a sync message that's
+///        multiplexed with those of other documents over one connection. It's
+///        followed by the length of the document's ID, the ID itself and then
+///        the sync message.
+static std::uint8_t const TAGGED_SYNC_MESSAGE_TYPE = 1;
+
+/// \brief The first byte of a JSON object, which can't be mistaken for a
+///        message type signifier byte.
+static std::uint8_t const JSON_OBJECT_BEGIN = '{';
+
+}  // namespace
+
+UsdjPacket classify_packet(std::uint8_t const* const p_buffer, std::size_t const p_size, bool const p_is_text) {
+    if (!p_buffer || !p_size)
+        return UsdjPacket{UsdjPacketType::UNKNOWN, p_buffer, 0};
+    if (p_is_text)
+        return UsdjPacket{UsdjPacketType::CONTROL, p_buffer, p_size};
+    switch (p_buffer[0]) {
+        case SYNC_MESSAGE_TYPE:
+            return UsdjPacket{UsdjPacketType::SYNC, p_buffer + 1, p_size - 1};
+        case TAGGED_SYNC_MESSAGE_TYPE: {
+            std::size_t const header_size = (p_size > 1) ? 2 + p_buffer[1] : p_size + 1;
+            if (header_size > p_size || header_size == 2)
+                return UsdjPacket{UsdjPacketType::UNKNOWN, p_buffer, p_size};
+            std::string_view const channel{reinterpret_cast<char const*>(p_buffer + 2), header_size - 2};
+            return UsdjPacket{UsdjPacketType::TAGGED_SYNC, p_buffer + header_size, p_size - header_size, channel};
+        }
+        case JSON_OBJECT_BEGIN:
+            // A control message sent in a binary frame.
+            return UsdjPacket{UsdjPacketType::CONTROL, p_buffer, p_size};
+        default:
+            return UsdjPacket{UsdjPacketType::UNKNOWN, p_buffer, p_size};
+    }
+}
+
+std::vector<std::uint8_t> frame_sync_message(std::string_view const p_channel,
+                                             std::uint8_t const* const p_message,
+                                             std::size_t const p_size) {
+    std::vector<std::uint8_t> frame{};
+    if (p_channel.size() > std::numeric_limits<std::uint8_t>::max())
+        return frame;
+    if (p_channel.empty()) {
+        frame.reserve(1 + p_size);
+        frame.push_back(SYNC_MESSAGE_TYPE);
+    } else {
+        frame.reserve(2 + p_channel.size() + p_size);
+        frame.push_back(TAGGED_SYNC_MESSAGE_TYPE);
+        frame.push_back(static_cast<std::uint8_t>(p_channel.size()));
+        frame.insert(frame.end(), p_channel.begin(), p_channel.end());
+    }
+    frame.insert(frame.end(), p_message, p_message + p_size);
+    return frame;
+}
@@ -0,0 +1,84 @@
+/**************************************************************************/
+/* usdj_packet.h                                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef REALITY_MERGE_USDJ_PACKET_H
+#define REALITY_MERGE_USDJ_PACKET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/// \brief The kinds of packets that a server can send.
+enum class UsdjPacketType : std::uint8_t {
+    BEGIN__ = 1,
+    /// A JSON control message.
+    CONTROL = BEGIN__,
+    /// An encoded Automerge sync message.
+    SYNC,
+    /// An encoded Automerge sync message tagged with the ID of its document.
+    TAGGED_SYNC,
+    /// A packet that isn't understood.
+    UNKNOWN,
+    END__,
+    SIZE__ = END__ - BEGIN__
+};
+
+/// \brief A borrowed view of a packet's payload.
+struct UsdjPacket {
+    UsdjPacketType type;
+    /// The payload without its message type signifier byte or its tag, if
+    /// any.
+    std::uint8_t const* payload;
+    std::size_t size;
+    /// The ID of the document that a tagged sync message belongs to.
+    std::string_view channel;
+};
+
+/// \brief Classifies a packet by its frame's opcode and its message type
+///        signifier byte without copying or parsing it.
+///
+/// \param[in] p_buffer A pointer to a packet's bytes.
+/// \param[in] p_size The count of bytes in \p p_buffer.
+/// \param[in] p_is_text Whether the packet arrived in a text frame.
+/// \returns A view into \p p_buffer.
+UsdjPacket classify_packet(std::uint8_t const* const p_buffer, std::size_t const p_size, bool const p_is_text);
+
+/// \brief Frames a sync message for sending to a server.
+///
+/// \param[in] p_channel The ID of the document that the message belongs to
+///                      or an empty ID for an untagged message.
+/// \param[in] p_message A pointer to an encoded sync message.
+/// \param[in] p_size The count of bytes in \p p_message.
+/// \returns A frame or an empty array if \p p_channel is too long to tag.
+std::vector<std::uint8_t> frame_sync_message(std::string_view const p_channel,
+                                             std::uint8_t const* const p_message,
+                                             std::size_t const p_size);
+
+#endif  // REALITY_MERGE_USDJ_PACKET_H
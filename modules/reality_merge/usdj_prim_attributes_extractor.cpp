@@ -0,0 +1,341 @@
+/**************************************************************************/
+/* usdj_prim_attributes_extractor.cpp                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+// third-party
+#include <cavi/usdj_am/assignment.hpp>
+#include <cavi/usdj_am/declaration.hpp>
+#include <cavi/usdj_am/definition.hpp>
+#include <cavi/usdj_am/definition_statement.hpp>
+#include <cavi/usdj_am/descriptor.hpp>
+#include <cavi/usdj_am/external_reference.hpp>
+#include <cavi/usdj_am/reference_file.hpp>
+#include <cavi/usdj_am/usd/token_type.hpp>
+
+// regional
+#include <core/math/vector3i.h>
+
+// local
+#include "usdj_prim_attributes_extractor.h"
+#include "usdj_value.h"
+
+std::optional<Color> UsdjPrimAttributes::get_display_color() const {
+    std::optional<Color> color{display_color};
+    if (color && display_opacity)
+        color->a = *display_opacity;
+    return color;
+}
+
+UsdjPrimAttributes extract_UsdjPrimAttributes(cavi::usdj_am::utils::Scene const& p_scene,
+                                              cavi::usdj_am::utils::Scene::Index const p_prim) {
+    using cavi::usdj_am::AssignmentKeyword;
+    using cavi::usdj_am::utils::Scene;
+    namespace geom = cavi::usdj_am::usd::geom;
+    namespace physics = cavi::usdj_am::usd::physics;
+    namespace usd = cavi::usdj_am::usd;
+
+    UsdjPrimAttributes attributes{};
+    std::optional<Vector3> referenced_size{};
+    auto const type = p_scene.get_prim_type(p_prim);
+    if (type != Scene::NONE)
+        attributes.geom_type = geom::extract_TokenType(p_scene.get_token(type));
+    auto const prim_attributes = p_scene.get_prim_attributes(p_prim);
+    for (auto attribute = prim_attributes.first; attribute != prim_attributes.first + prim_attributes.count;
+         ++attribute) {
+        std::string_view const name = p_scene.get_token(p_scene.get_attribute_name(attribute));
+        auto const kind = p_scene.get_attribute_value_kind(attribute);
+        auto const values = p_scene.get_attribute_values(attribute);
+        auto const tokens = p_scene.get_token_values() + values.first;
+        if (p_scene.get_attribute_scope(attribute) == Scene::Scope::METADATA) {
+            if (p_scene.get_metadata_keyword(attribute) != AssignmentKeyword::PREPEND ||
+                kind != Scene::ValueKind::TOKENS)
+                continue;
+            if (usd::extract_TokenType(name).value_or(usd::TokenType{}) == usd::TokenType::API_SCHEMAS) {
+                for (auto pos = 0U; pos != values.count; ++pos) {
+                    if (auto const api = physics::extract_TokenType(p_scene.get_token(tokens[pos])))
+                        attributes.physics_apis.insert(*api);
+                }
+            } else if (name == "references") {
+                /// \todo Actually load the referenced file and extract its
+                ///       attributes instead of assuming a unit cube.
+                for (auto pos = 0U; pos != values.count; ++pos) {
+                    if (p_scene.get_token(tokens[pos]) == "cube.usda") {
+                        if (!attributes.geom_type)
+                            attributes.geom_type.emplace(geom::TokenType::CUBE);
+                        referenced_size.emplace(Vector3{1.0, 1.0, 1.0});
+                    }
+                }
+            }
+            continue;
+        }
+        if (p_scene.get_property_keyword(attribute) || kind != Scene::ValueKind::NUMBERS || !values.count)
+            continue;
+        // A value is read from its first row like `extract_UsdjValue()` does.
+        auto const numbers = p_scene.get_numbers() + values.first;
+        auto const to_Vector3 = [&numbers]() { return Vector3(numbers[0], numbers[1], numbers[2]); };
+        if (auto const token = geom::extract_TokenType(name)) {
+            switch (*token) {
+                case geom::TokenType::PRIMVARS_DISPLAY_COLOR: {
+                    if (values.count >= 3)
+                        attributes.display_color.emplace(numbers[0], numbers[1], numbers[2]);
+                    break;
+                }
+                case geom::TokenType::PRIMVARS_DISPLAY_OPACITY: {
+                    attributes.display_opacity = numbers[0];
+                    break;
+                }
+                case geom::TokenType::SIZE: {
+                    if (values.count >= 3)
+                        attributes.size.emplace(to_Vector3());
+                    else
+                        attributes.size.emplace(Vector3{1.0, 1.0, 1.0} * numbers[0]);
+                    break;
+                }
+                default: {
+                    break;
+                }
+            }
+        } else if (auto const token = physics::extract_TokenType(name)) {
+            switch (*token) {
+                case physics::TokenType::PHYSICS_ANGULAR_VELOCITY: {
+                    if (values.count >= 3)
+                        attributes.angular_velocity.emplace(to_Vector3());
+                    break;
+                }
+                case physics::TokenType::PHYSICS_VELOCITY: {
+                    if (values.count >= 3)
+                        attributes.velocity.emplace(to_Vector3());
+                    break;
+                }
+                case physics::TokenType::PHYSICS_COLLISION_ENABLED: {
+                    // A boolean is stored as a number.
+                    if (p_scene.get_token(p_scene.get_attribute_type(attribute)) == "bool")
+                        attributes.collision_enabled = numbers[0] != 0.0;
+                    break;
+                }
+                case physics::TokenType::PHYSICS_DENSITY: {
+                    attributes.density = numbers[0];
+                    break;
+                }
+                case physics::TokenType::PHYSICS_MASS: {
+                    attributes.mass = numbers[0];
+                    break;
+                }
+                default: {
+                    break;
+                }
+            }
+        }
+    }
+    if (!attributes.size && attributes.geom_type == geom::TokenType::CUBE)
+        attributes.size = referenced_size;
+    return attributes;
+}
+
+UsdjPrimAttributesExtractor::UsdjPrimAttributesExtractor(cavi::usdj_am::Definition const& p_definition)
+    : m_definition{p_definition} {}
+
+UsdjPrimAttributesExtractor::~UsdjPrimAttributesExtractor() {}
+
+UsdjPrimAttributes UsdjPrimAttributesExtractor::operator()() {
+    using cavi::usdj_am::usd::geom::TokenType;
+
+    m_attributes = UsdjPrimAttributes{};
+    m_referenced_size.reset();
+    m_definition.accept(*this);
+    if (!m_attributes.size && m_attributes.geom_type == TokenType::CUBE)
+        m_attributes.size = m_referenced_size;
+    return std::move(m_attributes);
+}
+
+void UsdjPrimAttributesExtractor::visit(cavi::usdj_am::Assignment const& assignment) {
+    using cavi::usdj_am::AssignmentKeyword;
+    using cavi::usdj_am::ExternalReference;
+    namespace physics = cavi::usdj_am::usd::physics;
+    namespace usd = cavi::usdj_am::usd;
+
+    if (assignment.get_keyword().value_or(AssignmentKeyword{}) == AssignmentKeyword::PREPEND) {
+        if (usd::extract_TokenType(assignment.get_identifier()).value_or(usd::TokenType{}) ==
+            usd::TokenType::API_SCHEMAS) {
+            m_attributes.physics_apis = physics::extract_TokenTypeSet(assignment.get_value());
+        } else if (assignment.get_identifier() == "references") {
+            std::visit(
+                [this](auto const& alt) {
+                    using T = std::decay_t<decltype(alt)>;
+                    if constexpr (std::is_same_v<T, ExternalReference>) {
+                        alt.accept(*this);
+                    }
+                },
+                assignment.get_value());
+        }
+    }
+}
+
+void UsdjPrimAttributesExtractor::visit(cavi::usdj_am::Declaration const& declaration) {
+    namespace geom = cavi::usdj_am::usd::geom;
+    namespace physics = cavi::usdj_am::usd::physics;
+
+    if (declaration.get_descriptor() || declaration.get_keyword())
+        return;
+    std::string_view const reference = declaration.get_reference();
+    // Each declaration's value is only converted if its name is recognized.
+    if (auto const token = geom::extract_TokenType(reference)) {
+        switch (*token) {
+            case geom::TokenType::PRIMVARS_DISPLAY_COLOR: {
+                if (auto const usd_value = extract_UsdjValue(declaration)) {
+                    if (auto const color = std::get_if<Color>(&*usd_value))
+                        m_attributes.display_color = *color;
+                }
+                break;
+            }
+            case geom::TokenType::PRIMVARS_DISPLAY_OPACITY: {
+                if (auto const usd_value = extract_UsdjValue(declaration)) {
+                    if (auto const reals = std::get_if<Reals>(&*usd_value)) {
+                        if (!reals->empty())
+                            m_attributes.display_opacity = reals->front();
+                    } else if (auto const real = std::get_if<real_t>(&*usd_value)) {
+                        m_attributes.display_opacity = *real;
+                    }
+                }
+                break;
+            }
+            case geom::TokenType::SIZE: {
+                if (auto const usd_value = extract_UsdjValue(declaration)) {
+                    std::visit(
+                        [this](auto const& alt) {
+                            using T = std::decay_t<decltype(alt)>;
+                            if constexpr (std::is_same_v<T, real_t>)
+                                this->m_attributes.size.emplace(Vector3{1.0, 1.0, 1.0} * alt);
+                            else if constexpr (std::is_same_v<T, Vector3> || std::is_same_v<T, Vector3i>)
+                                this->m_attributes.size.emplace(alt);
+                        },
+                        *usd_value);
+                }
+                break;
+            }
+            default: {
+                break;
+            }
+        }
+    } else if (auto const token = physics::extract_TokenType(reference)) {
+        switch (*token) {
+            case physics::TokenType::PHYSICS_ANGULAR_VELOCITY:
+            case physics::TokenType::PHYSICS_VELOCITY: {
+                auto& velocity = (*token == physics::TokenType::PHYSICS_VELOCITY) ? m_attributes.velocity
+                                                                                  : m_attributes.angular_velocity;
+                if (auto const usd_value = extract_UsdjValue(declaration)) {
+                    std::visit(
+                        [&velocity](auto const& alt) {
+                            using T = std::decay_t<decltype(alt)>;
+                            if constexpr (std::is_same_v<T, Vector3> || std::is_same_v<T, Vector3i>)
+                                velocity.emplace(alt);
+                        },
+                        *usd_value);
+                }
+                break;
+            }
+            case physics::TokenType::PHYSICS_COLLISION_ENABLED: {
+                // A "bool" value isn't converted by `extract_UsdjValue()`.
+                auto const value = declaration.get_value();
+                if (auto const enabled = std::get_if<bool>(&value))
+                    m_attributes.collision_enabled = *enabled;
+                break;
+            }
+            case physics::TokenType::PHYSICS_DENSITY:
+            case physics::TokenType::PHYSICS_MASS: {
+                auto& quantity =
+                    (*token == physics::TokenType::PHYSICS_MASS) ? m_attributes.mass : m_attributes.density;
+                if (auto const usd_value = extract_UsdjValue(declaration)) {
+                    if (auto const real = std::get_if<real_t>(&*usd_value))
+                        quantity = *real;
+                }
+                break;
+            }
+            default: {
+                break;
+            }
+        }
+    }
+}
+
+void UsdjPrimAttributesExtractor::visit(cavi::usdj_am::Definition const& definition) {
+    using cavi::usdj_am::usd::geom::extract_TokenType;
+
+    if (auto const def_type = definition.get_def_type())
+        m_attributes.geom_type = extract_TokenType(*def_type);
+    if (auto const descriptor = definition.get_descriptor())
+        descriptor->accept(*this);
+    for (auto const& definition_statement : definition.get_statements()) {
+        definition_statement.accept(*this);
+    }
+}
+
+void UsdjPrimAttributesExtractor::visit(cavi::usdj_am::DefinitionStatement const& definition_statement) {
+    using cavi::usdj_am::Declaration;
+
+    std::visit(
+        [this](auto const& alt) {
+            using T = std::decay_t<decltype(alt)>;
+            if constexpr (std::is_same_v<T, Declaration>)
+                alt.accept(*this);
+        },
+        definition_statement);
+}
+
+void UsdjPrimAttributesExtractor::visit(cavi::usdj_am::Descriptor const& descriptor) {
+    for (auto const& assignment : descriptor.get_assignments()) {
+        assignment.accept(*this);
+    }
+}
+
+void UsdjPrimAttributesExtractor::visit(cavi::usdj_am::ExternalReference const& external_reference) {
+    if (!external_reference.get_to_import()) {
+        auto const reference_file = external_reference.get_reference_file();
+        reference_file.accept(*this);
+    }
+}
+
+void UsdjPrimAttributesExtractor::visit(cavi::usdj_am::ReferenceFile const& reference_file) {
+    using cavi::usdj_am::usd::geom::TokenType;
+
+    if (!reference_file.get_descriptor()) {
+        /// \todo Actually load the referenced file and extract its attributes
+        ///       instead of assuming a unit cube.
+        if (reference_file.get_src() == "cube.usda") {
+            if (!m_attributes.geom_type)
+                m_attributes.geom_type.emplace(TokenType::CUBE);
+            m_referenced_size.emplace(Vector3{1.0, 1.0, 1.0});
+        }
+    }
+}
@@ -0,0 +1,126 @@
+/**************************************************************************/
+/* usdj_prim_attributes_extractor.h                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef REALITY_MERGE_USDJ_PRIM_ATTRIBUTES_EXTRACTOR_H
+#define REALITY_MERGE_USDJ_PRIM_ATTRIBUTES_EXTRACTOR_H
+
+#include <optional>
+
+// third-party
+#include <cavi/usdj_am/usd/geom/token_type.hpp>
+#include <cavi/usdj_am/usd/physics/token_type.hpp>
+#include <cavi/usdj_am/utils/scene.hpp>
+#include <cavi/usdj_am/visitor.hpp>
+
+// regional
+#include <core/math/color.h>
+#include <core/math/math_defs.h>
+#include <core/math/vector3.h>
+
+/// \brief The attributes of a USD prim that a physics body is revised from.
+///
+/// \note An attribute that the prim doesn't author is `std::nullopt`.
+/// \note The prim's transform is evaluated for all prims at once by a
+///       `cavi::usdj_am::utils::XformProgram` instead.
+struct UsdjPrimAttributes {
+    /// \returns The color displayed on the prim's surfaces including its
+    ///          opacity, if any.
+    std::optional<Color> get_display_color() const;
+
+    std::optional<Vector3> angular_velocity;
+    std::optional<bool> collision_enabled;
+    std::optional<real_t> density;
+    std::optional<Color> display_color;
+    std::optional<real_t> display_opacity;
+    std::optional<cavi::usdj_am::usd::geom::TokenType> geom_type;
+    std::optional<real_t> mass;
+    cavi::usdj_am::usd::physics::TokenTypeSet physics_apis;
+    std::optional<Vector3> size;
+    std::optional<Vector3> velocity;
+};
+
+/// \brief Extracts all of the attributes of a prim from a compiled scene
+///        without reading its "USDA_Definition" node again.
+///
+/// \param[in] p_scene A compiled scene.
+/// \param[in] p_prim The index of a prim within \p p_scene.
+/// \returns The same attributes as a `UsdjPrimAttributesExtractor` except
+///          that a declaration with a descriptor isn't told apart and an
+///          external reference is followed even if it imports.
+/// \pre \p p_prim `< p_scene.get_prim_count()`
+UsdjPrimAttributes extract_UsdjPrimAttributes(cavi::usdj_am::utils::Scene const& p_scene,
+                                              cavi::usdj_am::utils::Scene::Index const p_prim);
+
+/// \brief An extractor of all of the attributes of a "USDA_Definition" node
+///        in a single pass over its descriptor and statements.
+///
+/// \note An attribute is added by adding a field to `UsdjPrimAttributes` and
+///       a case for its token to the visit of the node that authors it so
+///       that it costs no extra passes.
+class UsdjPrimAttributesExtractor : public cavi::usdj_am::Visitor {
+public:
+    UsdjPrimAttributesExtractor() = delete;
+
+    UsdjPrimAttributesExtractor(cavi::usdj_am::Definition const& p_definition);
+
+    UsdjPrimAttributesExtractor(UsdjPrimAttributesExtractor const&) = delete;
+
+    UsdjPrimAttributesExtractor(UsdjPrimAttributesExtractor&&) = default;
+
+    ~UsdjPrimAttributesExtractor();
+
+    UsdjPrimAttributesExtractor& operator=(UsdjPrimAttributesExtractor const&) = delete;
+
+    UsdjPrimAttributesExtractor& operator=(UsdjPrimAttributesExtractor&&) = default;
+
+    UsdjPrimAttributes operator()();
+
+    void visit(cavi::usdj_am::Assignment const& assignment) override;
+
+    void visit(cavi::usdj_am::Declaration const& declaration) override;
+
+    void visit(cavi::usdj_am::Definition const& definition) override;
+
+    void visit(cavi::usdj_am::DefinitionStatement const& definition_statement) override;
+
+    void visit(cavi::usdj_am::Descriptor const& descriptor) override;
+
+    void visit(cavi::usdj_am::ExternalReference const& external_reference) override;
+
+    void visit(cavi::usdj_am::ReferenceFile const& reference_file) override;
+
+private:
+    cavi::usdj_am::Definition const& m_definition;
+    UsdjPrimAttributes m_attributes;
+    /// \note The size of a cube that's only referenced, which its own "size"
+    ///       attribute supersedes.
+    std::optional<Vector3> m_referenced_size;
+};
+
+#endif  // REALITY_MERGE_USDJ_PRIM_ATTRIBUTES_EXTRACTOR_H
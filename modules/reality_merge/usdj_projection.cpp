@@ -27,12 +27,14 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
+#include <cstddef>
 #include <iterator>
 #include <sstream>
 #include <stdexcept>
 #include <typeinfo>
 
 // third-party
+#include <cavi/usdj_am/utils/numbers.hpp>
 #include <cavi/usdj_am/value.hpp>
 
 // regional
@@ -42,8 +44,8 @@
 #include "usdj_projection.h"
 
 Projection to_Projection(cavi::usdj_am::Value const& value) {
-    using cavi::usdj_am::Number;
     using cavi::usdj_am::ValueRange;
+    using cavi::usdj_am::utils::read_number_tuples;
 
     std::ostringstream args;
     Projection result{};
@@ -53,40 +55,19 @@ Projection to_Projection(cavi::usdj_am::Value const& value) {
         if (rows.size() != Vector4::AXIS_COUNT) {
             args << "std::get<" << typeid(decltype(rows)).name() << ">(value).size() == " << rows.size();
         } else {
-            std::size_t row_index = 0;
-            std::size_t column_index = 0;
+            real_t components[Vector4::AXIS_COUNT * Vector4::AXIS_COUNT];
+            read_number_tuples(rows, Vector4::AXIS_COUNT, components, std::size(components));
             std::size_t component_index = 0;
-            for (auto const& row : rows) {
-                try {
-                    auto const& columns = std::get<ValueRange>(row);
-                    if (columns.size() != 4) {
-                        args << "(*std::get<" << typeid(decltype(rows)).name() << ">(value))[" << row_index
-                             << "].size() == " << columns.size();
-                        break;
-                    } else {
-                        for (auto const& column : columns) {
-                            auto const& number = std::get<Number>(column);
-                            std::visit(
-                                [&](auto const& alt) {
-                                    result.columns[column_index].components[component_index] = static_cast<real_t>(alt);
-                                },
-                                number);
-                            if (++component_index == Vector4::AXIS_COUNT) {
-                                ++column_index;
-                                component_index = 0;
-                            }
-                        }
-                    }
-                    ++row_index;
-                } catch (std::bad_variant_access const& thrown) {
-                    args << "(*std::get<" << typeid(decltype(rows)).name() << ">(value))[" << row_index
-                         << "]: " << thrown.what();
-                    break;
+            for (auto& column : result.columns) {
+                for (auto& component : column.components) {
+                    component = components[component_index++];
                 }
             }
         }
     } catch (std::bad_variant_access const& thrown) {
         args << "std::get<ValueRange>(value): " << thrown.what();
+    } catch (std::invalid_argument const& thrown) {
+        args << thrown.what();
     }
     if (!args.str().empty()) {
         std::ostringstream what;
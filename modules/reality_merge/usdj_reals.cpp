@@ -32,26 +32,26 @@
 #include <typeinfo>
 
 // third-party
+#include <cavi/usdj_am/utils/numbers.hpp>
 #include <cavi/usdj_am/value.hpp>
 
 // local
 #include "usdj_reals.h"
 
 Reals to_reals(cavi::usdj_am::Value const& value) {
-    using cavi::usdj_am::Number;
     using cavi::usdj_am::ValueRange;
+    using cavi::usdj_am::utils::read_numbers;
 
     std::ostringstream args;
     Reals result;
     try {
         auto const& values = std::get<ValueRange>(value);
-        result.reserve(values.size());
-        for (auto const& value : values) {
-            auto const& number = std::get<Number>(value);
-            std::visit([&](auto const& alt) { result.push_back(static_cast<Reals::value_type>(alt)); }, number);
-        }
+        result.resize(values.size());
+        result.resize(read_numbers(values, result.data(), result.size()));
     } catch (std::bad_variant_access const& thrown) {
         args << "std::get<ValueRange>(value): " << thrown.what();
+    } catch (std::invalid_argument const& thrown) {
+        args << thrown.what();
     }
     if (!args.str().empty()) {
         std::ostringstream what;
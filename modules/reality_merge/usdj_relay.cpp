@@ -0,0 +1,276 @@
+/**************************************************************************/
+/* usdj_relay.cpp                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// third-party
+extern "C" {
+
+#include <automerge-c/automerge.h>
+}
+
+// regional
+#include <core/error/error_macros.h>
+#include <core/io/ip_address.h>
+#include <core/io/stream_peer_tcp.h>
+#include <core/templates/vector.h>
+
+// local
+#include "usdj_relay.h"
+
+namespace {
+
+static int const BUFFER_SIZE = (1 << 23) - 1;
+
+static int const MAX_QUEUED_PACKETS = 4096;
+
+}  // namespace
+
+UsdjRelay::UsdjRelay() : m_bytes_received{0}, m_bytes_sent{0}, m_messages_received{0}, m_messages_sent{0} {
+    m_json_parser.instantiate();
+    m_server.instantiate();
+}
+
+UsdjRelay::~UsdjRelay() {
+    stop();
+}
+
+void UsdjRelay::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("get_document_ids"), &UsdjRelay::get_document_ids);
+    ClassDB::bind_method(D_METHOD("get_peer_count"), &UsdjRelay::get_peer_count);
+    ClassDB::bind_method(D_METHOD("get_statistics"), &UsdjRelay::get_statistics);
+    ClassDB::bind_method(D_METHOD("is_listening"), &UsdjRelay::is_listening);
+    ClassDB::bind_method(D_METHOD("listen", "port", "bind_address"), &UsdjRelay::listen, DEFVAL("127.0.0.1"));
+    ClassDB::bind_method(D_METHOD("poll"), &UsdjRelay::poll);
+    ClassDB::bind_method(D_METHOD("save_document", "document_id"), &UsdjRelay::save_document);
+    ClassDB::bind_method(D_METHOD("stop"), &UsdjRelay::stop);
+}
+
+void UsdjRelay::control(Peer& p_peer, UsdjPacket const& p_packet) {
+    auto const text = String::utf8(reinterpret_cast<char const*>(p_packet.payload), static_cast<int>(p_packet.size));
+    if (m_json_parser->parse(text) != OK)
+        return;
+    auto const message = m_json_parser->get_data();
+    if (message.get_type() != Variant::DICTIONARY)
+        return;
+    Dictionary const request = message;
+    if (request.has("ping")) {
+        Dictionary response{};
+        response["pong"] = request["ping"];
+        p_peer.socket->send_text(m_json_parser->stringify(response, "\t", false));
+    } else if (String{request.get("wa", String{})} == "open") {
+        Dictionary const body = request.get("body", Dictionary{});
+        String const document_id = body.get("strateId", String{});
+        ERR_FAIL_COND_MSG(document_id.is_empty(), "A peer requested a document without an ID.");
+        if (m_documents.find(document_id) == m_documents.end()) {
+            try {
+                m_documents.emplace(document_id, Document{ResultPtr{AMcreate(nullptr), AMresultFree}});
+            } catch (std::invalid_argument const& thrown) {
+                ERR_FAIL_MSG(thrown.what());
+            }
+        }
+        // A peer that doesn't tag its sync messages can only have one
+        // document open at a time.
+        p_peer.multiplex = body.get("multiplex", false);
+        if (!p_peer.multiplex)
+            p_peer.sessions.clear();
+        // Every request for a document starts a new synchronization session.
+        p_peer.sessions.insert_or_assign(
+            document_id, Session{body.get("peerId", String{}), ResultPtr{AMsyncStateInit(), AMresultFree}});
+        m_changed_documents.insert(document_id);
+    }
+}
+
+void UsdjRelay::fan_out(String const& p_document_id) {
+    auto const document = m_documents.find(p_document_id);
+    if (document == m_documents.end())
+        return;
+    auto const document_id = p_document_id.utf8();
+    for (auto& peer : m_peers) {
+        auto const session = peer.sessions.find(p_document_id);
+        if (session == peer.sessions.end())
+            continue;
+        AMsyncState* sync_state = nullptr;
+        ERR_CONTINUE(!AMitemToSyncState(AMresultItem(session->second.sync_state.get()), &sync_state));
+        ResultPtr const generate_result{AMgenerateSyncMessage(document->second, sync_state), AMresultFree};
+        AMsyncMessage const* message = nullptr;
+        if (!AMitemToSyncMessage(AMresultItem(generate_result.get()), &message)) {
+            // The peer is up to date.
+            continue;
+        }
+        ResultPtr const encode_result{AMsyncMessageEncode(message), AMresultFree};
+        AMbyteSpan bytes = {0};
+        ERR_CONTINUE(!AMitemToBytes(AMresultItem(encode_result.get()), &bytes));
+        // Tag the message with its document's ID if the peer tags its own.
+        std::string_view channel{};
+        if (peer.multiplex)
+            channel = std::string_view{document_id.get_data(), static_cast<std::size_t>(document_id.length())};
+        auto const buffer = frame_sync_message(channel, bytes.src, bytes.count);
+        ERR_CONTINUE(buffer.empty());
+        ERR_CONTINUE(peer.socket->put_packet(buffer.data(), buffer.size()) != OK);
+        ++m_messages_sent;
+        m_bytes_sent += buffer.size();
+    }
+}
+
+PackedStringArray UsdjRelay::get_document_ids() const {
+    PackedStringArray result;
+    for (auto const& document : m_documents)
+        result.push_back(document.first);
+    return result;
+}
+
+int UsdjRelay::get_peer_count() const {
+    return static_cast<int>(m_peers.size());
+}
+
+Dictionary UsdjRelay::get_statistics() const {
+    Dictionary result{};
+    result["bytes_received"] = m_bytes_received;
+    result["bytes_sent"] = m_bytes_sent;
+    result["messages_received"] = m_messages_received;
+    result["messages_sent"] = m_messages_sent;
+    return result;
+}
+
+bool UsdjRelay::is_listening() const {
+    return m_server->is_listening();
+}
+
+Error UsdjRelay::listen(int const p_port, String const& p_bind_address) {
+    stop();
+    ERR_FAIL_COND_V_MSG(m_server->listen(p_port, IPAddress{p_bind_address}) != OK, ERR_CANT_CREATE,
+                        vformat("Unable to listen on %s:%d.", p_bind_address, p_port));
+    return OK;
+}
+
+void UsdjRelay::poll() {
+    while (m_server->is_listening() && m_server->is_connection_available()) {
+        auto const connection = m_server->take_connection();
+        if (connection.is_null())
+            break;
+        Peer peer{Ref<WebSocketPeer>(WebSocketPeer::create()), false, {}};
+        ERR_CONTINUE(peer.socket.is_null());
+        Vector<String> protocols;
+        protocols.push_back("binary");
+        peer.socket->set_supported_protocols(protocols);
+        peer.socket->set_max_queued_packets(MAX_QUEUED_PACKETS);
+        peer.socket->set_inbound_buffer_size(BUFFER_SIZE);
+        peer.socket->set_outbound_buffer_size(BUFFER_SIZE);
+        ERR_CONTINUE(peer.socket->accept_stream(connection) != OK);
+        m_peers.push_back(std::move(peer));
+    }
+    for (auto peer = m_peers.begin(); peer != m_peers.end();) {
+        peer->socket->poll();
+        auto const ready_state = peer->socket->get_ready_state();
+        if (ready_state == WebSocketPeer::STATE_CLOSED) {
+            peer = m_peers.erase(peer);
+            continue;
+        }
+        while (ready_state == WebSocketPeer::STATE_OPEN && peer->socket->get_available_packet_count()) {
+            std::uint8_t const* r_buffer = nullptr;
+            int r_buffer_size = 0;
+            if (peer->socket->get_packet(&r_buffer, r_buffer_size) != OK || r_buffer_size <= 0)
+                break;
+            ++m_messages_received;
+            m_bytes_received += r_buffer_size;
+            auto const packet = classify_packet(r_buffer, static_cast<std::size_t>(r_buffer_size),
+                                                peer->socket->was_string_packet());
+            switch (packet.type) {
+                case UsdjPacketType::CONTROL: {
+                    control(*peer, packet);
+                    break;
+                }
+                case UsdjPacketType::SYNC:
+                case UsdjPacketType::TAGGED_SYNC: {
+                    receive(*peer, packet);
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+        ++peer;
+    }
+    // Relay the changes once per poll instead of once per message.
+    for (auto const& document_id : m_changed_documents)
+        fan_out(document_id);
+    m_changed_documents.clear();
+}
+
+void UsdjRelay::receive(Peer& p_peer, UsdjPacket const& p_packet) {
+    auto session = p_peer.sessions.end();
+    if (p_packet.type == UsdjPacketType::TAGGED_SYNC) {
+        session = p_peer.sessions.find(
+            String::utf8(p_packet.channel.data(), static_cast<int>(p_packet.channel.size())));
+    } else if (p_peer.sessions.size() == 1) {
+        // An untagged sync message can only be meant for the sole document.
+        session = p_peer.sessions.begin();
+    }
+    if (session == p_peer.sessions.end())
+        return;
+    auto const document = m_documents.find(session->first);
+    if (document == m_documents.end())
+        return;
+    AMsyncState* sync_state = nullptr;
+    ERR_FAIL_COND(!AMitemToSyncState(AMresultItem(session->second.sync_state.get()), &sync_state));
+    ResultPtr const decode_result{AMsyncMessageDecode(p_packet.payload, p_packet.size), AMresultFree};
+    AMsyncMessage const* message = nullptr;
+    ERR_FAIL_COND(!AMitemToSyncMessage(AMresultItem(decode_result.get()), &message));
+    ResultPtr const receive_result{AMreceiveSyncMessage(document->second, sync_state, message), AMresultFree};
+    ERR_FAIL_COND(AMresultStatus(receive_result.get()) != AM_STATUS_OK);
+    // Even a message without changes must be answered to finish a session.
+    m_changed_documents.insert(session->first);
+}
+
+PackedByteArray UsdjRelay::save_document(String const& p_document_id) const {
+    PackedByteArray result;
+    auto const document = m_documents.find(p_document_id);
+    if (document == m_documents.end())
+        return result;
+    ResultPtr const save_result{AMsave(document->second), AMresultFree};
+    AMbyteSpan bytes = {0};
+    ERR_FAIL_COND_V(!AMitemToBytes(AMresultItem(save_result.get()), &bytes), result);
+    result.resize(static_cast<int>(bytes.count));
+    std::copy(bytes.src, bytes.src + bytes.count, result.ptrw());
+    return result;
+}
+
+void UsdjRelay::stop() {
+    for (auto& peer : m_peers)
+        peer.socket->close();
+    m_peers.clear();
+    m_changed_documents.clear();
+    if (m_server->is_listening())
+        m_server->stop();
+}
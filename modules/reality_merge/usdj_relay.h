@@ -0,0 +1,143 @@
+/**************************************************************************/
+/* usdj_relay.h                                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef REALITY_MERGE_USDJ_RELAY_H
+#define REALITY_MERGE_USDJ_RELAY_H
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <set>
+
+// third-party
+#include <cavi/usdj_am/utils/document.hpp>
+
+// regional
+#include <core/error/error_list.h>
+#include <core/io/json.h>
+#include <core/io/tcp_server.h>
+#include <core/object/ref_counted.h>
+#include <core/string/ustring.h>
+#include <core/variant/dictionary.h>
+#include <modules/websocket/websocket_peer.h>
+
+// local
+#include "usdj_packet.h"
+
+/// \brief A stand-in for a synchronization server that relays the changes to
+///        in-memory Automerge documents between the peers connected to it
+///        over plain WebSockets.
+///
+/// \note It speaks the same protocol as the server so that synchronization
+///       can be exercised and benchmarked without a network, along with the
+///       tagged sync messages that let a peer open several documents over one
+///       connection.
+class UsdjRelay : public RefCounted {
+    GDCLASS(UsdjRelay, RefCounted);
+
+public:
+    UsdjRelay();
+
+    ~UsdjRelay();
+
+    /// \returns The IDs of the documents that peers have opened.
+    PackedStringArray get_document_ids() const;
+
+    /// \returns The number of peers connected.
+    int get_peer_count() const;
+
+    /// \returns The counts of the messages and bytes relayed.
+    Dictionary get_statistics() const;
+
+    /// \returns `true` if the relay is accepting connections.
+    bool is_listening() const;
+
+    /// \brief Starts accepting connections.
+    ///
+    /// \param[in] p_port A TCP port number.
+    /// \param[in] p_bind_address The address to accept connections on.
+    /// \returns `Error::OK` if the relay is listening.
+    Error listen(int const p_port, String const& p_bind_address = "127.0.0.1");
+
+    /// \brief Accepts connections, receives messages and relays the changes
+    ///        within them without blocking.
+    void poll();
+
+    /// \param[in] p_document_id The ID of a document that a peer opened.
+    /// \returns The document saved into an array of bytes or an empty array
+    ///          if the document doesn't exist.
+    PackedByteArray save_document(String const& p_document_id) const;
+
+    /// \brief Disconnects the peers and stops accepting connections.
+    ///
+    /// \note The documents are retained.
+    void stop();
+
+protected:
+    static void _bind_methods();
+
+private:
+    using Document = cavi::usdj_am::utils::Document;
+    using ResultPtr = Document::ResultPtr;
+
+    /// \brief A peer's synchronization session for a document.
+    struct Session {
+        String peer_id;
+        ResultPtr sync_state;
+    };
+
+    struct Peer {
+        Ref<WebSocketPeer> socket;
+        /// Whether the peer tags its sync messages with the IDs of their
+        /// documents so that it can open several of them.
+        bool multiplex;
+        std::map<String, Session> sessions;
+    };
+
+    using Peers = std::list<Peer>;
+
+    void control(Peer& p_peer, UsdjPacket const& p_packet);
+
+    /// \brief Sends each peer of a document the changes it's missing.
+    void fan_out(String const& p_document_id);
+
+    void receive(Peer& p_peer, UsdjPacket const& p_packet);
+
+    std::uint64_t m_bytes_received;
+    std::uint64_t m_bytes_sent;
+    std::set<String> m_changed_documents;
+    std::map<String, Document> m_documents;
+    Ref<JSON> m_json_parser;
+    std::uint64_t m_messages_received;
+    std::uint64_t m_messages_sent;
+    Peers m_peers;
+    Ref<TCPServer> m_server;
+};
+
+#endif  // REALITY_MERGE_USDJ_RELAY_H
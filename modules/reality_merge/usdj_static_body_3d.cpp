@@ -30,11 +30,12 @@
 #include <sstream>
 #include <stdexcept>
 #include <typeinfo>
+#include <utility>
 
 // third-party
 #include <cavi/usdj_am/definition.hpp>
 #include <cavi/usdj_am/definition_type.hpp>
-#include <cavi/usdj_am/usd/physics/token_type.hpp>
+#include <cavi/usdj_am/usd/geom/token_type.hpp>
 
 // regional
 #include <core/core_string_names.h>
@@ -46,12 +47,9 @@
 #include <scene/resources/primitive_meshes.h>
 
 // local
-#include "usdj_box_size_extractor.h"
-#include "usdj_color_extractor.h"
 #include "usdj_geometry_extractor.h"
+#include "usdj_prim_attributes_extractor.h"
 #include "usdj_static_body_3d.h"
-#include "usdj_transform_3d_extractor.h"
-#include "usdj_velocity_extractor.h"
 
 void UsdjStaticBody3D::set_physics_material_override(const Ref<PhysicsMaterial>& p_physics_material_override) {
     if (physics_material_override.is_valid()) {
@@ -78,41 +76,39 @@ Ref<PhysicsMaterial> UsdjStaticBody3D::get_physics_material_override() const {
 }
 
 void UsdjStaticBody3D::set_constant_linear_velocity(const Vector3& p_vel) {
-    // constant_linear_velocity = p_vel;
-
-    // PhysicsServer3D::get_singleton()->body_set_state(get_rid(), PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY,
-    //                                                  constant_linear_velocity);
-    std::ostringstream msg;
-    msg << typeid(*this).name() << "::" << __func__ << "(...) not implemented";
-    WARN_PRINT(msg.str().c_str());
+    m_attributes.velocity = p_vel;
+    if (m_definition) {
+        m_edited_linear_velocity = true;
+        emit_signal(SNAME("edited"));
+    }
 }
 
 void UsdjStaticBody3D::set_constant_angular_velocity(const Vector3& p_vel) {
-    // constant_angular_velocity = p_vel;
-
-    // PhysicsServer3D::get_singleton()->body_set_state(get_rid(), PhysicsServer3D::BODY_STATE_ANGULAR_VELOCITY,
-    //                                                  constant_angular_velocity);
-    std::ostringstream msg;
-    msg << typeid(*this).name() << "::" << __func__ << "(...) not implemented";
-    WARN_PRINT(msg.str().c_str());
+    m_attributes.angular_velocity = p_vel;
+    if (m_definition) {
+        m_edited_angular_velocity = true;
+        emit_signal(SNAME("edited"));
+    }
 }
 
 Vector3 UsdjStaticBody3D::get_constant_linear_velocity() const {
-    using cavi::usdj_am::usd::physics::TokenType;
-
-    static auto const DEFAULT = Vector3{};
-
-    return (m_definition) ? UsdjVelocityExtractor{*m_definition}(TokenType::PHYSICS_VELOCITY).value_or(DEFAULT)
-                          : DEFAULT;
+    return m_attributes.velocity.value_or(Vector3{});
 }
 
 Vector3 UsdjStaticBody3D::get_constant_angular_velocity() const {
-    using cavi::usdj_am::usd::physics::TokenType;
+    return m_attributes.angular_velocity.value_or(Vector3{});
+}
 
-    static auto const DEFAULT = Vector3{};
+bool UsdjStaticBody3D::get_collision_enabled() const {
+    return m_attributes.collision_enabled.value_or(true);
+}
 
-    return (m_definition) ? UsdjVelocityExtractor{*m_definition}(TokenType::PHYSICS_ANGULAR_VELOCITY).value_or(DEFAULT)
-                          : DEFAULT;
+real_t UsdjStaticBody3D::get_density() const {
+    return m_attributes.density.value_or(0.0);
+}
+
+real_t UsdjStaticBody3D::get_mass() const {
+    return m_attributes.mass.value_or(0.0);
 }
 
 void UsdjStaticBody3D::_bind_methods() {
@@ -122,11 +118,19 @@ void UsdjStaticBody3D::_bind_methods() {
                          &UsdjStaticBody3D::set_constant_angular_velocity);
     ClassDB::bind_method(D_METHOD("get_constant_linear_velocity"), &UsdjStaticBody3D::get_constant_linear_velocity);
     ClassDB::bind_method(D_METHOD("get_constant_angular_velocity"), &UsdjStaticBody3D::get_constant_angular_velocity);
+    ClassDB::bind_method(D_METHOD("get_collision_enabled"), &UsdjStaticBody3D::get_collision_enabled);
+    ClassDB::bind_method(D_METHOD("get_density"), &UsdjStaticBody3D::get_density);
+    ClassDB::bind_method(D_METHOD("get_mass"), &UsdjStaticBody3D::get_mass);
 
     ClassDB::bind_method(D_METHOD("set_physics_material_override", "physics_material_override"),
                          &UsdjStaticBody3D::set_physics_material_override);
     ClassDB::bind_method(D_METHOD("get_physics_material_override"), &UsdjStaticBody3D::get_physics_material_override);
     ClassDB::bind_method(D_METHOD("revise"), &UsdjStaticBody3D::revise);
+    ClassDB::bind_method(D_METHOD("set_display_color", "color"), &UsdjStaticBody3D::set_display_color);
+    ClassDB::bind_method(D_METHOD("get_display_color"), &UsdjStaticBody3D::get_display_color);
+
+    ADD_SIGNAL(MethodInfo("edited"));
+    ADD_SIGNAL(MethodInfo("instance_changed"));
 
     ADD_PROPERTY(
         PropertyInfo(Variant::OBJECT, "physics_material_override", PROPERTY_HINT_RESOURCE_TYPE, "PhysicsMaterial"),
@@ -136,13 +140,67 @@ void UsdjStaticBody3D::_bind_methods() {
     ADD_PROPERTY(
         PropertyInfo(Variant::VECTOR3, "constant_angular_velocity", PROPERTY_HINT_NONE, U"radians,suffix:\u00B0/s"),
         "set_constant_angular_velocity", "get_constant_angular_velocity");
+    ADD_PROPERTY(PropertyInfo(Variant::COLOR, "display_color", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_EDITOR),
+                 "set_display_color", "get_display_color");
 }
 
-UsdjStaticBody3D::UsdjStaticBody3D(PhysicsServer3D::BodyMode p_mode) : PhysicsBody3D(p_mode) {}
+void UsdjStaticBody3D::_notification(int p_what) {
+    switch (p_what) {
+        case NOTIFICATION_LOCAL_TRANSFORM_CHANGED: {
+            // Only a transform that didn't come from the "USDA_Definition"
+            // must be written back into it.
+            if (!m_revising && m_definition) {
+                m_edited_transform = true;
+                emit_signal(SNAME("edited"));
+            }
+            break;
+        }
+        case NOTIFICATION_TRANSFORM_CHANGED: {
+            // The transforms of the body's ancestors move its instance too.
+            if (m_instanced)
+                emit_signal(SNAME("instance_changed"));
+            break;
+        }
+    }
+}
+
+UsdjStaticBody3D::UsdjStaticBody3D(PhysicsServer3D::BodyMode p_mode)
+    : PhysicsBody3D(p_mode),
+      m_acknowledged_generation{0},
+      m_display_color{1.0, 1.0, 1.0},
+      m_edit_generation{0},
+      m_edited_angular_velocity{false},
+      m_edited_display_color{false},
+      m_edited_linear_velocity{false},
+      m_edited_transform{false},
+      m_instanced{false},
+      m_prim_attributes{},
+      m_prim_top_level{false},
+      m_prim_transform{},
+      m_revising{false},
+      m_stale{false} {}
 
-UsdjStaticBody3D::UsdjStaticBody3D(cavi::usdj_am::Definition&& p_definition, PhysicsServer3D::BodyMode p_mode)
-    : PhysicsBody3D(p_mode), m_definition{std::move(p_definition)} {
+UsdjStaticBody3D::UsdjStaticBody3D(cavi::usdj_am::Definition&& p_definition,
+                                   bool const p_instanced,
+                                   PhysicsServer3D::BodyMode p_mode)
+    : PhysicsBody3D(p_mode),
+      m_acknowledged_generation{0},
+      m_definition{std::move(p_definition)},
+      m_display_color{1.0, 1.0, 1.0},
+      m_edit_generation{0},
+      m_edited_angular_velocity{false},
+      m_edited_display_color{false},
+      m_edited_linear_velocity{false},
+      m_edited_transform{false},
+      m_instanced{p_instanced},
+      m_prim_attributes{},
+      m_prim_top_level{false},
+      m_prim_transform{},
+      m_revising{false},
+      m_stale{false} {
     using cavi::usdj_am::DefinitionType;
+    using cavi::usdj_am::usd::geom::extract_TokenType;
+    using cavi::usdj_am::usd::geom::TokenType;
 
     std::ostringstream args;
     auto const sub_type = m_definition->get_sub_type();
@@ -150,18 +208,27 @@ UsdjStaticBody3D::UsdjStaticBody3D(cavi::usdj_am::Definition&& p_definition, Phy
         args << "p_definition.get_sub_type() == " << sub_type << ", ...";
     } else {
         auto geometry = UsdjGeometryExtractor{*m_definition}();
-        if (geometry.first.is_null()) {
+        // A group of other prims only contributes its transform to theirs.
+        auto const def_type = m_definition->get_def_type();
+        auto const is_xform = def_type && extract_TokenType(*def_type).value_or(TokenType{}) == TokenType::XFORM;
+        if (geometry.first.is_null() && !is_xform) {
             args << "p_definition: no mesh found, ...";
         } else {
-            auto mesh_instance_3d = memnew(MeshInstance3D);
-            mesh_instance_3d->set_mesh(geometry.first);
-            call_deferred(SNAME("add_child"), mesh_instance_3d);
+            if (m_instanced) {
+                m_instance_mesh = geometry.first;
+                set_notify_transform(true);
+            } else if (!geometry.first.is_null()) {
+                auto mesh_instance_3d = memnew(MeshInstance3D);
+                mesh_instance_3d->set_mesh(geometry.first);
+                call_deferred(SNAME("add_child"), mesh_instance_3d);
+            }
             if (!geometry.second.is_null()) {
                 auto collision_shape_3d = memnew(CollisionShape3D);
                 collision_shape_3d->set_shape(geometry.second);
                 call_deferred(SNAME("add_child"), collision_shape_3d);
             }
             call_deferred(SNAME("revise"));
+            set_notify_local_transform(true);
         }
     }
     if (!args.str().empty()) {
@@ -171,6 +238,11 @@ UsdjStaticBody3D::UsdjStaticBody3D(cavi::usdj_am::Definition&& p_definition, Phy
     }
 }
 
+UsdjStaticBody3D::~UsdjStaticBody3D() {
+    if (m_material_key)
+        UsdjMaterialCache::release(*m_material_key);
+}
+
 void UsdjStaticBody3D::_reload_physics_characteristics() {
     if (physics_material_override.is_null()) {
         PhysicsServer3D::get_singleton()->body_set_param(get_rid(), PhysicsServer3D::BODY_PARAM_BOUNCE, 0);
@@ -183,27 +255,130 @@ void UsdjStaticBody3D::_reload_physics_characteristics() {
     }
 }
 
+void UsdjStaticBody3D::acknowledge_edits(std::uint64_t const p_generation) {
+    m_acknowledged_generation = p_generation;
+}
+
+void UsdjStaticBody3D::apply_display_color(Color const& p_color) {
+    // Bodies with the same appearance share a material instead of changing
+    // their own.
+    auto const material_key = UsdjMaterialCache::Key{p_color};
+    if (!m_instanced && m_material_key != material_key) {
+        auto const material = UsdjMaterialCache::acquire(material_key);
+        if (m_material_key)
+            UsdjMaterialCache::release(*m_material_key);
+        m_material_key = material_key;
+        // The display color is constant across the prim so every surface of
+        // its mesh shares the material.
+        auto const mesh_instance_3ds = find_children("*", "MeshInstance3D", false, false);
+        for (int pos = 0; pos != mesh_instance_3ds.size(); ++pos) {
+            if (MeshInstance3D* const mesh_instance_3d = Object::cast_to<MeshInstance3D>(mesh_instance_3ds[pos])) {
+                auto const surface_count = mesh_instance_3d->get_surface_override_material_count();
+                for (int surface = 0; surface != surface_count; ++surface)
+                    mesh_instance_3d->set_surface_override_material(surface, material);
+            }
+        }
+    }
+    if (m_instanced)
+        emit_signal(SNAME("instance_changed"));
+}
+
+Color UsdjStaticBody3D::get_display_color() const {
+    return m_display_color;
+}
+
+std::optional<cavi::usdj_am::usd::geom::TokenType> UsdjStaticBody3D::get_geom_type() const {
+    return (m_instance_mesh.is_null()) ? std::nullopt : m_attributes.geom_type;
+}
+
+Ref<Mesh> UsdjStaticBody3D::get_instance_mesh() const {
+    return m_instance_mesh;
+}
+
+Transform3D UsdjStaticBody3D::get_instance_transform() const {
+    auto const& size = m_attributes.size;
+    return (size) ? get_global_transform() * Transform3D{Basis::from_scale(*size)} : get_global_transform();
+}
+
 AMobjId const* UsdjStaticBody3D::get_object_id() const {
     return (m_definition) ? m_definition->get_object_id() : nullptr;
 }
 
+bool UsdjStaticBody3D::is_edited() const {
+    return m_edited_angular_velocity || m_edited_display_color || m_edited_linear_velocity || m_edited_transform ||
+           m_edit_generation > m_acknowledged_generation;
+}
+
+bool UsdjStaticBody3D::is_instanced() const {
+    return m_instanced;
+}
+
+bool UsdjStaticBody3D::is_stale() const {
+    return m_stale;
+}
+
+void UsdjStaticBody3D::set_display_color(Color const& p_color) {
+    m_display_color = p_color;
+    apply_display_color(m_display_color);
+    if (m_definition) {
+        m_edited_display_color = true;
+        emit_signal(SNAME("edited"));
+    }
+}
+
+void UsdjStaticBody3D::set_definition(cavi::usdj_am::Definition&& p_definition) {
+    m_definition.emplace(std::move(p_definition));
+}
+
+void UsdjStaticBody3D::set_prim_attributes(UsdjPrimAttributes&& p_attributes) {
+    m_prim_attributes.emplace(std::move(p_attributes));
+}
+
+void UsdjStaticBody3D::set_prim_transform(Transform3D const& p_transform, bool const p_top_level) {
+    m_prim_top_level = p_top_level;
+    m_prim_transform = p_transform;
+}
+
 void UsdjStaticBody3D::revise() {
+    if (!m_definition)
+        return;
     std::string_view const name_view = m_definition->get_name();
     auto const name = String{name_view.data(), static_cast<int>(name_view.size())};
     set_name(name);
-    /// \todo Replace all three of these extractors with one in order to get
-    ///       their respective values in a single pass.
-    auto const box_size = UsdjBoxSizeExtractor{*m_definition}();
-    /// \todo Handle multiple surface materials.
-    auto const color = UsdjColorExtractor{*m_definition}();
-    auto const transform_3d = UsdjTransform3dExtractor{*m_definition}();
+    // The body is only revised when its prim changes.
+    auto const velocity = m_attributes.velocity;
+    auto const angular_velocity = m_attributes.angular_velocity;
+    if (m_prim_attributes) {
+        m_attributes = std::move(*m_prim_attributes);
+        m_prim_attributes.reset();
+    } else {
+        m_attributes = UsdjPrimAttributesExtractor{*m_definition}();
+    }
+    auto const& box_size = m_attributes.size;
+    // Local edits supersede the "USDA_Definition" until it reflects them.
+    m_stale = is_edited();
+    if (!m_stale) {
+        if (auto const color = m_attributes.get_display_color())
+            m_display_color = *color;
+        apply_display_color(m_display_color);
+        // The body stays where it is when its prim's transform couldn't be
+        // evaluated, e.g. because the scene couldn't be compiled.
+        if (m_prim_transform) {
+            m_revising = true;
+            set_as_top_level(m_prim_top_level);
+            set_transform(*m_prim_transform);
+            m_revising = false;
+        }
+    } else {
+        m_attributes.velocity = velocity;
+        m_attributes.angular_velocity = angular_velocity;
+    }
+    m_prim_transform.reset();
     auto const node_3ds = find_children("*", "Node3D", false, false);
     for (int pos = 0; pos != node_3ds.size(); ++pos) {
         if (Node3D* const node_3d = Object::cast_to<Node3D>(node_3ds[pos])) {
-            if (transform_3d) {
-                node_3d->set_transform(*transform_3d);
-            }
             if (CollisionShape3D* const collision_shape_3d = Object::cast_to<CollisionShape3D>(node_3d)) {
+                collision_shape_3d->set_disabled(!get_collision_enabled());
                 if (box_size)
                     if (BoxShape3D* const box_shape_3d =
                             Object::cast_to<BoxShape3D>(collision_shape_3d->get_shape().ptr()))
@@ -213,11 +388,31 @@ void UsdjStaticBody3D::revise() {
                 if (box_size)
                     if (BoxMesh* const box_mesh = Object::cast_to<BoxMesh>(mesh_instance_3d->get_mesh().ptr()))
                         box_mesh->set_size(*box_size);
-                if (color)
-                    if (BaseMaterial3D* const base_material_3d = Object::cast_to<BaseMaterial3D>(
-                            mesh_instance_3d->get_mesh()->surface_get_material(0).ptr()))
-                        base_material_3d->set_albedo(*color);
             }
         }
     }
+    // The size may have changed along with the prim.
+    if (m_instanced)
+        emit_signal(SNAME("instance_changed"));
+}
+
+std::optional<UsdjEdit> UsdjStaticBody3D::take_edit(std::uint64_t const p_generation) {
+    if (!(m_definition &&
+          (m_edited_angular_velocity || m_edited_display_color || m_edited_linear_velocity || m_edited_transform)))
+        return std::nullopt;
+    UsdjEdit edit{UsdjObjectKey{m_definition->get_object_id()}, std::nullopt, std::nullopt, std::nullopt, std::nullopt};
+    if (m_edited_display_color)
+        edit.display_color.emplace(m_display_color);
+    if (m_edited_transform)
+        edit.transform.emplace(get_transform());
+    if (m_edited_linear_velocity)
+        edit.velocity.emplace(get_constant_linear_velocity());
+    if (m_edited_angular_velocity)
+        edit.angular_velocity.emplace(get_constant_angular_velocity());
+    m_edited_angular_velocity = false;
+    m_edited_display_color = false;
+    m_edited_linear_velocity = false;
+    m_edited_transform = false;
+    m_edit_generation = p_generation;
+    return edit;
 }
@@ -30,60 +30,193 @@
 #ifndef REALITY_MERGE_USDJ_STATIC_BODY_3D_H
 #define REALITY_MERGE_USDJ_STATIC_BODY_3D_H
 
+#include <cstdint>
 #include <optional>
 
 // third-party
 #include <cavi/usdj_am/definition.hpp>
+#include <cavi/usdj_am/usd/geom/token_type.hpp>
 
 // regional
+#include <core/math/transform_3d.h>
+#include <core/object/ref_counted.h>
 #include <scene/3d/physics_body_3d.h>
+#include <scene/resources/mesh.h>
 #include <scene/resources/physics_material.h>
 #include <servers/physics_server_3d.h>
 
+// local
+#include "usdj_editor.h"
+#include "usdj_material_cache.h"
+#include "usdj_prim_attributes_extractor.h"
+
 struct AMobjId;
 
 class UsdjStaticBody3D : public PhysicsBody3D {
     GDCLASS(UsdjStaticBody3D, PhysicsBody3D);
 
 private:
-    // Vector3 constant_linear_velocity;
-    // Vector3 constant_angular_velocity;
-
     Ref<PhysicsMaterial> physics_material_override;
 
 protected:
     static void _bind_methods();
 
+    void _notification(int p_what);
+
 public:
     void set_physics_material_override(const Ref<PhysicsMaterial>& p_physics_material_override);
     Ref<PhysicsMaterial> get_physics_material_override() const;
 
+    /// \param[in] p_vel A "physics:velocity" that must be written back into
+    ///                  the "USDA_Definition".
     void set_constant_linear_velocity(const Vector3& p_vel);
+
+    /// \param[in] p_vel A "physics:angularVelocity" in the units of the
+    ///                  "USDA_Definition" that must be written back into it.
     void set_constant_angular_velocity(const Vector3& p_vel);
 
+    /// \returns The "physics:velocity" attribute of the prim or zero if it
+    ///          isn't authored.
     Vector3 get_constant_linear_velocity() const;
+
+    /// \returns The "physics:angularVelocity" attribute of the prim or zero
+    ///          if it isn't authored.
     Vector3 get_constant_angular_velocity() const;
 
+    /// \returns The "physics:collisionEnabled" attribute of the prim, which
+    ///          is `true` by default.
+    bool get_collision_enabled() const;
+
+    /// \returns The "physics:density" attribute of the prim or zero if it
+    ///          isn't authored.
+    real_t get_density() const;
+
+    /// \returns The "physics:mass" attribute of the prim or zero if it isn't
+    ///          authored.
+    real_t get_mass() const;
+
     UsdjStaticBody3D(PhysicsServer3D::BodyMode p_mode = PhysicsServer3D::BODY_MODE_STATIC);
 
+    /// \param[in] p_definition A "USDA_Definition" node.
+    /// \param[in] p_instanced A toggle for leaving the drawing of the body's
+    ///                        mesh to a `UsdjMultiMeshInstancer` instead of
+    ///                        a `MeshInstance3D` of its own.
+    /// \param[in] p_mode A physics body mode.
     /// \throws std::invalid_argument
     UsdjStaticBody3D(cavi::usdj_am::Definition&& p_definition,
+                     bool const p_instanced = false,
                      PhysicsServer3D::BodyMode p_mode = PhysicsServer3D::BODY_MODE_STATIC);
 
     UsdjStaticBody3D(UsdjStaticBody3D const&) = delete;
 
     UsdjStaticBody3D(UsdjStaticBody3D&&) = default;
 
+    ~UsdjStaticBody3D();
+
     UsdjStaticBody3D& operator=(UsdjStaticBody3D&&) = default;
 
+    /// \brief Stops local edits up to a batch from superseding the revisions
+    ///        of the "USDA_Definition" that are made after it.
+    ///
+    /// \param[in] p_generation The generation of the most recent batch of
+    ///                         edits that's reflected by the
+    ///                         "USDA_Definition".
+    void acknowledge_edits(std::uint64_t const p_generation);
+
+    /// \returns The color displayed on the body's surfaces.
+    Color get_display_color() const;
+
+    /// \returns The type of gprim that the body's mesh was extracted from,
+    ///          which identifies the source of its geometry, if any.
+    std::optional<cavi::usdj_am::usd::geom::TokenType> get_geom_type() const;
+
+    /// \returns The mesh to draw for the body if it's instanced.
+    Ref<Mesh> get_instance_mesh() const;
+
+    /// \returns The global transform of the body's mesh if it's instanced,
+    ///          which is scaled by its prim's size because the mesh is
+    ///          shared with other bodies.
+    Transform3D get_instance_transform() const;
+
     AMobjId const* get_object_id() const;
 
+    /// \returns `true` if the body has local edits that the
+    ///          "USDA_Definition" doesn't reflect yet.
+    bool is_edited() const;
+
+    /// \returns `true` if the body's mesh is drawn by a
+    ///          `UsdjMultiMeshInstancer`.
+    bool is_instanced() const;
+
+    /// \returns `true` if the last revision skipped the body's color,
+    ///          transform and velocities because of its local edits so it
+    ///          must be revised again once they're acknowledged.
+    bool is_stale() const;
+
+    /// \param[in] p_color A color to display on the body's surfaces that must
+    ///                    be written back into the "USDA_Definition".
+    void set_display_color(Color const& p_color);
+
+    /// \brief Rebinds the body to a newer revision of its "USDA_Definition".
+    ///
+    /// \param[in] p_definition A "USDA_Definition" node with the same object
+    ///                         ID as the current one.
+    void set_definition(cavi::usdj_am::Definition&& p_definition);
+
+    /// \param[in] p_transform The transform of the body's prim that was
+    ///                        evaluated from the "USDA_Definition" along with
+    ///                        those of all other prims, which is applied by
+    ///                        the next revision only.
+    /// \param[in] p_top_level Whether \p p_transform is a global transform
+    ///                        because the prim resets the transform stack.
+    /// \note A top-level body ignores the transforms of all of its ancestors
+    ///       so the mediator composes \p p_transform with its parent's global
+    ///       transform beforehand.
+    void set_prim_transform(Transform3D const& p_transform, bool const p_top_level = false);
+
+    /// \param[in] p_attributes The attributes of the body's prim that were
+    ///                         extracted from a compiled scene, which the
+    ///                         next revision uses instead of extracting them
+    ///                         from the "USDA_Definition" again.
+    void set_prim_attributes(UsdjPrimAttributes&& p_attributes);
+
     /// \brief Update properties extracted from the "USDA_Definition" that had
     ///        to be cached.
     void revise();
 
+    /// \brief Takes the edits that were made to the body locally since the
+    ///        previous call.
+    ///
+    /// \param[in] p_generation The generation of the batch of edits that the
+    ///                         result will belong to.
+    /// \returns The edits to write into the "USDA_Definition" or
+    ///          `std::nullopt`.
+    std::optional<UsdjEdit> take_edit(std::uint64_t const p_generation);
+
 private:
+    void apply_display_color(Color const& p_color);
+
+    std::uint64_t m_acknowledged_generation;
+    /// \note The attributes are extracted once per revision of the
+    ///       "USDA_Definition" that changes it so that reading them is O(1).
+    UsdjPrimAttributes m_attributes;
     std::optional<cavi::usdj_am::Definition> m_definition;
+    Color m_display_color;
+    std::uint64_t m_edit_generation;
+    bool m_edited_angular_velocity;
+    bool m_edited_display_color;
+    bool m_edited_linear_velocity;
+    bool m_edited_transform;
+    Ref<Mesh> m_instance_mesh;
+    bool m_instanced;
+    /// \note The key of the material shared with the other bodies that have
+    ///       the same appearance.
+    std::optional<UsdjMaterialCache::Key> m_material_key;
+    std::optional<UsdjPrimAttributes> m_prim_attributes;
+    bool m_prim_top_level;
+    std::optional<Transform3D> m_prim_transform;
+    bool m_revising;
+    bool m_stale;
 
     void _reload_physics_characteristics();
 };
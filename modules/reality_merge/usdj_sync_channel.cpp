@@ -0,0 +1,234 @@
+/**************************************************************************/
+/* usdj_sync_channel.cpp                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+// third-party
+extern "C" {
+
+#include <automerge-c/automerge.h>
+}
+
+// regional
+#include <core/error/error_macros.h>
+
+// local
+#include "usdj_sync_channel.h"
+
+namespace {
+
+static std::chrono::seconds const KEEPALIVE_INTERVAL{5};
+
+static std::chrono::seconds const KEEPALIVE_TIMEOUT{15};
+
+}  // namespace
+
+UsdjSyncChannel::UsdjSyncChannel(Document const& p_document,
+                                 String const& p_document_id,
+                                 String const& p_peer_id,
+                                 std::vector<std::uint8_t> const& p_sync_state)
+    : m_budget{0},
+      m_document_id{p_document_id},
+      m_edit_count{0},
+      m_keepalive_interval{UsdjHeartbeat::Duration{KEEPALIVE_INTERVAL}.count()},
+      m_keepalive_timeout{UsdjHeartbeat::Duration{KEEPALIVE_TIMEOUT}.count()},
+      m_open{false},
+      m_peer_id{p_peer_id},
+      m_published_edit_count{0},
+      m_replica{ResultPtr{AMfork(p_document, nullptr), AMresultFree}},
+      m_replying{false},
+      m_sync_state{AMsyncStateInit(), AMresultFree},
+      m_syncing{false},
+      m_unpublished{false} {
+    if (!p_sync_state.empty()) {
+        ResultPtr decode_result{AMsyncStateDecode(p_sync_state.data(), p_sync_state.size()), AMresultFree};
+        AMsyncState* sync_state = nullptr;
+        if (!AMitemToSyncState(AMresultItem(decode_result.get()), &sync_state)) {
+            WARN_PRINT("Discarding an undecodable synchronization state.");
+        } else {
+            // A synchronization state claiming changes that the replica lacks
+            // would stop the server from ever sending them.
+            bool consistent = true;
+            auto shared_heads = AMsyncStateSharedHeads(sync_state);
+            while (AMitem* const head = AMitemsNext(&shared_heads, 1)) {
+                AMbyteSpan hash = {0};
+                ResultPtr const change_result{
+                    (AMitemToChangeHash(head, &hash)) ? AMgetChangeByHash(m_replica, hash.src, hash.count) : nullptr,
+                    AMresultFree};
+                if (!change_result || AMitemValType(AMresultItem(change_result.get())) != AM_VAL_TYPE_CHANGE) {
+                    consistent = false;
+                    break;
+                }
+            }
+            if (consistent)
+                m_sync_state = std::move(decode_result);
+            else
+                WARN_PRINT("Discarding a synchronization state that doesn't match the document.");
+        }
+    }
+}
+
+UsdjSyncChannel::~UsdjSyncChannel() {}
+
+bool UsdjSyncChannel::apply_edits() {
+    bool result = false;
+    while (auto edits = m_edits.pop()) {
+        // Each batch becomes a single change so that the history and the
+        // sync messages don't grow with the number of edits per frame.
+        if (UsdjEditor{m_replica}(**edits))
+            result = true;
+        ++m_edit_count;
+    }
+    if (result) {
+        // Send the new change to the server at the next opportunity.
+        m_replying = true;
+    }
+    return result;
+}
+
+void UsdjSyncChannel::close() {
+    m_open = false;
+}
+
+std::vector<std::uint8_t> UsdjSyncChannel::encode_replica() const {
+    ResultPtr const save_result{AMsave(m_replica), AMresultFree};
+    AMbyteSpan bytes = {0};
+    ERR_FAIL_COND_V(!AMitemToBytes(AMresultItem(save_result.get()), &bytes), {});
+    return std::vector<std::uint8_t>(bytes.src, bytes.src + bytes.count);
+}
+
+std::vector<std::uint8_t> UsdjSyncChannel::encode_sync_state() const {
+    AMsyncState* sync_state = nullptr;
+    ERR_FAIL_COND_V(!AMitemToSyncState(AMresultItem(m_sync_state.get()), &sync_state), {});
+    ResultPtr const encode_result{AMsyncStateEncode(sync_state), AMresultFree};
+    AMbyteSpan bytes = {0};
+    ERR_FAIL_COND_V(!AMitemToBytes(AMresultItem(encode_result.get()), &bytes), {});
+    return std::vector<std::uint8_t>(bytes.src, bytes.src + bytes.count);
+}
+
+UsdjSyncChannel::Snapshot UsdjSyncChannel::fork_replica() const {
+    return Snapshot{Document{ResultPtr{AMfork(m_replica, nullptr), AMresultFree}}, m_edit_count};
+}
+
+void UsdjSyncChannel::open() {
+    // A new request starts a new synchronization session.
+    reset_sync_state();
+    m_open = true;
+    m_replying = false;
+    m_syncing = true;
+}
+
+void UsdjSyncChannel::publish(bool const p_backlogged) {
+    // A snapshot acknowledges the edits within it even if they didn't change
+    // anything.
+    m_unpublished = m_unpublished || m_edit_count != m_published_edit_count;
+    if (!m_unpublished || p_backlogged)
+        return;
+    // The consumer may not have caught up yet so a snapshot that doesn't fit
+    // is coalesced into the next one, as are the changes of a burst that
+    // hasn't been applied completely yet.
+    if (m_snapshots.full())
+        return;
+    try {
+        m_snapshots.push(std::make_unique<Snapshot>(fork_replica()));
+    } catch (std::invalid_argument const& thrown) {
+        // Don't retry a snapshot that can't be taken.
+        ERR_PRINT(thrown.what());
+    }
+    m_unpublished = false;
+    m_published_edit_count = m_edit_count;
+}
+
+bool UsdjSyncChannel::push_edits(std::unique_ptr<UsdjEdits>&& p_edits) {
+    return m_edits.push(std::move(p_edits));
+}
+
+bool UsdjSyncChannel::receive(std::uint8_t const* const p_message, std::size_t const p_size) {
+    AMsyncState* client_state = nullptr;
+    ERR_FAIL_COND_V(!AMitemToSyncState(AMresultItem(m_sync_state.get()), &client_state), false);
+    // Decode the sync message straight out of the socket's buffer.
+    ResultPtr const decode_result{AMsyncMessageDecode(p_message, p_size), AMresultFree};
+    AMsyncMessage const* server_message = nullptr;
+    if (!AMitemToSyncMessage(AMresultItem(decode_result.get()), &server_message))
+        return false;
+    ResultPtr const receive_result{AMreceiveSyncMessage(m_replica, client_state, server_message), AMresultFree};
+    ERR_FAIL_COND_V(AMresultStatus(receive_result.get()) != AM_STATUS_OK, false);
+    m_replying = true;
+    m_unpublished = true;
+    return true;
+}
+
+std::vector<std::uint8_t> UsdjSyncChannel::reply(bool const p_backlogged) {
+    std::vector<std::uint8_t> result{};
+    if (!((m_replying && !p_backlogged) || m_syncing))
+        return result;
+    m_replying = false;
+    AMsyncState* client_state = nullptr;
+    ERR_FAIL_COND_V(!AMitemToSyncState(AMresultItem(m_sync_state.get()), &client_state), result);
+    ResultPtr const generate_result{AMgenerateSyncMessage(m_replica, client_state), AMresultFree};
+    AMsyncMessage const* client_message = nullptr;
+    if (AMitemToSyncMessage(AMresultItem(generate_result.get()), &client_message)) {
+        ResultPtr const encode_result{AMsyncMessageEncode(client_message), AMresultFree};
+        AMbyteSpan client_message_bytes = {0};
+        ERR_FAIL_COND_V(!AMitemToBytes(AMresultItem(encode_result.get()), &client_message_bytes), result);
+        result.assign(client_message_bytes.src, client_message_bytes.src + client_message_bytes.count);
+        m_syncing = false;
+    }
+    return result;
+}
+
+void UsdjSyncChannel::reset_sync_state() {
+    // Only the encoded parts of a synchronization state outlive a connection.
+    auto const bytes = encode_sync_state();
+    ERR_FAIL_COND(bytes.empty());
+    ResultPtr decode_result{AMsyncStateDecode(bytes.data(), bytes.size()), AMresultFree};
+    ERR_FAIL_COND(AMresultStatus(decode_result.get()) != AM_STATUS_OK);
+    m_sync_state = std::move(decode_result);
+}
+
+void UsdjSyncChannel::set_budget(UsdjHeartbeat::Duration const p_budget) {
+    m_budget.store(p_budget.count(), std::memory_order_relaxed);
+}
+
+void UsdjSyncChannel::set_keepalive(UsdjHeartbeat::Duration const p_interval, UsdjHeartbeat::Duration const p_timeout) {
+    m_keepalive_interval.store(p_interval.count(), std::memory_order_relaxed);
+    m_keepalive_timeout.store(p_timeout.count(), std::memory_order_relaxed);
+}
+
+std::optional<UsdjSyncChannel::Snapshot> UsdjSyncChannel::take_snapshot() {
+    std::unique_ptr<Snapshot> latest{};
+    // Only the most recent snapshot is worth presenting.
+    while (auto snapshot = m_snapshots.pop())
+        latest = std::move(*snapshot);
+    if (latest)
+        return std::move(*latest);
+    return std::nullopt;
+}
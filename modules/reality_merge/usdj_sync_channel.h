@@ -0,0 +1,267 @@
+/**************************************************************************/
+/* usdj_sync_channel.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef REALITY_MERGE_USDJ_SYNC_CHANNEL_H
+#define REALITY_MERGE_USDJ_SYNC_CHANNEL_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+// third-party
+#include <cavi/usdj_am/utils/document.hpp>
+
+// regional
+#include <core/string/ustring.h>
+
+// local
+#include "spsc_queue.h"
+#include "usdj_editor.h"
+#include "usdj_heartbeat.h"
+
+/// \brief A replica of an Automerge document that's synchronized with a server
+///        over a connection that may be shared with other documents.
+///
+/// \note The thread that owns the connection exclusively owns the replica and
+///       the synchronization state while the channel is subscribed to it so
+///       the thread that pushes edits and takes snapshots never waits on it.
+class UsdjSyncChannel {
+public:
+    using Document = cavi::usdj_am::utils::Document;
+
+    /// \brief A snapshot of the replica.
+    struct Snapshot {
+        Document document;
+        /// The number of batches of edits that were written into the replica
+        /// before it was taken.
+        std::uint64_t edit_count;
+    };
+
+    UsdjSyncChannel() = delete;
+
+    /// \param[in] p_document An Automerge document to replicate.
+    /// \param[in] p_document_id The ID of the document on the server.
+    /// \param[in] p_peer_id The ID to present to the server as a peer.
+    /// \param[in] p_sync_state An encoded synchronization state that was
+    ///                         persisted with \p p_document or an empty
+    ///                         array.
+    /// \throws std::invalid_argument
+    /// \note A synchronization state that refers to changes which aren't in
+    ///       \p p_document is discarded.
+    UsdjSyncChannel(Document const& p_document,
+                    String const& p_document_id,
+                    String const& p_peer_id,
+                    std::vector<std::uint8_t> const& p_sync_state = {});
+
+    UsdjSyncChannel(UsdjSyncChannel const&) = delete;
+
+    UsdjSyncChannel(UsdjSyncChannel&&) = delete;
+
+    ~UsdjSyncChannel();
+
+    UsdjSyncChannel& operator=(UsdjSyncChannel const&) = delete;
+
+    UsdjSyncChannel& operator=(UsdjSyncChannel&&) = delete;
+
+    /// \returns `true` if there's room to push another batch of edits.
+    /// \note Must only be called from a single producing thread.
+    bool can_push_edits() const;
+
+    /// \brief Encodes the replica so that it can be persisted.
+    ///
+    /// \returns An array of bytes that's empty upon failure.
+    /// \note Only consistent with the synchronization state while the channel
+    ///       isn't subscribed to a connection.
+    std::vector<std::uint8_t> encode_replica() const;
+
+    /// \brief Encodes the parts of the synchronization state that outlive a
+    ///        connection so that they can be persisted.
+    ///
+    /// \returns An array of bytes that's empty upon failure.
+    /// \note Only consistent with the replica while the channel isn't
+    ///       subscribed to a connection.
+    std::vector<std::uint8_t> encode_sync_state() const;
+
+    /// \returns A snapshot of the replica regardless of whether it has changed.
+    /// \note Only consistent with the synchronization state while the channel
+    ///       isn't subscribed to a connection.
+    /// \throws std::invalid_argument
+    Snapshot fork_replica() const;
+
+    /// \returns The longest time to spend applying sync messages per pump
+    ///          or zero for no limit.
+    UsdjHeartbeat::Duration get_budget() const;
+
+    /// \returns The ID of the document on the server.
+    String const& get_document_id() const;
+
+    /// \returns The period between pings to the server.
+    UsdjHeartbeat::Duration get_keepalive_interval() const;
+
+    /// \returns The longest time to wait for the server to respond before
+    ///          reconnecting to it.
+    UsdjHeartbeat::Duration get_keepalive_timeout() const;
+
+    /// \returns The ID presented to the server as a peer.
+    String const& get_peer_id() const;
+
+    /// \brief Queues a batch of edits to be written into the replica as a
+    ///        single change and then synchronized with the server.
+    ///
+    /// \param[in] p_edits The edits made within a frame.
+    /// \returns `false` if there was no room for \p p_edits and it was left
+    ///          untouched.
+    /// \note Must only be called from a single producing thread.
+    bool push_edits(std::unique_ptr<UsdjEdits>&& p_edits);
+
+    /// \param[in] p_budget The longest time to spend applying sync messages
+    ///                     per pump or zero for no limit.
+    /// \note A connection shared with other channels applies the smallest
+    ///       budget among them.
+    void set_budget(UsdjHeartbeat::Duration const p_budget);
+
+    /// \param[in] p_interval The period between pings to the server.
+    /// \param[in] p_timeout The longest time to wait for the server to respond
+    ///                      before reconnecting to it.
+    /// \note A connection shared with other channels applies the shortest
+    ///       interval and timeout among them.
+    void set_keepalive(UsdjHeartbeat::Duration const p_interval, UsdjHeartbeat::Duration const p_timeout);
+
+    /// \brief Takes the most recent snapshot of the replica and discards any
+    ///        older ones.
+    ///
+    /// \returns A snapshot of the replica or `std::nullopt` if the replica
+    ///          hasn't changed since the previous call.
+    /// \note Must only be called from a single consuming thread.
+    std::optional<Snapshot> take_snapshot();
+
+    /// \brief Writes the queued batches of edits into the replica.
+    ///
+    /// \returns `true` if the replica was changed.
+    /// \note Must only be called from the connection's thread.
+    bool apply_edits();
+
+    /// \returns `true` if the document was requested during the connection.
+    /// \note Must only be called from the connection's thread.
+    bool is_open() const;
+
+    /// \brief Starts a new synchronization session for a new request of the
+    ///        document.
+    ///
+    /// \note Must only be called from the connection's thread.
+    void open();
+
+    /// \brief Publishes a snapshot of the replica if it changed and there's
+    ///        room for it.
+    ///
+    /// \param[in] p_backlogged Whether more sync messages are waiting to be
+    ///                         applied, in which case publishing is deferred.
+    /// \note Must only be called from the connection's thread.
+    void publish(bool const p_backlogged);
+
+    /// \brief Applies a sync message received from the server to the replica.
+    ///
+    /// \param[in] p_message A pointer to an encoded sync message.
+    /// \param[in] p_size The count of bytes in \p p_message.
+    /// \returns `true` if the message was applied.
+    /// \note Must only be called from the connection's thread.
+    bool receive(std::uint8_t const* const p_message, std::size_t const p_size);
+
+    /// \brief Generates a reply once a whole burst of sync messages has been
+    ///        applied or when a session starts.
+    ///
+    /// \param[in] p_backlogged Whether more sync messages are waiting to be
+    ///                         applied, in which case replying is deferred.
+    /// \returns An encoded sync message or an empty array if there's nothing
+    ///          to send.
+    /// \note Must only be called from the connection's thread.
+    std::vector<std::uint8_t> reply(bool const p_backlogged);
+
+    /// \brief Marks the document as unrequested after a connection is lost.
+    ///
+    /// \note Must only be called from the connection's thread.
+    void close();
+
+private:
+    using Edits = SpscQueue<std::unique_ptr<UsdjEdits>, 16>;
+    using ResultPtr = Document::ResultPtr;
+    using Snapshots = SpscQueue<std::unique_ptr<Snapshot>, 4>;
+
+    /// \brief Discards the parts of the synchronization state that don't
+    ///        outlive a connection.
+    void reset_sync_state();
+
+    std::atomic<UsdjHeartbeat::Duration::rep> m_budget;
+    String const m_document_id;
+    std::uint64_t m_edit_count;
+    Edits m_edits;
+    std::atomic<UsdjHeartbeat::Duration::rep> m_keepalive_interval;
+    std::atomic<UsdjHeartbeat::Duration::rep> m_keepalive_timeout;
+    bool m_open;
+    String const m_peer_id;
+    std::uint64_t m_published_edit_count;
+    Document m_replica;
+    bool m_replying;
+    Snapshots m_snapshots;
+    ResultPtr m_sync_state;
+    bool m_syncing;
+    bool m_unpublished;
+};
+
+inline bool UsdjSyncChannel::can_push_edits() const {
+    return !m_edits.full();
+}
+
+inline UsdjHeartbeat::Duration UsdjSyncChannel::get_budget() const {
+    return UsdjHeartbeat::Duration{m_budget.load(std::memory_order_relaxed)};
+}
+
+inline String const& UsdjSyncChannel::get_document_id() const {
+    return m_document_id;
+}
+
+inline UsdjHeartbeat::Duration UsdjSyncChannel::get_keepalive_interval() const {
+    return UsdjHeartbeat::Duration{m_keepalive_interval.load(std::memory_order_relaxed)};
+}
+
+inline UsdjHeartbeat::Duration UsdjSyncChannel::get_keepalive_timeout() const {
+    return UsdjHeartbeat::Duration{m_keepalive_timeout.load(std::memory_order_relaxed)};
+}
+
+inline String const& UsdjSyncChannel::get_peer_id() const {
+    return m_peer_id;
+}
+
+inline bool UsdjSyncChannel::is_open() const {
+    return m_open;
+}
+
+#endif  // REALITY_MERGE_USDJ_SYNC_CHANNEL_H
@@ -0,0 +1,444 @@
+/**************************************************************************/
+/* usdj_sync_worker.cpp                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// regional
+#include <core/config/project_settings.h>
+#include <core/error/error_macros.h>
+#include <core/templates/vector.h>
+#include <core/variant/dictionary.h>
+
+// local
+#include "usdj_sync_worker.h"
+
+namespace {
+
+/// \brief The delay before the first attempt to re-establish a connection.
+static std::chrono::milliseconds const BACKOFF_BASE{500};
+
+/// \brief The longest delay between attempts to re-establish a connection.
+static std::chrono::milliseconds const BACKOFF_CEILING{30000};
+
+static int const BUFFER_SIZE = (1 << 23) - 1;
+
+/// \brief The period to sleep for when the server has nothing to send.
+static std::chrono::milliseconds const IDLE_PERIOD{10};
+
+static std::chrono::seconds const KEEPALIVE_INTERVAL{5};
+
+static std::chrono::seconds const KEEPALIVE_TIMEOUT{15};
+
+static int MAX_QUEUED_MESSAGES() {
+    static std::optional<int> value{};
+
+    if (!value)
+        value.emplace(static_cast<int>(GLOBAL_GET("network/limits/debugger/max_queued_messages")));
+    return *value;
+}
+
+/// \brief The multiplexing connections keyed by their server's URL.
+static std::map<std::string, std::weak_ptr<UsdjSyncWorker>> s_connections{};
+
+static std::mutex s_connections_mutex{};
+
+static String PING_TEXT() {
+    static std::optional<String> text{};
+
+    if (!text) {
+        Dictionary request{};
+        request["ping"] = "ping";
+        Ref<JSON> json;
+        json.instantiate();
+        text = json->stringify(request, "\t", false);
+    }
+    return *text;
+}
+
+}  // namespace
+
+UsdjSyncWorker::UsdjSyncWorker(String const& p_domain_name, bool const p_tls, bool const p_multiplex)
+    : m_backlogged{false},
+      m_backoff_count{0},
+      m_budget{0},
+      m_exit{false},
+      m_keepalive_interval{KEEPALIVE_INTERVAL},
+      m_keepalive_timeout{KEEPALIVE_TIMEOUT},
+      m_multiplex{p_multiplex},
+      m_random{std::random_device{}()},
+      m_server_domain_name{p_domain_name},
+      m_server_tls{p_tls},
+      m_state{State::IDLE},
+      m_statistics{m_heartbeat.get_statistics()} {
+    m_json_parser.instantiate();
+    // Cache the project settings and the ping message before the background
+    // thread can need them.
+    MAX_QUEUED_MESSAGES();
+    PING_TEXT();
+}
+
+UsdjSyncWorker::~UsdjSyncWorker() {
+    stop();
+}
+
+std::shared_ptr<UsdjSyncWorker> UsdjSyncWorker::acquire(String const& p_domain_name, bool const p_tls) {
+    auto const url = String{(p_tls) ? "wss://" : "ws://"} + p_domain_name;
+    std::lock_guard<std::mutex> const lock{s_connections_mutex};
+    // Forget the connections that have already stopped.
+    for (auto pos = s_connections.begin(); pos != s_connections.end();)
+        pos = (pos->second.expired()) ? s_connections.erase(pos) : std::next(pos);
+    auto& entry = s_connections[url.utf8().get_data()];
+    auto result = entry.lock();
+    if (!result) {
+        // The connection stops when its last subscriber releases it.
+        result = std::make_shared<UsdjSyncWorker>(p_domain_name, p_tls, true);
+        result->start();
+        entry = result;
+    }
+    return result;
+}
+
+bool UsdjSyncWorker::advance_connection() {
+    auto const now = Clock::now();
+    switch (m_state) {
+        case State::IDLE: {
+            if (m_channels.empty())
+                return false;
+            if (connect() == OK) {
+                m_deadline = now + std::chrono::milliseconds{HANDSHAKE_TIMEOUT_MSECS};
+                m_state = State::CONNECTING;
+            } else {
+                back_off(now);
+            }
+            return false;
+        }
+        case State::CONNECTING:
+        case State::HANDSHAKING:
+        case State::OPEN: {
+            m_server_socket->poll();
+            auto const ready_state = m_server_socket->get_ready_state();
+            if (ready_state == WebSocketPeer::STATE_CLOSED) {
+                auto const code = m_server_socket->get_close_code();
+                auto const reason = m_server_socket->get_close_reason();
+                WARN_PRINT(vformat("WebSocket closed with code %d and reason \"%s\".", code, reason));
+                back_off(now);
+                return false;
+            }
+            if (m_state == State::CONNECTING && ready_state == WebSocketPeer::STATE_OPEN) {
+                // Disable Nagle's algorithm.
+                m_server_socket->set_no_delay(true);
+                m_heartbeat.reset(now);
+                m_backlogged = false;
+                m_state = State::HANDSHAKING;
+            }
+            // Channels can subscribe at any time during the connection.
+            if (m_state != State::CONNECTING && open_documents() != OK) {
+                back_off(now);
+                return false;
+            }
+            if (m_state == State::OPEN && m_heartbeat.is_dead(now, m_keepalive_timeout)) {
+                WARN_PRINT(vformat("Server \"%s\" stopped responding.", m_server_domain_name));
+                back_off(now);
+                return false;
+            }
+            if (m_state != State::OPEN && now >= m_deadline) {
+                WARN_PRINT(vformat("Unable to connect to server \"%s\" within %d ms.", m_server_domain_name,
+                                   HANDSHAKE_TIMEOUT_MSECS));
+                back_off(now);
+                return false;
+            }
+            return m_state != State::CONNECTING && ready_state == WebSocketPeer::STATE_OPEN;
+        }
+        case State::BACKOFF: {
+            if (now >= m_deadline)
+                m_state = State::IDLE;
+            return false;
+        }
+        default:
+            return false;
+    }
+}
+
+void UsdjSyncWorker::back_off(Clock::time_point const now) {
+    if (!m_server_socket.is_null()) {
+        m_server_socket->close();
+        m_server_socket.unref();
+    }
+    // Every document must be requested again upon reconnection.
+    for (auto const& channel : m_channels)
+        channel->close();
+    // Double the delay after every consecutive failure up to a ceiling and
+    // then pick a random delay within its upper half so that the peers that
+    // were disconnected together don't all reconnect together.
+    auto const exponent = std::min<std::uint32_t>(m_backoff_count, 16);
+    auto const ceiling = std::min<std::chrono::milliseconds>(BACKOFF_BASE * (1 << exponent), BACKOFF_CEILING);
+    std::uniform_int_distribution<std::chrono::milliseconds::rep> jitter{ceiling.count() / 2, ceiling.count()};
+    m_deadline = now + std::chrono::milliseconds{jitter(m_random)};
+    ++m_backoff_count;
+    m_state = State::BACKOFF;
+}
+
+void UsdjSyncWorker::combine_settings() {
+    if (m_channels.empty())
+        return;
+    // Every subscriber's limits are honored by the strictest combination.
+    m_budget = UsdjHeartbeat::Duration::zero();
+    m_keepalive_interval = UsdjHeartbeat::Duration::max();
+    m_keepalive_timeout = UsdjHeartbeat::Duration::max();
+    for (auto const& channel : m_channels) {
+        auto const budget = channel->get_budget();
+        if (budget.count() > 0 && (m_budget.count() == 0 || budget < m_budget))
+            m_budget = budget;
+        m_keepalive_interval = std::min(m_keepalive_interval, channel->get_keepalive_interval());
+        m_keepalive_timeout = std::min(m_keepalive_timeout, channel->get_keepalive_timeout());
+    }
+}
+
+void UsdjSyncWorker::control(UsdjPacket const& packet, Clock::time_point const now) {
+    auto const text = String::utf8(reinterpret_cast<char const*>(packet.payload), static_cast<int>(packet.size));
+    if (m_json_parser->parse(text) != OK)
+        return;
+    auto const message = m_json_parser->get_data();
+    if (message.get_type() != Variant::DICTIONARY)
+        return;
+    Dictionary const dictionary = message;
+    if (dictionary.has("pong")) {
+        m_heartbeat.on_pong(now);
+        std::lock_guard<std::mutex> const lock{m_statistics_mutex};
+        m_statistics = m_heartbeat.get_statistics();
+    }
+}
+
+Error UsdjSyncWorker::connect() {
+    m_server_socket = Ref<WebSocketPeer>(WebSocketPeer::create());
+    ERR_FAIL_COND_V(m_server_socket.is_null(), ERR_CANT_CREATE);
+    Vector<String> protocols;
+    protocols.push_back("binary");
+    m_server_socket->set_supported_protocols(protocols);
+    m_server_socket->set_max_queued_packets(MAX_QUEUED_MESSAGES());
+    m_server_socket->set_inbound_buffer_size(BUFFER_SIZE);
+    m_server_socket->set_outbound_buffer_size(BUFFER_SIZE);
+    auto const url = String{(m_server_tls) ? "wss://" : "ws://"} + m_server_domain_name;
+    auto const tls_options = (m_server_tls) ? TLSOptions::client() : Ref<TLSOptions>{};
+    ERR_FAIL_COND_V_MSG(m_server_socket->connect_to_url(url, tls_options) != OK, ERR_CANT_CONNECT,
+                        vformat("Unable to connect to server \"%s\".", m_server_domain_name));
+    return OK;
+}
+
+UsdjSyncWorker::Channel* UsdjSyncWorker::find_channel(UsdjPacket const& packet) const {
+    if (m_channels.empty())
+        return nullptr;
+    if (packet.type != UsdjPacketType::TAGGED_SYNC) {
+        // An untagged sync message can only be meant for the sole document.
+        return (m_channels.size() == 1) ? m_channels.front().get() : nullptr;
+    }
+    auto const document_id = String::utf8(packet.channel.data(), static_cast<int>(packet.channel.size()));
+    for (auto const& channel : m_channels) {
+        if (channel->get_document_id() == document_id)
+            return channel.get();
+    }
+    return nullptr;
+}
+
+std::size_t UsdjSyncWorker::get_channel_count() const {
+    std::lock_guard<std::mutex> const lock{m_channels_mutex};
+    return m_channels.size();
+}
+
+UsdjHeartbeat::Statistics UsdjSyncWorker::get_round_trip_statistics() const {
+    std::lock_guard<std::mutex> const lock{m_statistics_mutex};
+    return m_statistics;
+}
+
+Error UsdjSyncWorker::open_documents() {
+    for (auto const& channel : m_channels) {
+        if (channel->is_open())
+            continue;
+        // Request updates of the Automerge document.
+        Dictionary request{};
+        request["wa"] = "open";
+        Dictionary body{};
+        body["strateId"] = channel->get_document_id();
+        body["peerId"] = channel->get_peer_id();
+        if (m_multiplex)
+            body["multiplex"] = true;
+        request["body"] = body;
+        ERR_FAIL_COND_V(m_server_socket->send_text(m_json_parser->stringify(request, "\t", false)) != OK,
+                        ERR_QUERY_FAILED);
+        channel->open();
+    }
+    return OK;
+}
+
+bool UsdjSyncWorker::receive_changes() {
+    bool result = false;
+    auto const now = Clock::now();
+    auto packet_count = m_server_socket->get_available_packet_count();
+    if (packet_count && m_state == State::HANDSHAKING) {
+        // The server has responded to the request for a document.
+        m_state = State::OPEN;
+        m_backoff_count = 0;
+    }
+    while (packet_count && m_server_socket->get_ready_state() == WebSocketPeer::STATE_OPEN) {
+        // Leave the remaining packets in the socket for the next pump once
+        // the budget is spent, but always make some progress.
+        if (result && m_budget.count() > 0 && Clock::now() - now >= m_budget)
+            break;
+        std::uint8_t const* r_buffer = nullptr;
+        int r_buffer_size = 0;
+        auto const error = m_server_socket->get_packet(&r_buffer, r_buffer_size);
+        // The packets that were already applied still have to be replied to.
+        ERR_BREAK(error != OK);
+        ERR_BREAK(r_buffer_size <= 0);
+        m_heartbeat.on_packet(now);
+        auto const packet = classify_packet(r_buffer, static_cast<std::size_t>(r_buffer_size),
+                                            m_server_socket->was_string_packet());
+        switch (packet.type) {
+            case UsdjPacketType::CONTROL: {
+                control(packet, now);
+                break;
+            }
+            case UsdjPacketType::SYNC:
+            case UsdjPacketType::TAGGED_SYNC: {
+                // A document that was unsubscribed from may still have sync
+                // messages in flight.
+                auto* const channel = find_channel(packet);
+                if (channel && channel->is_open() && channel->receive(packet.payload, packet.size))
+                    result = true;
+                break;
+            }
+            default:
+                break;
+        }
+        --packet_count;
+    }
+    m_backlogged = m_server_socket->get_available_packet_count() > 0;
+    // Reply once to a whole burst of sync messages instead of once per pump.
+    for (auto const& channel : m_channels) {
+        if (!channel->is_open())
+            continue;
+        auto const client_message = channel->reply(m_backlogged);
+        if (client_message.empty())
+            continue;
+        auto const document_id = (m_multiplex) ? channel->get_document_id().utf8() : CharString{};
+        auto const client_buffer =
+            frame_sync_message(std::string_view{document_id.get_data(), static_cast<std::size_t>(document_id.length())},
+                               client_message.data(), client_message.size());
+        ERR_CONTINUE_MSG(client_buffer.empty(),
+                         vformat("Document ID \"%s\" is too long to be tagged.", channel->get_document_id()));
+        ERR_FAIL_COND_V(m_server_socket->put_packet(client_buffer.data(), client_buffer.size()) != OK, result);
+    }
+    return result;
+}
+
+void UsdjSyncWorker::run() {
+    while (!m_exit.load(std::memory_order_acquire)) {
+        bool edited = false;
+        bool changed = false;
+        {
+            // Unsubscribing waits for the channels to be released.
+            std::lock_guard<std::mutex> const lock{m_channels_mutex};
+            combine_settings();
+            for (auto const& channel : m_channels)
+                edited = channel->apply_edits() || edited;
+            changed = advance_connection() && receive_changes();
+            for (auto const& channel : m_channels)
+                channel->publish(m_backlogged);
+        }
+        // Keep the connection, if there is one, alive.
+        send_ping(Clock::now());
+        if (!(edited || changed || m_backlogged))
+            std::this_thread::sleep_for(IDLE_PERIOD);
+    }
+    std::lock_guard<std::mutex> const lock{m_channels_mutex};
+    if (!m_server_socket.is_null()) {
+        m_server_socket->close();
+        m_server_socket.unref();
+    }
+    for (auto const& channel : m_channels)
+        channel->close();
+    m_state = State::IDLE;
+}
+
+Error UsdjSyncWorker::send_ping(Clock::time_point const now) {
+    if (m_state != State::OPEN || !m_heartbeat.is_due(now, m_keepalive_interval))
+        return OK;
+    // Send a ping message.
+    ERR_FAIL_COND_V(m_server_socket->send_text(PING_TEXT()) != OK, FAILED);
+    m_heartbeat.on_ping(now);
+    return OK;
+}
+
+void UsdjSyncWorker::start() {
+    if (is_running())
+        return;
+    m_exit.store(false, std::memory_order_release);
+    m_thread = std::thread{&UsdjSyncWorker::run, this};
+}
+
+void UsdjSyncWorker::stop() {
+    m_exit.store(true, std::memory_order_release);
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+bool UsdjSyncWorker::subscribe(std::shared_ptr<Channel> const& p_channel) {
+    ERR_FAIL_NULL_V(p_channel, false);
+    std::lock_guard<std::mutex> const lock{m_channels_mutex};
+    if (std::find(m_channels.begin(), m_channels.end(), p_channel) != m_channels.end())
+        return true;
+    if (!m_multiplex && !m_channels.empty())
+        return false;
+    for (auto const& channel : m_channels) {
+        ERR_FAIL_COND_V_MSG(channel->get_document_id() == p_channel->get_document_id(), false,
+                            vformat("Document \"%s\" is already subscribed to.", p_channel->get_document_id()));
+    }
+    // The document is requested during the next step of the connection.
+    m_channels.push_back(p_channel);
+    return true;
+}
+
+void UsdjSyncWorker::unsubscribe(std::shared_ptr<Channel> const& p_channel) {
+    std::lock_guard<std::mutex> const lock{m_channels_mutex};
+    auto const pos = std::find(m_channels.begin(), m_channels.end(), p_channel);
+    if (pos == m_channels.end())
+        return;
+    (*pos)->close();
+    m_channels.erase(pos);
+}
@@ -0,0 +1,240 @@
+/**************************************************************************/
+/* usdj_sync_worker.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef REALITY_MERGE_USDJ_SYNC_WORKER_H
+#define REALITY_MERGE_USDJ_SYNC_WORKER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+// regional
+#include <core/error/error_list.h>
+#include <core/io/json.h>
+#include <core/object/ref_counted.h>
+#include <core/string/ustring.h>
+#include <core/variant/variant.h>
+#include <modules/websocket/websocket_peer.h>
+
+// local
+#include "usdj_heartbeat.h"
+#include "usdj_packet.h"
+#include "usdj_sync_channel.h"
+
+/// \brief Synchronizes the replicas of Automerge documents with a server on a
+///        background thread over a single connection, writes local edits
+///        into the replicas and publishes snapshots of the replicas whenever
+///        they change.
+///
+/// \note The background thread exclusively owns the server connection and
+///       the subscribed channels so the thread that consumes the snapshots
+///       never waits on the network or on Automerge.
+/// \note A multiplexing connection tags every sync message with the ID of
+///       its document so that several documents can share one socket, TLS
+///       session and heartbeat. Servers that don't understand tagged sync
+///       messages need a connection per document instead.
+class UsdjSyncWorker {
+public:
+    using Channel = UsdjSyncChannel;
+
+    /// \brief The time allowed for connecting to the server and for it to
+    ///        respond to the request for a document.
+    static std::uint64_t const HANDSHAKE_TIMEOUT_MSECS = 6000;
+
+    UsdjSyncWorker() = delete;
+
+    /// \param[in] p_domain_name A server's URL domain name component.
+    /// \param[in] p_tls A toggle for securing the connection with TLS.
+    /// \param[in] p_multiplex A toggle for tagging sync messages with the IDs
+    ///                        of their documents.
+    UsdjSyncWorker(String const& p_domain_name, bool const p_tls = true, bool const p_multiplex = false);
+
+    UsdjSyncWorker(UsdjSyncWorker const&) = delete;
+
+    UsdjSyncWorker(UsdjSyncWorker&&) = delete;
+
+    /// \brief Stops the background thread if it's running.
+    ~UsdjSyncWorker();
+
+    UsdjSyncWorker& operator=(UsdjSyncWorker const&) = delete;
+
+    UsdjSyncWorker& operator=(UsdjSyncWorker&&) = delete;
+
+    /// \brief Gets the multiplexing connection to a server that's shared by
+    ///        every subscriber, starting it if there's none yet.
+    ///
+    /// \param[in] p_domain_name A server's URL domain name component.
+    /// \param[in] p_tls A toggle for securing the connection with TLS.
+    /// \returns A running connection that stops once it's released by its
+    ///          last owner.
+    static std::shared_ptr<UsdjSyncWorker> acquire(String const& p_domain_name, bool const p_tls = true);
+
+    /// \returns The count of channels subscribed to the connection.
+    std::size_t get_channel_count() const;
+
+    /// \returns The statistics of the round trips to the server.
+    UsdjHeartbeat::Statistics get_round_trip_statistics() const;
+
+    /// \returns `true` if sync messages are tagged with the IDs of their
+    ///          documents.
+    bool is_multiplexed() const;
+
+    /// \returns `true` if the background thread is running.
+    bool is_running() const;
+
+    /// \brief Starts synchronizing on a background thread.
+    void start();
+
+    /// \brief Stops synchronizing and joins the background thread.
+    void stop();
+
+    /// \brief Starts synchronizing a channel's document over the connection.
+    ///
+    /// \param[in] p_channel A channel that isn't subscribed to any connection.
+    /// \returns `false` if \p p_channel can't share a non-multiplexing
+    ///          connection with the channels already subscribed to it.
+    bool subscribe(std::shared_ptr<Channel> const& p_channel);
+
+    /// \brief Stops synchronizing a channel's document over the connection.
+    ///
+    /// \param[in] p_channel A channel subscribed to the connection.
+    /// \note The background thread is done with \p p_channel upon return.
+    void unsubscribe(std::shared_ptr<Channel> const& p_channel);
+
+private:
+    using Channels = std::vector<std::shared_ptr<Channel>>;
+    using Clock = std::chrono::steady_clock;
+
+    /// \brief The stages of a connection to the server.
+    enum class State : std::uint8_t {
+        BEGIN__ = 1,
+        /// There's no connection.
+        IDLE = BEGIN__,
+        /// The WebSocket connection is being established.
+        CONNECTING,
+        /// The documents were requested but the server hasn't responded yet.
+        HANDSHAKING,
+        /// The server is responding.
+        OPEN,
+        /// The connection was lost and is waiting to be re-established.
+        BACKOFF,
+        END__,
+        SIZE__ = END__ - BEGIN__
+    };
+
+    /// \brief Advances the connection to the server by one non-blocking step.
+    ///
+    /// \returns `true` if the connection can carry sync messages.
+    bool advance_connection();
+
+    /// \brief Drops the connection and schedules its re-establishment after
+    ///        an exponentially increasing, randomly jittered delay.
+    ///
+    /// \param[in] now The current time.
+    void back_off(Clock::time_point const now);
+
+    /// \param[in] packet A packet classified as a sync message.
+    /// \returns The subscribed channel that \p packet belongs to or `nullptr`
+    ///          if there's none.
+    Channel* find_channel(UsdjPacket const& packet) const;
+
+    /// \brief Combines the budgets and keepalive settings of the subscribed
+    ///        channels into the strictest ones, which the connection applies.
+    ///
+    /// \note At least one sync message is applied per pump regardless of the
+    ///       budget.
+    void combine_settings();
+
+    /// \brief Handles a control message received from the server.
+    ///
+    /// \param[in] packet A packet classified as a JSON control message.
+    /// \param[in] now The current time.
+    void control(UsdjPacket const& packet, Clock::time_point const now);
+
+    /// \brief Starts connecting to the server.
+    ///
+    /// \returns `Error::OK` if the connection is being established.
+    Error connect();
+
+    /// \brief Requests updates of the Automerge documents that haven't been
+    ///        requested during the connection yet.
+    ///
+    /// \returns `Error::OK` if the requests were sent.
+    Error open_documents();
+
+    /// \brief Applies the sync messages received from the server to the
+    ///        replicas within the budget and replies to them once they've all
+    ///        been applied.
+    ///
+    /// \returns `true` if a replica was changed.
+    bool receive_changes();
+
+    void run();
+
+    /// \brief Sends a ping to the server if one is due.
+    ///
+    /// \param[in] now The current time.
+    Error send_ping(Clock::time_point const now);
+
+    bool m_backlogged;
+    std::uint32_t m_backoff_count;
+    UsdjHeartbeat::Duration m_budget;
+    Channels m_channels;
+    mutable std::mutex m_channels_mutex;
+    Clock::time_point m_deadline;
+    std::atomic<bool> m_exit;
+    UsdjHeartbeat m_heartbeat;
+    Ref<JSON> m_json_parser;
+    UsdjHeartbeat::Duration m_keepalive_interval;
+    UsdjHeartbeat::Duration m_keepalive_timeout;
+    bool const m_multiplex;
+    std::minstd_rand m_random;
+    String m_server_domain_name;
+    Ref<WebSocketPeer> m_server_socket;
+    bool m_server_tls;
+    State m_state;
+    UsdjHeartbeat::Statistics m_statistics;
+    mutable std::mutex m_statistics_mutex;
+    std::thread m_thread;
+};
+
+inline bool UsdjSyncWorker::is_multiplexed() const {
+    return m_multiplex;
+}
+
+inline bool UsdjSyncWorker::is_running() const {
+    return m_thread.joinable();
+}
+
+#endif  // REALITY_MERGE_USDJ_SYNC_WORKER_H
@@ -38,6 +38,7 @@
 // local
 #include "usdj_basis.h"
 #include "usdj_color.h"
+#include "usdj_packed_vector3_array.h"
 #include "usdj_projection.h"
 #include "usdj_quaternion.h"
 #include "usdj_real.h"
@@ -160,15 +161,18 @@ std::optional<UsdjValue> extract_UsdjValue(cavi::usdj_am::Declaration const& dec
             // case ValueTypeName::DOUBLE_2_ARRAY:
             // case ValueTypeName::DOUBLE_3_ARRAY:
             // case ValueTypeName::DOUBLE_4_ARRAY:
-            // case ValueTypeName::POINT_3H_ARRAY:
-            // case ValueTypeName::POINT_3F_ARRAY:
-            // case ValueTypeName::POINT_3D_ARRAY:
-            // case ValueTypeName::VECTOR_3H_ARRAY:
-            // case ValueTypeName::VECTOR_3F_ARRAY:
-            // case ValueTypeName::VECTOR_3D_ARRAY:
-            // case ValueTypeName::NORMAL_3H_ARRAY:
-            // case ValueTypeName::NORMAL_3F_ARRAY:
-            // case ValueTypeName::NORMAL_3D_ARRAY:
+            case ValueTypeName::POINT_3H_ARRAY:
+            case ValueTypeName::POINT_3F_ARRAY:
+            case ValueTypeName::POINT_3D_ARRAY:
+            case ValueTypeName::VECTOR_3H_ARRAY:
+            case ValueTypeName::VECTOR_3F_ARRAY:
+            case ValueTypeName::VECTOR_3D_ARRAY:
+            case ValueTypeName::NORMAL_3H_ARRAY:
+            case ValueTypeName::NORMAL_3F_ARRAY:
+            case ValueTypeName::NORMAL_3D_ARRAY: {
+                usd_value.emplace(to_PackedVector3Array(declaration.get_value()));
+                break;
+            }
             case ValueTypeName::COLOR_3H_ARRAY:
             case ValueTypeName::COLOR_3F_ARRAY:
             case ValueTypeName::COLOR_3D_ARRAY:
@@ -44,6 +44,7 @@
 #include <core/math/vector4.h>
 #include <core/math/vector4i.h>
 #include <core/string/ustring.h>
+#include <core/variant/variant.h>
 
 // local
 #include "usdj_reals.h"
@@ -56,8 +57,18 @@ class Declaration;
 }  // namespace usdj_am
 }  // namespace cavi
 
-using UsdjValue =
-    std::variant<real_t, Basis, Color, Projection, Quaternion, Reals, String, Vector3, Vector3i, Vector4, Vector4i>;
+using UsdjValue = std::variant<real_t,
+                               Basis,
+                               Color,
+                               PackedVector3Array,
+                               Projection,
+                               Quaternion,
+                               Reals,
+                               String,
+                               Vector3,
+                               Vector3i,
+                               Vector4,
+                               Vector4i>;
 
 /// \brief Extracts the Godot counterpart of a USD value from within the given
 ///        USDJ declaration, if any.
@@ -30,13 +30,13 @@
 #ifndef REALITY_MERGE_USDJ_VECTOR_H
 #define REALITY_MERGE_USDJ_VECTOR_H
 
-#include <iterator>
 #include <sstream>
 #include <stdexcept>
 #include <typeinfo>
 #include <variant>
 
 // third-party
+#include <cavi/usdj_am/utils/numbers.hpp>
 #include <cavi/usdj_am/value.hpp>
 
 /// \brief Converts a USDJ value into a Godot 3D vector.
@@ -48,8 +48,8 @@
 /// \throws std::invalid_argument
 template <class VectorT, typename AxisT>
 VectorT to_Vector(cavi::usdj_am::Value const& value) {
-    using cavi::usdj_am::Number;
     using cavi::usdj_am::ValueRange;
+    using cavi::usdj_am::utils::read_numbers;
 
     std::ostringstream args;
     VectorT result{};
@@ -58,15 +58,12 @@ VectorT to_Vector(cavi::usdj_am::Value const& value) {
         if (values.size() != VectorT::AXIS_COUNT) {
             args << "std::get<" << typeid(decltype(values)).name() << ">(value).size() == " << values.size();
         } else {
-            auto axis = std::begin(result.coord);
-            for (auto const& value : values) {
-                auto const& number = std::get<Number>(value);
-                std::visit([&](auto const& alt) { *axis = static_cast<AxisT>(alt); }, number);
-                ++axis;
-            }
+            read_numbers<AxisT>(values, result.coord, VectorT::AXIS_COUNT);
         }
     } catch (std::bad_variant_access const& thrown) {
         args << "std::get<ValueRange>(value): " << thrown.what();
+    } catch (std::invalid_argument const& thrown) {
+        args << thrown.what();
     }
     if (!args.str().empty()) {
         std::ostringstream what;